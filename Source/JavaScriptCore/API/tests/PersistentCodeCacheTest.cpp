@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "PersistentCodeCacheTest.h"
+
+#include "InitializeThreading.h"
+#include "JavaScriptCore.h"
+#include "Options.h"
+#include <wtf/Vector.h>
+#include <wtf/text/CString.h>
+#include <wtf/text/StringBuilder.h>
+
+#if OS(UNIX)
+#include <dirent.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using JSC::Options;
+
+#if OS(UNIX)
+
+static const double expectedResult = 2087;
+
+// Long enough to be cached, with nested functions, a regular expression and a
+// constant buffer, so that all parts of an entry are exercised.
+static CString largeProgram()
+{
+    StringBuilder builder;
+    builder.appendLiteral("var result = 0;\n");
+    for (unsigned i = 0; i < 64; ++i) {
+        builder.appendLiteral("function f");
+        builder.appendNumber(i);
+        builder.appendLiteral("(x) { return x + ");
+        builder.appendNumber(i);
+        builder.appendLiteral("; }\nresult += f");
+        builder.appendNumber(i);
+        builder.appendLiteral("(1);\n");
+    }
+    builder.appendLiteral("result += 'abc'.length + /b/.exec('abc').index + [1.5, true, null].length;\n");
+    return builder.toString().utf8();
+}
+
+// Each run uses a new VM, so results can only come from the program or from the directory.
+static bool evaluateInNewVM(const CString& program)
+{
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    JSStringRef script = JSStringCreateWithUTF8CString(program.data());
+    JSValueRef exception = nullptr;
+    JSValueRef value = JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+    JSStringRelease(script);
+    bool success = value && !exception && JSValueIsNumber(context, value) && JSValueToNumber(context, value, nullptr) == expectedResult;
+    JSGlobalContextRelease(context);
+    return success;
+}
+
+// Returns the path of the only entry in the directory, or a null string.
+static CString onlyEntry(const CString& directory)
+{
+    DIR* dir = opendir(directory.data());
+    if (!dir)
+        return CString();
+    CString entry;
+    unsigned entryCount = 0;
+    while (struct dirent* directoryEntry = readdir(dir)) {
+        if (directoryEntry->d_name[0] == '.')
+            continue;
+        entry = makeString(directory.data(), "/", directoryEntry->d_name).utf8();
+        ++entryCount;
+    }
+    closedir(dir);
+    return entryCount == 1 ? entry : CString();
+}
+
+static bool readEntry(const CString& path, Vector<char>& contents, mode_t& mode)
+{
+    FILE* file = fopen(path.data(), "rb");
+    if (!file)
+        return false;
+    struct stat fileStat;
+    bool success = !fstat(fileno(file), &fileStat);
+    if (success) {
+        mode = fileStat.st_mode & 0777;
+        contents.resize(fileStat.st_size);
+        success = fread(contents.data(), 1, contents.size(), file) == contents.size();
+    }
+    fclose(file);
+    return success;
+}
+
+static bool overwriteEntry(const CString& path, const Vector<char>& contents)
+{
+    // Rewrites the file in place, so that its inode does not change.
+    FILE* file = fopen(path.data(), "r+b");
+    if (!file)
+        return false;
+    bool success = fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    success = !fflush(file) && success;
+    success = !ftruncate(fileno(file), contents.size()) && success;
+    fclose(file);
+    return success;
+}
+
+static bool check(bool condition, const char* description)
+{
+    if (condition)
+        printf("PASS: %s\n", description);
+    else
+        printf("FAIL: %s\n", description);
+    return !condition;
+}
+
+#endif // OS(UNIX)
+
+int testPersistentCodeCache()
+{
+#if OS(UNIX)
+    bool failed = false;
+
+    JSC::initializeThreading();
+    Options::initialize(); // Ensure options is initialized first.
+
+    char directoryTemplate[] = "/tmp/PersistentCodeCacheTest.XXXXXX";
+    if (!mkdtemp(directoryTemplate)) {
+        printf("FAIL: Could not create a directory for the persistent code cache.\n");
+        return 1;
+    }
+    CString directory(directoryTemplate);
+
+    StringBuilder savedOptionsBuilder;
+    Options::dumpAllOptionsInALine(savedOptionsBuilder);
+    Options::setOptions(makeString("diskCachePath=\"", directoryTemplate, "\"").utf8().data());
+
+    CString program = largeProgram();
+
+    // Releasing the VM waits for its writes to finish.
+    failed |= check(evaluateInNewVM(program), "Program without a cache entry has the expected result.");
+    CString entryPath = onlyEntry(directory);
+    Vector<char> originalContents;
+    mode_t mode = 0;
+    failed |= check(!entryPath.isNull() && readEntry(entryPath, originalContents, mode), "Persistent code cache wrote an entry for the program.");
+
+    if (!failed) {
+        // A hit leaves the file alone, while a rejected entry is replaced by a new file with the default mode.
+        chmod(entryPath.data(), 0400);
+        failed |= check(evaluateInNewVM(program), "Program loaded from the persistent code cache has the expected result.");
+        Vector<char> contents;
+        failed |= check(readEntry(entryPath, contents, mode) && mode == 0400 && contents == originalContents, "Persistent code cache entry round-trips and is reused.");
+        chmod(entryPath.data(), 0600);
+
+        // Flip a bit in the payload, then cut the file short.
+        Vector<char> corruptedContents = originalContents;
+        corruptedContents.last() ^= 1;
+        failed |= check(overwriteEntry(entryPath, corruptedContents), "Corrupted the persistent code cache entry.");
+        failed |= check(evaluateInNewVM(program), "Program with a corrupted cache entry has the expected result.");
+        failed |= check(readEntry(entryPath, contents, mode) && contents == originalContents, "Corrupted persistent code cache entry is rejected and rewritten.");
+
+        corruptedContents.shrink(corruptedContents.size() / 2);
+        failed |= check(overwriteEntry(entryPath, corruptedContents), "Truncated the persistent code cache entry.");
+        failed |= check(evaluateInNewVM(program), "Program with a truncated cache entry has the expected result.");
+        failed |= check(readEntry(entryPath, contents, mode) && contents == originalContents, "Truncated persistent code cache entry is rejected and rewritten.");
+    }
+
+    Options::setOptions(savedOptionsBuilder.toString().ascii().data());
+
+    if (!entryPath.isNull())
+        unlink(entryPath.data());
+    rmdir(directory.data());
+
+    return failed;
+#else
+    return 0;
+#endif
+}
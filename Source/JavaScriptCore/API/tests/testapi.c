@@ -43,6 +43,7 @@
 #include "CustomGlobalObjectClassTest.h"
 #include "ExecutionTimeLimitTest.h"
 #include "GlobalContextWithFinalizerTest.h"
+#include "PersistentCodeCacheTest.h"
 #include "PingPongStackOverflowTest.h"
 
 #if JSC_OBJC_API_ENABLED
@@ -1893,6 +1894,7 @@ int main(int argc, char* argv[])
 
     failed = testExecutionTimeLimit() || failed;
     failed = testGlobalContextWithFinalizer() || failed;
+    failed = testPersistentCodeCache() || failed;
     failed = testPingPongStackOverflow() || failed;
 
     // Clear out local variables pointing at JSObjectRefs to allow their values to be collected
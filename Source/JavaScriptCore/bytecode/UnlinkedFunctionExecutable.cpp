@@ -109,6 +109,32 @@ UnlinkedFunctionExecutable::UnlinkedFunctionExecutable(VM* vm, Structure* struct
     m_parentScopeTDZVariables.swap(parentScopeTDZVariables);
 }
 
+UnlinkedFunctionExecutable::UnlinkedFunctionExecutable(VM* vm, Structure* structure)
+    : Base(*vm, structure)
+    , m_firstLineOffset(0)
+    , m_lineCount(0)
+    , m_unlinkedFunctionNameStart(0)
+    , m_unlinkedBodyStartColumn(0)
+    , m_unlinkedBodyEndColumn(0)
+    , m_startOffset(0)
+    , m_sourceLength(0)
+    , m_parametersStartOffset(0)
+    , m_typeProfilingStartOffset(0)
+    , m_typeProfilingEndOffset(0)
+    , m_parameterCount(0)
+    , m_features(0)
+    , m_isInStrictContext(false)
+    , m_hasCapturedVariables(false)
+    , m_isBuiltinFunction(false)
+    , m_constructAbility(0)
+    , m_constructorKind(0)
+    , m_functionMode(0)
+    , m_superBinding(0)
+    , m_derivedContextType(0)
+    , m_sourceParseMode(0)
+{
+}
+
 void UnlinkedFunctionExecutable::visitChildren(JSCell* cell, SlotVisitor& visitor)
 {
     UnlinkedFunctionExecutable* thisObject = jsCast<UnlinkedFunctionExecutable*>(cell);
@@ -61,6 +61,7 @@ enum UnlinkedFunctionKind {
 class UnlinkedFunctionExecutable final : public JSCell {
 public:
     friend class CodeCache;
+    friend class PersistentCodeCache;
     friend class VM;
 
     typedef JSCell Base;
@@ -134,6 +135,8 @@ public:
     
 private:
     UnlinkedFunctionExecutable(VM*, Structure*, const SourceCode&, RefPtr<SourceProvider>&& sourceOverride, FunctionMetadataNode*, UnlinkedFunctionKind, ConstructAbility, VariableEnvironment&,  JSC::DerivedContextType);
+    // Creates an empty executable for PersistentCodeCache to fill in.
+    UnlinkedFunctionExecutable(VM*, Structure*);
 
     unsigned m_firstLineOffset;
     unsigned m_lineCount;
@@ -81,6 +81,7 @@
 #include "ProfilerDatabase.h"
 #include "TrackedReferences.h"
 #include <wtf/CurrentTime.h>
+#include <wtf/SystemTracing.h>
 
 #if ENABLE(FTL_JIT)
 #include "FTLCapabilities.h"
@@ -177,6 +178,7 @@ void Plan::compileInThread(LongLivedState& longLivedState, ThreadData* threadDat
     
     SamplingRegion samplingRegion("DFG Compilation (Plan)");
     CompilationScope compilationScope;
+    TraceScope traceScope(DFGCompileStart, DFGCompileEnd, mode);
 
     if (logCompilationChanges(mode))
         dataLog("DFG(Plan) compiling ", *codeBlock, " with ", mode, ", number of instructions = ", codeBlock->instructionCount(), "\n");
@@ -53,6 +53,7 @@
 #include <wtf/ParallelVectorIterator.h>
 #include <wtf/ProcessID.h>
 #include <wtf/RAMSize.h>
+#include <wtf/SystemTracing.h>
 
 using namespace std;
 
@@ -1086,6 +1087,7 @@ NEVER_INLINE void Heap::collectImpl(HeapOperation collectionType, void* stackOri
 
     suspendCompilerThreads();
     willStartCollection(collectionType);
+    TraceScope traceScope(GarbageCollectionStart, GarbageCollectionEnd, m_operationInProgress == FullCollection);
     GCPHASE(Collect);
 
     double gcStartTime = WTF::monotonicallyIncreasingTime();
@@ -48,6 +48,7 @@
 #include "StackAlignment.h"
 #include "TypeProfilerLog.h"
 #include <wtf/CryptographicallyRandomNumber.h>
+#include <wtf/SystemTracing.h>
 
 using namespace std;
 
@@ -478,6 +479,8 @@ void JIT::privateCompileSlowCases()
 
 CompilationResult JIT::privateCompile(JITCompilationEffort effort)
 {
+    TraceScope traceScope(BaselineJITCompileStart, BaselineJITCompileEnd, m_codeBlock->instructionCount());
+
     DFG::CapabilityLevel level = m_codeBlock->capabilityLevel();
     switch (level) {
     case DFG::CannotCompile:
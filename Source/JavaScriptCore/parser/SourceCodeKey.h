@@ -60,6 +60,8 @@ public:
 
     size_t length() const { return m_sourceCode.length(); }
 
+    unsigned flags() const { return m_flags; }
+
     bool isNull() const { return m_sourceCode.isNull(); }
 
     // To save memory, we compute our string on demand. It's expected that source
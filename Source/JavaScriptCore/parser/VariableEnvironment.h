@@ -88,6 +88,7 @@ public:
     void markVariableAsCaptured(const RefPtr<UniquedStringImpl>& identifier);
     void markAllVariablesAsCaptured();
     bool hasCapturedVariables() const;
+    bool isEverythingCaptured() const { return m_isEverythingCaptured; }
     bool captures(UniquedStringImpl* identifier) const;
     void markVariableAsImported(const RefPtr<UniquedStringImpl>& identifier);
     void markVariableAsExported(const RefPtr<UniquedStringImpl>& identifier);
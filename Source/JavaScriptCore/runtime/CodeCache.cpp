@@ -31,6 +31,7 @@
 #include "CodeSpecializationKind.h"
 #include "JSCInlines.h"
 #include "Parser.h"
+#include "PersistentCodeCache.h"
 #include "StrongInlines.h"
 #include "UnlinkedCodeBlock.h"
 
@@ -56,6 +57,8 @@ void CodeCacheMap::pruneSlowCase()
 
 CodeCache::CodeCache()
 {
+    if (const char* diskCachePath = Options::diskCachePath())
+        m_persistentCache = std::make_unique<PersistentCodeCache>(String::fromUTF8(diskCachePath), Options::diskCacheSizeLimit());
 }
 
 CodeCache::~CodeCache()
@@ -82,6 +85,30 @@ template <> struct CacheTypes<UnlinkedModuleProgramCodeBlock> {
     static const SourceParseMode parseMode = SourceParseMode::ModuleEvaluateMode;
 };
 
+// Only top-level program code is kept on disk; eval code is rarely large or
+// repeated across runs, and module code depends on the module loader.
+static UnlinkedProgramCodeBlock* findPersistedCodeBlock(PersistentCodeCache* persistentCache, VM& vm, ProgramExecutable* executable, const SourceCode& source, const SourceCodeKey& key)
+{
+    return persistentCache ? persistentCache->findProgramCodeBlock(vm, executable, source, key) : nullptr;
+}
+
+template <class ExecutableType>
+static UnlinkedCodeBlock* findPersistedCodeBlock(PersistentCodeCache*, VM&, ExecutableType*, const SourceCode&, const SourceCodeKey&)
+{
+    return nullptr;
+}
+
+static void persistCodeBlock(PersistentCodeCache* persistentCache, VM& vm, const SourceCodeKey& key, UnlinkedProgramCodeBlock* codeBlock)
+{
+    if (persistentCache)
+        persistentCache->storeProgramCodeBlock(vm, key, codeBlock);
+}
+
+template <class UnlinkedCodeBlockType>
+static void persistCodeBlock(PersistentCodeCache*, VM&, const SourceCodeKey&, UnlinkedCodeBlockType*)
+{
+}
+
 template <class UnlinkedCodeBlockType, class ExecutableType>
 UnlinkedCodeBlockType* CodeCache::getGlobalCodeBlock(VM& vm, ExecutableType* executable, const SourceCode& source, JSParserBuiltinMode builtinMode, JSParserStrictMode strictMode, ThisTDZMode thisTDZMode, bool, DebuggerMode debuggerMode, ProfilerMode profilerMode, ParserError& error, const VariableEnvironment* variablesUnderTDZ)
 {
@@ -101,6 +128,14 @@ UnlinkedCodeBlockType* CodeCache::getGlobalCodeBlock(VM& vm, ExecutableType* exe
         return unlinkedCodeBlock;
     }
 
+    if (!cache && canCache) {
+        if (UnlinkedCodeBlock* persistedCodeBlock = findPersistedCodeBlock(m_persistentCache.get(), vm, executable, source, key)) {
+            UnlinkedCodeBlockType* unlinkedCodeBlock = jsCast<UnlinkedCodeBlockType*>(persistedCodeBlock);
+            m_sourceCode.addCache(key, SourceCodeValue(vm, unlinkedCodeBlock, m_sourceCode.age()));
+            return unlinkedCodeBlock;
+        }
+    }
+
     typedef typename CacheTypes<UnlinkedCodeBlockType>::RootNode RootNode;
     std::unique_ptr<RootNode> rootNode = parse<RootNode>(
         &vm, source, Identifier(), builtinMode, strictMode,
@@ -127,6 +162,7 @@ UnlinkedCodeBlockType* CodeCache::getGlobalCodeBlock(VM& vm, ExecutableType* exe
     if (!canCache)
         return unlinkedCodeBlock;
 
+    persistCodeBlock(m_persistentCache.get(), vm, key, unlinkedCodeBlock);
     m_sourceCode.addCache(key, SourceCodeValue(vm, unlinkedCodeBlock, m_sourceCode.age()));
     return unlinkedCodeBlock;
 }
@@ -45,6 +45,7 @@ class FunctionMetadataNode;
 class Identifier;
 class JSScope;
 class ParserError;
+class PersistentCodeCache;
 class ProgramExecutable;
 class ModuleProgramExecutable;
 class UnlinkedCodeBlock;
@@ -208,6 +209,7 @@ private:
     UnlinkedCodeBlockType* getGlobalCodeBlock(VM&, ExecutableType*, const SourceCode&, JSParserBuiltinMode, JSParserStrictMode, ThisTDZMode, bool, DebuggerMode, ProfilerMode, ParserError&, const VariableEnvironment*);
 
     CodeCacheMap m_sourceCode;
+    std::unique_ptr<PersistentCodeCache> m_persistentCache;
 };
 
 }
@@ -28,18 +28,18 @@
 
 namespace JSC {
 
-#define INITIALIZE_PROPERTY_NAME(name) , name(Identifier::fromString(vm, #name))
-#define INITIALIZE_KEYWORD(name) , name##Keyword(Identifier::fromString(vm, #name))
+#define INITIALIZE_PROPERTY_NAME(name) , name(Identifier::fromLiteral(vm, #name))
+#define INITIALIZE_KEYWORD(name) , name##Keyword(Identifier::fromLiteral(vm, #name))
 #define INITIALIZE_PRIVATE_NAME(name) , name##PrivateName(m_builtinNames->name##PrivateName())
 #define INITIALIZE_SYMBOL(name) , name##Symbol(m_builtinNames->name##Symbol())
 
 CommonIdentifiers::CommonIdentifiers(VM* vm)
     : nullIdentifier()
     , emptyIdentifier(Identifier::EmptyIdentifier)
-    , underscoreProto(Identifier::fromString(vm, "__proto__"))
-    , thisIdentifier(Identifier::fromString(vm, "this"))
-    , useStrictIdentifier(Identifier::fromString(vm, "use strict"))
-    , timesIdentifier(Identifier::fromString(vm, "*"))
+    , underscoreProto(Identifier::fromLiteral(vm, "__proto__"))
+    , thisIdentifier(Identifier::fromLiteral(vm, "this"))
+    , useStrictIdentifier(Identifier::fromLiteral(vm, "use strict"))
+    , timesIdentifier(Identifier::fromLiteral(vm, "*"))
     , m_builtinNames(new BuiltinNames(vm, this))
     JSC_COMMON_IDENTIFIERS_EACH_KEYWORD(INITIALIZE_KEYWORD)
     JSC_COMMON_IDENTIFIERS_EACH_PROPERTY_NAME(INITIALIZE_PROPERTY_NAME)
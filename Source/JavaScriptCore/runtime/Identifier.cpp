@@ -53,6 +53,15 @@ Ref<StringImpl> Identifier::add(ExecState* exec, const char* c)
     return add(&exec->vm(), c);
 }
 
+Ref<StringImpl> Identifier::addLiteral(VM* vm, const char* characters, unsigned length)
+{
+    ASSERT(length);
+    if (length == 1)
+        return *vm->smallStrings.singleCharacterStringRep(characters[0]);
+
+    return AtomicStringImpl::addLiteral(characters, length);
+}
+
 Ref<StringImpl> Identifier::add8(VM* vm, const UChar* s, int length)
 {
     if (length == 1) {
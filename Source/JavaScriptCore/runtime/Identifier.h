@@ -116,6 +116,10 @@ public:
     static Identifier fromString(VM*, const char (&characters)[charactersCount]);
     template<unsigned charactersCount>
     static Identifier fromString(ExecState*, const char (&characters)[charactersCount]);
+    // Only to be used with string literals, which must outlive the process's atomic strings:
+    // the characters are not copied.
+    template<unsigned charactersCount>
+    static Identifier fromLiteral(VM*, const char (&characters)[charactersCount]);
     static Identifier fromString(VM*, const LChar*, int length);
     static Identifier fromString(VM*, const UChar*, int length);
     static Identifier fromString(VM*, const String&);
@@ -188,6 +192,7 @@ private:
 
     template <typename T> static Ref<StringImpl> add(VM*, const T*, int length);
     static Ref<StringImpl> add8(VM*, const UChar*, int length);
+    JS_EXPORT_PRIVATE static Ref<StringImpl> addLiteral(VM*, const char*, unsigned length);
     template <typename T> ALWAYS_INLINE static bool canUseSingleCharacterString(T);
 
     static Ref<StringImpl> add(ExecState*, StringImpl*);
@@ -100,6 +100,12 @@ inline Identifier Identifier::fromString(ExecState* exec, const char (&character
     return Identifier(&exec->vm(), characters);
 }
 
+template<unsigned charactersCount>
+inline Identifier Identifier::fromLiteral(VM* vm, const char (&characters)[charactersCount])
+{
+    return Identifier(vm, addLiteral(vm, characters, charactersCount - 1).ptr());
+}
+
 inline Identifier Identifier::fromString(VM* vm, const LChar* s, int length)
 {
     return Identifier(vm, s, length);
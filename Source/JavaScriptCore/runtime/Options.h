@@ -342,6 +342,8 @@ typedef const char* optionString;
     \
     v(bool, useDollarVM, false, "installs the $vm debugging tool in global objects") \
     v(optionString, functionOverrides, nullptr, "file with debugging overrides for function bodies") \
+    v(optionString, diskCachePath, nullptr, "directory in which bytecode for large top-level programs is cached across runs") \
+    v(unsigned, diskCacheSizeLimit, 64 * MB, "size in bytes above which the least recently used entries are removed from diskCachePath") \
     \
     v(unsigned, watchdog, 0, "watchdog timeout (0 = Disabled, N = a timeout period of N milliseconds)") \
     \
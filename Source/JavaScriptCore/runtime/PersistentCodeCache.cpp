@@ -0,0 +1,1156 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "PersistentCodeCache.h"
+
+#include "BuiltinNames.h"
+#include "Executable.h"
+#include "JSCInlines.h"
+#include "Opcode.h"
+#include "RegExp.h"
+#include "SourceCodeKey.h"
+#include "UnlinkedCodeBlock.h"
+#include "UnlinkedInstructionStream.h"
+#include <mutex>
+#include <wtf/Condition.h>
+#include <wtf/Hasher.h>
+#include <wtf/Lock.h>
+#include <wtf/ThreadSafeRefCounted.h>
+
+#if OS(UNIX)
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace JSC {
+
+static const uint32_t cacheFileMagic = 0x4a534243; // "JSBC"
+static const uint32_t cacheFileVersion = 2;
+static const char cacheFileExtension[] = ".jsbc";
+
+// Parsing and generating bytecode for a short program is cheaper than opening a file.
+static const size_t minimumSourceLength = 1024;
+
+struct CacheFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t buildFingerprint;
+    uint32_t keyFlags;
+    uint32_t sourceLength;
+    uint32_t payloadSize;
+    uint8_t sourceDigest[SHA1::hashSize];
+    uint8_t payloadDigest[SHA1::hashSize];
+};
+
+static void computePayloadDigest(const uint8_t* payload, size_t size, SHA1::Digest& digest)
+{
+    SHA1 sha1;
+    sha1.addBytes(payload, size);
+    sha1.computeHash(digest);
+}
+
+enum class StringKind : uint8_t { Null, Latin1, UTF16 };
+enum class IdentifierKind : uint8_t { Null, String, PrivateName, WellKnownSymbol };
+enum class ValueKind : uint8_t { Empty, Int32, Double, True, False, Undefined, Null, String };
+
+// Bytecode is only meaningful to the build that generated it, so every entry
+// records a hash of the opcode set and of the layout of the structures that are
+// stored as raw bytes.
+static uint32_t buildFingerprint()
+{
+    static uint32_t fingerprint;
+    static std::once_flag onceFlag;
+    std::call_once(onceFlag, [] {
+        StringHasher hasher;
+        for (unsigned i = 0; i < numOpcodeIDs; ++i) {
+            for (const char* name = opcodeNames[i]; *name; ++name)
+                hasher.addCharacter(*name);
+            hasher.addCharacter(opcodeLengths[i]);
+        }
+        hasher.addCharacter(sizeof(ExpressionRangeInfo));
+        hasher.addCharacter(sizeof(ExpressionRangeInfo::FatPosition));
+        hasher.addCharacter(sizeof(UnlinkedInstruction));
+        hasher.addCharacter(LinkTimeConstantCount);
+        hasher.addCharacter(FirstConstantRegisterIndex >> 16);
+        fingerprint = hasher.hash();
+    });
+    return fingerprint;
+}
+
+class PersistentCodeCache::Encoder {
+public:
+    explicit Encoder(VM& vm)
+        : m_vm(vm)
+    {
+    }
+
+    Vector<uint8_t> takeBuffer() { return WTFMove(m_buffer); }
+
+    template<typename T> void encode(T value)
+    {
+        m_buffer.append(reinterpret_cast<const uint8_t*>(&value), sizeof(value));
+    }
+
+    // Only for vectors of plain structs, which are stored as they are laid out in memory.
+    template<typename T> void encodeVector(const Vector<T>& vector)
+    {
+        encode<uint32_t>(vector.size());
+        m_buffer.append(reinterpret_cast<const uint8_t*>(vector.data()), vector.size() * sizeof(T));
+    }
+
+    void encodeString(const String& string)
+    {
+        if (string.isNull()) {
+            encode(StringKind::Null);
+            return;
+        }
+        encode(string.is8Bit() ? StringKind::Latin1 : StringKind::UTF16);
+        encode<uint32_t>(string.length());
+        if (string.is8Bit())
+            m_buffer.append(string.characters8(), string.length());
+        else
+            m_buffer.append(reinterpret_cast<const uint8_t*>(string.characters16()), string.length() * sizeof(UChar));
+    }
+
+    bool encodeIdentifier(const Identifier&);
+    bool encodeValue(JSValue);
+    bool encodeVariableEnvironment(const VariableEnvironment&);
+
+private:
+    VM& m_vm;
+    Vector<uint8_t> m_buffer;
+};
+
+bool PersistentCodeCache::Encoder::encodeIdentifier(const Identifier& identifier)
+{
+    if (identifier.isNull()) {
+        encode(IdentifierKind::Null);
+        return true;
+    }
+
+    if (!identifier.isSymbol()) {
+        encode(IdentifierKind::String);
+        encodeString(identifier.string());
+        return true;
+    }
+
+    // Symbols are unique to this VM, but private names and well-known symbols
+    // can be found again by name.
+    if (m_vm.propertyNames->isPrivateName(identifier)) {
+        encode(IdentifierKind::PrivateName);
+        encodeString(m_vm.propertyNames->lookUpPublicName(identifier).string());
+        return true;
+    }
+
+    uint32_t index = 0;
+#define ENCODE_WELL_KNOWN_SYMBOL(name) \
+    if (identifier == m_vm.propertyNames->name##Symbol) { \
+        encode(IdentifierKind::WellKnownSymbol); \
+        encode(index); \
+        return true; \
+    } \
+    ++index;
+    JSC_COMMON_PRIVATE_IDENTIFIERS_EACH_WELL_KNOWN_SYMBOL(ENCODE_WELL_KNOWN_SYMBOL)
+#undef ENCODE_WELL_KNOWN_SYMBOL
+
+    return false;
+}
+
+bool PersistentCodeCache::Encoder::encodeValue(JSValue value)
+{
+    if (!value)
+        encode(ValueKind::Empty);
+    else if (value.isInt32()) {
+        encode(ValueKind::Int32);
+        encode<int32_t>(value.asInt32());
+    } else if (value.isDouble()) {
+        encode(ValueKind::Double);
+        encode<double>(value.asDouble());
+    } else if (value.isTrue())
+        encode(ValueKind::True);
+    else if (value.isFalse())
+        encode(ValueKind::False);
+    else if (value.isUndefined())
+        encode(ValueKind::Undefined);
+    else if (value.isNull())
+        encode(ValueKind::Null);
+    else if (value.isString() && asString(value)->tryGetValueImpl()) {
+        encode(ValueKind::String);
+        encodeString(asString(value)->tryGetValue());
+    } else {
+        // Symbol tables, template registry keys and the like are tied to this VM.
+        return false;
+    }
+    return true;
+}
+
+enum VariableEnvironmentEntryBits : uint8_t {
+    IsCaptured = 1 << 0,
+    IsConst = 1 << 1,
+    IsVar = 1 << 2,
+    IsLet = 1 << 3,
+    IsExported = 1 << 4,
+    IsImported = 1 << 5,
+    IsImportedNamespace = 1 << 6
+};
+
+bool PersistentCodeCache::Encoder::encodeVariableEnvironment(const VariableEnvironment& environment)
+{
+    encode<uint8_t>(environment.isEverythingCaptured());
+    encode<uint32_t>(environment.size());
+    for (auto& entry : environment) {
+        if (!encodeIdentifier(Identifier::fromUid(&m_vm, entry.key.get())))
+            return false;
+        uint8_t bits = 0;
+        if (entry.value.isCaptured())
+            bits |= IsCaptured;
+        if (entry.value.isConst())
+            bits |= IsConst;
+        if (entry.value.isVar())
+            bits |= IsVar;
+        if (entry.value.isLet())
+            bits |= IsLet;
+        if (entry.value.isExported())
+            bits |= IsExported;
+        if (entry.value.isImported())
+            bits |= IsImported;
+        if (entry.value.isImportedNamespace())
+            bits |= IsImportedNamespace;
+        encode(bits);
+    }
+    return true;
+}
+
+// Reads back what Encoder wrote. Every read is bounds checked, as is every
+// offset into the source or the instruction stream, and any failure makes the
+// whole entry unusable.
+class PersistentCodeCache::Decoder {
+public:
+    Decoder(VM& vm, unsigned sourceLength, const uint8_t* data, size_t size)
+        : m_vm(vm)
+        , m_sourceLength(sourceLength)
+        , m_cursor(data)
+        , m_end(data + size)
+    {
+    }
+
+    VM& vm() const { return m_vm; }
+    unsigned sourceLength() const { return m_sourceLength; }
+    size_t remaining() const { return m_end - m_cursor; }
+    bool atEnd() const { return m_cursor == m_end; }
+
+    template<typename T> bool decode(T& value)
+    {
+        if (remaining() < sizeof(value))
+            return false;
+        memcpy(&value, m_cursor, sizeof(value));
+        m_cursor += sizeof(value);
+        return true;
+    }
+
+    template<typename T> bool decodeVector(Vector<T>& vector)
+    {
+        uint32_t size;
+        if (!decode(size) || size > remaining() / sizeof(T))
+            return false;
+        vector.grow(size);
+        memcpy(vector.data(), m_cursor, size * sizeof(T));
+        m_cursor += size * sizeof(T);
+        return true;
+    }
+
+    bool decodeString(String&);
+    bool decodeIdentifier(Identifier&);
+    bool decodeValue(JSValue&);
+    bool decodeVariableEnvironment(VariableEnvironment&);
+
+private:
+    VM& m_vm;
+    unsigned m_sourceLength;
+    const uint8_t* m_cursor;
+    const uint8_t* m_end;
+};
+
+bool PersistentCodeCache::Decoder::decodeString(String& string)
+{
+    StringKind kind;
+    uint32_t length;
+    if (!decode(kind))
+        return false;
+
+    switch (kind) {
+    case StringKind::Null:
+        string = String();
+        return true;
+    case StringKind::Latin1:
+        if (!decode(length) || length > remaining())
+            return false;
+        string = String(m_cursor, length);
+        m_cursor += length;
+        return true;
+    case StringKind::UTF16: {
+        if (!decode(length) || length > remaining() / sizeof(UChar))
+            return false;
+        UChar* characters;
+        string = StringImpl::createUninitialized(length, characters);
+        memcpy(characters, m_cursor, length * sizeof(UChar));
+        m_cursor += length * sizeof(UChar);
+        return true;
+    }
+    }
+    return false;
+}
+
+bool PersistentCodeCache::Decoder::decodeIdentifier(Identifier& identifier)
+{
+    IdentifierKind kind;
+    if (!decode(kind))
+        return false;
+
+    switch (kind) {
+    case IdentifierKind::Null:
+        identifier = Identifier();
+        return true;
+    case IdentifierKind::String: {
+        String string;
+        if (!decodeString(string) || string.isNull())
+            return false;
+        identifier = Identifier::fromString(&m_vm, string);
+        return true;
+    }
+    case IdentifierKind::PrivateName: {
+        String publicName;
+        if (!decodeString(publicName) || publicName.isNull())
+            return false;
+        const Identifier* privateName = m_vm.propertyNames->lookUpPrivateName(Identifier::fromString(&m_vm, publicName));
+        if (!privateName)
+            return false;
+        identifier = *privateName;
+        return true;
+    }
+    case IdentifierKind::WellKnownSymbol: {
+        uint32_t index;
+        if (!decode(index))
+            return false;
+        uint32_t currentIndex = 0;
+#define DECODE_WELL_KNOWN_SYMBOL(name) \
+        if (index == currentIndex) { \
+            identifier = m_vm.propertyNames->name##Symbol; \
+            return true; \
+        } \
+        ++currentIndex;
+        JSC_COMMON_PRIVATE_IDENTIFIERS_EACH_WELL_KNOWN_SYMBOL(DECODE_WELL_KNOWN_SYMBOL)
+#undef DECODE_WELL_KNOWN_SYMBOL
+        return false;
+    }
+    }
+    return false;
+}
+
+bool PersistentCodeCache::Decoder::decodeValue(JSValue& value)
+{
+    ValueKind kind;
+    if (!decode(kind))
+        return false;
+
+    switch (kind) {
+    case ValueKind::Empty:
+        value = JSValue();
+        return true;
+    case ValueKind::Int32: {
+        int32_t number;
+        if (!decode(number))
+            return false;
+        value = jsNumber(number);
+        return true;
+    }
+    case ValueKind::Double: {
+        double number;
+        if (!decode(number))
+            return false;
+        value = JSValue(JSValue::EncodeAsDouble, number);
+        return true;
+    }
+    case ValueKind::True:
+        value = jsBoolean(true);
+        return true;
+    case ValueKind::False:
+        value = jsBoolean(false);
+        return true;
+    case ValueKind::Undefined:
+        value = jsUndefined();
+        return true;
+    case ValueKind::Null:
+        value = jsNull();
+        return true;
+    case ValueKind::String: {
+        String string;
+        if (!decodeString(string) || string.isNull())
+            return false;
+        value = jsOwnedString(&m_vm, string);
+        return true;
+    }
+    }
+    return false;
+}
+
+bool PersistentCodeCache::Decoder::decodeVariableEnvironment(VariableEnvironment& environment)
+{
+    uint8_t isEverythingCaptured;
+    uint32_t size;
+    if (!decode(isEverythingCaptured) || !decode(size))
+        return false;
+
+    for (uint32_t i = 0; i < size; ++i) {
+        Identifier identifier;
+        uint8_t bits;
+        if (!decodeIdentifier(identifier) || identifier.isNull() || !decode(bits))
+            return false;
+        VariableEnvironmentEntry& entry = environment.add(identifier).iterator->value;
+        if (bits & IsCaptured)
+            entry.setIsCaptured();
+        if (bits & IsConst)
+            entry.setIsConst();
+        if (bits & IsVar)
+            entry.setIsVar();
+        if (bits & IsLet)
+            entry.setIsLet();
+        if (bits & IsExported)
+            entry.setIsExported();
+        if (bits & IsImported)
+            entry.setIsImported();
+        if (bits & IsImportedNamespace)
+            entry.setIsImportedNamespace();
+    }
+
+    // Marks everything that was added so far, as the parser would have.
+    if (isEverythingCaptured)
+        environment.markAllVariablesAsCaptured();
+    return true;
+}
+
+// An encoded entry on its way to the queue. Nothing in it is shared with the
+// thread that encoded it.
+struct PersistentCodeCache::PendingWrite : public ThreadSafeRefCounted<PendingWrite> {
+    PendingWrite(const String& path, const CacheFileHeader& header, Vector<uint8_t>&& payload)
+        : path(path.utf8())
+        , temporaryPath(makeString(path, ".", String::number(getpid())).utf8())
+        , header(header)
+        , payload(WTFMove(payload))
+    {
+    }
+
+    CString path;
+    CString temporaryPath;
+    CacheFileHeader header;
+    Vector<uint8_t> payload;
+};
+
+PersistentCodeCache::PersistentCodeCache(const String& directory, size_t sizeLimit)
+    : m_directory(directory)
+    , m_sizeLimit(sizeLimit)
+    , m_queue(WorkQueue::create("jsc.persistent-code-cache.queue", WorkQueue::Type::Serial, WorkQueue::QOS::Background))
+{
+#if OS(UNIX)
+    mkdir(m_directory.utf8().data(), 0700);
+
+    // Other processes may have added entries since the directory was last pruned.
+    m_queue->dispatch([this] {
+        pruneEntries();
+    });
+#endif
+}
+
+PersistentCodeCache::~PersistentCodeCache()
+{
+    // Queued work refers to this object.
+    Lock lock;
+    Condition condition;
+    bool isFinished = false;
+    m_queue->dispatch([&] {
+        LockHolder locker(lock);
+        isFinished = true;
+        condition.notifyOne();
+    });
+
+    LockHolder locker(lock);
+    condition.wait(lock, [&] { return isFinished; });
+}
+
+void PersistentCodeCache::writeEntry(PendingWrite& pendingWrite)
+{
+#if OS(UNIX)
+    SHA1::Digest payloadDigest;
+    computePayloadDigest(pendingWrite.payload.data(), pendingWrite.payload.size(), payloadDigest);
+    memcpy(pendingWrite.header.payloadDigest, payloadDigest.data(), SHA1::hashSize);
+
+    // Write to a private file and rename it into place, so that readers in other
+    // processes never see a partially written entry.
+    int fd = open(pendingWrite.temporaryPath.data(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd == -1)
+        return;
+
+    bool success = true;
+    const uint8_t* chunks[] = { reinterpret_cast<const uint8_t*>(&pendingWrite.header), pendingWrite.payload.data() };
+    size_t chunkSizes[] = { sizeof(pendingWrite.header), pendingWrite.payload.size() };
+    for (size_t i = 0; success && i < WTF_ARRAY_LENGTH(chunks); ++i) {
+        const uint8_t* data = chunks[i];
+        size_t size = chunkSizes[i];
+        while (size) {
+            ssize_t written = write(fd, data, size);
+            if (written == -1 && errno == EINTR)
+                continue;
+            if (written <= 0) {
+                success = false;
+                break;
+            }
+            data += written;
+            size -= written;
+        }
+    }
+    close(fd);
+
+    if (!success || rename(pendingWrite.temporaryPath.data(), pendingWrite.path.data())) {
+        unlink(pendingWrite.temporaryPath.data());
+        return;
+    }
+
+    m_estimatedSize += sizeof(pendingWrite.header) + pendingWrite.payload.size();
+    if (m_estimatedSize > m_sizeLimit)
+        pruneEntries();
+#else
+    UNUSED_PARAM(pendingWrite);
+#endif
+}
+
+// Removes the least recently used entries until the directory is well under the
+// limit, so that a full cache is not scanned again after every write.
+void PersistentCodeCache::pruneEntries()
+{
+#if OS(UNIX)
+    DIR* directory = opendir(m_directory.utf8().data());
+    if (!directory)
+        return;
+    int directoryFD = dirfd(directory);
+
+    struct Entry {
+        CString name;
+        time_t lastUseTime;
+        size_t size;
+    };
+    Vector<Entry> entries;
+    size_t totalSize = 0;
+    size_t extensionLength = strlen(cacheFileExtension);
+    while (struct dirent* directoryEntry = readdir(directory)) {
+        const char* name = directoryEntry->d_name;
+        size_t nameLength = strlen(name);
+        if (nameLength <= extensionLength || strcmp(name + nameLength - extensionLength, cacheFileExtension))
+            continue;
+        struct stat fileStat;
+        if (fstatat(directoryFD, name, &fileStat, AT_SYMLINK_NOFOLLOW) || !S_ISREG(fileStat.st_mode))
+            continue;
+        entries.append({ name, fileStat.st_mtime, static_cast<size_t>(fileStat.st_size) });
+        totalSize += fileStat.st_size;
+    }
+
+    if (totalSize > m_sizeLimit) {
+        std::sort(entries.begin(), entries.end(), [] (const Entry& a, const Entry& b) {
+            return a.lastUseTime < b.lastUseTime;
+        });
+        size_t targetSize = m_sizeLimit / 4 * 3;
+        for (auto& entry : entries) {
+            if (totalSize <= targetSize)
+                break;
+            if (!unlinkat(directoryFD, entry.name.data(), 0))
+                totalSize -= entry.size;
+        }
+    }
+
+    closedir(directory);
+    m_estimatedSize = totalSize;
+#endif
+}
+
+String PersistentCodeCache::pathForKey(const SourceCodeKey& key, SHA1::Digest& digest) const
+{
+    SHA1 sha1;
+    unsigned flags = key.flags();
+    sha1.addBytes(reinterpret_cast<const uint8_t*>(&flags), sizeof(flags));
+    StringView source = key.string();
+    uint8_t is8Bit = source.is8Bit();
+    sha1.addBytes(&is8Bit, sizeof(is8Bit));
+    if (source.is8Bit())
+        sha1.addBytes(source.characters8(), source.length());
+    else
+        sha1.addBytes(reinterpret_cast<const uint8_t*>(source.characters16()), source.length() * sizeof(UChar));
+    sha1.computeHash(digest);
+
+    return m_directory + "/" + SHA1::hexDigest(digest).data() + cacheFileExtension;
+}
+
+bool PersistentCodeCache::encodeFunctionExecutable(Encoder& encoder, UnlinkedFunctionExecutable& executable)
+{
+    // Builtins and functions with their own source provider cannot be relinked
+    // against the program's source.
+    if (executable.m_isBuiltinFunction || executable.m_sourceOverride)
+        return false;
+
+    encoder.encode<uint32_t>(executable.m_firstLineOffset);
+    encoder.encode<uint32_t>(executable.m_lineCount);
+    encoder.encode<uint32_t>(executable.m_unlinkedFunctionNameStart);
+    encoder.encode<uint32_t>(executable.m_unlinkedBodyStartColumn);
+    encoder.encode<uint32_t>(executable.m_unlinkedBodyEndColumn);
+    encoder.encode<uint32_t>(executable.m_startOffset);
+    encoder.encode<uint32_t>(executable.m_sourceLength);
+    encoder.encode<uint32_t>(executable.m_parametersStartOffset);
+    encoder.encode<uint32_t>(executable.m_typeProfilingStartOffset);
+    encoder.encode<uint32_t>(executable.m_typeProfilingEndOffset);
+    encoder.encode<uint32_t>(executable.m_parameterCount);
+    encoder.encode<uint32_t>(executable.m_features);
+    encoder.encode<uint8_t>(executable.m_isInStrictContext);
+    encoder.encode<uint8_t>(executable.m_hasCapturedVariables);
+    encoder.encode<uint8_t>(executable.m_constructAbility);
+    encoder.encode<uint8_t>(executable.m_constructorKind);
+    encoder.encode<uint8_t>(executable.m_functionMode);
+    encoder.encode<uint8_t>(executable.m_superBinding);
+    encoder.encode<uint8_t>(executable.m_derivedContextType);
+    encoder.encode<uint8_t>(executable.m_sourceParseMode);
+
+    JSString* nameValue = executable.m_nameValue.get();
+    if (!nameValue || !nameValue->tryGetValueImpl())
+        return false;
+
+    if (!encoder.encodeIdentifier(executable.m_name) || !encoder.encodeIdentifier(executable.m_inferredName))
+        return false;
+    encoder.encodeString(nameValue->tryGetValue());
+    return encoder.encodeVariableEnvironment(executable.m_parentScopeTDZVariables);
+}
+
+UnlinkedFunctionExecutable* PersistentCodeCache::decodeFunctionExecutable(Decoder& decoder)
+{
+    VM& vm = decoder.vm();
+    UnlinkedFunctionExecutable* executable = new (NotNull, allocateCell<UnlinkedFunctionExecutable>(vm.heap)) UnlinkedFunctionExecutable(&vm, vm.unlinkedFunctionExecutableStructure.get());
+    executable->finishCreation(vm);
+
+    uint8_t isInStrictContext;
+    uint8_t hasCapturedVariables;
+    uint8_t constructAbility;
+    uint8_t constructorKind;
+    uint8_t functionMode;
+    uint8_t superBinding;
+    uint8_t derivedContextType;
+    uint8_t sourceParseMode;
+    String nameValue;
+    if (!decoder.decode(executable->m_firstLineOffset)
+        || !decoder.decode(executable->m_lineCount)
+        || !decoder.decode(executable->m_unlinkedFunctionNameStart)
+        || !decoder.decode(executable->m_unlinkedBodyStartColumn)
+        || !decoder.decode(executable->m_unlinkedBodyEndColumn)
+        || !decoder.decode(executable->m_startOffset)
+        || !decoder.decode(executable->m_sourceLength)
+        || !decoder.decode(executable->m_parametersStartOffset)
+        || !decoder.decode(executable->m_typeProfilingStartOffset)
+        || !decoder.decode(executable->m_typeProfilingEndOffset)
+        || !decoder.decode(executable->m_parameterCount)
+        || !decoder.decode(executable->m_features)
+        || !decoder.decode(isInStrictContext)
+        || !decoder.decode(hasCapturedVariables)
+        || !decoder.decode(constructAbility)
+        || !decoder.decode(constructorKind)
+        || !decoder.decode(functionMode)
+        || !decoder.decode(superBinding)
+        || !decoder.decode(derivedContextType)
+        || !decoder.decode(sourceParseMode)
+        || !decoder.decodeIdentifier(executable->m_name)
+        || !decoder.decodeIdentifier(executable->m_inferredName)
+        || !decoder.decodeString(nameValue)
+        || nameValue.isNull()
+        || !decoder.decodeVariableEnvironment(executable->m_parentScopeTDZVariables))
+        return nullptr;
+
+    unsigned sourceLength = decoder.sourceLength();
+    if (executable->m_startOffset > sourceLength
+        || executable->m_sourceLength > sourceLength - executable->m_startOffset
+        || executable->m_unlinkedFunctionNameStart > sourceLength
+        || executable->m_parameterCount > executable->m_sourceLength
+        || constructAbility > static_cast<uint8_t>(ConstructAbility::CannotConstruct)
+        || constructorKind > static_cast<uint8_t>(ConstructorKind::Derived)
+        || functionMode > FunctionDeclaration
+        || superBinding > static_cast<uint8_t>(SuperBinding::NotNeeded)
+        || derivedContextType > static_cast<uint8_t>(DerivedContextType::DerivedMethodContext)
+        || sourceParseMode > static_cast<uint8_t>(SourceParseMode::ModuleEvaluateMode)
+        || !isFunctionParseMode(static_cast<SourceParseMode>(sourceParseMode)))
+        return nullptr;
+
+    executable->m_isInStrictContext = isInStrictContext;
+    executable->m_hasCapturedVariables = hasCapturedVariables;
+    executable->m_constructAbility = constructAbility;
+    executable->m_constructorKind = constructorKind;
+    executable->m_functionMode = functionMode;
+    executable->m_superBinding = superBinding;
+    executable->m_derivedContextType = derivedContextType;
+    executable->m_sourceParseMode = sourceParseMode;
+    executable->m_nameValue.set(vm, executable, jsString(&vm, nameValue));
+    return executable;
+}
+
+bool PersistentCodeCache::encodeCodeBlock(Encoder& encoder, UnlinkedProgramCodeBlock& codeBlock)
+{
+    UnlinkedCodeBlock::RareData* rareData = codeBlock.m_rareData.get();
+    if (rareData && (!rareData->m_typeProfilerInfoMap.isEmpty() || !rareData->m_opProfileControlFlowBytecodeOffsets.isEmpty()))
+        return false;
+
+    encoder.encode<int32_t>(codeBlock.m_numParameters);
+    encoder.encode<int32_t>(codeBlock.m_thisRegister.offset());
+    encoder.encode<int32_t>(codeBlock.m_scopeRegister.offset());
+    encoder.encode<int32_t>(codeBlock.m_globalObjectRegister.offset());
+    encoder.encode<int32_t>(codeBlock.m_numVars);
+    encoder.encode<int32_t>(codeBlock.m_numCapturedVars);
+    encoder.encode<int32_t>(codeBlock.m_numCalleeLocals);
+    encoder.encode<uint32_t>(codeBlock.m_arrayProfileCount);
+    encoder.encode<uint32_t>(codeBlock.m_arrayAllocationProfileCount);
+    encoder.encode<uint32_t>(codeBlock.m_objectAllocationProfileCount);
+    encoder.encode<uint32_t>(codeBlock.m_valueProfileCount);
+    encoder.encode<uint32_t>(codeBlock.m_llintCallLinkInfoCount);
+
+    // The instruction stream is stored unpacked, one word per operand.
+    const UnlinkedInstructionStream& instructions = codeBlock.instructions();
+    encoder.encode<uint32_t>(instructions.count());
+    UnlinkedInstructionStream::Reader reader(instructions);
+    while (!reader.atEnd()) {
+        const UnlinkedInstruction* pc = reader.next();
+        OpcodeID opcode = pc[0].u.opcode;
+        encoder.encode<uint32_t>(opcode);
+        for (size_t i = 1; i < opcodeLength(opcode); ++i)
+            encoder.encode<int32_t>(pc[i].u.operand);
+    }
+
+    encoder.encodeVector(codeBlock.m_jumpTargets);
+    encoder.encodeVector(codeBlock.m_propertyAccessInstructions);
+
+    encoder.encode<uint32_t>(codeBlock.m_identifiers.size());
+    for (auto& identifier : codeBlock.m_identifiers) {
+        if (!encoder.encodeIdentifier(identifier))
+            return false;
+    }
+
+    encoder.encode<uint32_t>(codeBlock.m_constantRegisters.size());
+    for (size_t i = 0; i < codeBlock.m_constantRegisters.size(); ++i) {
+        if (!encoder.encodeValue(codeBlock.m_constantRegisters[i].get()))
+            return false;
+        encoder.encode(codeBlock.m_constantsSourceCodeRepresentation[i]);
+    }
+    for (unsigned linkTimeConstant : codeBlock.m_linkTimeConstants)
+        encoder.encode<uint32_t>(linkTimeConstant);
+
+    encoder.encode<uint32_t>(codeBlock.m_functionDecls.size());
+    for (auto& functionDecl : codeBlock.m_functionDecls) {
+        if (!encodeFunctionExecutable(encoder, *functionDecl.get()))
+            return false;
+    }
+    encoder.encode<uint32_t>(codeBlock.m_functionExprs.size());
+    for (auto& functionExpr : codeBlock.m_functionExprs) {
+        if (!encodeFunctionExecutable(encoder, *functionExpr.get()))
+            return false;
+    }
+
+    encoder.encodeVector(codeBlock.m_expressionInfo);
+
+    encoder.encode<uint8_t>(!!rareData);
+    if (rareData) {
+        encoder.encode<uint32_t>(rareData->m_exceptionHandlers.size());
+        for (auto& handler : rareData->m_exceptionHandlers) {
+            encoder.encode<uint32_t>(handler.start);
+            encoder.encode<uint32_t>(handler.end);
+            encoder.encode<uint32_t>(handler.target);
+            encoder.encode<uint8_t>(handler.typeBits);
+        }
+
+        encoder.encode<uint32_t>(rareData->m_regexps.size());
+        for (auto& regexp : rareData->m_regexps) {
+            encoder.encodeString(regexp->pattern());
+            encoder.encode<int32_t>(regexp->key().flagsValue);
+        }
+
+        encoder.encode<uint32_t>(rareData->m_constantBuffers.size());
+        for (auto& constantBuffer : rareData->m_constantBuffers) {
+            encoder.encode<uint32_t>(constantBuffer.size());
+            for (JSValue value : constantBuffer) {
+                if (!encoder.encodeValue(value))
+                    return false;
+            }
+        }
+
+        encoder.encode<uint32_t>(rareData->m_switchJumpTables.size());
+        for (auto& jumpTable : rareData->m_switchJumpTables) {
+            encoder.encode<int32_t>(jumpTable.min);
+            encoder.encodeVector(jumpTable.branchOffsets);
+        }
+
+        encoder.encode<uint32_t>(rareData->m_stringSwitchJumpTables.size());
+        for (auto& jumpTable : rareData->m_stringSwitchJumpTables) {
+            encoder.encode<uint32_t>(jumpTable.offsetTable.size());
+            for (auto& entry : jumpTable.offsetTable) {
+                encoder.encodeString(entry.key.get());
+                encoder.encode<int32_t>(entry.value);
+            }
+        }
+
+        encoder.encodeVector(rareData->m_expressionInfoFatPositions);
+    }
+
+    return encoder.encodeVariableEnvironment(codeBlock.m_varDeclarations)
+        && encoder.encodeVariableEnvironment(codeBlock.m_lexicalDeclarations);
+}
+
+bool PersistentCodeCache::decodeCodeBlock(Decoder& decoder, UnlinkedProgramCodeBlock& codeBlock)
+{
+    VM& vm = decoder.vm();
+
+    int32_t thisRegister;
+    int32_t scopeRegister;
+    int32_t globalObjectRegister;
+    if (!decoder.decode(codeBlock.m_numParameters)
+        || !decoder.decode(thisRegister)
+        || !decoder.decode(scopeRegister)
+        || !decoder.decode(globalObjectRegister)
+        || !decoder.decode(codeBlock.m_numVars)
+        || !decoder.decode(codeBlock.m_numCapturedVars)
+        || !decoder.decode(codeBlock.m_numCalleeLocals)
+        || !decoder.decode(codeBlock.m_arrayProfileCount)
+        || !decoder.decode(codeBlock.m_arrayAllocationProfileCount)
+        || !decoder.decode(codeBlock.m_objectAllocationProfileCount)
+        || !decoder.decode(codeBlock.m_valueProfileCount)
+        || !decoder.decode(codeBlock.m_llintCallLinkInfoCount))
+        return false;
+    if (codeBlock.m_numParameters < 1 || codeBlock.m_numVars < 0 || codeBlock.m_numCapturedVars < 0 || codeBlock.m_numCalleeLocals < 0)
+        return false;
+    codeBlock.m_thisRegister = VirtualRegister(thisRegister);
+    codeBlock.m_scopeRegister = VirtualRegister(scopeRegister);
+    codeBlock.m_globalObjectRegister = VirtualRegister(globalObjectRegister);
+
+    uint32_t instructionCount;
+    if (!decoder.decode(instructionCount) || instructionCount > decoder.remaining() / sizeof(int32_t))
+        return false;
+    Vector<UnlinkedInstruction, 0, UnsafeVectorOverflow> instructions;
+    instructions.reserveInitialCapacity(instructionCount);
+    while (instructions.size() < instructionCount) {
+        uint32_t opcode;
+        if (!decoder.decode(opcode) || opcode >= numOpcodeIDs)
+            return false;
+        size_t length = opcodeLength(static_cast<OpcodeID>(opcode));
+        if (instructions.size() + length > instructionCount)
+            return false;
+        instructions.append(UnlinkedInstruction(static_cast<OpcodeID>(opcode)));
+        for (size_t i = 1; i < length; ++i) {
+            int32_t operand;
+            if (!decoder.decode(operand))
+                return false;
+            instructions.append(UnlinkedInstruction(operand));
+        }
+    }
+    codeBlock.setInstructions(std::make_unique<UnlinkedInstructionStream>(instructions));
+
+    if (!decoder.decodeVector(codeBlock.m_jumpTargets) || !decoder.decodeVector(codeBlock.m_propertyAccessInstructions))
+        return false;
+    for (unsigned jumpTarget : codeBlock.m_jumpTargets) {
+        if (jumpTarget >= instructionCount)
+            return false;
+    }
+    for (unsigned propertyAccessInstruction : codeBlock.m_propertyAccessInstructions) {
+        if (propertyAccessInstruction >= instructionCount)
+            return false;
+    }
+
+    uint32_t identifierCount;
+    if (!decoder.decode(identifierCount))
+        return false;
+    for (uint32_t i = 0; i < identifierCount; ++i) {
+        Identifier identifier;
+        if (!decoder.decodeIdentifier(identifier))
+            return false;
+        codeBlock.addIdentifier(identifier);
+    }
+
+    uint32_t constantCount;
+    if (!decoder.decode(constantCount))
+        return false;
+    for (uint32_t i = 0; i < constantCount; ++i) {
+        JSValue value;
+        SourceCodeRepresentation sourceCodeRepresentation;
+        if (!decoder.decodeValue(value) || !decoder.decode(sourceCodeRepresentation) || sourceCodeRepresentation > SourceCodeRepresentation::Double)
+            return false;
+        codeBlock.m_constantRegisters.append(WriteBarrier<Unknown>());
+        if (value)
+            codeBlock.m_constantRegisters.last().set(vm, &codeBlock, value);
+        codeBlock.m_constantsSourceCodeRepresentation.append(sourceCodeRepresentation);
+    }
+    for (unsigned& linkTimeConstant : codeBlock.m_linkTimeConstants) {
+        if (!decoder.decode(linkTimeConstant) || (linkTimeConstant && linkTimeConstant >= constantCount + FirstConstantRegisterIndex))
+            return false;
+    }
+
+    uint32_t functionDeclCount;
+    if (!decoder.decode(functionDeclCount))
+        return false;
+    for (uint32_t i = 0; i < functionDeclCount; ++i) {
+        UnlinkedFunctionExecutable* functionDecl = decodeFunctionExecutable(decoder);
+        if (!functionDecl)
+            return false;
+        codeBlock.addFunctionDecl(functionDecl);
+    }
+    uint32_t functionExprCount;
+    if (!decoder.decode(functionExprCount))
+        return false;
+    for (uint32_t i = 0; i < functionExprCount; ++i) {
+        UnlinkedFunctionExecutable* functionExpr = decodeFunctionExecutable(decoder);
+        if (!functionExpr)
+            return false;
+        codeBlock.addFunctionExpr(functionExpr);
+    }
+
+    if (!decoder.decodeVector(codeBlock.m_expressionInfo))
+        return false;
+
+    uint8_t hasRareData;
+    if (!decoder.decode(hasRareData))
+        return false;
+    if (hasRareData) {
+        codeBlock.createRareDataIfNecessary();
+        UnlinkedCodeBlock::RareData& rareData = *codeBlock.m_rareData;
+
+        uint32_t handlerCount;
+        if (!decoder.decode(handlerCount))
+            return false;
+        for (uint32_t i = 0; i < handlerCount; ++i) {
+            uint32_t start;
+            uint32_t end;
+            uint32_t target;
+            uint8_t type;
+            if (!decoder.decode(start) || !decoder.decode(end) || !decoder.decode(target) || !decoder.decode(type) || type > static_cast<uint8_t>(HandlerType::SynthesizedFinally))
+                return false;
+            if (start > end || end > instructionCount || target >= instructionCount)
+                return false;
+            rareData.m_exceptionHandlers.append(UnlinkedHandlerInfo(start, end, target, static_cast<HandlerType>(type)));
+        }
+
+        uint32_t regexpCount;
+        if (!decoder.decode(regexpCount))
+            return false;
+        for (uint32_t i = 0; i < regexpCount; ++i) {
+            String pattern;
+            int32_t flags;
+            if (!decoder.decodeString(pattern) || pattern.isNull() || !decoder.decode(flags) || flags < NoFlags || flags >= InvalidFlags)
+                return false;
+            codeBlock.addRegExp(RegExp::create(vm, pattern, static_cast<RegExpFlags>(flags)));
+        }
+
+        uint32_t constantBufferCount;
+        if (!decoder.decode(constantBufferCount))
+            return false;
+        for (uint32_t i = 0; i < constantBufferCount; ++i) {
+            uint32_t length;
+            if (!decoder.decode(length) || length > decoder.remaining())
+                return false;
+            unsigned index = codeBlock.addConstantBuffer(length);
+            for (uint32_t j = 0; j < length; ++j) {
+                if (!decoder.decodeValue(codeBlock.constantBuffer(index)[j]))
+                    return false;
+            }
+        }
+
+        uint32_t switchJumpTableCount;
+        if (!decoder.decode(switchJumpTableCount))
+            return false;
+        for (uint32_t i = 0; i < switchJumpTableCount; ++i) {
+            UnlinkedSimpleJumpTable& jumpTable = codeBlock.addSwitchJumpTable();
+            if (!decoder.decode(jumpTable.min) || !decoder.decodeVector(jumpTable.branchOffsets))
+                return false;
+        }
+
+        uint32_t stringSwitchJumpTableCount;
+        if (!decoder.decode(stringSwitchJumpTableCount))
+            return false;
+        for (uint32_t i = 0; i < stringSwitchJumpTableCount; ++i) {
+            UnlinkedStringJumpTable& jumpTable = codeBlock.addStringSwitchJumpTable();
+            uint32_t entryCount;
+            if (!decoder.decode(entryCount))
+                return false;
+            for (uint32_t j = 0; j < entryCount; ++j) {
+                String string;
+                int32_t offset;
+                if (!decoder.decodeString(string) || string.isNull() || !decoder.decode(offset))
+                    return false;
+                jumpTable.offsetTable.add(string.impl(), offset);
+            }
+        }
+
+        if (!decoder.decodeVector(rareData.m_expressionInfoFatPositions))
+            return false;
+    }
+
+    size_t fatPositionCount = codeBlock.m_rareData ? codeBlock.m_rareData->m_expressionInfoFatPositions.size() : 0;
+    for (const ExpressionRangeInfo& info : codeBlock.m_expressionInfo) {
+        if (info.instructionOffset > instructionCount || info.mode > ExpressionRangeInfo::FatLineAndColumnMode)
+            return false;
+        if (info.mode == ExpressionRangeInfo::FatLineAndColumnMode && info.position >= fatPositionCount)
+            return false;
+    }
+
+    VariableEnvironment varDeclarations;
+    VariableEnvironment lexicalDeclarations;
+    if (!decoder.decodeVariableEnvironment(varDeclarations) || !decoder.decodeVariableEnvironment(lexicalDeclarations))
+        return false;
+    codeBlock.setVariableDeclarations(varDeclarations);
+    codeBlock.setLexicalDeclarations(lexicalDeclarations);
+    return true;
+}
+
+UnlinkedProgramCodeBlock* PersistentCodeCache::findProgramCodeBlock(VM& vm, ProgramExecutable* executable, const SourceCode& source, const SourceCodeKey& key)
+{
+#if OS(UNIX)
+    if (key.length() < minimumSourceLength)
+        return nullptr;
+
+    SHA1::Digest digest;
+    String path = pathForKey(key, digest);
+    CString fileSystemPath = path.utf8();
+    int fd = open(fileSystemPath.data(), O_RDONLY);
+    if (fd == -1)
+        return nullptr;
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) || static_cast<size_t>(fileStat.st_size) < sizeof(CacheFileHeader)) {
+        close(fd);
+        return nullptr;
+    }
+    size_t fileSize = fileStat.st_size;
+    void* mappedFile = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The modification time orders entries for pruning.
+    futimes(fd, nullptr);
+    close(fd);
+    if (mappedFile == MAP_FAILED)
+        return nullptr;
+
+    const uint8_t* data = static_cast<const uint8_t*>(mappedFile);
+    CacheFileHeader header;
+    memcpy(&header, data, sizeof(header));
+    const uint8_t* payload = data + sizeof(header);
+    size_t payloadSize = fileSize - sizeof(header);
+
+    SHA1::Digest payloadDigest;
+    computePayloadDigest(payload, payloadSize, payloadDigest);
+
+    UnlinkedProgramCodeBlock* codeBlock = nullptr;
+    if (header.magic == cacheFileMagic
+        && header.version == cacheFileVersion
+        && header.buildFingerprint == buildFingerprint()
+        && header.keyFlags == key.flags()
+        && header.sourceLength == key.length()
+        && !memcmp(header.sourceDigest, digest.data(), SHA1::hashSize)
+        && header.payloadSize == payloadSize
+        && !memcmp(header.payloadDigest, payloadDigest.data(), SHA1::hashSize)) {
+        Decoder decoder(vm, key.length(), payload, payloadSize);
+        CodeFeatures features;
+        uint8_t hasCapturedVariables;
+        unsigned firstLine;
+        unsigned lineCount;
+        unsigned endColumn;
+        if (decoder.decode(features) && decoder.decode(hasCapturedVariables) && decoder.decode(firstLine) && decoder.decode(lineCount) && decoder.decode(endColumn)) {
+            // This mirrors an in-memory cache hit in CodeCache::getGlobalCodeBlock.
+            unsigned absoluteFirstLine = source.firstLine() + firstLine;
+            unsigned startColumn = source.startColumn();
+            bool endColumnIsOnStartLine = !lineCount;
+            unsigned absoluteEndColumn = endColumn + (endColumnIsOnStartLine ? startColumn : 1);
+            executable->recordParse(features, hasCapturedVariables, absoluteFirstLine, absoluteFirstLine + lineCount, startColumn, absoluteEndColumn);
+
+            codeBlock = UnlinkedProgramCodeBlock::create(&vm, executable->executableInfo());
+            codeBlock->recordParse(features, hasCapturedVariables, firstLine, lineCount, endColumn);
+            if (!decodeCodeBlock(decoder, *codeBlock) || !decoder.atEnd())
+                codeBlock = nullptr;
+        }
+    }
+    munmap(mappedFile, fileSize);
+
+    // Entries from other builds or damaged files are replaced once the program has been compiled.
+    if (!codeBlock)
+        unlink(fileSystemPath.data());
+    return codeBlock;
+#else
+    UNUSED_PARAM(vm);
+    UNUSED_PARAM(executable);
+    UNUSED_PARAM(source);
+    UNUSED_PARAM(key);
+    return nullptr;
+#endif
+}
+
+void PersistentCodeCache::storeProgramCodeBlock(VM& vm, const SourceCodeKey& key, UnlinkedProgramCodeBlock* codeBlock)
+{
+#if OS(UNIX)
+    if (key.length() < minimumSourceLength)
+        return;
+
+    Encoder encoder(vm);
+    encoder.encode<CodeFeatures>(codeBlock->codeFeatures());
+    encoder.encode<uint8_t>(codeBlock->hasCapturedVariables());
+    encoder.encode<uint32_t>(codeBlock->firstLine());
+    encoder.encode<uint32_t>(codeBlock->lineCount());
+    encoder.encode<uint32_t>(codeBlock->endColumn());
+    if (!encodeCodeBlock(encoder, *codeBlock))
+        return;
+    Vector<uint8_t> payload = encoder.takeBuffer();
+
+    SHA1::Digest digest;
+    String path = pathForKey(key, digest);
+
+    // The payload digest is computed on the queue.
+    CacheFileHeader header;
+    header.magic = cacheFileMagic;
+    header.version = cacheFileVersion;
+    header.buildFingerprint = buildFingerprint();
+    header.keyFlags = key.flags();
+    header.sourceLength = key.length();
+    header.payloadSize = payload.size();
+    memcpy(header.sourceDigest, digest.data(), SHA1::hashSize);
+
+    RefPtr<PendingWrite> pendingWrite = adoptRef(new PendingWrite(path, header, WTFMove(payload)));
+    m_queue->dispatch([this, pendingWrite] {
+        writeEntry(*pendingWrite);
+    });
+#else
+    UNUSED_PARAM(vm);
+    UNUSED_PARAM(key);
+    UNUSED_PARAM(codeBlock);
+#endif
+}
+
+} // namespace JSC
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PersistentCodeCache_h
+#define PersistentCodeCache_h
+
+#include <wtf/FastMalloc.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/SHA1.h>
+#include <wtf/WorkQueue.h>
+#include <wtf/text/WTFString.h>
+
+namespace JSC {
+
+class ProgramExecutable;
+class SourceCode;
+class SourceCodeKey;
+class UnlinkedFunctionExecutable;
+class UnlinkedProgramCodeBlock;
+class VM;
+
+// Stores the bytecode of large top-level programs in a directory, one file per
+// source, so that later runs can skip parsing and bytecode generation. Files are
+// keyed by a SHA-1 of the source text and are validated against the source, the
+// parser flags and the bytecode format of this build before they are used.
+//
+// Nested functions are stored as metadata only; their bytecode is generated
+// lazily, exactly as it is for code that was not loaded from the cache.
+//
+// Entries are written on a background queue, which also keeps the directory
+// under Options::diskCacheSizeLimit() by removing the least recently used
+// entries. Lookups refresh the modification time of the entry they load.
+//
+// The cache directory is trusted: its contents are loaded as bytecode, so it
+// must not be writable by anything that cannot already run script.
+class PersistentCodeCache {
+    WTF_MAKE_NONCOPYABLE(PersistentCodeCache); WTF_MAKE_FAST_ALLOCATED;
+public:
+    PersistentCodeCache(const String& directory, size_t sizeLimit);
+    ~PersistentCodeCache();
+
+    // Returns 0 if there is no valid entry. On success the parse information
+    // of the executable has been recorded, as for an in-memory cache hit.
+    UnlinkedProgramCodeBlock* findProgramCodeBlock(VM&, ProgramExecutable*, const SourceCode&, const SourceCodeKey&);
+    void storeProgramCodeBlock(VM&, const SourceCodeKey&, UnlinkedProgramCodeBlock*);
+
+private:
+    class Encoder;
+    class Decoder;
+    struct PendingWrite;
+
+    String pathForKey(const SourceCodeKey&, SHA1::Digest&) const;
+
+    // These run on m_queue.
+    void writeEntry(PendingWrite&);
+    void pruneEntries();
+
+    static bool encodeCodeBlock(Encoder&, UnlinkedProgramCodeBlock&);
+    static bool decodeCodeBlock(Decoder&, UnlinkedProgramCodeBlock&);
+    static bool encodeFunctionExecutable(Encoder&, UnlinkedFunctionExecutable&);
+    static UnlinkedFunctionExecutable* decodeFunctionExecutable(Decoder&);
+
+    String m_directory;
+    size_t m_sizeLimit;
+    Ref<WorkQueue> m_queue;
+
+    // Only accessed on m_queue. Entries removed by lookups are not subtracted,
+    // so this can be larger than the directory until the next prune.
+    size_t m_estimatedSize { 0 };
+};
+
+} // namespace JSC
+
+#endif // PersistentCodeCache_h
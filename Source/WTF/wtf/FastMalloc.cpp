@@ -262,9 +262,19 @@ void releaseFastMallocFreeMemory()
 
 FastMallocStatistics fastMallocStatistics()
 {
-
-    // FIXME: Can bmalloc itself report the stats instead of relying on the OS?
     FastMallocStatistics statistics;
+
+    bmalloc::Statistics heapStatistics = bmalloc::api::statistics();
+    if (heapStatistics.reservedBytes) {
+        statistics.reservedVMBytes = heapStatistics.reservedBytes;
+        statistics.committedVMBytes = heapStatistics.committedBytes;
+        statistics.freeListBytes = heapStatistics.freeSmallPageBytes + heapStatistics.freeLargeCommittedBytes;
+        for (auto& sizeClass : heapStatistics.sizeClasses)
+            statistics.freeListBytes += sizeClass.freeBytes;
+        return statistics;
+    }
+
+    // bmalloc is disabled in this environment, so the system malloc is in use.
     statistics.freeListBytes = 0;
     statistics.reservedVMBytes = 0;
 
@@ -176,6 +176,15 @@
 #define WTF_CPU_X86_SSE2 1
 #endif
 
+#if CPU(X86_SSE2)
+/* All SSE2 intrinsics usage can be disabled by this macro. */
+#define HAVE_X86_SSE2_INTRINSICS 1
+#if COMPILER(GCC_OR_CLANG)
+/* AVX2 code is compiled per function and only used if the CPU supports it. */
+#define HAVE_X86_AVX2_INTRINSICS 1
+#endif
+#endif
+
 /* CPU(ARM64) - Apple */
 #if (defined(__arm64__) && defined(__APPLE__)) || defined(__aarch64__)
 #define WTF_CPU_ARM64 1
@@ -636,6 +645,12 @@
 #define HAVE_STAT_BIRTHTIME 1
 #endif
 
+#if !defined(HAVE_LINUX_SYSTEM_TRACING)
+#if OS(LINUX)
+#define HAVE_LINUX_SYSTEM_TRACING 1
+#endif
+#endif
+
 #if !OS(WINDOWS) && !OS(SOLARIS)
 #define HAVE_TM_GMTOFF 1
 #define HAVE_TM_ZONE 1
@@ -822,6 +837,12 @@
 #define ENABLE_ALLOCATION_LOGGING 0
 #endif
 
+/* Atomize string literals once for the whole process rather than once per thread,
+   so that workers don't have to rebuild the identifier sets the main thread already has. */
+#if !defined(ENABLE_SHARED_ATOMIC_STRING_TABLE)
+#define ENABLE_SHARED_ATOMIC_STRING_TABLE 1
+#endif
+
 /* Enable verification that that register allocations are not made within generated control flow.
    Turned on for debug builds. */
 #if !defined(ENABLE_DFG_REGISTER_ALLOCATION_VALIDATION) && ENABLE(DFG_JIT)
@@ -0,0 +1,411 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "SystemTracing.h"
+
+#if HAVE(LINUX_SYSTEM_TRACING)
+
+#include <atomic>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <wtf/Deque.h>
+#include <wtf/FilePrintStream.h>
+#include <wtf/Lock.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+#include <wtf/text/CString.h>
+#include <wtf/text/WTFString.h>
+
+namespace WTF {
+
+bool systemTracingIsEnabled;
+
+static const char* traceFilePath;
+static int traceMarkerFileDescriptor = -1;
+
+// 384KB per thread that hit a trace point. When full, the oldest events are overwritten.
+static const unsigned traceBufferCapacity = 1 << 14;
+
+struct TraceEvent {
+    uint64_t timestamp;
+    uint64_t data;
+    TracePointCode code;
+};
+
+// Only the thread that owns the buffer writes to it, so recording a trace point takes no lock.
+// The writer publishes each event by bumping the count, and a reader that races with the writer
+// discards the events the writer may have overwritten while they were being copied.
+struct ThreadTraceBuffer {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    pid_t threadID;
+    char threadName[16];
+    std::atomic<uint64_t> eventCount { 0 };
+    TraceEvent events[traceBufferCapacity];
+};
+
+// When a thread exits, the events in its buffer are copied out so that they end up in the trace, and the
+// buffer is reused by the next thread that needs one. The most recent events of exited threads are kept,
+// up to the capacity of a few buffers.
+static const unsigned exitedThreadsEventCapacity = 4 * traceBufferCapacity;
+
+struct ExitedThreadTrace {
+    pid_t threadID;
+    char threadName[16];
+    Vector<TraceEvent> events;
+};
+
+static Lock traceBuffersLock;
+static Vector<ThreadTraceBuffer*>& traceBuffers()
+{
+    static NeverDestroyed<Vector<ThreadTraceBuffer*>> buffers;
+    return buffers;
+}
+
+static Vector<ThreadTraceBuffer*>& unusedTraceBuffers()
+{
+    static NeverDestroyed<Vector<ThreadTraceBuffer*>> buffers;
+    return buffers;
+}
+
+static Deque<ExitedThreadTrace>& exitedThreadTraces()
+{
+    static NeverDestroyed<Deque<ExitedThreadTrace>> traces;
+    return traces;
+}
+
+static size_t exitedThreadsEventCount;
+
+static pthread_key_t traceBufferKey;
+static __thread ThreadTraceBuffer* currentThreadTraceBuffer;
+
+static NEVER_INLINE ThreadTraceBuffer& createTraceBufferForCurrentThread()
+{
+    ThreadTraceBuffer* buffer = nullptr;
+    {
+        LockHolder locker(traceBuffersLock);
+        if (!unusedTraceBuffers().isEmpty())
+            buffer = unusedTraceBuffers().takeLast();
+    }
+    if (!buffer)
+        buffer = new ThreadTraceBuffer;
+
+    buffer->threadID = syscall(SYS_gettid);
+    if (prctl(PR_GET_NAME, buffer->threadName, 0, 0, 0))
+        buffer->threadName[0] = '\0';
+    buffer->threadName[sizeof(buffer->threadName) - 1] = '\0';
+    buffer->eventCount.store(0, std::memory_order_relaxed);
+
+    {
+        LockHolder locker(traceBuffersLock);
+        traceBuffers().append(buffer);
+    }
+    pthread_setspecific(traceBufferKey, buffer);
+    currentThreadTraceBuffer = buffer;
+    return *buffer;
+}
+
+static inline uint64_t monotonicTimeInNanoseconds()
+{
+    // The same clock as ftrace's "mono" trace clock, so both traces can be lined up.
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<uint64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+#define FOR_EACH_TRACE_SLICE(macro) \
+    macro(GarbageCollection) \
+    macro(BaselineJITCompile) \
+    macro(DFGCompile) \
+    macro(StyleRecalc) \
+    macro(Layout) \
+    macro(PaintView) \
+    macro(PaintLayer) \
+    macro(IPCMessageDispatch)
+
+// A Start and an End code are the beginning and the end of a slice, the range codes are instants.
+static const char* tracePointName(TracePointCode code, char& phase)
+{
+    switch (code) {
+#define CASE_FOR_TRACE_SLICE(name) \
+    case name##Start: \
+        phase = 'B'; \
+        return #name; \
+    case name##End: \
+        phase = 'E'; \
+        return #name;
+    FOR_EACH_TRACE_SLICE(CASE_FOR_TRACE_SLICE)
+#undef CASE_FOR_TRACE_SLICE
+    case WTFRange:
+    case JavaScriptRange:
+    case WebCoreRange:
+    case WebKitRange:
+    case WebKit2Range:
+        break;
+    }
+    phase = 'i';
+    return "TracePoint";
+}
+
+static void writeToTraceMarker(const char* line, int length, size_t bufferSize)
+{
+    // A failed write loses the trace point, and there is nothing better to do about it.
+    ssize_t result = write(traceMarkerFileDescriptor, line, std::min<size_t>(std::max(length, 0), bufferSize - 1));
+    UNUSED_PARAM(result);
+}
+
+static void writeToTraceMarker(TracePointCode code, uint64_t data)
+{
+    // The format systrace and Perfetto parse from atrace. It has no instants, so they become empty slices.
+    char phase;
+    const char* name = tracePointName(code, phase);
+    char line[128];
+    pid_t processID = getpid();
+    if (phase != 'E')
+        writeToTraceMarker(line, snprintf(line, sizeof(line), "B|%d|%s %" PRIu64, processID, name, phase == 'B' ? data : static_cast<uint64_t>(code)), sizeof(line));
+    if (phase != 'B')
+        writeToTraceMarker(line, snprintf(line, sizeof(line), "E|%d", processID), sizeof(line));
+}
+
+void recordTracePoint(TracePointCode code, uint64_t data)
+{
+    // Buffers are only written out to the trace file, so ftrace alone doesn't need one.
+    if (traceFilePath) {
+        ThreadTraceBuffer* buffer = currentThreadTraceBuffer;
+        if (UNLIKELY(!buffer))
+            buffer = &createTraceBufferForCurrentThread();
+
+        uint64_t eventCount = buffer->eventCount.load(std::memory_order_relaxed);
+        TraceEvent& event = buffer->events[eventCount % traceBufferCapacity];
+        event.timestamp = monotonicTimeInNanoseconds();
+        event.data = data;
+        event.code = code;
+        buffer->eventCount.store(eventCount + 1, std::memory_order_release);
+    }
+
+    if (traceMarkerFileDescriptor != -1)
+        writeToTraceMarker(code, data);
+}
+
+static void copyEvents(const ThreadTraceBuffer& buffer, Vector<TraceEvent>& events)
+{
+    uint64_t endBeforeCopy = buffer.eventCount.load(std::memory_order_acquire);
+    uint64_t begin = endBeforeCopy > traceBufferCapacity ? endBeforeCopy - traceBufferCapacity : 0;
+    events.reserveInitialCapacity(endBeforeCopy - begin);
+    for (uint64_t i = begin; i < endBeforeCopy; ++i)
+        events.uncheckedAppend(buffer.events[i % traceBufferCapacity]);
+
+    // The owner thread may have kept going, and be writing the event after the last one it published.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t endAfterCopy = buffer.eventCount.load(std::memory_order_relaxed);
+    if (endAfterCopy + 1 > begin + traceBufferCapacity)
+        events.remove(0, std::min<uint64_t>(endAfterCopy + 1 - begin - traceBufferCapacity, events.size()));
+}
+
+static void retireTraceBufferOfExitingThread(void* data)
+{
+    ThreadTraceBuffer* buffer = static_cast<ThreadTraceBuffer*>(data);
+    currentThreadTraceBuffer = nullptr;
+
+    ExitedThreadTrace trace;
+    trace.threadID = buffer->threadID;
+    memcpy(trace.threadName, buffer->threadName, sizeof(trace.threadName));
+    copyEvents(*buffer, trace.events);
+
+    LockHolder locker(traceBuffersLock);
+    traceBuffers().removeFirst(buffer);
+    unusedTraceBuffers().append(buffer);
+
+    exitedThreadsEventCount += trace.events.size();
+    exitedThreadTraces().append(WTFMove(trace));
+    while (exitedThreadsEventCount > exitedThreadsEventCapacity) {
+        exitedThreadsEventCount -= exitedThreadTraces().first().events.size();
+        exitedThreadTraces().removeFirst();
+    }
+}
+
+static void printJSONString(PrintStream& out, const char* string)
+{
+    out.print("\"");
+    for (const char* character = string; *character; ++character) {
+        if (*character == '"' || *character == '\\')
+            out.printf("\\%c", *character);
+        else if (static_cast<unsigned char>(*character) < 0x20)
+            out.printf("\\u%04x", *character);
+        else
+            out.printf("%c", *character);
+    }
+    out.print("\"");
+}
+
+static void writeThreadTrace(PrintStream& file, pid_t processID, pid_t threadID, const char* threadName, const Vector<TraceEvent>& events, bool& isFirstEvent)
+{
+    // Timestamps are in microseconds.
+    file.printf("%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":", isFirstEvent ? "" : ",", processID, threadID);
+    printJSONString(file, threadName);
+    file.print("}}");
+    isFirstEvent = false;
+
+    unsigned sliceDepth = 0;
+    for (const TraceEvent& event : events) {
+        char phase;
+        const char* name = tracePointName(event.code, phase);
+        // Skip the ends of the slices whose beginning was overwritten.
+        if (phase == 'B')
+            ++sliceDepth;
+        else if (phase == 'E') {
+            if (!sliceDepth)
+                continue;
+            --sliceDepth;
+        }
+        file.printf(",\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%" PRIu64 ".%03u,\"pid\":%d,\"tid\":%d", name, phase,
+            event.timestamp / 1000, static_cast<unsigned>(event.timestamp % 1000), processID, threadID);
+        if (phase == 'B')
+            file.printf(",\"args\":{\"data\":%" PRIu64 "}", event.data);
+        else if (phase == 'i')
+            file.printf(",\"s\":\"t\",\"args\":{\"code\":%d}", event.code);
+        file.print("}");
+    }
+}
+
+bool writeSystemTrace(const char* path)
+{
+    std::unique_ptr<FilePrintStream> file = FilePrintStream::open(path, "w");
+    if (!file)
+        return false;
+
+    pid_t processID = getpid();
+    file->print("{\"traceEvents\":[");
+    bool isFirstEvent = true;
+
+    LockHolder locker(traceBuffersLock);
+    for (const ExitedThreadTrace& trace : exitedThreadTraces())
+        writeThreadTrace(*file, processID, trace.threadID, trace.threadName, trace.events, isFirstEvent);
+
+    for (ThreadTraceBuffer* buffer : traceBuffers()) {
+        Vector<TraceEvent> events;
+        copyEvents(*buffer, events);
+        writeThreadTrace(*file, processID, buffer->threadID, buffer->threadName, events, isFirstEvent);
+    }
+
+    file->print("\n]}\n");
+    return true;
+}
+
+bool dumpSystemTrace()
+{
+    if (!traceFilePath)
+        return false;
+
+    // Dumps requested with the signal and the one at exit may overlap.
+    static StaticLock dumpLock;
+    LockHolder locker(dumpLock);
+    return writeSystemTrace(traceFilePath);
+}
+
+static void writeSystemTraceAtExit()
+{
+    if (!dumpSystemTrace())
+        fprintf(stderr, "Could not write the system trace to %s\n", traceFilePath);
+}
+
+// The signal handler can only do async-signal-safe things, so it hands the dump to a thread over a pipe.
+static int dumpRequestPipe[2] = { -1, -1 };
+
+static void requestSystemTraceDump(int)
+{
+    int savedErrno = errno;
+    char request = 0;
+    ssize_t result = write(dumpRequestPipe[1], &request, 1);
+    UNUSED_PARAM(result);
+    errno = savedErrno;
+}
+
+static void installSystemTraceDumpSignalHandler()
+{
+    if (pipe2(dumpRequestPipe, O_CLOEXEC)) {
+        fprintf(stderr, "Could not create a pipe, SIGUSR1 will not dump the system trace\n");
+        return;
+    }
+    // A request that doesn't fit in the pipe is redundant with the ones already in it.
+    fcntl(dumpRequestPipe[1], F_SETFL, O_NONBLOCK);
+
+    detachThread(createThread("WebKit: System Trace Dump", [] {
+        while (true) {
+            char request;
+            ssize_t result = read(dumpRequestPipe[0], &request, 1);
+            if (result == -1 && errno == EINTR)
+                continue;
+            if (result != 1)
+                return;
+            if (!dumpSystemTrace())
+                fprintf(stderr, "Could not write the system trace to %s\n", traceFilePath);
+        }
+    }));
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = requestSystemTraceDump;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &action, nullptr);
+}
+
+void initializeSystemTracing()
+{
+    if (const char* path = getenv("WEBKIT_SYSTEM_TRACE_FILE")) {
+        String filePath = String::fromUTF8(path);
+        filePath.replace(ASCIILiteral("%p"), String::number(getpid()));
+        traceFilePath = strdup(filePath.utf8().data());
+        pthread_key_create(&traceBufferKey, retireTraceBufferOfExitingThread);
+        atexit(writeSystemTraceAtExit);
+        installSystemTraceDumpSignalHandler();
+    }
+
+    if (getenv("WEBKIT_SYSTEM_TRACE_FTRACE")) {
+        traceMarkerFileDescriptor = open("/sys/kernel/tracing/trace_marker", O_WRONLY | O_CLOEXEC);
+        if (traceMarkerFileDescriptor == -1)
+            traceMarkerFileDescriptor = open("/sys/kernel/debug/tracing/trace_marker", O_WRONLY | O_CLOEXEC);
+        if (traceMarkerFileDescriptor == -1)
+            fprintf(stderr, "Could not open ftrace's trace_marker, trace points will not be written to it\n");
+    }
+
+    systemTracingIsEnabled = traceFilePath || traceMarkerFileDescriptor != -1;
+}
+
+} // namespace WTF
+
+#endif // HAVE(LINUX_SYSTEM_TRACING)
@@ -26,6 +26,8 @@
 #ifndef SystemTracing_h
 #define SystemTracing_h
 
+#include <stdint.h>
+
 #if USE(APPLE_INTERNAL_SDK)
 #include <System/sys/kdebug.h>
 #define HAVE_KDEBUG_H 1
@@ -37,11 +39,18 @@
 #define WEBKIT_COMPONENT 47
 
 // Trace point codes can be up to 14 bits (0-16383).
-// When adding or changing these codes, update Tools/Tracing/SystemTracePoints.plist to match.
+// When adding or changing these codes, update Tools/Tracing/SystemTracePoints.plist to match,
+// as well as tracePointName() in SystemTracing.cpp.
 enum TracePointCode {
     WTFRange = 0,
 
     JavaScriptRange = 2500,
+    GarbageCollectionStart,
+    GarbageCollectionEnd,
+    BaselineJITCompileStart,
+    BaselineJITCompileEnd,
+    DFGCompileStart,
+    DFGCompileEnd,
 
     WebCoreRange = 5000,
     StyleRecalcStart,
@@ -55,43 +64,67 @@ enum TracePointCode {
 
     WebKitRange = 10000,
     WebKit2Range = 12000,
+    IPCMessageDispatchStart,
+    IPCMessageDispatchEnd,
 };
 
 #ifdef __cplusplus
 
 namespace WTF {
 
-class TraceScope {
-public:
+#if HAVE(LINUX_SYSTEM_TRACING)
+// Trace points are recorded into a ring buffer per thread when the WEBKIT_SYSTEM_TRACE_FILE environment
+// variable is set, and written to that file as Chrome trace events when the process exits, when it
+// receives SIGUSR1, or when dumpSystemTrace() is called. A "%p" in the file name is replaced by the
+// process ID. When WEBKIT_SYSTEM_TRACE_FTRACE is set, trace points are also written to ftrace's
+// trace_marker as they happen. Both are read by initializeThreading().
+WTF_EXPORTDATA extern bool systemTracingIsEnabled;
+
+void initializeSystemTracing();
+WTF_EXPORT_PRIVATE void recordTracePoint(TracePointCode, uint64_t data);
+
+// Writes what the ring buffers currently hold. Returns false if the file couldn't be written.
+WTF_EXPORT_PRIVATE bool writeSystemTrace(const char* path);
 
+// Writes the trace file now, replacing the previous dump. Returns false if no trace file was requested
+// or if it couldn't be written.
+WTF_EXPORT_PRIVATE bool dumpSystemTrace();
+#endif
+
+inline void tracePoint(TracePointCode code, uint64_t data = 0)
+{
 #if HAVE(KDEBUG_H)
-    TraceScope(TracePointCode entryCode, TracePointCode exitCode)
-        : m_exitCode(exitCode)
-    {
-        kdebug_trace(ARIADNEDBG_CODE(WEBKIT_COMPONENT, entryCode), 0, 0, 0, 0);
-    }
+    kdebug_trace(ARIADNEDBG_CODE(WEBKIT_COMPONENT, code), data, 0, 0, 0);
+#elif HAVE(LINUX_SYSTEM_TRACING)
+    if (UNLIKELY(systemTracingIsEnabled))
+        recordTracePoint(code, data);
 #else
-    TraceScope(TracePointCode, TracePointCode)
+    UNUSED_PARAM(code);
+    UNUSED_PARAM(data);
+#endif
+}
+
+class TraceScope {
+public:
+    TraceScope(TracePointCode entryCode, TracePointCode exitCode, uint64_t data = 0)
+        : m_exitCode(exitCode)
     {
+        tracePoint(entryCode, data);
     }
-#endif
     
     ~TraceScope()
     {
-#if HAVE(KDEBUG_H)
-        kdebug_trace(ARIADNEDBG_CODE(WEBKIT_COMPONENT, m_exitCode), 0, 0, 0, 0);
-#endif
+        tracePoint(m_exitCode);
     }
 
 private:
-#if HAVE(KDEBUG_H)
     TracePointCode m_exitCode;
-#endif
 };
 
 } // namespace WTF
 
 using WTF::TraceScope;
+using WTF::tracePoint;
 
 #endif // __cplusplus
 
@@ -40,6 +40,7 @@
 #include "HashMap.h"
 #include "RandomNumberSeed.h"
 #include "StdLibExtras.h"
+#include "SystemTracing.h"
 #include "ThreadFunctionInvocation.h"
 #include "ThreadIdentifierDataPthreads.h"
 #include "ThreadSpecific.h"
@@ -122,6 +123,9 @@ void initializeThreading()
     ThreadIdentifierData::initializeOnce();
     wtfThreadData();
     initializeDates();
+#if HAVE(LINUX_SYSTEM_TRACING)
+    initializeSystemTracing();
+#endif
 }
 
 static ThreadMap& threadMap()
@@ -27,6 +27,7 @@
 #include "AtomicStringTable.h"
 #include "HashSet.h"
 #include "IntegerToStringConversion.h"
+#include "SharedAtomicStringTable.h"
 #include "StringHash.h"
 #include "Threading.h"
 #include "WTFThreadData.h"
@@ -70,16 +71,68 @@ static ALWAYS_INLINE HashSet<StringImpl*>& stringTable()
     return wtfThreadData().atomicStringTable()->table();
 }
 
+#if ENABLE(SHARED_ATOMIC_STRING_TABLE)
+
+// Before creating a new atomic string for this thread, looks for one that all threads share.
+// A shared string goes into this thread's table too, so that the next lookup finds it in one probe.
+template<typename HashTranslator>
+struct SharedStringTableTranslator {
+    template<typename T> static unsigned hash(const T& value)
+    {
+        return HashTranslator::hash(value);
+    }
+
+    template<typename T> static bool equal(StringImpl* const& string, const T& value)
+    {
+        return HashTranslator::equal(string, value);
+    }
+
+    template<typename T> static void translate(StringImpl*& location, const T& value, unsigned hash)
+    {
+        if (StringImpl* string = SharedAtomicStringTable::singleton().find<HashTranslator>(value, hash)) {
+            location = string;
+            return;
+        }
+        HashTranslator::translate(location, value, hash);
+    }
+};
+
+template<typename HashTranslator> using StringTableTranslator = SharedStringTableTranslator<HashTranslator>;
+
+#else
+
+template<typename HashTranslator> using StringTableTranslator = HashTranslator;
+
+#endif // ENABLE(SHARED_ATOMIC_STRING_TABLE)
+
+struct StringImplTranslator {
+    static unsigned hash(StringImpl* string)
+    {
+        return string->hash();
+    }
+
+    static bool equal(StringImpl* const& a, StringImpl* b)
+    {
+        return WTF::equal(*a, *b);
+    }
+
+    static void translate(StringImpl*& location, StringImpl* string, unsigned)
+    {
+        location = string;
+    }
+};
+
 template<typename T, typename HashTranslator>
 static inline Ref<AtomicStringImpl> addToStringTable(const T& value)
 {
     AtomicStringTableLocker locker;
 
-    HashSet<StringImpl*>::AddResult addResult = stringTable().add<HashTranslator>(value);
+    HashSet<StringImpl*>::AddResult addResult = stringTable().add<StringTableTranslator<HashTranslator>>(value);
 
     // If the string is newly-translated, then we need to adopt it.
-    // The boolean in the pair tells us if that is so.
-    if (addResult.isNewEntry)
+    // The boolean in the pair tells us if that is so. Shared strings
+    // are static and are not translated with a reference to adopt.
+    if (addResult.isNewEntry && !(*addResult.iterator)->isStatic())
         return adoptRef(static_cast<AtomicStringImpl&>(**addResult.iterator));
     return *static_cast<AtomicStringImpl*>(*addResult.iterator);
 }
@@ -375,6 +428,16 @@ struct CharBufferFromLiteralDataTranslator {
     }
 };
 
+#if ENABLE(SHARED_ATOMIC_STRING_TABLE)
+struct SharedCharBufferFromLiteralDataTranslator : CharBufferFromLiteralDataTranslator {
+    static void translate(StringImpl*& location, const CharBuffer& buf, unsigned hash)
+    {
+        // Literals outlive every thread, so they can be atomized once for all of them.
+        location = &SharedAtomicStringTable::singleton().add<CharBufferFromLiteralDataTranslator>(buf, hash);
+    }
+};
+#endif
+
 RefPtr<AtomicStringImpl> AtomicStringImpl::add(const LChar* s, unsigned length)
 {
     if (!s)
@@ -393,7 +456,11 @@ Ref<AtomicStringImpl> AtomicStringImpl::addLiteral(const char* characters, unsig
     ASSERT(length);
 
     CharBuffer buffer = { characters, length };
+#if ENABLE(SHARED_ATOMIC_STRING_TABLE)
+    return addToStringTable<CharBuffer, SharedCharBufferFromLiteralDataTranslator>(buffer);
+#else
     return addToStringTable<CharBuffer, CharBufferFromLiteralDataTranslator>(buffer);
+#endif
 }
 
 Ref<AtomicStringImpl> AtomicStringImpl::addSlowCase(StringImpl& string)
@@ -410,12 +477,10 @@ Ref<AtomicStringImpl> AtomicStringImpl::addSlowCase(StringImpl& string)
     ASSERT_WITH_MESSAGE(!string.isAtomic(), "AtomicStringImpl should not hit the slow case if the string is already atomic.");
 
     AtomicStringTableLocker locker;
-    auto addResult = stringTable().add(&string);
+    auto addResult = stringTable().add<StringTableTranslator<StringImplTranslator>>(&string);
 
-    if (addResult.isNewEntry) {
-        ASSERT(*addResult.iterator == &string);
+    if (addResult.isNewEntry && *addResult.iterator == &string)
         string.setIsAtomic(true);
-    }
 
     return *static_cast<AtomicStringImpl*>(*addResult.iterator);
 }
@@ -434,12 +499,10 @@ Ref<AtomicStringImpl> AtomicStringImpl::addSlowCase(AtomicStringTable& stringTab
     ASSERT_WITH_MESSAGE(!string.isAtomic(), "AtomicStringImpl should not hit the slow case if the string is already atomic.");
 
     AtomicStringTableLocker locker;
-    auto addResult = stringTable.table().add(&string);
+    auto addResult = stringTable.table().add<StringTableTranslator<StringImplTranslator>>(&string);
 
-    if (addResult.isNewEntry) {
-        ASSERT(*addResult.iterator == &string);
+    if (addResult.isNewEntry && *addResult.iterator == &string)
         string.setIsAtomic(true);
-    }
 
     return *static_cast<AtomicStringImpl*>(*addResult.iterator);
 }
@@ -472,7 +535,11 @@ RefPtr<AtomicStringImpl> AtomicStringImpl::lookUpSlowCase(StringImpl& string)
     auto iterator = atomicStringTable.find(&string);
     if (iterator != atomicStringTable.end())
         return static_cast<AtomicStringImpl*>(*iterator);
+#if ENABLE(SHARED_ATOMIC_STRING_TABLE)
+    return static_cast<AtomicStringImpl*>(SharedAtomicStringTable::singleton().find<StringImplTranslator>(&string, string.hash()));
+#else
     return nullptr;
+#endif
 }
 
 RefPtr<AtomicStringImpl> AtomicStringImpl::addUTF8(const char* charactersStart, const char* charactersEnd)
@@ -496,7 +563,11 @@ RefPtr<AtomicStringImpl> AtomicStringImpl::lookUpInternal(const LChar* character
     auto iterator = table.find<LCharBufferTranslator>(buffer);
     if (iterator != table.end())
         return static_cast<AtomicStringImpl*>(*iterator);
+#if ENABLE(SHARED_ATOMIC_STRING_TABLE)
+    return static_cast<AtomicStringImpl*>(SharedAtomicStringTable::singleton().find<LCharBufferTranslator>(buffer, LCharBufferTranslator::hash(buffer)));
+#else
     return nullptr;
+#endif
 }
 
 RefPtr<AtomicStringImpl> AtomicStringImpl::lookUpInternal(const UChar* characters, unsigned length)
@@ -508,13 +579,21 @@ RefPtr<AtomicStringImpl> AtomicStringImpl::lookUpInternal(const UChar* character
     auto iterator = table.find<UCharBufferTranslator>(buffer);
     if (iterator != table.end())
         return static_cast<AtomicStringImpl*>(*iterator);
+#if ENABLE(SHARED_ATOMIC_STRING_TABLE)
+    return static_cast<AtomicStringImpl*>(SharedAtomicStringTable::singleton().find<UCharBufferTranslator>(buffer, UCharBufferTranslator::hash(buffer)));
+#else
     return nullptr;
+#endif
 }
 
 #if !ASSERT_DISABLED
 bool AtomicStringImpl::isInAtomicStringTable(StringImpl* string)
 {
     AtomicStringTableLocker locker;
+#if ENABLE(SHARED_ATOMIC_STRING_TABLE)
+    if (string->isStatic() && SharedAtomicStringTable::singleton().find<StringImplTranslator>(string, string->existingHash()) == string)
+        return true;
+#endif
     return stringTable().contains(string);
 }
 #endif
@@ -53,8 +53,11 @@ void AtomicStringTable::create(WTFThreadData& data)
 
 AtomicStringTable::~AtomicStringTable()
 {
-    for (auto* string : m_table)
-        string->setIsAtomic(false);
+    for (auto* string : m_table) {
+        // Strings from the SharedAtomicStringTable stay atomic for the other threads.
+        if (!string->isStatic())
+            string->setIsAtomic(false);
+    }
 }
 
 void AtomicStringTable::destroy(AtomicStringTable* table)
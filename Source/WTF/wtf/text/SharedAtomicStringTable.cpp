@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "SharedAtomicStringTable.h"
+
+#if ENABLE(SHARED_ATOMIC_STRING_TABLE)
+
+#include <mutex>
+#include <wtf/MathExtras.h>
+
+namespace WTF {
+
+SharedAtomicStringTable& SharedAtomicStringTable::singleton()
+{
+    static SharedAtomicStringTable* table;
+    static std::once_flag onceFlag;
+    std::call_once(onceFlag, [] {
+        table = new SharedAtomicStringTable;
+    });
+    return *table;
+}
+
+auto SharedAtomicStringTable::Table::create(unsigned capacity) -> Table*
+{
+    ASSERT(hasOneBitSet(capacity));
+    Table* table = static_cast<Table*>(fastZeroedMalloc(sizeof(Table) + capacity * sizeof(std::atomic<StringImpl*>)));
+    table->m_mask = capacity - 1;
+    return table;
+}
+
+void SharedAtomicStringTable::Table::add(StringImpl& string)
+{
+    for (unsigned i = tableIndex(string.existingHash()); ; ++i) {
+        if (!entry(i).load(std::memory_order_relaxed)) {
+            entry(i).store(&string, std::memory_order_release);
+            return;
+        }
+    }
+}
+
+void SharedAtomicStringTable::add(Shard& shard, StringImpl& string)
+{
+    ASSERT(shard.lock.isLocked());
+
+    Table* table = shard.table.load(std::memory_order_relaxed);
+    if (!table || (shard.size + 1) * 2 > table->capacity()) {
+        Table* newTable = Table::create(table ? table->capacity() * 2 : minimumTableCapacity);
+        if (table) {
+            for (unsigned i = 0; i < table->capacity(); ++i) {
+                if (StringImpl* entry = table->entry(i).load(std::memory_order_relaxed))
+                    newTable->add(*entry);
+            }
+        }
+        // Readers may still be probing the old table and there's no telling when they are done,
+        // so it's never freed. Since tables double in size, that is less than the current one.
+        shard.table.store(newTable, std::memory_order_release);
+        table = newTable;
+    }
+
+    table->add(string);
+    ++shard.size;
+}
+
+} // namespace WTF
+
+#endif // ENABLE(SHARED_ATOMIC_STRING_TABLE)
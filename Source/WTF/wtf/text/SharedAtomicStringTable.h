@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WTF_SharedAtomicStringTable_h
+#define WTF_SharedAtomicStringTable_h
+
+#if ENABLE(SHARED_ATOMIC_STRING_TABLE)
+
+#include <array>
+#include <atomic>
+#include <wtf/Lock.h>
+#include <wtf/text/StringImpl.h>
+
+namespace WTF {
+
+// A process-wide set of atomic strings that are never destroyed, so any thread can use them.
+// Lookups take no lock and never ref the string, which makes them safe on compiler threads too.
+// Additions take the lock of one of a few shards, picked by hash.
+//
+// A shared string is only the canonical atomic string for threads that haven't atomized the
+// same characters into their own AtomicStringTable, which is why AtomicStringImpl checks the
+// per-thread table first.
+class SharedAtomicStringTable {
+    WTF_MAKE_NONCOPYABLE(SharedAtomicStringTable); WTF_MAKE_FAST_ALLOCATED;
+public:
+    WTF_EXPORT_PRIVATE static SharedAtomicStringTable& singleton();
+
+    template<typename HashTranslator, typename T> StringImpl* find(const T&, unsigned hash) const;
+
+    // Uses HashTranslator::translate to create the string if it isn't in the table yet.
+    template<typename HashTranslator, typename T> StringImpl& add(const T&, unsigned hash);
+
+private:
+    SharedAtomicStringTable() = default;
+
+    static const unsigned shardBits = 4;
+    static const unsigned shardCount = 1 << shardBits;
+    static const unsigned minimumTableCapacity = 64;
+
+    class Table {
+    public:
+        static Table* create(unsigned capacity);
+
+        unsigned capacity() const { return m_mask + 1; }
+        std::atomic<StringImpl*>& entry(unsigned index) { return entries()[index & m_mask]; }
+        void add(StringImpl&);
+
+    private:
+        std::atomic<StringImpl*>* entries() { return reinterpret_cast<std::atomic<StringImpl*>*>(this + 1); }
+
+        unsigned m_mask;
+    };
+
+    struct Shard {
+        Lock lock;
+        std::atomic<Table*> table { nullptr };
+        unsigned size { 0 };
+    };
+
+    static unsigned shardIndex(unsigned hash) { return hash & (shardCount - 1); }
+    // The low bits of the hash pick the shard, so they'd be the same for every string in it.
+    static unsigned tableIndex(unsigned hash) { return hash >> shardBits; }
+
+    WTF_EXPORT_PRIVATE void add(Shard&, StringImpl&);
+
+    std::array<Shard, shardCount> m_shards;
+};
+
+template<typename HashTranslator, typename T>
+inline StringImpl* SharedAtomicStringTable::find(const T& value, unsigned hash) const
+{
+    Table* table = m_shards[shardIndex(hash)].table.load(std::memory_order_acquire);
+    if (!table)
+        return nullptr;
+
+    // Tables are never more than half full, so this always reaches an empty entry.
+    for (unsigned i = tableIndex(hash); ; ++i) {
+        StringImpl* string = table->entry(i).load(std::memory_order_acquire);
+        if (!string)
+            return nullptr;
+        if (string->existingHash() == hash && HashTranslator::equal(string, value))
+            return string;
+    }
+}
+
+template<typename HashTranslator, typename T>
+inline StringImpl& SharedAtomicStringTable::add(const T& value, unsigned hash)
+{
+    if (StringImpl* string = find<HashTranslator>(value, hash))
+        return *string;
+
+    Shard& shard = m_shards[shardIndex(hash)];
+    LockHolder locker(shard.lock);
+    if (StringImpl* string = find<HashTranslator>(value, hash))
+        return *string;
+
+    StringImpl* string;
+    HashTranslator::translate(string, value, hash);
+    ASSERT(string->isAtomic());
+    string->setIsStatic();
+    add(shard, *string);
+    return *string;
+}
+
+} // namespace WTF
+
+using WTF::SharedAtomicStringTable;
+
+#endif // ENABLE(SHARED_ATOMIC_STRING_TABLE)
+
+#endif // WTF_SharedAtomicStringTable_h
@@ -54,6 +54,7 @@ class LLIntOffsetsExtractor;
 
 namespace WTF {
 
+class SharedAtomicStringTable;
 class SymbolImpl;
 class SymbolRegistry;
 
@@ -143,6 +144,7 @@ class StringImpl {
     friend struct WTF::UCharBufferTranslator;
     friend class JSC::LLInt::Data;
     friend class JSC::LLIntOffsetsExtractor;
+    friend class WTF::SharedAtomicStringTable;
     
 private:
     enum BufferOwnership {
@@ -841,6 +843,8 @@ private:
     template<CaseConvertType type, typename CharacterType> static Ref<StringImpl> convertASCIICase(StringImpl&, const CharacterType*, unsigned);
 
     BufferOwnership bufferOwnership() const { return static_cast<BufferOwnership>(m_hashAndFlags & s_hashMaskBufferOwnership); }
+    // Makes the string immortal, like the empty string, so that it can be shared across threads.
+    void setIsStatic() { m_refCount |= s_refCountFlagIsStaticString; }
     template <class UCharPredicate> Ref<StringImpl> stripMatchedCharacters(UCharPredicate);
     template <typename CharType, class UCharPredicate> Ref<StringImpl> simplifyMatchedCharactersToSpace(UCharPredicate);
     template <typename CharType> static Ref<StringImpl> constructInternal(StringImpl*, unsigned);
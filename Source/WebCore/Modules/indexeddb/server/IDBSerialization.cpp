@@ -30,6 +30,7 @@
 #include "IDBKeyData.h"
 #include "IDBKeyPath.h"
 #include "KeyedCoding.h"
+#include <wtf/text/StringBuilder.h>
 
 namespace WebCore {
 
@@ -65,6 +66,242 @@ bool deserializeIDBKeyData(const uint8_t* data, size_t size, IDBKeyData& result)
     return IDBKeyData::decode(*decoder, result);
 }
 
+// Every encoded key starts with a tag, in the sort order of the key types. The tags are
+// all non-zero so that the zero byte that ends an array sorts before any array element.
+enum SortableKeyTag : uint8_t {
+    SortableKeyEnd = 0x00,
+    SortableKeyInvalid = 0x01,
+    SortableKeyMin = 0x10,
+    SortableKeyNumber = 0x20,
+    SortableKeyDate = 0x30,
+    SortableKeyString = 0x40,
+    SortableKeyArray = 0x50,
+    SortableKeyMax = 0x60,
+};
+
+static uint8_t sortableKeyTag(const IDBKeyData& key)
+{
+    switch (key.type()) {
+    case KeyType::Invalid:
+        return SortableKeyInvalid;
+    case KeyType::Min:
+        return SortableKeyMin;
+    case KeyType::Number:
+        return SortableKeyNumber;
+    case KeyType::Date:
+        return SortableKeyDate;
+    case KeyType::String:
+        return SortableKeyString;
+    case KeyType::Array:
+        return SortableKeyArray;
+    case KeyType::Max:
+        return SortableKeyMax;
+    }
+
+    ASSERT_NOT_REACHED();
+    return SortableKeyInvalid;
+}
+
+// Doubles are stored big endian, with the sign bit flipped for positive numbers and all bits
+// flipped for negative numbers, which makes their unsigned byte order the numeric order.
+static void appendSortableDouble(Vector<char>& buffer, double value)
+{
+    // -0 and 0 compare equal, so they need the same encoding.
+    if (!value)
+        value = 0;
+
+    uint64_t bits = bitwise_cast<uint64_t>(value);
+    if (bits & (1ULL << 63))
+        bits = ~bits;
+    else
+        bits |= 1ULL << 63;
+
+    for (int shift = 56; shift >= 0; shift -= 8)
+        buffer.append(static_cast<char>(bits >> shift));
+}
+
+static bool readSortableDouble(const uint8_t*& data, const uint8_t* end, double& result)
+{
+    if (end - data < 8)
+        return false;
+
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i)
+        bits = bits << 8 | *data++;
+
+    if (bits & (1ULL << 63))
+        bits &= ~(1ULL << 63);
+    else
+        bits = ~bits;
+
+    result = bitwise_cast<double>(bits);
+    return true;
+}
+
+// Strings are compared by UTF-16 code unit. Each code unit c is stored as c + 1 in a prefix
+// code of one to three bytes whose lead bytes grow with the value, and the string ends with
+// a zero byte so that a string sorts before the strings it is a prefix of.
+static void appendSortableCharacter(Vector<char>& buffer, UChar character)
+{
+    uint32_t value = static_cast<uint32_t>(character) + 1;
+    if (value < 0x80)
+        buffer.append(static_cast<char>(value));
+    else if (value < 0x4000) {
+        buffer.append(static_cast<char>(0x80 | value >> 8));
+        buffer.append(static_cast<char>(value));
+    } else {
+        buffer.append(static_cast<char>(0xC0 | value >> 16));
+        buffer.append(static_cast<char>(value >> 8));
+        buffer.append(static_cast<char>(value));
+    }
+}
+
+static void appendSortableString(Vector<char>& buffer, const String& string)
+{
+    unsigned length = string.length();
+    if (string.is8Bit()) {
+        const LChar* characters = string.characters8();
+        for (unsigned i = 0; i < length; ++i)
+            appendSortableCharacter(buffer, characters[i]);
+    } else {
+        const UChar* characters = string.characters16();
+        for (unsigned i = 0; i < length; ++i)
+            appendSortableCharacter(buffer, characters[i]);
+    }
+    buffer.append(static_cast<char>(SortableKeyEnd));
+}
+
+static bool readSortableString(const uint8_t*& data, const uint8_t* end, String& result)
+{
+    StringBuilder builder;
+    while (data < end) {
+        uint8_t lead = *data++;
+        if (lead == SortableKeyEnd) {
+            result = builder.toString();
+            return true;
+        }
+
+        uint32_t value;
+        if (lead < 0x80)
+            value = lead;
+        else if (lead < 0xC0) {
+            if (data == end)
+                return false;
+            value = (lead & 0x3F) << 8 | *data++;
+        } else {
+            if (lead > 0xC1 || end - data < 2)
+                return false;
+            value = (lead & 0x01) << 16 | data[0] << 8 | data[1];
+            data += 2;
+        }
+
+        if (!value || value > 0x10000)
+            return false;
+        builder.append(static_cast<UChar>(value - 1));
+    }
+
+    return false;
+}
+
+static void appendSortableKey(Vector<char>& buffer, const IDBKeyData& key)
+{
+    uint8_t tag = sortableKeyTag(key);
+    buffer.append(static_cast<char>(tag));
+
+    switch (key.type()) {
+    case KeyType::Invalid:
+    case KeyType::Min:
+    case KeyType::Max:
+        break;
+    case KeyType::Number:
+        appendSortableDouble(buffer, key.number());
+        break;
+    case KeyType::Date:
+        appendSortableDouble(buffer, key.date());
+        break;
+    case KeyType::String:
+        appendSortableString(buffer, key.string());
+        break;
+    case KeyType::Array:
+        for (auto& item : key.array())
+            appendSortableKey(buffer, item);
+        buffer.append(static_cast<char>(SortableKeyEnd));
+        break;
+    }
+}
+
+static bool readSortableKey(const uint8_t*& data, const uint8_t* end, IDBKeyData& result)
+{
+    if (data == end)
+        return false;
+
+    switch (*data++) {
+    case SortableKeyInvalid:
+        result = IDBKeyData();
+        return true;
+    case SortableKeyMin:
+        result = IDBKeyData::minimum();
+        return true;
+    case SortableKeyMax:
+        result = IDBKeyData::maximum();
+        return true;
+    case SortableKeyNumber: {
+        double number;
+        if (!readSortableDouble(data, end, number))
+            return false;
+        result.setNumberValue(number);
+        return true;
+    }
+    case SortableKeyDate: {
+        double date;
+        if (!readSortableDouble(data, end, date))
+            return false;
+        result.setDateValue(date);
+        return true;
+    }
+    case SortableKeyString: {
+        String string;
+        if (!readSortableString(data, end, string))
+            return false;
+        result.setStringValue(string);
+        return true;
+    }
+    case SortableKeyArray: {
+        Vector<IDBKeyData> array;
+        while (data < end) {
+            if (*data == SortableKeyEnd) {
+                ++data;
+                result.setArrayValue(array);
+                return true;
+            }
+            IDBKeyData item;
+            if (!readSortableKey(data, end, item))
+                return false;
+            array.append(WTFMove(item));
+        }
+        return false;
+    }
+    }
+
+    return false;
+}
+
+RefPtr<SharedBuffer> serializeSortableIDBKeyData(const IDBKeyData& key)
+{
+    Vector<char> buffer;
+    appendSortableKey(buffer, key);
+    return SharedBuffer::adoptVector(buffer);
+}
+
+bool deserializeSortableIDBKeyData(const uint8_t* data, size_t size, IDBKeyData& result)
+{
+    if (!data || !size)
+        return false;
+
+    const uint8_t* end = data + size;
+    return readSortableKey(data, end, result) && data == end;
+}
+
 } // namespace WebCore
 
 #endif // ENABLE(INDEXED_DATABASE)
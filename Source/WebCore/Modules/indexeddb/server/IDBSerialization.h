@@ -42,6 +42,11 @@ bool deserializeIDBKeyPath(const uint8_t* buffer, size_t bufferSize, IDBKeyPath&
 RefPtr<SharedBuffer> serializeIDBKeyData(const IDBKeyData&);
 bool deserializeIDBKeyData(const uint8_t* buffer, size_t bufferSize, IDBKeyData&);
 
+// A binary encoding of keys whose byte-wise (memcmp) order is the order of IDBKeyData::compare(),
+// so that the database can sort and compare encoded keys without decoding them.
+WEBCORE_EXPORT RefPtr<SharedBuffer> serializeSortableIDBKeyData(const IDBKeyData&);
+WEBCORE_EXPORT bool deserializeSortableIDBKeyData(const uint8_t* buffer, size_t bufferSize, IDBKeyData&);
+
 } // namespace WebCore
 
 #endif // ENABLE(INDEXED_DATABASE)
@@ -43,45 +43,44 @@ IndexValueStore::IndexValueStore(bool unique)
 
 const IDBKeyData* IndexValueStore::lowestValueForKey(const IDBKeyData& key) const
 {
-    const auto& entry = m_records.get(key);
+    auto* entry = m_records.valueForKey(key);
     if (!entry)
         return nullptr;
 
-    return entry->getLowest();
+    return (*entry)->getLowest();
 }
 
 uint64_t IndexValueStore::countForKey(const IDBKeyData& key) const
 {
-    const auto& entry = m_records.get(key);
+    auto* entry = m_records.valueForKey(key);
     if (!entry)
         return 0;
 
-    return entry->getCount();
+    return (*entry)->getCount();
 }
 
 bool IndexValueStore::contains(const IDBKeyData& key) const
 {
-    const auto& entry = m_records.get(key);
+    auto* entry = m_records.valueForKey(key);
     if (!entry)
         return false;
 
-    ASSERT(entry->getCount());
+    ASSERT((*entry)->getCount());
 
     return true;
 }
 
 IDBError IndexValueStore::addRecord(const IDBKeyData& indexKey, const IDBKeyData& valueKey)
 {
-    auto result = m_records.add(indexKey, nullptr);
+    auto* entry = m_records.valueForKey(indexKey);
 
-    if (!result.isNewEntry && m_unique)
+    if (entry && m_unique)
         return IDBError(IDBDatabaseException::ConstraintError);
 
-    if (result.isNewEntry)
-        result.iterator->value = std::make_unique<IndexValueEntry>(m_unique);
+    if (!entry)
+        entry = &m_records.add(indexKey, std::make_unique<IndexValueEntry>(m_unique)).iterator.value();
 
-    result.iterator->value->addKey(valueKey);
-    m_orderedKeys.insert(indexKey);
+    (*entry)->addKey(valueKey);
 
     return { };
 }
@@ -89,10 +88,10 @@ IDBError IndexValueStore::addRecord(const IDBKeyData& indexKey, const IDBKeyData
 void IndexValueStore::removeRecord(const IDBKeyData& indexKey, const IDBKeyData& valueKey)
 {
     auto iterator = m_records.find(indexKey);
-    if (!iterator->value)
+    if (iterator == m_records.end())
         return;
 
-    if (iterator->value->removeKey(valueKey))
+    if (iterator.value()->removeKey(valueKey) && !iterator.value()->getCount())
         m_records.remove(iterator);
 }
 
@@ -101,17 +100,16 @@ void IndexValueStore::removeEntriesWithValueKey(MemoryIndex& index, const IDBKey
     Vector<IDBKeyData> entryKeysToRemove;
     entryKeysToRemove.reserveInitialCapacity(m_records.size());
 
-    for (auto& entry : m_records) {
-        if (entry.value->removeKey(valueKey))
-            index.notifyCursorsOfValueChange(entry.key, valueKey);
-        if (!entry.value->getCount())
-            entryKeysToRemove.uncheckedAppend(entry.key);
+    for (auto iterator = m_records.begin(); iterator != m_records.end(); ++iterator) {
+        auto& entry = *iterator.value();
+        if (entry.removeKey(valueKey))
+            index.notifyCursorsOfValueChange(iterator.key(), valueKey);
+        if (!entry.getCount())
+            entryKeysToRemove.uncheckedAppend(iterator.key());
     }
 
-    for (auto& entry : entryKeysToRemove) {
-        m_orderedKeys.erase(entry);
+    for (auto& entry : entryKeysToRemove)
         m_records.remove(entry);
-    }
 }
 
 IDBKeyData IndexValueStore::lowestKeyWithRecordInRange(const IDBKeyRangeData& range) const
@@ -122,55 +120,58 @@ IDBKeyData IndexValueStore::lowestKeyWithRecordInRange(const IDBKeyRangeData& ra
         return m_records.contains(range.lowerKey) ? range.lowerKey : IDBKeyData();
 
     auto iterator = lowestIteratorInRange(range);
-    if (iterator == m_orderedKeys.end())
+    if (iterator == m_records.end())
         return { };
 
     return *iterator;
 }
 
-std::set<IDBKeyData>::iterator IndexValueStore::lowestIteratorInRange(const IDBKeyRangeData& range) const
+IndexKeyValueMap::const_iterator IndexValueStore::lowestIteratorInRange(const IDBKeyRangeData& range) const
 {
-    auto lowestInRange = m_orderedKeys.lower_bound(range.lowerKey);
+    auto lowestInRange = m_records.lowerBound(range.lowerKey);
 
-    if (lowestInRange == m_orderedKeys.end())
+    if (lowestInRange == m_records.end())
         return lowestInRange;
 
     if (range.lowerOpen && *lowestInRange == range.lowerKey) {
         ++lowestInRange;
 
-        if (lowestInRange == m_orderedKeys.end())
+        if (lowestInRange == m_records.end())
             return lowestInRange;
     }
 
     if (!range.upperKey.isNull()) {
         if (lowestInRange->compare(range.upperKey) > 0)
-            return m_orderedKeys.end();
+            return m_records.end();
         if (range.upperOpen && *lowestInRange == range.upperKey)
-            return m_orderedKeys.end();
+            return m_records.end();
     }
 
     return lowestInRange;
 }
 
-std::set<IDBKeyData>::reverse_iterator IndexValueStore::highestReverseIteratorInRange(const IDBKeyRangeData& range) const
+IndexKeyValueMap::const_iterator IndexValueStore::highestIteratorInRange(const IDBKeyRangeData& range) const
 {
-    auto highestInRange = std::set<IDBKeyData>::reverse_iterator(m_orderedKeys.upper_bound(range.upperKey));
+    // This is one record past the highest key in the range.
+    auto highestInRange = m_records.upperBound(range.upperKey);
+
+    if (highestInRange == m_records.begin())
+        return m_records.end();
 
-    if (highestInRange == m_orderedKeys.rend())
-        return highestInRange;
+    --highestInRange;
 
     if (range.upperOpen && *highestInRange == range.upperKey) {
-        ++highestInRange;
+        if (highestInRange == m_records.begin())
+            return m_records.end();
 
-        if (highestInRange == m_orderedKeys.rend())
-            return highestInRange;
+        --highestInRange;
     }
 
     if (!range.lowerKey.isNull()) {
         if (highestInRange->compare(range.lowerKey) < 0)
-            return m_orderedKeys.rend();
+            return m_records.end();
         if (range.lowerOpen && *highestInRange == range.lowerKey)
-            return m_orderedKeys.rend();
+            return m_records.end();
     }
 
     return highestInRange;
@@ -186,10 +187,10 @@ IndexValueStore::Iterator IndexValueStore::find(const IDBKeyData& key, bool open
     range.lowerOpen = open;
 
     auto iterator = lowestIteratorInRange(range);
-    if (iterator == m_orderedKeys.end())
+    if (iterator == m_records.end())
         return { };
 
-    auto record = m_records.get(*iterator);
+    auto& record = iterator.value();
     ASSERT(record);
 
     auto primaryIterator = record->begin();
@@ -207,10 +208,10 @@ IndexValueStore::Iterator IndexValueStore::find(const IDBKeyData& key, const IDB
     range.lowerOpen = false;
 
     auto iterator = lowestIteratorInRange(range);
-    if (iterator == m_orderedKeys.end())
+    if (iterator == m_records.end())
         return { };
 
-    auto record = m_records.get(*iterator);
+    auto* record = iterator.value().get();
     ASSERT(record);
 
     // If the main record iterator is not equal to the key we were looking for,
@@ -228,11 +229,11 @@ IndexValueStore::Iterator IndexValueStore::find(const IDBKeyData& key, const IDB
 
     // If we didn't find a primary key iterator in this entry,
     // we need to move on to start of the next record.
-    iterator++;
-    if (iterator == m_orderedKeys.end())
+    ++iterator;
+    if (iterator == m_records.end())
         return { };
 
-    record = m_records.get(*iterator);
+    record = iterator.value().get();
     ASSERT(record);
 
     primaryIterator = record->begin();
@@ -250,11 +251,11 @@ IndexValueStore::Iterator IndexValueStore::reverseFind(const IDBKeyData& key, Cu
         range.upperKey = IDBKeyData::maximum();
     range.upperOpen = open;
 
-    auto iterator = highestReverseIteratorInRange(range);
-    if (iterator == m_orderedKeys.rend())
+    auto iterator = highestIteratorInRange(range);
+    if (iterator == m_records.end())
         return { };
 
-    auto record = m_records.get(*iterator);
+    auto& record = iterator.value();
     ASSERT(record);
 
     auto primaryIterator = record->reverseBegin(duplicity);
@@ -271,11 +272,11 @@ IndexValueStore::Iterator IndexValueStore::reverseFind(const IDBKeyData& key, co
     range.upperKey = key;
     range.upperOpen = false;
 
-    auto iterator = highestReverseIteratorInRange(range);
-    if (iterator == m_orderedKeys.rend())
+    auto iterator = highestIteratorInRange(range);
+    if (iterator == m_records.end())
         return { };
 
-    auto record = m_records.get(*iterator);
+    auto* record = iterator.value().get();
     ASSERT(record);
 
     auto primaryIterator = record->reverseFind(primaryKey, duplicity);
@@ -284,11 +285,11 @@ IndexValueStore::Iterator IndexValueStore::reverseFind(const IDBKeyData& key, co
 
     // If we didn't find a primary key iterator in this entry,
     // we need to move on to start of the next record.
-    iterator++;
-    if (iterator == m_orderedKeys.rend())
+    if (iterator == m_records.begin())
         return { };
+    --iterator;
 
-    record = m_records.get(*iterator);
+    record = iterator.value().get();
     ASSERT(record);
 
     primaryIterator = record->reverseBegin(duplicity);
@@ -298,47 +299,47 @@ IndexValueStore::Iterator IndexValueStore::reverseFind(const IDBKeyData& key, co
 }
 
 
-IndexValueStore::Iterator::Iterator(IndexValueStore& store, std::set<IDBKeyData>::iterator iterator, IndexValueEntry::Iterator primaryIterator)
+IndexValueStore::Iterator::Iterator(IndexValueStore& store, IndexKeyValueMap::const_iterator iterator, IndexValueEntry::Iterator primaryIterator)
     : m_store(&store)
-    , m_forwardIterator(iterator)
+    , m_iterator(iterator)
     , m_primaryKeyIterator(primaryIterator)
 {
 }
 
-IndexValueStore::Iterator::Iterator(IndexValueStore& store, CursorDuplicity duplicity, std::set<IDBKeyData>::reverse_iterator iterator, IndexValueEntry::Iterator primaryIterator)
+IndexValueStore::Iterator::Iterator(IndexValueStore& store, CursorDuplicity duplicity, IndexKeyValueMap::const_iterator iterator, IndexValueEntry::Iterator primaryIterator)
     : m_store(&store)
     , m_forward(false)
     , m_duplicity(duplicity)
-    , m_reverseIterator(iterator)
+    , m_iterator(iterator)
     , m_primaryKeyIterator(primaryIterator)
 {
 }
 
 IndexValueStore::Iterator& IndexValueStore::Iterator::nextIndexEntry()
 {
-    if (!m_store)
+    if (!m_store || m_iterator.isStale())
         return *this;
 
     if (m_forward) {
-        ++m_forwardIterator;
-        if (m_forwardIterator == m_store->m_orderedKeys.end()) {
+        ++m_iterator;
+        if (m_iterator == m_store->m_records.end()) {
             invalidate();
             return *this;
         }
 
-        auto* entry = m_store->m_records.get(*m_forwardIterator);
+        auto& entry = m_iterator.value();
         ASSERT(entry);
 
         m_primaryKeyIterator = entry->begin();
         ASSERT(m_primaryKeyIterator.isValid());
     } else {
-        ++m_reverseIterator;
-        if (m_reverseIterator == m_store->m_orderedKeys.rend()) {
+        if (m_iterator == m_store->m_records.begin()) {
             invalidate();
             return *this;
         }
+        --m_iterator;
 
-        auto* entry = m_store->m_records.get(*m_reverseIterator);
+        auto& entry = m_iterator.value();
         ASSERT(entry);
 
         m_primaryKeyIterator = entry->reverseBegin(m_duplicity);
@@ -369,13 +370,14 @@ void IndexValueStore::Iterator::invalidate()
 
 bool IndexValueStore::Iterator::isValid()
 {
-    return m_store && m_primaryKeyIterator.isValid();
+    // Adding or removing index keys repositions the entries in the store, cursors then have to find their place again.
+    return m_store && !m_iterator.isStale() && m_primaryKeyIterator.isValid();
 }
 
 const IDBKeyData& IndexValueStore::Iterator::key()
 {
     ASSERT(isValid());
-    return m_forward ? *m_forwardIterator : *m_reverseIterator;
+    return *m_iterator;
 }
 
 const IDBKeyData& IndexValueStore::Iterator::primaryKey()
@@ -388,9 +390,9 @@ const IDBKeyData& IndexValueStore::Iterator::primaryKey()
 String IndexValueStore::loggingString() const
 {
     String result;
-    for (auto& key : m_orderedKeys) {
-        result.append(makeString("Key: ", key.loggingString()));
-        result.append(makeString("  Entry has ", String::number(m_records.get(key)->getCount()), " entries"));
+    for (auto iterator = m_records.begin(); iterator != m_records.end(); ++iterator) {
+        result.append(makeString("Key: ", iterator.key().loggingString()));
+        result.append(makeString("  Entry has ", String::number(iterator.value()->getCount()), " entries"));
     }
     return result;
 }
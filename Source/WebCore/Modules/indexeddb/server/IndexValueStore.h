@@ -31,8 +31,7 @@
 #include "IDBCursorInfo.h"
 #include "IDBKeyData.h"
 #include "IndexValueEntry.h"
-#include <set>
-#include <wtf/HashMap.h>
+#include "OrderedKeyMap.h"
 
 namespace WebCore {
 
@@ -44,7 +43,7 @@ namespace IDBServer {
 
 class MemoryIndex;
 
-typedef HashMap<IDBKeyData, std::unique_ptr<IndexValueEntry>, IDBKeyDataHash, IDBKeyDataHashTraits> IndexKeyValueMap;
+typedef OrderedKeyMap<std::unique_ptr<IndexValueEntry>> IndexKeyValueMap;
 
 class IndexValueStore {
 public:
@@ -67,8 +66,8 @@ public:
         {
         }
 
-        Iterator(IndexValueStore&, std::set<IDBKeyData>::iterator, IndexValueEntry::Iterator);
-        Iterator(IndexValueStore&, CursorDuplicity, std::set<IDBKeyData>::reverse_iterator, IndexValueEntry::Iterator);
+        Iterator(IndexValueStore&, IndexKeyValueMap::const_iterator, IndexValueEntry::Iterator);
+        Iterator(IndexValueStore&, CursorDuplicity, IndexKeyValueMap::const_iterator, IndexValueEntry::Iterator);
 
         void invalidate();
         bool isValid();
@@ -84,8 +83,7 @@ public:
         IndexValueStore* m_store { nullptr };
         bool m_forward { true };
         CursorDuplicity m_duplicity { CursorDuplicity::Duplicates };
-        std::set<IDBKeyData>::iterator m_forwardIterator;
-        std::set<IDBKeyData>::reverse_iterator m_reverseIterator;
+        IndexKeyValueMap::const_iterator m_iterator;
 
         IndexValueEntry::Iterator m_primaryKeyIterator;
     };
@@ -103,12 +101,11 @@ public:
 #endif
 
 private:
-    std::set<IDBKeyData>::iterator lowestIteratorInRange(const IDBKeyRangeData&) const;
-    std::set<IDBKeyData>::reverse_iterator highestReverseIteratorInRange(const IDBKeyRangeData&) const;
+    IndexKeyValueMap::const_iterator lowestIteratorInRange(const IDBKeyRangeData&) const;
+    IndexKeyValueMap::const_iterator highestIteratorInRange(const IDBKeyRangeData&) const;
 
     IndexKeyValueMap m_records;
-    std::set<IDBKeyData> m_orderedKeys;
-    
+
     bool m_unique;
 };
 
@@ -133,7 +133,7 @@ void MemoryBackingStoreTransaction::objectStoreDeleted(Ref<MemoryObjectStore>&&
         addResult.iterator->value = WTFMove(objectStore);
 }
 
-void MemoryBackingStoreTransaction::objectStoreCleared(MemoryObjectStore& objectStore, std::unique_ptr<KeyValueMap>&& keyValueMap, std::unique_ptr<std::set<IDBKeyData>>&& orderedKeys)
+void MemoryBackingStoreTransaction::objectStoreCleared(MemoryObjectStore& objectStore, std::unique_ptr<OrderedKeyValueMap>&& keyValueMap)
 {
     ASSERT(m_objectStores.contains(&objectStore));
 
@@ -144,9 +144,6 @@ void MemoryBackingStoreTransaction::objectStoreCleared(MemoryObjectStore& object
         return;
 
     addResult.iterator->value = WTFMove(keyValueMap);
-
-    ASSERT(!m_clearedOrderedKeys.contains(&objectStore));
-    m_clearedOrderedKeys.add(&objectStore, WTFMove(orderedKeys));
 }
 
 void MemoryBackingStoreTransaction::indexCleared(MemoryIndex& index, std::unique_ptr<IndexValueStore>&& valueStore)
@@ -160,7 +157,7 @@ void MemoryBackingStoreTransaction::indexCleared(MemoryIndex& index, std::unique
     addResult.iterator->value = WTFMove(valueStore);
 }
 
-void MemoryBackingStoreTransaction::recordValueChanged(MemoryObjectStore& objectStore, const IDBKeyData& key, ThreadSafeDataBuffer* value)
+void MemoryBackingStoreTransaction::recordValueChanged(MemoryObjectStore& objectStore, const IDBKeyData& key, const ThreadSafeDataBuffer* value)
 {
     ASSERT(m_objectStores.contains(&objectStore));
 
@@ -219,10 +216,8 @@ void MemoryBackingStoreTransaction::abort()
         objectStore->setKeyGeneratorValue(m_originalKeyGenerators.get(objectStore.get()));
 
         auto clearedKeyValueMap = m_clearedKeyValueMaps.take(objectStore.get());
-        if (clearedKeyValueMap) {
-            ASSERT(m_clearedOrderedKeys.contains(objectStore.get()));
-            objectStore->replaceKeyValueStore(WTFMove(clearedKeyValueMap), m_clearedOrderedKeys.take(objectStore.get()));
-        }
+        if (clearedKeyValueMap)
+            objectStore->replaceKeyValueStore(WTFMove(clearedKeyValueMap));
 
         auto keyValueMap = m_originalValues.take(objectStore.get());
         if (!keyValueMap)
@@ -32,6 +32,7 @@
 #include "IDBKeyData.h"
 #include "IDBTransactionInfo.h"
 #include "IndexValueStore.h"
+#include "OrderedKeyMap.h"
 #include "ThreadSafeDataBuffer.h"
 #include <wtf/HashMap.h>
 #include <wtf/HashSet.h>
@@ -44,6 +45,7 @@ class MemoryIndex;
 class MemoryObjectStore;
 
 typedef HashMap<IDBKeyData, ThreadSafeDataBuffer, IDBKeyDataHash, IDBKeyDataHashTraits> KeyValueMap;
+typedef OrderedKeyMap<ThreadSafeDataBuffer> OrderedKeyValueMap;
 
 class MemoryBackingStoreTransaction {
 public:
@@ -61,9 +63,9 @@ public:
     void addNewObjectStore(MemoryObjectStore&);
     void addExistingObjectStore(MemoryObjectStore&);
     
-    void recordValueChanged(MemoryObjectStore&, const IDBKeyData&, ThreadSafeDataBuffer*);
+    void recordValueChanged(MemoryObjectStore&, const IDBKeyData&, const ThreadSafeDataBuffer*);
     void objectStoreDeleted(Ref<MemoryObjectStore>&&);
-    void objectStoreCleared(MemoryObjectStore&, std::unique_ptr<KeyValueMap>&&, std::unique_ptr<std::set<IDBKeyData>>&&);
+    void objectStoreCleared(MemoryObjectStore&, std::unique_ptr<OrderedKeyValueMap>&&);
     void indexCleared(MemoryIndex&, std::unique_ptr<IndexValueStore>&&);
 
     void addNewIndex(MemoryIndex&);
@@ -93,8 +95,7 @@ private:
     HashMap<String, RefPtr<MemoryObjectStore>> m_deletedObjectStores;
     HashMap<String, RefPtr<MemoryIndex>> m_deletedIndexes;
     HashMap<MemoryObjectStore*, std::unique_ptr<KeyValueMap>> m_originalValues;
-    HashMap<MemoryObjectStore*, std::unique_ptr<KeyValueMap>> m_clearedKeyValueMaps;
-    HashMap<MemoryObjectStore*, std::unique_ptr<std::set<IDBKeyData>>> m_clearedOrderedKeys;
+    HashMap<MemoryObjectStore*, std::unique_ptr<OrderedKeyValueMap>> m_clearedKeyValueMaps;
     HashMap<MemoryIndex*, std::unique_ptr<IndexValueStore>> m_clearedIndexValueStores;
 };
 
@@ -179,7 +179,7 @@ void MemoryObjectStore::clear()
     LOG(IndexedDB, "MemoryObjectStore::clear");
     ASSERT(m_writeTransaction);
 
-    m_writeTransaction->objectStoreCleared(*this, WTFMove(m_keyValueStore), WTFMove(m_orderedKeys));
+    m_writeTransaction->objectStoreCleared(*this, WTFMove(m_keyValueStore));
     for (auto& index : m_indexesByIdentifier.values())
         index->objectStoreCleared();
 
@@ -187,13 +187,12 @@ void MemoryObjectStore::clear()
         cursor->objectStoreCleared();
 }
 
-void MemoryObjectStore::replaceKeyValueStore(std::unique_ptr<KeyValueMap>&& store, std::unique_ptr<std::set<IDBKeyData>>&& orderedKeys)
+void MemoryObjectStore::replaceKeyValueStore(std::unique_ptr<OrderedKeyValueMap>&& store)
 {
     ASSERT(m_writeTransaction);
     ASSERT(m_writeTransaction->isAborting());
 
     m_keyValueStore = WTFMove(store);
-    m_orderedKeys = WTFMove(orderedKeys);
 }
 
 void MemoryObjectStore::deleteRecord(const IDBKeyData& key)
@@ -207,17 +206,14 @@ void MemoryObjectStore::deleteRecord(const IDBKeyData& key)
         return;
     }
 
-    ASSERT(m_orderedKeys);
-
     auto iterator = m_keyValueStore->find(key);
     if (iterator == m_keyValueStore->end()) {
         m_writeTransaction->recordValueChanged(*this, key, nullptr);
         return;
     }
 
-    m_writeTransaction->recordValueChanged(*this, key, &iterator->value);
+    m_writeTransaction->recordValueChanged(*this, key, &iterator.value());
     m_keyValueStore->remove(iterator);
-    m_orderedKeys->erase(key);
 
     updateIndexesForDeleteRecord(key);
     updateCursorsForDeleteRecord(key);
@@ -254,34 +250,27 @@ IDBError MemoryObjectStore::addRecord(MemoryBackingStoreTransaction& transaction
     ASSERT(m_writeTransaction);
     ASSERT_UNUSED(transaction, m_writeTransaction == &transaction);
     ASSERT(!m_keyValueStore || !m_keyValueStore->contains(keyData));
-    ASSERT(!m_orderedKeys || m_orderedKeys->find(keyData) == m_orderedKeys->end());
 
-    if (!m_keyValueStore) {
-        ASSERT(!m_orderedKeys);
-        m_keyValueStore = std::make_unique<KeyValueMap>();
-        m_orderedKeys = std::make_unique<std::set<IDBKeyData>>();
-    }
+    if (!m_keyValueStore)
+        m_keyValueStore = std::make_unique<OrderedKeyValueMap>();
 
-    auto mapResult = m_keyValueStore->set(keyData, value);
-    ASSERT(mapResult.isNewEntry);
-    auto listResult = m_orderedKeys->insert(keyData);
-    ASSERT(listResult.second);
+    auto addResult = m_keyValueStore->add(keyData, value);
+    ASSERT_UNUSED(addResult, addResult.isNewEntry);
 
     // If there was an error indexing this addition, then revert it.
     auto error = updateIndexesForPutRecord(keyData, value);
-    if (!error.isNull()) {
-        m_keyValueStore->remove(mapResult.iterator);
-        m_orderedKeys->erase(listResult.first);
-    } else
-        updateCursorsForPutRecord(listResult.first);
+    if (!error.isNull())
+        m_keyValueStore->remove(keyData);
+    else
+        updateCursorsForPutRecord(keyData);
 
     return error;
 }
 
-void MemoryObjectStore::updateCursorsForPutRecord(std::set<IDBKeyData>::iterator iterator)
+void MemoryObjectStore::updateCursorsForPutRecord(const IDBKeyData& key)
 {
     for (auto& cursor : m_cursors.values())
-        cursor->keyAdded(iterator);
+        cursor->keyAdded(key);
 }
 
 void MemoryObjectStore::updateCursorsForDeleteRecord(const IDBKeyData& key)
@@ -337,8 +326,8 @@ IDBError MemoryObjectStore::populateIndexWithExistingRecords(MemoryIndex& index)
 
     JSLockHolder locker(UniqueIDBDatabase::databaseThreadVM());
 
-    for (auto iterator : *m_keyValueStore) {
-        auto jsValue = idbValueDataToJSValue(UniqueIDBDatabase::databaseThreadExecState(), iterator.value);
+    for (auto iterator = m_keyValueStore->begin(); iterator != m_keyValueStore->end(); ++iterator) {
+        auto jsValue = idbValueDataToJSValue(UniqueIDBDatabase::databaseThreadExecState(), iterator.value());
         if (jsValue.isUndefinedOrNull())
             return { };
 
@@ -348,7 +337,7 @@ IDBError MemoryObjectStore::populateIndexWithExistingRecords(MemoryIndex& index)
         if (indexKey.isNull())
             continue;
 
-        IDBError error = index.putIndexKey(iterator.key, indexKey);
+        IDBError error = index.putIndexKey(iterator.key(), indexKey);
         if (!error.isNull())
             return error;
     }
@@ -389,7 +378,8 @@ ThreadSafeDataBuffer MemoryObjectStore::valueForKey(const IDBKeyData& key) const
     if (!m_keyValueStore)
         return { };
 
-    return m_keyValueStore->get(key);
+    auto* value = m_keyValueStore->valueForKey(key);
+    return value ? *value : ThreadSafeDataBuffer();
 }
 
 ThreadSafeDataBuffer MemoryObjectStore::valueForKeyRange(const IDBKeyRangeData& keyRangeData) const
@@ -401,7 +391,7 @@ ThreadSafeDataBuffer MemoryObjectStore::valueForKeyRange(const IDBKeyRangeData&
         return ThreadSafeDataBuffer();
 
     ASSERT(m_keyValueStore);
-    return m_keyValueStore->get(key);
+    return *m_keyValueStore->valueForKey(key);
 }
 
 IDBGetResult MemoryObjectStore::indexValueForKeyRange(uint64_t indexIdentifier, IndexedDB::IndexRecordType recordType, const IDBKeyRangeData& range) const
@@ -421,17 +411,15 @@ IDBKeyData MemoryObjectStore::lowestKeyWithRecordInRange(const IDBKeyRangeData&
     if (keyRangeData.isExactlyOneKey() && m_keyValueStore->contains(keyRangeData.lowerKey))
         return keyRangeData.lowerKey;
 
-    ASSERT(m_orderedKeys);
-
-    auto lowestInRange = m_orderedKeys->lower_bound(keyRangeData.lowerKey);
+    auto lowestInRange = m_keyValueStore->lowerBound(keyRangeData.lowerKey);
 
-    if (lowestInRange == m_orderedKeys->end())
+    if (lowestInRange == m_keyValueStore->end())
         return { };
 
     if (keyRangeData.lowerOpen && *lowestInRange == keyRangeData.lowerKey)
         ++lowestInRange;
 
-    if (lowestInRange == m_orderedKeys->end())
+    if (lowestInRange == m_keyValueStore->end())
         return { };
 
     if (!keyRangeData.upperKey.isNull()) {
@@ -33,7 +33,6 @@
 #include "MemoryIndex.h"
 #include "MemoryObjectStoreCursor.h"
 #include "ThreadSafeDataBuffer.h"
-#include <set>
 #include <wtf/HashMap.h>
 #include <wtf/RefCounted.h>
 
@@ -53,8 +52,6 @@ namespace IDBServer {
 
 class MemoryBackingStoreTransaction;
 
-typedef HashMap<IDBKeyData, ThreadSafeDataBuffer, IDBKeyDataHash, IDBKeyDataHashTraits> KeyValueMap;
-
 class MemoryObjectStore : public RefCounted<MemoryObjectStore> {
 public:
     static Ref<MemoryObjectStore> create(const IDBObjectStoreInfo&);
@@ -79,7 +76,7 @@ public:
     void setKeyGeneratorValue(uint64_t value) { m_keyGeneratorValue = value; }
 
     void clear();
-    void replaceKeyValueStore(std::unique_ptr<KeyValueMap>&&, std::unique_ptr<std::set<IDBKeyData>>&&);
+    void replaceKeyValueStore(std::unique_ptr<OrderedKeyValueMap>&&);
 
     ThreadSafeDataBuffer valueForKey(const IDBKeyData&) const;
     ThreadSafeDataBuffer valueForKeyRange(const IDBKeyRangeData&) const;
@@ -90,7 +87,7 @@ public:
 
     MemoryObjectStoreCursor* maybeOpenCursor(const IDBCursorInfo&);
 
-    std::set<IDBKeyData>* orderedKeys() { return m_orderedKeys.get(); }
+    OrderedKeyValueMap* keyValueStore() { return m_keyValueStore.get(); }
 
     MemoryIndex* indexForIdentifier(uint64_t);
 
@@ -100,12 +97,11 @@ private:
     MemoryObjectStore(const IDBObjectStoreInfo&);
 
     IDBKeyData lowestKeyWithRecordInRange(const IDBKeyRangeData&) const;
-    std::set<IDBKeyData>::iterator lowestIteratorInRange(const IDBKeyRangeData&, bool reverse) const;
 
     IDBError populateIndexWithExistingRecords(MemoryIndex&);
     IDBError updateIndexesForPutRecord(const IDBKeyData&, const ThreadSafeDataBuffer& value);
     void updateIndexesForDeleteRecord(const IDBKeyData& value);
-    void updateCursorsForPutRecord(std::set<IDBKeyData>::iterator);
+    void updateCursorsForPutRecord(const IDBKeyData&);
     void updateCursorsForDeleteRecord(const IDBKeyData&);
 
     RefPtr<MemoryIndex> takeIndexByIdentifier(uint64_t indexIdentifier);
@@ -115,8 +111,7 @@ private:
     MemoryBackingStoreTransaction* m_writeTransaction { nullptr };
     uint64_t m_keyGeneratorValue { 1 };
 
-    std::unique_ptr<KeyValueMap> m_keyValueStore;
-    std::unique_ptr<std::set<IDBKeyData>> m_orderedKeys;
+    std::unique_ptr<OrderedKeyValueMap> m_keyValueStore;
 
     void unregisterIndex(MemoryIndex&);
     HashMap<uint64_t, RefPtr<MemoryIndex>> m_indexesByIdentifier;
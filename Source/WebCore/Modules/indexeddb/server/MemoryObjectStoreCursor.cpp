@@ -41,11 +41,13 @@ MemoryObjectStoreCursor::MemoryObjectStoreCursor(MemoryObjectStore& objectStore,
 {
     LOG(IndexedDB, "MemoryObjectStoreCursor::MemoryObjectStoreCursor %s", info.range().loggingString().utf8().data());
 
-    auto* orderedKeys = objectStore.orderedKeys();
-    if (!orderedKeys)
+    auto* keyValueStore = objectStore.keyValueStore();
+    if (!keyValueStore)
         return;
 
-    setFirstInRemainingRange(*orderedKeys);
+    setFirstInRemainingRange(*keyValueStore);
+    if (m_iterator)
+        m_currentPositionKey = **m_iterator;
 }
 
 void MemoryObjectStoreCursor::objectStoreCleared()
@@ -61,16 +63,30 @@ void MemoryObjectStoreCursor::keyDeleted(const IDBKeyData& key)
     m_iterator = Nullopt;
 }
 
-void MemoryObjectStoreCursor::keyAdded(std::set<IDBKeyData>::iterator iterator)
+void MemoryObjectStoreCursor::keyAdded(const IDBKeyData& key)
 {
     if (m_iterator)
         return;
 
-    if (*iterator == m_currentPositionKey)
-        m_iterator = iterator;
+    if (key == m_currentPositionKey) {
+        ASSERT(m_objectStore.keyValueStore());
+        m_iterator = m_objectStore.keyValueStore()->find(key);
+    }
+}
+
+void MemoryObjectStoreCursor::refreshStaleIterator(OrderedKeyValueMap& map)
+{
+    if (!m_iterator || !m_iterator->isStale())
+        return;
+
+    // Other records were added or removed since the iterator was positioned. Ours is still there,
+    // otherwise keyDeleted() would have dropped the iterator, so seek back to it.
+    m_iterator = map.find(m_currentPositionKey);
+    if (*m_iterator == map.end())
+        m_iterator = Nullopt;
 }
 
-void MemoryObjectStoreCursor::setFirstInRemainingRange(std::set<IDBKeyData>& set)
+void MemoryObjectStoreCursor::setFirstInRemainingRange(OrderedKeyValueMap& set)
 {
     m_iterator = Nullopt;
 
@@ -91,7 +107,7 @@ void MemoryObjectStoreCursor::setFirstInRemainingRange(std::set<IDBKeyData>& set
     ASSERT(!m_iterator || *m_iterator != set.end());
 }
 
-void MemoryObjectStoreCursor::setForwardIteratorFromRemainingRange(std::set<IDBKeyData>& set)
+void MemoryObjectStoreCursor::setForwardIteratorFromRemainingRange(OrderedKeyValueMap& set)
 {
     if (!set.size()) {
         m_iterator = Nullopt;
@@ -108,7 +124,7 @@ void MemoryObjectStoreCursor::setForwardIteratorFromRemainingRange(std::set<IDBK
 
     m_iterator = Nullopt;
 
-    auto lowest = set.lower_bound(m_remainingRange.lowerKey);
+    auto lowest = set.lowerBound(m_remainingRange.lowerKey);
     if (lowest == set.end())
         return;
 
@@ -129,7 +145,7 @@ void MemoryObjectStoreCursor::setForwardIteratorFromRemainingRange(std::set<IDBK
     m_iterator = lowest;
 }
 
-void MemoryObjectStoreCursor::setReverseIteratorFromRemainingRange(std::set<IDBKeyData>& set)
+void MemoryObjectStoreCursor::setReverseIteratorFromRemainingRange(OrderedKeyValueMap& set)
 {
     if (!set.size()) {
         m_iterator = Nullopt;
@@ -145,7 +161,8 @@ void MemoryObjectStoreCursor::setReverseIteratorFromRemainingRange(std::set<IDBK
     }
 
     if (!m_remainingRange.upperKey.isValid()) {
-        m_iterator = --set.end();
+        m_iterator = set.end();
+        --*m_iterator;
         if (!m_remainingRange.containsKey(**m_iterator))
             m_iterator = Nullopt;
 
@@ -155,7 +172,7 @@ void MemoryObjectStoreCursor::setReverseIteratorFromRemainingRange(std::set<IDBK
     m_iterator = Nullopt;
 
     // This is one record past the actual key we're looking for.
-    auto highest = set.upper_bound(m_remainingRange.upperKey);
+    auto highest = set.upperBound(m_remainingRange.upperKey);
 
     if (highest == set.begin())
         return;
@@ -182,6 +199,9 @@ void MemoryObjectStoreCursor::setReverseIteratorFromRemainingRange(std::set<IDBK
 
 void MemoryObjectStoreCursor::currentData(IDBGetResult& data)
 {
+    if (auto* keyValueStore = m_objectStore.keyValueStore())
+        refreshStaleIterator(*keyValueStore);
+
     if (!m_iterator) {
         m_currentPositionKey = { };
         data = { };
@@ -189,11 +209,13 @@ void MemoryObjectStoreCursor::currentData(IDBGetResult& data)
     }
 
     m_currentPositionKey = **m_iterator;
-    data = { m_currentPositionKey, m_currentPositionKey, m_objectStore.valueForKeyRange(m_currentPositionKey) };
+    data = { m_currentPositionKey, m_currentPositionKey, m_iterator->value() };
 }
 
-void MemoryObjectStoreCursor::incrementForwardIterator(std::set<IDBKeyData>& set, const IDBKeyData& key, uint32_t count)
+void MemoryObjectStoreCursor::incrementForwardIterator(OrderedKeyValueMap& set, const IDBKeyData& key, uint32_t count)
 {
+    refreshStaleIterator(set);
+
     // We might need to re-grab the current iterator.
     // e.g. If the record it was pointed to had been deleted.
     bool didResetIterator = false;
@@ -248,8 +270,10 @@ void MemoryObjectStoreCursor::incrementForwardIterator(std::set<IDBKeyData>& set
     }
 }
 
-void MemoryObjectStoreCursor::incrementReverseIterator(std::set<IDBKeyData>& set, const IDBKeyData& key, uint32_t count)
+void MemoryObjectStoreCursor::incrementReverseIterator(OrderedKeyValueMap& set, const IDBKeyData& key, uint32_t count)
 {
+    refreshStaleIterator(set);
+
     // We might need to re-grab the current iterator.
     // e.g. If the record it was pointed to had been deleted.
     bool didResetIterator = false;
@@ -312,7 +336,7 @@ void MemoryObjectStoreCursor::iterate(const IDBKeyData& key, uint32_t count, IDB
 {
     LOG(IndexedDB, "MemoryObjectStoreCursor::iterate to key %s", key.loggingString().utf8().data());
 
-    if (!m_objectStore.orderedKeys()) {
+    if (!m_objectStore.keyValueStore()) {
         m_currentPositionKey = { };
         outData = { };
         return;
@@ -324,7 +348,7 @@ void MemoryObjectStoreCursor::iterate(const IDBKeyData& key, uint32_t count, IDB
         return;
     }
 
-    auto* set = m_objectStore.orderedKeys();
+    auto* set = m_objectStore.keyValueStore();
     if (set) {
         if (m_info.isDirectionForward())
             incrementForwardIterator(*set, key, count);
@@ -31,7 +31,8 @@
 #include "IDBCursorInfo.h"
 #include "IDBKeyData.h"
 #include "MemoryCursor.h"
-#include <set>
+#include "OrderedKeyMap.h"
+#include "ThreadSafeDataBuffer.h"
 #include <wtf/Optional.h>
 
 namespace WebCore {
@@ -39,24 +40,27 @@ namespace IDBServer {
 
 class MemoryObjectStore;
 
+typedef OrderedKeyMap<ThreadSafeDataBuffer> OrderedKeyValueMap;
+
 class MemoryObjectStoreCursor : public MemoryCursor {
 public:
     MemoryObjectStoreCursor(MemoryObjectStore&, const IDBCursorInfo&);
 
     void objectStoreCleared();
     void keyDeleted(const IDBKeyData&);
-    void keyAdded(std::set<IDBKeyData>::iterator);
+    void keyAdded(const IDBKeyData&);
 
 private:
     virtual void currentData(IDBGetResult&) override final;
     virtual void iterate(const IDBKeyData&, uint32_t count, IDBGetResult&) override final;
 
-    void setFirstInRemainingRange(std::set<IDBKeyData>&);
-    void setForwardIteratorFromRemainingRange(std::set<IDBKeyData>&);
-    void setReverseIteratorFromRemainingRange(std::set<IDBKeyData>&);
+    void setFirstInRemainingRange(OrderedKeyValueMap&);
+    void setForwardIteratorFromRemainingRange(OrderedKeyValueMap&);
+    void setReverseIteratorFromRemainingRange(OrderedKeyValueMap&);
+    void refreshStaleIterator(OrderedKeyValueMap&);
 
-    void incrementForwardIterator(std::set<IDBKeyData>&, const IDBKeyData&, uint32_t count);
-    void incrementReverseIterator(std::set<IDBKeyData>&, const IDBKeyData&, uint32_t count);
+    void incrementForwardIterator(OrderedKeyValueMap&, const IDBKeyData&, uint32_t count);
+    void incrementReverseIterator(OrderedKeyValueMap&, const IDBKeyData&, uint32_t count);
 
     bool hasValidPosition() const;
 
@@ -64,7 +68,7 @@ private:
 
     IDBKeyRangeData m_remainingRange;
 
-    WTF::Optional<std::set<IDBKeyData>::iterator> m_iterator;
+    WTF::Optional<OrderedKeyValueMap::iterator> m_iterator;
 
     IDBKeyData m_currentPositionKey;
 };
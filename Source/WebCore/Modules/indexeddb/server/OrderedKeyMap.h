@@ -0,0 +1,368 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OrderedKeyMap_h
+#define OrderedKeyMap_h
+
+#if ENABLE(INDEXED_DATABASE)
+
+#include "IDBKeyData.h"
+#include <algorithm>
+#include <wtf/HashTable.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/Vector.h>
+
+namespace WebCore {
+namespace IDBServer {
+
+// Map from IDBKeyData to ValueType kept in key order, serving both point lookups and ordered cursor walks.
+// Entries live in a list of sorted chunks holding at most maxChunkSize keys each, so lookups are binary
+// searches over contiguous keys and iteration is a linear scan, with no per-entry node allocation.
+//
+// Any insertion or removal invalidates all outstanding iterators (isStale() then returns true).
+// Holders that need a position that survives mutation, like cursors, keep the key they are at and
+// seek back to it with find() or lowerBound().
+template<typename ValueType>
+class OrderedKeyMap {
+    WTF_MAKE_NONCOPYABLE(OrderedKeyMap);
+    WTF_MAKE_FAST_ALLOCATED;
+private:
+    static const size_t maxChunkSize = 64;
+    static const size_t minChunkSize = maxChunkSize / 4;
+
+    struct Chunk {
+        WTF_MAKE_FAST_ALLOCATED;
+    public:
+        Chunk()
+        {
+            keys.reserveInitialCapacity(maxChunkSize);
+            values.reserveInitialCapacity(maxChunkSize);
+        }
+
+        size_t size() const { return keys.size(); }
+
+        Vector<IDBKeyData> keys;
+        Vector<ValueType> values;
+    };
+
+    struct Position {
+        size_t chunkIndex;
+        size_t offset;
+    };
+
+public:
+    template<typename MapType, typename MappedType>
+    class IteratorBase {
+    public:
+        IteratorBase()
+        {
+        }
+
+        template<typename OtherMapType, typename OtherMappedType>
+        IteratorBase(const IteratorBase<OtherMapType, OtherMappedType>& other)
+            : m_map(other.m_map)
+            , m_position(other.m_position)
+            , m_version(other.m_version)
+        {
+        }
+
+        const IDBKeyData& key() const
+        {
+            ASSERT(!isStale());
+            return m_map->m_chunks[m_position.chunkIndex]->keys[m_position.offset];
+        }
+
+        MappedType& value() const
+        {
+            ASSERT(!isStale());
+            return m_map->m_chunks[m_position.chunkIndex]->values[m_position.offset];
+        }
+
+        const IDBKeyData& operator*() const { return key(); }
+        const IDBKeyData* operator->() const { return &key(); }
+
+        IteratorBase& operator++()
+        {
+            ASSERT(!isStale());
+            if (++m_position.offset == m_map->m_chunks[m_position.chunkIndex]->size()) {
+                ++m_position.chunkIndex;
+                m_position.offset = 0;
+            }
+            return *this;
+        }
+
+        IteratorBase& operator--()
+        {
+            ASSERT(!isStale());
+            if (!m_position.offset) {
+                ASSERT(m_position.chunkIndex);
+                m_position.offset = m_map->m_chunks[--m_position.chunkIndex]->size();
+            }
+            --m_position.offset;
+            return *this;
+        }
+
+        bool operator==(const IteratorBase& other) const
+        {
+            return m_map == other.m_map && m_position.chunkIndex == other.m_position.chunkIndex && m_position.offset == other.m_position.offset;
+        }
+
+        bool operator!=(const IteratorBase& other) const { return !(*this == other); }
+
+        bool isStale() const { return !m_map || m_version != m_map->m_version; }
+
+    private:
+        template<typename, typename> friend class IteratorBase;
+        friend class OrderedKeyMap;
+
+        IteratorBase(MapType& map, Position position)
+            : m_map(&map)
+            , m_position(position)
+            , m_version(map.m_version)
+        {
+        }
+
+        MapType* m_map { nullptr };
+        Position m_position { 0, 0 };
+        uint64_t m_version { 0 };
+    };
+
+    typedef IteratorBase<OrderedKeyMap, ValueType> iterator;
+    typedef IteratorBase<const OrderedKeyMap, const ValueType> const_iterator;
+    typedef WTF::HashTableAddResult<iterator> AddResult;
+
+    OrderedKeyMap()
+    {
+    }
+
+    size_t size() const { return m_size; }
+    bool isEmpty() const { return !m_size; }
+
+    iterator begin() { return { *this, { 0, 0 } }; }
+    iterator end() { return { *this, endPosition() }; }
+    const_iterator begin() const { return { *this, { 0, 0 } }; }
+    const_iterator end() const { return { *this, endPosition() }; }
+
+    iterator find(const IDBKeyData& key) { return { *this, findPosition(key) }; }
+    const_iterator find(const IDBKeyData& key) const { return { *this, findPosition(key) }; }
+
+    // The first entry whose key is not less than the given key.
+    iterator lowerBound(const IDBKeyData& key) { return { *this, lowerBoundPosition(key) }; }
+    const_iterator lowerBound(const IDBKeyData& key) const { return { *this, lowerBoundPosition(key) }; }
+
+    // The first entry whose key is greater than the given key.
+    iterator upperBound(const IDBKeyData& key) { return { *this, upperBoundPosition(key) }; }
+    const_iterator upperBound(const IDBKeyData& key) const { return { *this, upperBoundPosition(key) }; }
+
+    bool contains(const IDBKeyData& key) const { return !isEnd(findPosition(key)); }
+
+    ValueType* valueForKey(const IDBKeyData& key)
+    {
+        auto position = findPosition(key);
+        return isEnd(position) ? nullptr : &m_chunks[position.chunkIndex]->values[position.offset];
+    }
+
+    const ValueType* valueForKey(const IDBKeyData& key) const
+    {
+        return const_cast<OrderedKeyMap*>(this)->valueForKey(key);
+    }
+
+    // Inserts the entry if the key is not in the map yet, otherwise leaves the existing value alone.
+    template<typename V> AddResult add(const IDBKeyData&, V&&);
+
+    bool remove(const IDBKeyData&);
+    void remove(const iterator& iterator) { removeAt(iterator.m_position); }
+    void remove(const const_iterator& iterator) { removeAt(iterator.m_position); }
+
+    void clear()
+    {
+        m_chunks.clear();
+        m_size = 0;
+        ++m_version;
+    }
+
+private:
+    Position endPosition() const { return { m_chunks.size(), 0 }; }
+    bool isEnd(const Position& position) const { return position.chunkIndex == m_chunks.size(); }
+
+    Position lowerBoundPosition(const IDBKeyData&) const;
+    Position upperBoundPosition(const IDBKeyData&) const;
+    Position findPosition(const IDBKeyData&) const;
+
+    void removeAt(const Position&);
+    void splitChunk(size_t chunkIndex);
+    void mergeChunkWithNext(size_t chunkIndex);
+
+    Vector<std::unique_ptr<Chunk>> m_chunks;
+    size_t m_size { 0 };
+    uint64_t m_version { 0 };
+};
+
+template<typename ValueType>
+auto OrderedKeyMap<ValueType>::lowerBoundPosition(const IDBKeyData& key) const -> Position
+{
+    auto chunk = std::lower_bound(m_chunks.begin(), m_chunks.end(), key, [](const std::unique_ptr<Chunk>& chunk, const IDBKeyData& key) {
+        return chunk->keys.last() < key;
+    });
+    if (chunk == m_chunks.end())
+        return endPosition();
+
+    auto& keys = (*chunk)->keys;
+    return { static_cast<size_t>(chunk - m_chunks.begin()), static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), key) - keys.begin()) };
+}
+
+template<typename ValueType>
+auto OrderedKeyMap<ValueType>::upperBoundPosition(const IDBKeyData& key) const -> Position
+{
+    auto chunk = std::upper_bound(m_chunks.begin(), m_chunks.end(), key, [](const IDBKeyData& key, const std::unique_ptr<Chunk>& chunk) {
+        return key < chunk->keys.last();
+    });
+    if (chunk == m_chunks.end())
+        return endPosition();
+
+    auto& keys = (*chunk)->keys;
+    return { static_cast<size_t>(chunk - m_chunks.begin()), static_cast<size_t>(std::upper_bound(keys.begin(), keys.end(), key) - keys.begin()) };
+}
+
+template<typename ValueType>
+auto OrderedKeyMap<ValueType>::findPosition(const IDBKeyData& key) const -> Position
+{
+    auto position = lowerBoundPosition(key);
+    if (isEnd(position) || !(m_chunks[position.chunkIndex]->keys[position.offset] == key))
+        return endPosition();
+    return position;
+}
+
+template<typename ValueType>
+template<typename V>
+auto OrderedKeyMap<ValueType>::add(const IDBKeyData& key, V&& value) -> AddResult
+{
+    auto position = lowerBoundPosition(key);
+    if (!isEnd(position) && m_chunks[position.chunkIndex]->keys[position.offset] == key)
+        return { { *this, position }, false };
+
+    if (m_chunks.isEmpty())
+        m_chunks.append(std::make_unique<Chunk>());
+    else if (isEnd(position))
+        position = { m_chunks.size() - 1, m_chunks.last()->size() };
+
+    if (m_chunks[position.chunkIndex]->size() == maxChunkSize) {
+        if (position.chunkIndex == m_chunks.size() - 1 && position.offset == maxChunkSize) {
+            // Keys that sort after everything else (like generated keys) start a fresh chunk
+            // rather than splitting, so bulk loads leave full chunks behind.
+            m_chunks.append(std::make_unique<Chunk>());
+            position = { position.chunkIndex + 1, 0 };
+        } else {
+            splitChunk(position.chunkIndex);
+            if (position.offset > maxChunkSize / 2)
+                position = { position.chunkIndex + 1, position.offset - maxChunkSize / 2 };
+        }
+    }
+
+    auto& chunk = *m_chunks[position.chunkIndex];
+    chunk.keys.insert(position.offset, key);
+    chunk.values.insert(position.offset, std::forward<V>(value));
+
+    ++m_size;
+    ++m_version;
+    return { { *this, position }, true };
+}
+
+template<typename ValueType>
+bool OrderedKeyMap<ValueType>::remove(const IDBKeyData& key)
+{
+    auto position = findPosition(key);
+    if (isEnd(position))
+        return false;
+
+    removeAt(position);
+    return true;
+}
+
+template<typename ValueType>
+void OrderedKeyMap<ValueType>::removeAt(const Position& position)
+{
+    ASSERT(!isEnd(position));
+
+    size_t chunkIndex = position.chunkIndex;
+    auto& chunk = *m_chunks[chunkIndex];
+    chunk.keys.remove(position.offset);
+    chunk.values.remove(position.offset);
+
+    --m_size;
+    ++m_version;
+
+    if (!chunk.size()) {
+        m_chunks.remove(chunkIndex);
+        return;
+    }
+
+    if (chunk.size() >= minChunkSize)
+        return;
+
+    // Fold a sparse chunk into a neighbor so that range deletes don't leave lots of nearly empty chunks.
+    if (chunkIndex + 1 < m_chunks.size() && chunk.size() + m_chunks[chunkIndex + 1]->size() <= maxChunkSize)
+        mergeChunkWithNext(chunkIndex);
+    else if (chunkIndex && m_chunks[chunkIndex - 1]->size() + chunk.size() <= maxChunkSize)
+        mergeChunkWithNext(chunkIndex - 1);
+}
+
+template<typename ValueType>
+void OrderedKeyMap<ValueType>::splitChunk(size_t chunkIndex)
+{
+    auto& chunk = *m_chunks[chunkIndex];
+    auto newChunk = std::make_unique<Chunk>();
+
+    size_t splitOffset = chunk.size() / 2;
+    for (size_t i = splitOffset; i < chunk.size(); ++i) {
+        newChunk->keys.uncheckedAppend(WTFMove(chunk.keys[i]));
+        newChunk->values.uncheckedAppend(WTFMove(chunk.values[i]));
+    }
+    chunk.keys.shrink(splitOffset);
+    chunk.values.shrink(splitOffset);
+
+    m_chunks.insert(chunkIndex + 1, WTFMove(newChunk));
+}
+
+template<typename ValueType>
+void OrderedKeyMap<ValueType>::mergeChunkWithNext(size_t chunkIndex)
+{
+    auto& chunk = *m_chunks[chunkIndex];
+    auto& nextChunk = *m_chunks[chunkIndex + 1];
+    ASSERT(chunk.size() + nextChunk.size() <= maxChunkSize);
+
+    for (size_t i = 0; i < nextChunk.size(); ++i) {
+        chunk.keys.uncheckedAppend(WTFMove(nextChunk.keys[i]));
+        chunk.values.uncheckedAppend(WTFMove(nextChunk.values[i]));
+    }
+
+    m_chunks.remove(chunkIndex + 1);
+}
+
+} // namespace IDBServer
+} // namespace WebCore
+
+#endif // ENABLE(INDEXED_DATABASE)
+#endif // OrderedKeyMap_h
@@ -143,6 +143,51 @@ static const String& v2IndexRecordsTableSchemaAlternate()
     return v2IndexRecordsTableSchemaString;
 }
 
+// Version 3 stores keys in the sortable binary encoding, so they are compared with the
+// default BLOB ordering instead of the IDBKEY collation.
+static const String v3RecordsTableSchema(const String& tableName)
+{
+    return makeString("CREATE TABLE ", tableName, " (objectStoreID INTEGER NOT NULL ON CONFLICT FAIL, key BLOB NOT NULL ON CONFLICT FAIL, value NOT NULL ON CONFLICT FAIL)");
+}
+
+static const String& v3RecordsTableSchema()
+{
+    static NeverDestroyed<WTF::String> v3RecordsTableSchemaString(v3RecordsTableSchema("Records"));
+    return v3RecordsTableSchemaString;
+}
+
+static const String& v3RecordsTableSchemaAlternate()
+{
+    static NeverDestroyed<WTF::String> v3RecordsTableSchemaString(v3RecordsTableSchema("\"Records\""));
+    return v3RecordsTableSchemaString;
+}
+
+static const String v3IndexRecordsTableSchema(const String& tableName)
+{
+    return makeString("CREATE TABLE ", tableName, " (indexID INTEGER NOT NULL ON CONFLICT FAIL, objectStoreID INTEGER NOT NULL ON CONFLICT FAIL, key BLOB NOT NULL ON CONFLICT FAIL, value BLOB NOT NULL ON CONFLICT FAIL)");
+}
+
+static const String& v3IndexRecordsTableSchema()
+{
+    static NeverDestroyed<WTF::String> v3IndexRecordsTableSchemaString(v3IndexRecordsTableSchema("IndexRecords"));
+    return v3IndexRecordsTableSchemaString;
+}
+
+static const String& v3IndexRecordsTableSchemaAlternate()
+{
+    static NeverDestroyed<WTF::String> v3IndexRecordsTableSchemaString(v3IndexRecordsTableSchema("\"IndexRecords\""));
+    return v3IndexRecordsTableSchemaString;
+}
+
+// Converts a key stored by a previous schema version to the sortable binary encoding.
+static RefPtr<SharedBuffer> migrateKeyToSortableEncoding(const Vector<uint8_t>& oldKeyBuffer)
+{
+    IDBKeyData key;
+    if (!deserializeIDBKeyData(oldKeyBuffer.data(), oldKeyBuffer.size(), key))
+        return nullptr;
+    return serializeSortableIDBKeyData(key);
+}
+
 
 SQLiteIDBBackingStore::SQLiteIDBBackingStore(const IDBDatabaseIdentifier& identifier, const String& databaseRootDirectory)
     : m_identifier(identifier)
@@ -201,7 +246,7 @@ static bool createOrMigrateRecordsTableIfNecessary(SQLiteDatabase& database)
 
         // If there is no Records table at all, create it and then bail.
         if (sqliteResult == SQLITE_DONE) {
-            if (!database.executeCommand(v2RecordsTableSchema())) {
+            if (!database.executeCommand(v3RecordsTableSchema())) {
                 LOG_ERROR("Could not create Records table in database (%i) - %s", database.lastError(), database.lastErrorMsg());
                 return false;
             }
@@ -220,26 +265,59 @@ static bool createOrMigrateRecordsTableIfNecessary(SQLiteDatabase& database)
     ASSERT(!currentSchema.isEmpty());
 
     // If the schema in the backing store is the current schema, we're done.
-    if (currentSchema == v2RecordsTableSchema() || currentSchema == v2RecordsTableSchemaAlternate())
+    if (currentSchema == v3RecordsTableSchema() || currentSchema == v3RecordsTableSchemaAlternate())
         return true;
 
     // If the record table is not the current schema then it must be one of the previous schemas.
     // If it is not then the database is in an unrecoverable state and this should be considered a fatal error.
-    if (currentSchema != v1RecordsTableSchema() && currentSchema != v1RecordsTableSchemaAlternate())
+    if (currentSchema != v2RecordsTableSchema() && currentSchema != v2RecordsTableSchemaAlternate()
+        && currentSchema != v1RecordsTableSchema() && currentSchema != v1RecordsTableSchemaAlternate())
         RELEASE_ASSERT_NOT_REACHED();
 
     SQLiteTransaction transaction(database);
     transaction.begin();
 
     // Create a temporary table with the correct schema and migrate all existing content over.
-    if (!database.executeCommand(v2RecordsTableSchema("_Temp_Records"))) {
+    if (!database.executeCommand(v3RecordsTableSchema("_Temp_Records"))) {
         LOG_ERROR("Could not create temporary records table in database (%i) - %s", database.lastError(), database.lastErrorMsg());
         return false;
     }
 
-    if (!database.executeCommand("INSERT INTO _Temp_Records SELECT * FROM Records")) {
-        LOG_ERROR("Could not migrate existing Records content (%i) - %s", database.lastError(), database.lastErrorMsg());
-        return false;
+    {
+        SQLiteStatement selectStatement(database, "SELECT objectStoreID, key, value FROM Records;");
+        SQLiteStatement insertStatement(database, "INSERT INTO _Temp_Records VALUES (?, ?, ?);");
+        if (selectStatement.prepare() != SQLITE_OK || insertStatement.prepare() != SQLITE_OK) {
+            LOG_ERROR("Could not prepare statements to migrate existing Records content (%i) - %s", database.lastError(), database.lastErrorMsg());
+            return false;
+        }
+
+        int result = selectStatement.step();
+        for (; result == SQLITE_ROW; result = selectStatement.step()) {
+            Vector<uint8_t> keyBuffer;
+            Vector<uint8_t> valueBuffer;
+            selectStatement.getColumnBlobAsVector(1, keyBuffer);
+            selectStatement.getColumnBlobAsVector(2, valueBuffer);
+
+            RefPtr<SharedBuffer> sortableKeyBuffer = migrateKeyToSortableEncoding(keyBuffer);
+            if (!sortableKeyBuffer) {
+                LOG_ERROR("Unable to deserialize a key while migrating Records content.");
+                return false;
+            }
+
+            insertStatement.reset();
+            if (insertStatement.bindInt64(1, selectStatement.getColumnInt64(0)) != SQLITE_OK
+                || insertStatement.bindBlob(2, sortableKeyBuffer->data(), sortableKeyBuffer->size()) != SQLITE_OK
+                || insertStatement.bindBlob(3, valueBuffer.data(), valueBuffer.size()) != SQLITE_OK
+                || insertStatement.step() != SQLITE_DONE) {
+                LOG_ERROR("Could not migrate existing Records content (%i) - %s", database.lastError(), database.lastErrorMsg());
+                return false;
+            }
+        }
+
+        if (result != SQLITE_DONE) {
+            LOG_ERROR("Could not read existing Records content (%i) - %s", database.lastError(), database.lastErrorMsg());
+            return false;
+        }
     }
 
     if (!database.executeCommand("DROP TABLE Records")) {
@@ -293,7 +371,7 @@ bool SQLiteIDBBackingStore::ensureValidIndexRecordsTable()
 
         // If there is no IndexRecords table at all, create it and then bail.
         if (sqliteResult == SQLITE_DONE) {
-            if (!m_sqliteDB->executeCommand(v2IndexRecordsTableSchema())) {
+            if (!m_sqliteDB->executeCommand(v3IndexRecordsTableSchema())) {
                 LOG_ERROR("Could not create IndexRecords table in database (%i) - %s", m_sqliteDB->lastError(), m_sqliteDB->lastErrorMsg());
                 return false;
             }
@@ -312,26 +390,62 @@ bool SQLiteIDBBackingStore::ensureValidIndexRecordsTable()
     ASSERT(!currentSchema.isEmpty());
 
     // If the schema in the backing store is the current schema, we're done.
-    if (currentSchema == v2IndexRecordsTableSchema() || currentSchema == v2IndexRecordsTableSchemaAlternate())
+    if (currentSchema == v3IndexRecordsTableSchema() || currentSchema == v3IndexRecordsTableSchemaAlternate())
         return true;
 
     // If the record table is not the current schema then it must be one of the previous schemas.
     // If it is not then the database is in an unrecoverable state and this should be considered a fatal error.
-    if (currentSchema != v1IndexRecordsTableSchema() && currentSchema != v1IndexRecordsTableSchemaAlternate())
+    if (currentSchema != v2IndexRecordsTableSchema() && currentSchema != v2IndexRecordsTableSchemaAlternate()
+        && currentSchema != v1IndexRecordsTableSchema() && currentSchema != v1IndexRecordsTableSchemaAlternate())
         RELEASE_ASSERT_NOT_REACHED();
 
     SQLiteTransaction transaction(*m_sqliteDB);
     transaction.begin();
 
     // Create a temporary table with the correct schema and migrate all existing content over.
-    if (!m_sqliteDB->executeCommand(v2IndexRecordsTableSchema("_Temp_IndexRecords"))) {
+    if (!m_sqliteDB->executeCommand(v3IndexRecordsTableSchema("_Temp_IndexRecords"))) {
         LOG_ERROR("Could not create temporary index records table in database (%i) - %s", m_sqliteDB->lastError(), m_sqliteDB->lastErrorMsg());
         return false;
     }
 
-    if (!m_sqliteDB->executeCommand("INSERT INTO _Temp_IndexRecords SELECT * FROM IndexRecords")) {
-        LOG_ERROR("Could not migrate existing IndexRecords content (%i) - %s", m_sqliteDB->lastError(), m_sqliteDB->lastErrorMsg());
-        return false;
+    {
+        // Both the index key and the value, which is the primary key of the record, are keys.
+        SQLiteStatement selectStatement(*m_sqliteDB, "SELECT indexID, objectStoreID, key, value FROM IndexRecords;");
+        SQLiteStatement insertStatement(*m_sqliteDB, "INSERT INTO _Temp_IndexRecords VALUES (?, ?, ?, ?);");
+        if (selectStatement.prepare() != SQLITE_OK || insertStatement.prepare() != SQLITE_OK) {
+            LOG_ERROR("Could not prepare statements to migrate existing IndexRecords content (%i) - %s", m_sqliteDB->lastError(), m_sqliteDB->lastErrorMsg());
+            return false;
+        }
+
+        int result = selectStatement.step();
+        for (; result == SQLITE_ROW; result = selectStatement.step()) {
+            Vector<uint8_t> keyBuffer;
+            Vector<uint8_t> valueBuffer;
+            selectStatement.getColumnBlobAsVector(2, keyBuffer);
+            selectStatement.getColumnBlobAsVector(3, valueBuffer);
+
+            RefPtr<SharedBuffer> sortableKeyBuffer = migrateKeyToSortableEncoding(keyBuffer);
+            RefPtr<SharedBuffer> sortableValueBuffer = migrateKeyToSortableEncoding(valueBuffer);
+            if (!sortableKeyBuffer || !sortableValueBuffer) {
+                LOG_ERROR("Unable to deserialize a key while migrating IndexRecords content.");
+                return false;
+            }
+
+            insertStatement.reset();
+            if (insertStatement.bindInt64(1, selectStatement.getColumnInt64(0)) != SQLITE_OK
+                || insertStatement.bindInt64(2, selectStatement.getColumnInt64(1)) != SQLITE_OK
+                || insertStatement.bindBlob(3, sortableKeyBuffer->data(), sortableKeyBuffer->size()) != SQLITE_OK
+                || insertStatement.bindBlob(4, sortableValueBuffer->data(), sortableValueBuffer->size()) != SQLITE_OK
+                || insertStatement.step() != SQLITE_DONE) {
+                LOG_ERROR("Could not migrate existing IndexRecords content (%i) - %s", m_sqliteDB->lastError(), m_sqliteDB->lastErrorMsg());
+                return false;
+            }
+        }
+
+        if (result != SQLITE_DONE) {
+            LOG_ERROR("Could not read existing IndexRecords content (%i) - %s", m_sqliteDB->lastError(), m_sqliteDB->lastErrorMsg());
+            return false;
+        }
     }
 
     if (!m_sqliteDB->executeCommand("DROP TABLE IndexRecords")) {
@@ -578,6 +692,7 @@ IDBError SQLiteIDBBackingStore::getOrEstablishDatabaseInfo(IDBDatabaseInfo& info
     if (!m_sqliteDB)
         return { IDBDatabaseException::UnknownError, ASCIILiteral("Unable to open database file on disk") };
 
+    // Tables from before schema version 3 use the IDBKEY collation, it is needed until they are migrated.
     m_sqliteDB->setCollationFunction("IDBKEY", [](int aLength, const void* a, int bLength, const void* b) {
         return idbKeyCollate(aLength, a, bLength, b);
     });
@@ -936,13 +1051,13 @@ IDBError SQLiteIDBBackingStore::uncheckedHasIndexRecord(const IDBIndexInfo& info
 {
     hasRecord = false;
 
-    RefPtr<SharedBuffer> indexKeyBuffer = serializeIDBKeyData(indexKey);
+    RefPtr<SharedBuffer> indexKeyBuffer = serializeSortableIDBKeyData(indexKey);
     if (!indexKeyBuffer) {
         LOG_ERROR("Unable to serialize index key to be stored in the database");
         return { IDBDatabaseException::UnknownError, ASCIILiteral("Unable to serialize IDBKey to check for index record in database") };
     }
 
-    SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("SELECT rowid FROM IndexRecords WHERE indexID = ? AND objectStoreID = ? AND key = CAST(? AS TEXT);"));
+    SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("SELECT rowid FROM IndexRecords WHERE indexID = ? AND objectStoreID = ? AND key = ?;"));
     if (sql.prepare() != SQLITE_OK
         || sql.bindInt64(1, info.identifier()) != SQLITE_OK
         || sql.bindInt64(2, info.objectStoreIdentifier()) != SQLITE_OK
@@ -1002,20 +1117,20 @@ IDBError SQLiteIDBBackingStore::uncheckedPutIndexRecord(int64_t objectStoreID, i
 {
     LOG(IndexedDB, "SQLiteIDBBackingStore::uncheckedPutIndexRecord - %s, %s", keyValue.loggingString().utf8().data(), indexKey.loggingString().utf8().data());
 
-    RefPtr<SharedBuffer> indexKeyBuffer = serializeIDBKeyData(indexKey);
+    RefPtr<SharedBuffer> indexKeyBuffer = serializeSortableIDBKeyData(indexKey);
     if (!indexKeyBuffer) {
         LOG_ERROR("Unable to serialize index key to be stored in the database");
         return { IDBDatabaseException::UnknownError, ASCIILiteral("Unable to serialize index key to be stored in the database") };
     }
 
-    RefPtr<SharedBuffer> valueBuffer = serializeIDBKeyData(keyValue);
+    RefPtr<SharedBuffer> valueBuffer = serializeSortableIDBKeyData(keyValue);
     if (!valueBuffer) {
         LOG_ERROR("Unable to serialize the value to be stored in the database");
         return { IDBDatabaseException::UnknownError, ASCIILiteral("Unable to serialize value to be stored in the database") };
     }
 
     {
-        SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("INSERT INTO IndexRecords VALUES (?, ?, CAST(? AS TEXT), CAST(? AS TEXT));"));
+        SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("INSERT INTO IndexRecords VALUES (?, ?, ?, ?);"));
         if (sql.prepare() != SQLITE_OK
             || sql.bindInt64(1, indexID) != SQLITE_OK
             || sql.bindInt64(2, objectStoreID) != SQLITE_OK
@@ -1093,12 +1208,12 @@ IDBError SQLiteIDBBackingStore::keyExistsInObjectStore(const IDBResourceIdentifi
         return { IDBDatabaseException::UnknownError, ASCIILiteral("Attempt to see if key exists in objectstore without an in-progress transaction") };
     }
 
-    RefPtr<SharedBuffer> keyBuffer = serializeIDBKeyData(keyData);
+    RefPtr<SharedBuffer> keyBuffer = serializeSortableIDBKeyData(keyData);
     if (!keyBuffer) {
         LOG_ERROR("Unable to serialize IDBKey to check for existence in object store");
         return { IDBDatabaseException::UnknownError, ASCIILiteral("Unable to serialize IDBKey to check for existence in object store") };
     }
-    SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("SELECT key FROM Records WHERE objectStoreID = ? AND key = CAST(? AS TEXT) LIMIT 1;"));
+    SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("SELECT key FROM Records WHERE objectStoreID = ? AND key = ? LIMIT 1;"));
     if (sql.prepare() != SQLITE_OK
         || sql.bindInt64(1, objectStoreID) != SQLITE_OK
         || sql.bindBlob(2, keyBuffer->data(), keyBuffer->size()) != SQLITE_OK) {
@@ -1130,7 +1245,7 @@ IDBError SQLiteIDBBackingStore::deleteRecord(SQLiteIDBTransaction& transaction,
     ASSERT(transaction.mode() != IndexedDB::TransactionMode::ReadOnly);
     UNUSED_PARAM(transaction);
 
-    RefPtr<SharedBuffer> keyBuffer = serializeIDBKeyData(keyData);
+    RefPtr<SharedBuffer> keyBuffer = serializeSortableIDBKeyData(keyData);
     if (!keyBuffer) {
         LOG_ERROR("Unable to serialize IDBKeyData to be removed from the database");
         return { IDBDatabaseException::UnknownError, ASCIILiteral("Unable to serialize IDBKeyData to be removed from the database") };
@@ -1138,7 +1253,7 @@ IDBError SQLiteIDBBackingStore::deleteRecord(SQLiteIDBTransaction& transaction,
 
     // Delete record from object store
     {
-        SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("DELETE FROM Records WHERE objectStoreID = ? AND key = CAST(? AS TEXT);"));
+        SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("DELETE FROM Records WHERE objectStoreID = ? AND key = ?;"));
 
         if (sql.prepare() != SQLITE_OK
             || sql.bindInt64(1, objectStoreID) != SQLITE_OK
@@ -1151,7 +1266,7 @@ IDBError SQLiteIDBBackingStore::deleteRecord(SQLiteIDBTransaction& transaction,
 
     // Delete record from indexes store
     {
-        SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("DELETE FROM IndexRecords WHERE objectStoreID = ? AND value = CAST(? AS TEXT);"));
+        SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("DELETE FROM IndexRecords WHERE objectStoreID = ? AND value = ?;"));
 
         if (sql.prepare() != SQLITE_OK
             || sql.bindInt64(1, objectStoreID) != SQLITE_OK
@@ -1266,9 +1381,9 @@ IDBError SQLiteIDBBackingStore::updateAllIndexesForAddRecord(const IDBObjectStor
     }
 
     if (!error.isNull() && anyRecordsSucceeded) {
-        RefPtr<SharedBuffer> keyBuffer = serializeIDBKeyData(key);
+        RefPtr<SharedBuffer> keyBuffer = serializeSortableIDBKeyData(key);
 
-        SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("DELETE FROM IndexRecords WHERE objectStoreID = ? AND value = CAST(? AS TEXT);"));
+        SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("DELETE FROM IndexRecords WHERE objectStoreID = ? AND value = ?;"));
 
         if (sql.prepare() != SQLITE_OK
             || sql.bindInt64(1, info.identifier()) != SQLITE_OK
@@ -1300,13 +1415,13 @@ IDBError SQLiteIDBBackingStore::addRecord(const IDBResourceIdentifier& transacti
         return { IDBDatabaseException::UnknownError, ASCIILiteral("Attempt to store a record in an object store in a read-only transaction") };
     }
 
-    RefPtr<SharedBuffer> keyBuffer = serializeIDBKeyData(keyData);
+    RefPtr<SharedBuffer> keyBuffer = serializeSortableIDBKeyData(keyData);
     if (!keyBuffer) {
         LOG_ERROR("Unable to serialize IDBKey to be stored in an object store");
         return { IDBDatabaseException::UnknownError, ASCIILiteral("Unable to serialize IDBKey to be stored in an object store") };
     }
     {
-        SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("INSERT INTO Records VALUES (?, CAST(? AS TEXT), ?);"));
+        SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("INSERT INTO Records VALUES (?, ?, ?);"));
         if (sql.prepare() != SQLITE_OK
             || sql.bindInt64(1, objectStoreInfo.identifier()) != SQLITE_OK
             || sql.bindBlob(2, keyBuffer->data(), keyBuffer->size()) != SQLITE_OK
@@ -1320,7 +1435,7 @@ IDBError SQLiteIDBBackingStore::addRecord(const IDBResourceIdentifier& transacti
     auto error = updateAllIndexesForAddRecord(objectStoreInfo, keyData, value);
 
     if (!error.isNull()) {
-        SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("DELETE FROM Records WHERE objectStoreID = ? AND key = CAST(? AS TEXT);"));
+        SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("DELETE FROM Records WHERE objectStoreID = ? AND key = ?;"));
         if (sql.prepare() != SQLITE_OK
             || sql.bindInt64(1, objectStoreInfo.identifier()) != SQLITE_OK
             || sql.bindBlob(2, keyBuffer->data(), keyBuffer->size()) != SQLITE_OK
@@ -1351,7 +1466,7 @@ IDBError SQLiteIDBBackingStore::getRecord(const IDBResourceIdentifier& transacti
     auto key = keyRange.lowerKey;
     if (key.isNull())
         key = IDBKeyData::minimum();
-    RefPtr<SharedBuffer> lowerBuffer = serializeIDBKeyData(key);
+    RefPtr<SharedBuffer> lowerBuffer = serializeSortableIDBKeyData(key);
     if (!lowerBuffer) {
         LOG_ERROR("Unable to serialize lower IDBKey in lookup range");
         return { IDBDatabaseException::UnknownError, ASCIILiteral("Unable to serialize lower IDBKey in lookup range") };
@@ -1360,17 +1475,17 @@ IDBError SQLiteIDBBackingStore::getRecord(const IDBResourceIdentifier& transacti
     key = keyRange.upperKey;
     if (key.isNull())
         key = IDBKeyData::maximum();
-    RefPtr<SharedBuffer> upperBuffer = serializeIDBKeyData(key);
+    RefPtr<SharedBuffer> upperBuffer = serializeSortableIDBKeyData(key);
     if (!upperBuffer) {
         LOG_ERROR("Unable to serialize upper IDBKey in lookup range");
         return { IDBDatabaseException::UnknownError, ASCIILiteral("Unable to serialize upper IDBKey in lookup range") };
     }
 
     {
-        static NeverDestroyed<const ASCIILiteral> lowerOpenUpperOpen("SELECT value FROM Records WHERE objectStoreID = ? AND key > CAST(? AS TEXT) AND key < CAST(? AS TEXT) ORDER BY key;");
-        static NeverDestroyed<const ASCIILiteral> lowerOpenUpperClosed("SELECT value FROM Records WHERE objectStoreID = ? AND key > CAST(? AS TEXT) AND key <= CAST(? AS TEXT) ORDER BY key;");
-        static NeverDestroyed<const ASCIILiteral> lowerClosedUpperOpen("SELECT value FROM Records WHERE objectStoreID = ? AND key >= CAST(? AS TEXT) AND key < CAST(? AS TEXT) ORDER BY key;");
-        static NeverDestroyed<const ASCIILiteral> lowerClosedUpperClosed("SELECT value FROM Records WHERE objectStoreID = ? AND key >= CAST(? AS TEXT) AND key <= CAST(? AS TEXT) ORDER BY key;");
+        static NeverDestroyed<const ASCIILiteral> lowerOpenUpperOpen("SELECT value FROM Records WHERE objectStoreID = ? AND key > ? AND key < ? ORDER BY key;");
+        static NeverDestroyed<const ASCIILiteral> lowerOpenUpperClosed("SELECT value FROM Records WHERE objectStoreID = ? AND key > ? AND key <= ? ORDER BY key;");
+        static NeverDestroyed<const ASCIILiteral> lowerClosedUpperOpen("SELECT value FROM Records WHERE objectStoreID = ? AND key >= ? AND key < ? ORDER BY key;");
+        static NeverDestroyed<const ASCIILiteral> lowerClosedUpperClosed("SELECT value FROM Records WHERE objectStoreID = ? AND key >= ? AND key <= ? ORDER BY key;");
 
         const ASCIILiteral* query = nullptr;
 
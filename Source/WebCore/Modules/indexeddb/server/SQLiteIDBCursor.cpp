@@ -115,13 +115,13 @@ static String buildIndexStatement(const IDBKeyRangeData& keyRange, IndexedDB::Cu
     else
         builder.append('>');
 
-    builder.appendLiteral(" CAST(? AS TEXT) AND key ");
+    builder.appendLiteral(" ? AND key ");
     if (!keyRange.upperKey.isNull() && !keyRange.upperOpen)
         builder.appendLiteral("<=");
     else
         builder.append('<');
 
-    builder.appendLiteral(" CAST(? AS TEXT) ORDER BY key");
+    builder.appendLiteral(" ? ORDER BY key");
     if (cursorDirection == IndexedDB::CursorDirection::Prev || cursorDirection == IndexedDB::CursorDirection::PrevNoDuplicate)
         builder.appendLiteral(" DESC");
 
@@ -145,14 +145,14 @@ static String buildObjectStoreStatement(const IDBKeyRangeData& keyRange, Indexed
     else
         builder.append('>');
 
-    builder.appendLiteral(" CAST(? AS TEXT) AND key ");
+    builder.appendLiteral(" ? AND key ");
 
     if (!keyRange.upperKey.isNull() && !keyRange.upperOpen)
         builder.appendLiteral("<=");
     else
         builder.append('<');
 
-    builder.appendLiteral(" CAST(? AS TEXT) ORDER BY key");
+    builder.appendLiteral(" ? ORDER BY key");
 
     if (cursorDirection == IndexedDB::CursorDirection::Prev || cursorDirection == IndexedDB::CursorDirection::PrevNoDuplicate)
         builder.appendLiteral(" DESC");
@@ -269,13 +269,13 @@ bool SQLiteIDBCursor::bindArguments()
         return false;
     }
 
-    RefPtr<SharedBuffer> buffer = serializeIDBKeyData(m_currentLowerKey);
+    RefPtr<SharedBuffer> buffer = serializeSortableIDBKeyData(m_currentLowerKey);
     if (m_statement->bindBlob(currentBindArgument++, buffer->data(), buffer->size()) != SQLITE_OK) {
         LOG_ERROR("Could not create cursor statement (lower key)");
         return false;
     }
 
-    buffer = serializeIDBKeyData(m_currentUpperKey);
+    buffer = serializeSortableIDBKeyData(m_currentUpperKey);
     if (m_statement->bindBlob(currentBindArgument++, buffer->data(), buffer->size()) != SQLITE_OK) {
         LOG_ERROR("Could not create cursor statement (upper key)");
         return false;
@@ -366,7 +366,7 @@ SQLiteIDBCursor::AdvanceResult SQLiteIDBCursor::internalAdvanceOnce()
     Vector<uint8_t> keyData;
     m_statement->getColumnBlobAsVector(1, keyData);
 
-    if (!deserializeIDBKeyData(keyData.data(), keyData.size(), m_currentKey)) {
+    if (!deserializeSortableIDBKeyData(keyData.data(), keyData.size(), m_currentKey)) {
         LOG_ERROR("Unable to deserialize key data from database while advancing cursor");
         m_completed = true;
         m_errored = true;
@@ -380,14 +380,14 @@ SQLiteIDBCursor::AdvanceResult SQLiteIDBCursor::internalAdvanceOnce()
     if (m_indexID == IDBIndexInfo::InvalidId)
         m_currentPrimaryKey = m_currentKey;
     else {
-        if (!deserializeIDBKeyData(keyData.data(), keyData.size(), m_currentPrimaryKey)) {
+        if (!deserializeSortableIDBKeyData(keyData.data(), keyData.size(), m_currentPrimaryKey)) {
             LOG_ERROR("Unable to deserialize value data from database while advancing index cursor");
             m_completed = true;
             m_errored = true;
             return AdvanceResult::Failure;
         }
 
-        SQLiteStatement objectStoreStatement(m_statement->database(), "SELECT value FROM Records WHERE key = CAST(? AS TEXT) and objectStoreID = ?;");
+        SQLiteStatement objectStoreStatement(m_statement->database(), "SELECT value FROM Records WHERE key = ? and objectStoreID = ?;");
 
         if (objectStoreStatement.prepare() != SQLITE_OK
             || objectStoreStatement.bindBlob(1, m_currentValueBuffer.data(), m_currentValueBuffer.size()) != SQLITE_OK
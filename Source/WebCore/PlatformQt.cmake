@@ -83,6 +83,7 @@ list(APPEND WebCore_SOURCES
     platform/graphics/texmap/TextureMapperImageBuffer.cpp
 
     platform/graphics/qt/ColorQt.cpp
+    platform/graphics/qt/ComplexTextLayoutCacheQt.cpp
     platform/graphics/qt/FloatPointQt.cpp
     platform/graphics/qt/FloatRectQt.cpp
     platform/graphics/qt/FloatSizeQt.cpp
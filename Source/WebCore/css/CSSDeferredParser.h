@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CSSDeferredParser_h
+#define CSSDeferredParser_h
+
+#include "CSSParserMode.h"
+#include <wtf/RefCounted.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+
+class ImmutableStyleProperties;
+
+// The text of a style sheet whose style rule declaration blocks were skipped by CSSParser, so that
+// each StyleRule can parse its own block the first time its properties are needed.
+class CSSDeferredParser : public RefCounted<CSSDeferredParser> {
+public:
+    static Ref<CSSDeferredParser> create(const CSSParserContext& context, const String& sheetText)
+    {
+        return adoptRef(*new CSSDeferredParser(context, sheetText));
+    }
+
+    const String& sheetText() const { return m_sheetText; }
+
+    Ref<ImmutableStyleProperties> parseDeclarationBlock(unsigned offset, unsigned length) const;
+
+private:
+    CSSDeferredParser(const CSSParserContext&, const String& sheetText);
+
+    CSSParserContext m_context;
+    String m_sheetText;
+};
+
+} // namespace WebCore
+
+#endif // CSSDeferredParser_h
@@ -250,6 +250,7 @@ CSSParserContext::CSSParserContext(CSSParserMode mode, const URL& baseURL)
     , needsSiteSpecificQuirks(false)
     , enforcesCSSMIMETypeInNoQuirksMode(true)
     , useLegacyBackgroundSizeShorthandBehavior(false)
+    , isDeferredCSSParserEnabled(false)
 {
 #if PLATFORM(IOS)
     // FIXME: Force the site specific quirk below to work on iOS. Investigating other site specific quirks
@@ -269,6 +270,7 @@ CSSParserContext::CSSParserContext(Document& document, const URL& baseURL, const
     , needsSiteSpecificQuirks(document.settings() ? document.settings()->needsSiteSpecificQuirks() : false)
     , enforcesCSSMIMETypeInNoQuirksMode(!document.settings() || document.settings()->enforceCSSMIMETypeInNoQuirksMode())
     , useLegacyBackgroundSizeShorthandBehavior(document.settings() ? document.settings()->useLegacyBackgroundSizeShorthandBehavior() : false)
+    , isDeferredCSSParserEnabled(document.settings() ? document.settings()->deferredCSSParserEnabled() : false)
 {
 #if PLATFORM(IOS)
     // FIXME: Force the site specific quirk below to work on iOS. Investigating other site specific quirks
@@ -288,7 +290,8 @@ bool operator==(const CSSParserContext& a, const CSSParserContext& b)
         && a.isCSSCompositingEnabled == b.isCSSCompositingEnabled
         && a.needsSiteSpecificQuirks == b.needsSiteSpecificQuirks
         && a.enforcesCSSMIMETypeInNoQuirksMode == b.enforcesCSSMIMETypeInNoQuirksMode
-        && a.useLegacyBackgroundSizeShorthandBehavior == b.useLegacyBackgroundSizeShorthandBehavior;
+        && a.useLegacyBackgroundSizeShorthandBehavior == b.useLegacyBackgroundSizeShorthandBehavior
+        && a.isDeferredCSSParserEnabled == b.isDeferredCSSParserEnabled;
 }
 
 CSSParser::CSSParser(const CSSParserContext& context)
@@ -310,6 +313,9 @@ CSSParser::CSSParser(const CSSParserContext& context)
     , m_nestedSelectorLevel(0)
     , m_propertyRange(UINT_MAX, UINT_MAX)
     , m_ruleSourceDataResult(nullptr)
+    , m_hasDeferredDeclarationBlock(false)
+    , m_deferredDeclarationBlockOffset(0)
+    , m_deferredDeclarationBlockLength(0)
     , m_parsingMode(NormalMode)
     , m_is8BitSource(false)
     , m_currentCharacter8(nullptr)
@@ -419,9 +425,13 @@ void CSSParser::parseSheet(StyleSheetContents* sheet, const String& string, cons
     m_sheetStartColumnNumber = textPosition.m_column.zeroBasedInt();
     m_lineNumber = m_sheetStartLineNumber;
     m_columnOffsetForLine = 0;
+    // The inspector needs the source ranges of every property, so it only gets fully parsed sheets.
+    if (m_context.isDeferredCSSParserEnabled && !ruleSourceDataResult)
+        m_deferredParser = CSSDeferredParser::create(m_context, string);
     setupParser("", string, "");
     cssyyparse(this);
     sheet->shrinkToFit();
+    m_deferredParser = nullptr;
     m_currentRuleDataStack.reset();
     m_ruleSourceDataResult = nullptr;
     m_rule = nullptr;
@@ -12913,11 +12923,15 @@ RefPtr<StyleRuleBase> CSSParser::createStyleRule(Vector<std::unique_ptr<CSSParse
     if (selectors) {
         m_allowImportRules = false;
         m_allowNamespaceDeclarations = false;
-        rule = StyleRule::create(m_lastSelectorLineNumber, createStyleProperties());
+        if (m_hasDeferredDeclarationBlock)
+            rule = StyleRule::create(m_lastSelectorLineNumber, *m_deferredParser, m_deferredDeclarationBlockOffset, m_deferredDeclarationBlockLength);
+        else
+            rule = StyleRule::create(m_lastSelectorLineNumber, createStyleProperties());
         rule->parserAdoptSelectorVector(*selectors);
         processAndAddNewRuleToSourceTreeIfNeeded();
     } else
         popRuleData();
+    m_hasDeferredDeclarationBlock = false;
     clearProperties();
     return rule;
 }
@@ -13270,6 +13284,138 @@ void CSSParser::markRuleBodyStart()
     m_currentRuleDataStack->last()->ruleBodyRange.start = offset;
 }
 
+template <typename CharacterType>
+static inline bool startsWithLettersIgnoringASCIICase(const CharacterType* characters, const char* lowercaseLetters)
+{
+    // The characters are null terminated, so the first mismatch stops the loop at the latest.
+    for (; *lowercaseLetters; ++characters, ++lowercaseLetters) {
+        if (toASCIILower(*characters) != *lowercaseLetters)
+            return false;
+    }
+    return true;
+}
+
+// Returns the offset of the '}' that closes the declaration block starting at the given characters, or notFound
+// when the block is not plain enough to be sure the grammar would close it at the same place, or when parsing it
+// has side effects on the style sheet. Such blocks are parsed right away.
+template <typename CharacterType>
+static size_t findEndOfDeferrableDeclarationBlock(const CharacterType* characters, bool& usesRemUnits)
+{
+    Vector<CharacterType, 8> closingBrackets;
+    for (size_t i = 0; ; ++i) {
+        CharacterType character = characters[i];
+        switch (character) {
+        case '\0':
+        case '{':
+        case '@':
+        case '\\':
+            return notFound;
+        case '}':
+            return closingBrackets.isEmpty() ? i : notFound;
+        case '(':
+            closingBrackets.append(')');
+            break;
+        case '[':
+            closingBrackets.append(']');
+            break;
+        case ')':
+        case ']':
+            if (closingBrackets.isEmpty() || closingBrackets.last() != character)
+                return notFound;
+            closingBrackets.removeLast();
+            break;
+        case '"':
+        case '\'':
+            for (++i; characters[i] != character; ++i) {
+                if (characters[i] == '\\')
+                    ++i;
+                if (!characters[i] || characters[i] == '\n' || characters[i] == '\r' || characters[i] == '\f')
+                    return notFound;
+            }
+            break;
+        case '/':
+            if (characters[i + 1] != '*')
+                break;
+            for (i += 2; characters[i] != '*' || characters[i + 1] != '/'; ++i) {
+                if (!characters[i])
+                    return notFound;
+            }
+            ++i;
+            break;
+        case 'r':
+        case 'R':
+            // Parsing a rem length marks the style sheet, which has to happen now.
+            if (i && isASCIIDigit(characters[i - 1]) && startsWithLettersIgnoringASCIICase(characters + i, "rem"))
+                usesRemUnits = true;
+            break;
+        case 'u':
+        case 'U':
+            // So does parsing -webkit-user-modify.
+            if (startsWithLettersIgnoringASCIICase(characters + i, "user-modify"))
+                return notFound;
+            // The contents of an unquoted url() are not tokenized.
+            if (startsWithLettersIgnoringASCIICase(characters + i, "url(")) {
+                size_t end = i + 4;
+                while (isHTMLSpace(characters[end]))
+                    ++end;
+                if (characters[end] == '"' || characters[end] == '\'')
+                    break;
+                for (; characters[end] != ')'; ++end) {
+                    if (!characters[end] || characters[end] == '\\')
+                        return notFound;
+                }
+                i = end;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+template <typename CharacterType>
+static inline void advancePastLineBreaks(const CharacterType* characters, size_t length, unsigned startOffset, int& lineNumber, int& columnOffsetForLine)
+{
+    for (size_t i = 0; i < length; ++i) {
+        if (characters[i] == '\n') {
+            ++lineNumber;
+            columnOffsetForLine = startOffset + i + 1;
+        }
+    }
+}
+
+void CSSParser::deferDeclarationBlockIfPossible()
+{
+    ASSERT(!m_hasDeferredDeclarationBlock);
+    if (!m_deferredParser)
+        return;
+
+    unsigned startOffset = currentCharacterOffset();
+    bool usesRemUnits = false;
+    size_t length;
+    if (is8BitSource()) {
+        length = findEndOfDeferrableDeclarationBlock(currentCharacter<LChar>(), usesRemUnits);
+        if (length == notFound)
+            return;
+        advancePastLineBreaks(currentCharacter<LChar>(), length, startOffset, m_lineNumber, m_columnOffsetForLine);
+        currentCharacter<LChar>() += length;
+    } else {
+        length = findEndOfDeferrableDeclarationBlock(currentCharacter<UChar>(), usesRemUnits);
+        if (length == notFound)
+            return;
+        advancePastLineBreaks(currentCharacter<UChar>(), length, startOffset, m_lineNumber, m_columnOffsetForLine);
+        currentCharacter<UChar>() += length;
+    }
+
+    if (usesRemUnits && m_styleSheet)
+        m_styleSheet->parserSetUsesRemUnits();
+
+    // The lexer continues with the closing brace, leaving an empty declaration list to the grammar.
+    m_hasDeferredDeclarationBlock = true;
+    m_deferredDeclarationBlockOffset = startOffset - m_parsedTextPrefixLength;
+    m_deferredDeclarationBlockLength = length;
+}
+
 void CSSParser::markRuleBodyEnd()
 {
     // Precondition: (!isExtractingSourceData())
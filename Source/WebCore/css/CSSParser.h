@@ -24,6 +24,7 @@
 #define CSSParser_h
 
 #include "CSSCalculationValue.h"
+#include "CSSDeferredParser.h"
 #include "CSSGradientValue.h"
 #include "CSSParserMode.h"
 #include "CSSParserValues.h"
@@ -129,6 +130,7 @@ public:
     RefPtr<CSSPrimitiveValue> parseValidPrimitive(CSSValueID ident, ValueWithCalculation&);
 
     WEBCORE_EXPORT bool parseDeclaration(MutableStyleProperties*, const String&, PassRefPtr<CSSRuleSourceData>, StyleSheetContents* contextStyleSheet);
+    Ref<ImmutableStyleProperties> parseDeclaration(const String&, StyleSheetContents* contextStyleSheet);
     static Ref<ImmutableStyleProperties> parseInlineStyleDeclaration(const String&, Element*);
     std::unique_ptr<MediaQuery> parseMediaQuery(const String&);
 
@@ -434,6 +436,12 @@ public:
     RefPtr<CSSRuleSourceData> m_currentRuleData;
     RuleSourceDataList* m_ruleSourceDataResult;
 
+    // Set while parsing a style sheet whose style rule declaration blocks are parsed on first use.
+    RefPtr<CSSDeferredParser> m_deferredParser;
+    bool m_hasDeferredDeclarationBlock;
+    unsigned m_deferredDeclarationBlockOffset;
+    unsigned m_deferredDeclarationBlockLength;
+
     void fixUnparsedPropertyRanges(CSSRuleSourceData*);
     void markRuleHeaderStart(CSSRuleSourceData::Type);
     void markRuleHeaderEnd();
@@ -445,6 +453,7 @@ public:
 
     void markRuleBodyStart();
     void markRuleBodyEnd();
+    void deferDeclarationBlockIfPossible();
     void markPropertyStart();
     void markPropertyEnd(bool isImportantFound, bool isPropertyParsed);
     void processAndAddNewRuleToSourceTreeIfNeeded();
@@ -570,7 +579,6 @@ private:
     bool parseGeneratedImage(CSSParserValueList&, RefPtr<CSSValue>&);
 
     ParseResult parseValue(MutableStyleProperties*, CSSPropertyID, const String&, bool important, StyleSheetContents* contextStyleSheet);
-    Ref<ImmutableStyleProperties> parseDeclaration(const String&, StyleSheetContents* contextStyleSheet);
 
     RefPtr<CSSBasicShape> parseInsetRoundedCorners(PassRefPtr<CSSBasicShapeInset>, CSSParserValueList&);
 
@@ -458,8 +458,10 @@ void ElementRuleCollector::collectMatchingRulesForList(const RuleSet::RuleDataVe
         StyleRule* rule = ruleData.rule();
 
         // If the rule has no properties to apply, then ignore it in the non-debug mode.
-        const StyleProperties& properties = rule->properties();
-        if (properties.isEmpty() && !matchRequest.includeEmptyRules)
+        // A declaration block that hasn't been parsed yet is only checked once the rule matches,
+        // so that rules that never match are never parsed.
+        const StyleProperties* properties = rule->propertiesWithoutDeferredParsing();
+        if (properties && properties->isEmpty() && !matchRequest.includeEmptyRules)
             continue;
 
         // FIXME: Exposing the non-standard getMatchedCSSRules API to web is the only reason this is needed.
@@ -468,6 +470,9 @@ void ElementRuleCollector::collectMatchingRulesForList(const RuleSet::RuleDataVe
 
         unsigned specificity;
         if (ruleMatches(ruleData, specificity)) {
+            if (!properties && rule->properties().isEmpty() && !matchRequest.includeEmptyRules)
+                continue;
+
             // Update our first/last rule indices in the matched rules array.
             ++ruleRange.lastRuleIndex;
             if (ruleRange.firstRuleIndex == -1)
@@ -23,6 +23,7 @@
 #include "StyleRule.h"
 
 #include "CSSCharsetRule.h"
+#include "CSSDeferredParser.h"
 #include "CSSFontFaceRule.h"
 #include "CSSImportRule.h"
 #include "CSSKeyframeRule.h"
@@ -201,10 +202,21 @@ StyleRule::StyleRule(int sourceLine, Ref<StyleProperties>&& properties)
 {
 }
 
+StyleRule::StyleRule(int sourceLine, CSSDeferredParser& deferredParser, unsigned declarationBlockOffset, unsigned declarationBlockLength)
+    : StyleRuleBase(Style, sourceLine)
+    , m_deferredParser(&deferredParser)
+    , m_declarationBlockOffset(declarationBlockOffset)
+    , m_declarationBlockLength(declarationBlockLength)
+{
+}
+
 StyleRule::StyleRule(const StyleRule& o)
     : StyleRuleBase(o)
-    , m_properties(o.m_properties->mutableCopy())
+    , m_properties(o.m_properties ? RefPtr<StyleProperties>(o.m_properties->mutableCopy()) : nullptr)
     , m_selectorList(o.m_selectorList)
+    , m_deferredParser(o.m_deferredParser)
+    , m_declarationBlockOffset(o.m_declarationBlockOffset)
+    , m_declarationBlockLength(o.m_declarationBlockLength)
 {
 }
 
@@ -212,11 +224,20 @@ StyleRule::~StyleRule()
 {
 }
 
+void StyleRule::parseDeferredDeclarationBlock() const
+{
+    ASSERT(!m_properties);
+    ASSERT(m_deferredParser);
+    m_properties = m_deferredParser->parseDeclarationBlock(m_declarationBlockOffset, m_declarationBlockLength);
+    // Let go of the style sheet text once the last deferred rule is parsed.
+    m_deferredParser = nullptr;
+}
+
 MutableStyleProperties& StyleRule::mutableProperties()
 {
-    if (!is<MutableStyleProperties>(m_properties.get()))
+    if (!is<MutableStyleProperties>(properties()))
         m_properties = m_properties->mutableCopy();
-    return downcast<MutableStyleProperties>(m_properties.get());
+    return downcast<MutableStyleProperties>(*m_properties);
 }
 
 Ref<StyleRule> StyleRule::create(int sourceLine, const Vector<const CSSSelector*>& selectors, Ref<StyleProperties>&& properties)
@@ -244,7 +265,7 @@ Vector<RefPtr<StyleRule>> StyleRule::splitIntoMultipleRulesWithMaximumSelectorCo
             componentsInThisSelector.append(component);
 
         if (componentsInThisSelector.size() + componentsSinceLastSplit.size() > maxCount && !componentsSinceLastSplit.isEmpty()) {
-            rules.append(create(sourceLine(), componentsSinceLastSplit, const_cast<StyleProperties&>(m_properties.get())));
+            rules.append(create(sourceLine(), componentsSinceLastSplit, const_cast<StyleProperties&>(properties())));
             componentsSinceLastSplit.clear();
         }
 
@@ -252,7 +273,7 @@ Vector<RefPtr<StyleRule>> StyleRule::splitIntoMultipleRulesWithMaximumSelectorCo
     }
 
     if (!componentsSinceLastSplit.isEmpty())
-        rules.append(create(sourceLine(), componentsSinceLastSplit, const_cast<StyleProperties&>(m_properties.get())));
+        rules.append(create(sourceLine(), componentsSinceLastSplit, const_cast<StyleProperties&>(properties())));
 
     return rules;
 }
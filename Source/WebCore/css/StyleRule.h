@@ -30,6 +30,7 @@
 
 namespace WebCore {
 
+class CSSDeferredParser;
 class CSSRule;
 class CSSStyleRule;
 class CSSStyleSheet;
@@ -107,12 +108,21 @@ public:
     {
         return adoptRef(*new StyleRule(sourceLine, WTFMove(properties)));
     }
+
+    // The declaration block is at the given range of the style sheet text, and is parsed on first use.
+    static Ref<StyleRule> create(int sourceLine, CSSDeferredParser& deferredParser, unsigned declarationBlockOffset, unsigned declarationBlockLength)
+    {
+        return adoptRef(*new StyleRule(sourceLine, deferredParser, declarationBlockOffset, declarationBlockLength));
+    }
     
     ~StyleRule();
 
     const CSSSelectorList& selectorList() const { return m_selectorList; }
-    const StyleProperties& properties() const { return m_properties; }
+    const StyleProperties& properties() const;
     MutableStyleProperties& mutableProperties();
+
+    // Null as long as the declaration block hasn't been parsed.
+    const StyleProperties* propertiesWithoutDeferredParsing() const { return m_properties.get(); }
     
     void parserAdoptSelectorVector(Vector<std::unique_ptr<CSSParserSelector>>& selectors) { m_selectorList.adoptSelectorVector(selectors); }
     void wrapperAdoptSelectorList(CSSSelectorList& selectors) { m_selectorList = WTFMove(selectors); }
@@ -126,14 +136,28 @@ public:
 
 private:
     StyleRule(int sourceLine, Ref<StyleProperties>&&);
+    StyleRule(int sourceLine, CSSDeferredParser&, unsigned declarationBlockOffset, unsigned declarationBlockLength);
     StyleRule(const StyleRule&);
 
     static Ref<StyleRule> create(int sourceLine, const Vector<const CSSSelector*>&, Ref<StyleProperties>&&);
 
-    Ref<StyleProperties> m_properties;
+    void parseDeferredDeclarationBlock() const;
+
+    mutable RefPtr<StyleProperties> m_properties;
     CSSSelectorList m_selectorList;
+
+    mutable RefPtr<CSSDeferredParser> m_deferredParser;
+    unsigned m_declarationBlockOffset { 0 };
+    unsigned m_declarationBlockLength { 0 };
 };
 
+inline const StyleProperties& StyleRule::properties() const
+{
+    if (!m_properties)
+        parseDeferredDeclarationBlock();
+    return *m_properties;
+}
+
 class StyleRuleFontFace : public StyleRuleBase {
 public:
     static Ref<StyleRuleFontFace> create(Ref<StyleProperties>&& properties) { return adoptRef(*new StyleRuleFontFace(WTFMove(properties))); }
@@ -439,10 +439,13 @@ static bool traverseSubresourcesInRules(const Vector<RefPtr<StyleRuleBase>>& rul
 {
     for (auto& rule : rules) {
         switch (rule->type()) {
-        case StyleRuleBase::Style:
-            if (downcast<StyleRule>(*rule).properties().traverseSubresources(handler))
+        case StyleRuleBase::Style: {
+            // A rule that hasn't been parsed yet has not loaded anything either.
+            auto* properties = downcast<StyleRule>(*rule).propertiesWithoutDeferredParsing();
+            if (properties && properties->traverseSubresources(handler))
                 return true;
             break;
+        }
         case StyleRuleBase::FontFace:
             if (downcast<StyleRuleFontFace>(*rule).properties().traverseSubresources(handler))
                 return true;
@@ -93,12 +93,19 @@ struct DisplayListDrawingContext {
     DisplayList::Recorder recorder;
     DisplayList::DisplayList displayList;
     
-    DisplayListDrawingContext(const FloatRect& clip)
+    DisplayListDrawingContext(const FloatRect& clip, DisplayList::DisplayList::StorageMode storageMode)
         : recorder(context, displayList, clip, AffineTransform())
+        , displayList(storageMode)
     {
     }
 };
 
+static DisplayList::DisplayList::StorageMode displayListStorageMode(bool tracksDisplayListReplay)
+{
+    // Tracking replay shares recorded items with the replay list, which requires ref-counted items.
+    return tracksDisplayListReplay ? DisplayList::DisplayList::StorageMode::RefCountedItems : DisplayList::DisplayList::StorageMode::Arena;
+}
+
 typedef HashMap<const CanvasRenderingContext2D*, std::unique_ptr<DisplayList::DisplayList>> ContextDisplayListHashMap;
 
 static ContextDisplayListHashMap& contextDisplayListMap()
@@ -1463,6 +1470,9 @@ void CanvasRenderingContext2D::drawImage(HTMLImageElement* imageElement, const F
     if (!cachedImage)
         return;
 
+    // The canvas can read back what is drawn, so it gets the image at full size.
+    cachedImage->requireFullSizeDecode();
+
     Image* image = cachedImage->imageForRenderer(imageElement->renderer());
     if (!image)
         return;
@@ -1860,6 +1870,8 @@ RefPtr<CanvasPattern> CanvasRenderingContext2D::createPattern(HTMLImageElement*
         return nullptr;
     }
 
+    cachedImage->requireFullSizeDecode();
+
     if (!imageElement->cachedImage()->imageForRenderer(imageElement->renderer()))
         return CanvasPattern::create(Image::nullImage(), repeatX, repeatY, true);
 
@@ -1954,6 +1966,22 @@ void CanvasRenderingContext2D::setTracksDisplayListReplay(bool tracksDisplayList
     m_tracksDisplayListReplay = tracksDisplayListReplay;
     if (!m_tracksDisplayListReplay)
         contextDisplayListMap().remove(this);
+
+    if (!m_recordingContext)
+        return;
+
+    if (!m_recordingContext->displayList.itemCount()) {
+        m_recordingContext->displayList = DisplayList::DisplayList(displayListStorageMode(m_tracksDisplayListReplay));
+        return;
+    }
+
+    // Ref-counted items can be replayed without tracking, so only arena items need converting.
+    if (!m_tracksDisplayListReplay || m_recordingContext->displayList.storageMode() == DisplayList::DisplayList::StorageMode::RefCountedItems)
+        return;
+
+    // Arena items cannot be shared with a replay list. Re-recording them keeps the canvas state, including
+    // state changes not yet written to the list.
+    m_recordingContext->recorder.convertToRefCountedItems();
 }
 
 String CanvasRenderingContext2D::displayListAsText(DisplayList::AsTextFlags flags) const
@@ -1999,7 +2027,7 @@ GraphicsContext* CanvasRenderingContext2D::drawingContext() const
 {
     if (UNLIKELY(m_usesDisplayListDrawing)) {
         if (!m_recordingContext)
-            m_recordingContext = std::make_unique<DisplayListDrawingContext>(FloatRect(FloatPoint::zero(), canvas()->size()));
+            m_recordingContext = std::make_unique<DisplayListDrawingContext>(FloatRect(FloatPoint::zero(), canvas()->size()), displayListStorageMode(m_tracksDisplayListReplay));
 
         return &m_recordingContext->context;
     }
@@ -256,6 +256,10 @@ void CanvasStyle::applyStrokeColor(GraphicsContext* context) const
 #if USE(CG)
         CGContextSetCMYKStrokeColor(context->platformContext(), m_cmyka->c, m_cmyka->m, m_cmyka->y, m_cmyka->k, m_cmyka->a);
 #elif PLATFORM(QT)
+        if (context->isRecording()) {
+            context->setStrokeColor(m_cmyka->rgba);
+            break;
+        }
         QPen currentPen = context->platformContext()->pen();
         QColor clr;
         clr.setCmykF(m_cmyka->c, m_cmyka->m, m_cmyka->y, m_cmyka->k, m_cmyka->a);
@@ -294,6 +298,10 @@ void CanvasStyle::applyFillColor(GraphicsContext* context) const
 #if USE(CG)
         CGContextSetCMYKFillColor(context->platformContext(), m_cmyka->c, m_cmyka->m, m_cmyka->y, m_cmyka->k, m_cmyka->a);
 #elif PLATFORM(QT)
+        if (context->isRecording()) {
+            context->setFillColor(m_cmyka->rgba);
+            break;
+        }
         QBrush currentBrush = context->platformContext()->brush();
         QColor clr;
         clr.setCmykF(m_cmyka->c, m_cmyka->m, m_cmyka->y, m_cmyka->k, m_cmyka->a);
@@ -1418,6 +1418,7 @@ void WebGL2RenderingContext::texSubImage2D(GC3Denum target, GC3Dint level, GC3Di
     if (isContextLostOrPending() || !validateHTMLImageElement("texSubImage2D", image, ec))
         return;
     
+    image->cachedImage()->requireFullSizeDecode();
     RefPtr<Image> imageForRender = image->cachedImage()->imageForRenderer(image->renderer());
     if (!imageForRender)
         return;
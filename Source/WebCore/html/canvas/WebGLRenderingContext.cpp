@@ -626,6 +626,7 @@ void WebGLRenderingContext::texSubImage2D(GC3Denum target, GC3Dint level, GC3Din
     if (isContextLostOrPending() || !validateHTMLImageElement("texSubImage2D", image, ec))
         return;
     
+    image->cachedImage()->requireFullSizeDecode();
     RefPtr<Image> imageForRender = image->cachedImage()->imageForRenderer(image->renderer());
     if (!imageForRender)
         return;
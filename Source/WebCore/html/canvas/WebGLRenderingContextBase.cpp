@@ -3187,6 +3187,7 @@ void WebGLRenderingContextBase::texImage2D(GC3Denum target, GC3Dint level, GC3De
     if (isContextLostOrPending() || !validateHTMLImageElement("texImage2D", image, ec))
         return;
 
+    image->cachedImage()->requireFullSizeDecode();
     RefPtr<Image> imageForRender = image->cachedImage()->imageForRenderer(image->renderer());
     if (!imageForRender)
         return;
@@ -27,6 +27,7 @@
 #ifndef AtomicHTMLToken_h
 #define AtomicHTMLToken_h
 
+#include "CompactHTMLToken.h"
 #include "HTMLToken.h"
 
 namespace WebCore {
@@ -34,6 +35,7 @@ namespace WebCore {
 class AtomicHTMLToken {
 public:
     explicit AtomicHTMLToken(HTMLToken&);
+    explicit AtomicHTMLToken(CompactHTMLToken&);
     AtomicHTMLToken(HTMLToken::Type, const AtomicString& name, Vector<Attribute>&& = Vector<Attribute>()); // Only StartTag or EndTag.
 
     HTMLToken::Type type() const;
@@ -77,7 +79,7 @@ private:
     String m_data; // Comment
 
     // We don't want to copy the the characters out of the HTMLToken, so we keep a pointer to its buffer instead.
-    // This buffer is owned by the HTMLToken and causes a lifetime dependence between these objects.
+    // This buffer is owned by the HTMLToken (or CompactHTMLToken) and causes a lifetime dependence between these objects.
     // FIXME: Add a mechanism for "internalizing" the characters when the HTMLToken is destroyed.
     const UChar* m_externalCharacters; // Character
     unsigned m_externalCharactersLength; // Character
@@ -232,6 +234,40 @@ inline AtomicHTMLToken::AtomicHTMLToken(HTMLToken& token)
     ASSERT_NOT_REACHED();
 }
 
+inline AtomicHTMLToken::AtomicHTMLToken(CompactHTMLToken& token)
+    : m_type(token.type())
+{
+    switch (m_type) {
+    case HTMLToken::Uninitialized:
+        ASSERT_NOT_REACHED();
+        return;
+    case HTMLToken::DOCTYPE:
+        m_name = AtomicString(token.name());
+        m_doctypeData = token.releaseDoctypeData();
+        return;
+    case HTMLToken::EndOfFile:
+        return;
+    case HTMLToken::StartTag:
+    case HTMLToken::EndTag:
+        m_selfClosing = token.selfClosing();
+        m_name = AtomicString(token.name());
+        // CompactHTMLToken has already dropped the attributes AtomicHTMLToken(HTMLToken&) would drop.
+        m_attributes.reserveInitialCapacity(token.attributes().size());
+        for (auto& attribute : token.attributes())
+            m_attributes.uncheckedAppend(Attribute(QualifiedName(nullAtom, AtomicString(attribute.name), nullAtom), AtomicString(attribute.value)));
+        return;
+    case HTMLToken::Comment:
+        m_data = token.comment();
+        return;
+    case HTMLToken::Character:
+        m_externalCharacters = token.characters().characters16();
+        m_externalCharactersLength = token.characters().length();
+        m_externalCharactersIsAll8BitData = token.charactersIsAll8BitData();
+        return;
+    }
+    ASSERT_NOT_REACHED();
+}
+
 inline AtomicHTMLToken::AtomicHTMLToken(HTMLToken::Type type, const AtomicString& name, Vector<Attribute>&& attributes)
     : m_type(type)
     , m_name(name)
@@ -0,0 +1,312 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "BackgroundHTMLParser.h"
+
+#include "HTMLDocumentParser.h"
+#include <wtf/MainThread.h>
+#include <wtf/WorkQueue.h>
+
+namespace WebCore {
+
+// Large enough that handing tokens over is cheap compared to tokenizing them, small enough that
+// the main thread can start building the tree early.
+static const size_t maximumTokensPerDelivery = 1000;
+
+static WorkQueue& parserQueue()
+{
+    static auto& queue = WorkQueue::create("org.webkit.HTMLParser").leakRef();
+    return queue;
+}
+
+// A rough model of how HTMLTreeBuilder drives the tokenizer. It can't use HTMLNames, whose atoms belong
+// to the main thread, and doesn't know about the DOM, so it only tracks whether we are in foreign content
+// and in one of the elements the tokenizer treats as text. Mistakes are caught by HTMLDocumentParser.
+class BackgroundHTMLParser::TreeBuilderSimulator {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    explicit TreeBuilderSimulator(const HTMLParserOptions& options)
+        : m_options(options)
+    {
+        m_namespaceStack.append(HTML);
+    }
+
+    void simulate(const CompactHTMLToken&, HTMLTokenizer&);
+
+private:
+    enum Namespace { HTML, SVG, MathML };
+
+    bool inForeignContent() const { return m_namespaceStack.last() != HTML; }
+
+    static bool tokenExitsForeignContent(const CompactHTMLToken&);
+    static bool tokenExitsSVG(const String& tagName);
+    static bool tokenExitsMath(const String& tagName);
+
+    void switchTokenizerState(const CompactHTMLToken&, HTMLTokenizer&);
+
+    const HTMLParserOptions m_options;
+    Vector<Namespace, 1> m_namespaceStack;
+    bool m_inTextElement { false };
+};
+
+static bool hasAttributeNamed(const CompactHTMLToken& token, const char* name)
+{
+    for (auto& attribute : token.attributes()) {
+        if (attribute.name == name)
+            return true;
+    }
+    return false;
+}
+
+bool BackgroundHTMLParser::TreeBuilderSimulator::tokenExitsForeignContent(const CompactHTMLToken& token)
+{
+    // See the first step of HTMLTreeBuilder::processTokenInForeignContent() for start tags.
+    static const char* const tagNames[] = {
+        "b", "big", "blockquote", "body", "br", "center", "code", "dd", "div", "dl", "dt", "em", "embed",
+        "h1", "h2", "h3", "h4", "h5", "h6", "head", "hr", "i", "img", "li", "listing", "menu", "meta", "nobr",
+        "ol", "p", "pre", "ruby", "s", "small", "span", "strong", "strike", "sub", "sup", "table", "tt", "u",
+        "ul", "var"
+    };
+
+    const String& tagName = token.name();
+    for (auto* name : tagNames) {
+        if (tagName == name)
+            return true;
+    }
+    return tagName == "font" && (hasAttributeNamed(token, "color") || hasAttributeNamed(token, "face") || hasAttributeNamed(token, "size"));
+}
+
+bool BackgroundHTMLParser::TreeBuilderSimulator::tokenExitsSVG(const String& tagName)
+{
+    // HTML integration points, see HTMLElementStack::isHTMLIntegrationPoint().
+    return tagName == "foreignobject" || tagName == "desc" || tagName == "title";
+}
+
+bool BackgroundHTMLParser::TreeBuilderSimulator::tokenExitsMath(const String& tagName)
+{
+    // MathML text integration points, see HTMLElementStack::isMathMLTextIntegrationPoint().
+    return tagName == "mi" || tagName == "mo" || tagName == "mn" || tagName == "ms" || tagName == "mtext";
+}
+
+void BackgroundHTMLParser::TreeBuilderSimulator::switchTokenizerState(const CompactHTMLToken& token, HTMLTokenizer& tokenizer)
+{
+    // This mirrors HTMLTokenizer::updateStateFor(), which uses HTMLNames.
+    const String& tagName = token.name();
+    if (tagName == "textarea" || tagName == "title") {
+        tokenizer.setRCDATAState();
+        m_inTextElement = true;
+    } else if (tagName == "plaintext")
+        tokenizer.setPLAINTEXTState();
+    else if (tagName == "script") {
+        // HTMLTreeBuilder closes self-closing scripts right away in this mode.
+        if (m_options.usePreHTML5ParserQuirks && token.selfClosing())
+            return;
+        tokenizer.setScriptDataState();
+        m_inTextElement = true;
+    } else if (tagName == "style"
+        || tagName == "iframe"
+        || tagName == "xmp"
+        || (tagName == "noembed" && m_options.pluginsEnabled)
+        || tagName == "noframes"
+        || (tagName == "noscript" && m_options.scriptEnabled)) {
+        tokenizer.setRAWTEXTState();
+        m_inTextElement = true;
+    }
+}
+
+void BackgroundHTMLParser::TreeBuilderSimulator::simulate(const CompactHTMLToken& token, HTMLTokenizer& tokenizer)
+{
+    switch (token.type()) {
+    case HTMLToken::StartTag: {
+        const String& tagName = token.name();
+        size_t namespaceStackSize = m_namespaceStack.size();
+        if (tagName == "svg")
+            m_namespaceStack.append(SVG);
+        else if (tagName == "math")
+            m_namespaceStack.append(MathML);
+        else if (inForeignContent() && tokenExitsForeignContent(token)) {
+            m_namespaceStack.removeLast();
+            namespaceStackSize = m_namespaceStack.size();
+        }
+
+        if (!inForeignContent())
+            switchTokenizerState(token, tokenizer);
+        else if ((m_namespaceStack.last() == SVG && tokenExitsSVG(tagName)) || (m_namespaceStack.last() == MathML && tokenExitsMath(tagName)))
+            m_namespaceStack.append(HTML);
+
+        // Self-closing elements are popped right away, but only foreign elements can be self-closing.
+        if (token.selfClosing() && m_namespaceStack.size() > namespaceStackSize)
+            m_namespaceStack.removeLast();
+        break;
+    }
+    case HTMLToken::EndTag: {
+        const String& tagName = token.name();
+        if ((m_namespaceStack.last() == SVG && tagName == "svg")
+            || (m_namespaceStack.last() == MathML && tagName == "math")
+            || (m_namespaceStack.size() > 1 && m_namespaceStack.last() == HTML && (tokenExitsSVG(tagName) || tokenExitsMath(tagName))))
+            m_namespaceStack.removeLast();
+        // The tokenizer only emits the end tag of the element that put it into a text state, which takes the tree builder out of it.
+        m_inTextElement = false;
+        break;
+    }
+    default:
+        break;
+    }
+
+    // See the end of HTMLTreeBuilder::constructTree().
+    tokenizer.setForceNullCharacterReplacement(m_inTextElement || inForeignContent());
+    tokenizer.setShouldAllowCDATA(inForeignContent());
+}
+
+Ref<BackgroundHTMLParser> BackgroundHTMLParser::create(HTMLDocumentParser& parser, const HTMLParserOptions& options, const HTMLTokenizer& tokenizer, const TextPosition& position)
+{
+    return adoptRef(*new BackgroundHTMLParser(parser, options, tokenizer, position));
+}
+
+BackgroundHTMLParser::BackgroundHTMLParser(HTMLDocumentParser& parser, const HTMLParserOptions& options, const HTMLTokenizer& tokenizer, const TextPosition& position)
+    : m_parser(&parser)
+    , m_options(options)
+    , m_tokenizer(m_options)
+    , m_treeBuilderSimulator(std::make_unique<TreeBuilderSimulator>(m_options))
+{
+    ASSERT(isMainThread());
+
+    HTMLTokenizer::Checkpoint checkpoint;
+    tokenizer.createCheckpoint(checkpoint);
+    m_tokenizer.restoreFromCheckpoint(checkpoint);
+
+    m_input.current().setCurrentPosition(position.m_line, position.m_column, 0);
+}
+
+BackgroundHTMLParser::~BackgroundHTMLParser()
+{
+}
+
+void BackgroundHTMLParser::append(const String& source)
+{
+    ASSERT(isMainThread());
+    {
+        LockHolder locker(m_lock);
+        m_pendingInput.append(source.isolatedCopy());
+    }
+    scheduleTokenization();
+}
+
+void BackgroundHTMLParser::finish()
+{
+    ASSERT(isMainThread());
+    {
+        LockHolder locker(m_lock);
+        m_pendingEndOfFile = true;
+    }
+    scheduleTokenization();
+}
+
+void BackgroundHTMLParser::stop()
+{
+    ASSERT(isMainThread());
+    m_parser = nullptr;
+    m_stopped = true;
+}
+
+void BackgroundHTMLParser::takeTokens(Deque<SpeculativeToken>& tokens)
+{
+    ASSERT(isMainThread());
+    LockHolder locker(m_lock);
+    for (auto& token : m_tokens)
+        tokens.append(WTFMove(token));
+    m_tokens.clear();
+}
+
+void BackgroundHTMLParser::scheduleTokenization()
+{
+    RefPtr<BackgroundHTMLParser> protectedThis(this);
+    parserQueue().dispatch([protectedThis] {
+        protectedThis->tokenize();
+    });
+}
+
+void BackgroundHTMLParser::tokenize()
+{
+    ASSERT(!isMainThread());
+    {
+        LockHolder locker(m_lock);
+        for (auto& source : m_pendingInput)
+            m_input.appendToEnd(source);
+        m_pendingInput.clear();
+        if (m_pendingEndOfFile && !m_input.haveSeenEndOfFile())
+            m_input.markEndOfFile();
+    }
+
+    Vector<SpeculativeToken> tokens;
+    while (!m_stopped) {
+        auto rawToken = m_tokenizer.nextToken(m_input.current());
+        if (!rawToken)
+            break;
+
+        SpeculativeToken token(*rawToken);
+        rawToken.clear();
+
+        m_treeBuilderSimulator->simulate(token.token, m_tokenizer);
+
+        SegmentedString& input = m_input.current();
+        token.textPosition = TextPosition(input.currentLine(), input.currentColumn());
+        token.inputOffset = input.numberOfCharactersConsumed();
+        if (m_tokenizer.canCreateCheckpoint()) {
+            token.hasTokenizerCheckpoint = true;
+            m_tokenizer.createCheckpoint(token.tokenizerCheckpoint);
+        }
+
+        tokens.append(WTFMove(token));
+        if (tokens.size() >= maximumTokensPerDelivery)
+            deliverTokens(tokens);
+    }
+
+    if (!tokens.isEmpty())
+        deliverTokens(tokens);
+}
+
+void BackgroundHTMLParser::deliverTokens(Vector<SpeculativeToken>& tokens)
+{
+    {
+        LockHolder locker(m_lock);
+        if (m_tokens.isEmpty())
+            m_tokens.swap(tokens);
+        else {
+            for (auto& token : tokens)
+                m_tokens.append(WTFMove(token));
+        }
+    }
+    tokens.clear();
+
+    RefPtr<BackgroundHTMLParser> protectedThis(this);
+    callOnMainThread([protectedThis] {
+        if (auto* parser = protectedThis->m_parser)
+            parser->didReceiveTokensFromBackgroundParser();
+    });
+}
+
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BackgroundHTMLParser_h
+#define BackgroundHTMLParser_h
+
+#include "CompactHTMLToken.h"
+#include "HTMLInputStream.h"
+#include "HTMLParserOptions.h"
+#include "HTMLTokenizer.h"
+#include <atomic>
+#include <wtf/Deque.h>
+#include <wtf/Lock.h>
+#include <wtf/ThreadSafeRefCounted.h>
+#include <wtf/text/TextPosition.h>
+
+namespace WebCore {
+
+class HTMLDocumentParser;
+
+// Tokenizes the input of an HTMLDocumentParser on a background thread, ahead of the tree builder.
+//
+// The tree builder switches the tokenizer into other states for some elements, which only the main thread
+// can know for sure. The background parser predicts these switches with a rough model of the tree builder,
+// and records its prediction with each token. HTMLDocumentParser compares the prediction with what the tree
+// builder actually did, and takes over tokenization on the main thread as soon as they differ, or as soon as
+// document.write() changes the input.
+class BackgroundHTMLParser : public ThreadSafeRefCounted<BackgroundHTMLParser> {
+public:
+    struct SpeculativeToken {
+        explicit SpeculativeToken(HTMLToken& token)
+            : token(token)
+        {
+        }
+
+        CompactHTMLToken token;
+
+        // The position of the input right after the token, and the number of characters consumed up to there,
+        // counting from where the background parser started.
+        TextPosition textPosition;
+        unsigned inputOffset { 0 };
+
+        // The predicted state of the tokenizer once the tree builder processed the token. Missing after a
+        // character token that ended where an end tag started, the only place the tokenizer can't be handed over.
+        bool hasTokenizerCheckpoint { false };
+        HTMLTokenizer::Checkpoint tokenizerCheckpoint;
+    };
+
+    // Starts from the given tokenizer state and input position, which are those of the main thread tokenizer.
+    static Ref<BackgroundHTMLParser> create(HTMLDocumentParser&, const HTMLParserOptions&, const HTMLTokenizer&, const TextPosition&);
+    ~BackgroundHTMLParser();
+
+    // These are all called on the main thread.
+    void append(const String&);
+    void finish();
+    void stop();
+    void takeTokens(Deque<SpeculativeToken>&);
+
+private:
+    BackgroundHTMLParser(HTMLDocumentParser&, const HTMLParserOptions&, const HTMLTokenizer&, const TextPosition&);
+
+    class TreeBuilderSimulator;
+
+    void scheduleTokenization();
+    void tokenize();
+    void deliverTokens(Vector<SpeculativeToken>&);
+
+    HTMLDocumentParser* m_parser; // Only used on the main thread.
+    std::atomic<bool> m_stopped { false };
+
+    Lock m_lock;
+    Vector<String> m_pendingInput;
+    bool m_pendingEndOfFile { false };
+    Vector<SpeculativeToken> m_tokens;
+
+    // Only used on the parser thread.
+    HTMLParserOptions m_options;
+    HTMLInputStream m_input;
+    HTMLTokenizer m_tokenizer;
+    std::unique_ptr<TreeBuilderSimulator> m_treeBuilderSimulator;
+};
+
+}
+
+#endif
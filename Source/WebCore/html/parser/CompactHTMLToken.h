@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CompactHTMLToken_h
+#define CompactHTMLToken_h
+
+#include "HTMLToken.h"
+
+namespace WebCore {
+
+// A copy of an HTMLToken that can be handed from the thread that tokenized it to the main thread.
+// It holds plain Strings, which AtomicHTMLToken atomizes on the main thread, so it must never be
+// shared: whichever thread owns it is the only one that may touch its strings.
+class CompactHTMLToken {
+public:
+    struct Attribute {
+        String name;
+        String value;
+    };
+
+    explicit CompactHTMLToken(HTMLToken&);
+
+    HTMLToken::Type type() const { return static_cast<HTMLToken::Type>(m_type); }
+
+    // StartTag, EndTag, DOCTYPE.
+    const String& name() const;
+
+    // StartTag, EndTag.
+    bool selfClosing() const;
+    const Vector<Attribute>& attributes() const;
+
+    // Character. Always 16-bit, so the tree builder can process the characters in place.
+    const String& characters() const;
+    bool charactersIsAll8BitData() const;
+
+    // Comment.
+    const String& comment() const;
+
+    // DOCTYPE.
+    std::unique_ptr<DoctypeData> releaseDoctypeData();
+
+private:
+    unsigned m_type : 4;
+    unsigned m_selfClosing : 1;
+    unsigned m_isAll8BitData : 1;
+
+    String m_data; // Name, characters or comment.
+    Vector<Attribute> m_attributes;
+    std::unique_ptr<DoctypeData> m_doctypeData;
+};
+
+inline const String& CompactHTMLToken::name() const
+{
+    ASSERT(type() == HTMLToken::StartTag || type() == HTMLToken::EndTag || type() == HTMLToken::DOCTYPE);
+    return m_data;
+}
+
+inline bool CompactHTMLToken::selfClosing() const
+{
+    ASSERT(type() == HTMLToken::StartTag || type() == HTMLToken::EndTag);
+    return m_selfClosing;
+}
+
+inline auto CompactHTMLToken::attributes() const -> const Vector<Attribute>&
+{
+    ASSERT(type() == HTMLToken::StartTag || type() == HTMLToken::EndTag);
+    return m_attributes;
+}
+
+inline const String& CompactHTMLToken::characters() const
+{
+    ASSERT(type() == HTMLToken::Character);
+    return m_data;
+}
+
+inline bool CompactHTMLToken::charactersIsAll8BitData() const
+{
+    ASSERT(type() == HTMLToken::Character);
+    return m_isAll8BitData;
+}
+
+inline const String& CompactHTMLToken::comment() const
+{
+    ASSERT(type() == HTMLToken::Comment);
+    return m_data;
+}
+
+inline std::unique_ptr<DoctypeData> CompactHTMLToken::releaseDoctypeData()
+{
+    ASSERT(type() == HTMLToken::DOCTYPE);
+    return WTFMove(m_doctypeData);
+}
+
+}
+
+#endif
@@ -80,6 +80,7 @@ HTMLDocumentParser::~HTMLDocumentParser()
     ASSERT(!m_pumpSessionNestingLevel);
     ASSERT(!m_preloadScanner);
     ASSERT(!m_insertionPreloadScanner);
+    ASSERT(!m_backgroundParser);
 }
 
 void HTMLDocumentParser::detach()
@@ -93,12 +94,16 @@ void HTMLDocumentParser::detach()
     m_preloadScanner = nullptr;
     m_insertionPreloadScanner = nullptr;
     m_parserScheduler = nullptr; // Deleting the scheduler will clear any timers.
+    if (m_backgroundParser)
+        stopSpeculating();
 }
 
 void HTMLDocumentParser::stopParsing()
 {
     DocumentParser::stopParsing();
     m_parserScheduler = nullptr; // Deleting the scheduler will clear any timers.
+    if (m_backgroundParser)
+        stopSpeculating();
 }
 
 // This kicks off "Once the user agent stops parsing" as described by:
@@ -139,7 +144,7 @@ inline bool HTMLDocumentParser::inPumpSession() const
 
 inline bool HTMLDocumentParser::shouldDelayEnd() const
 {
-    return inPumpSession() || isWaitingForScripts() || isScheduledForResume() || isExecutingScript();
+    return inPumpSession() || isWaitingForScripts() || isScheduledForResume() || isExecutingScript() || m_backgroundParser;
 }
 
 bool HTMLDocumentParser::isParsingFragment() const
@@ -250,6 +255,12 @@ void HTMLDocumentParser::pumpTokenizer(SynchronousMode mode)
     m_xssAuditor.init(document(), &m_xssAuditorDelegate);
 
     while (canTakeNextToken(mode, session) && !session.needsYield) {
+        if (m_backgroundParser) {
+            if (!constructTreeFromSpeculativeToken())
+                break;
+            continue;
+        }
+
         if (!isParsingFragment())
             m_sourceTracker.startToken(m_input.current(), m_tokenizer);
 
@@ -282,6 +293,8 @@ void HTMLDocumentParser::pumpTokenizer(SynchronousMode mode)
     if (isWaitingForScripts()) {
         ASSERT(m_tokenizer.isInDataState());
         if (!m_preloadScanner) {
+            if (m_backgroundParser)
+                synchronizeInputWithSpeculation();
             m_preloadScanner = std::make_unique<HTMLPreloadScanner>(m_options, document()->url(), document()->deviceScaleFactor());
             m_preloadScanner->appendToEnd(m_input.current());
         }
@@ -312,6 +325,92 @@ void HTMLDocumentParser::constructTreeFromHTMLToken(HTMLTokenizer::TokenPtr& raw
     m_treeBuilder->constructTree(token);
 }
 
+bool HTMLDocumentParser::canStartSpeculating() const
+{
+    // The background parser takes over from the main thread tokenizer, which must be between two tokens
+    // with no input left, and in a state the tree builder can't change anymore.
+    return m_options.useThreading && !m_backgroundParser && !isParsingFragment() && !inPumpSession()
+        && !m_input.hasInsertionPoint() && !m_input.haveSeenEndOfFile() && m_input.current().isEmpty()
+        && m_tokenizer.canCreateCheckpoint();
+}
+
+void HTMLDocumentParser::startSpeculating()
+{
+    ASSERT(canStartSpeculating());
+
+    auto& currentString = m_input.current();
+    m_textPosition = TextPosition(currentString.currentLine(), currentString.currentColumn());
+    m_speculativeInputOffset = 0;
+    m_synchronizedInputOffset = 0;
+    m_backgroundParser = BackgroundHTMLParser::create(*this, m_options, m_tokenizer, m_textPosition);
+}
+
+// Hands tokenization back to the main thread, right after the last token the tree builder processed.
+void HTMLDocumentParser::stopSpeculating()
+{
+    ASSERT(m_backgroundParser);
+
+    synchronizeInputWithSpeculation();
+    m_backgroundParser->stop();
+    m_backgroundParser = nullptr;
+    m_speculativeTokens.clear();
+}
+
+void HTMLDocumentParser::synchronizeInputWithSpeculation()
+{
+    ASSERT(m_backgroundParser);
+
+    if (m_synchronizedInputOffset == m_speculativeInputOffset)
+        return;
+
+    // Nothing can be inserted before the tokens the tree builder processed while speculating.
+    ASSERT(!m_input.hasInsertionPoint());
+
+    auto& currentString = m_input.current();
+    currentString.advance(m_speculativeInputOffset - m_synchronizedInputOffset);
+    currentString.setCurrentPosition(m_textPosition.m_line, m_textPosition.m_column, 0);
+    m_synchronizedInputOffset = m_speculativeInputOffset;
+}
+
+bool HTMLDocumentParser::constructTreeFromSpeculativeToken()
+{
+    if (m_speculativeTokens.isEmpty()) {
+        m_backgroundParser->takeTokens(m_speculativeTokens);
+        if (m_speculativeTokens.isEmpty())
+            return false;
+    }
+
+    auto speculativeToken = m_speculativeTokens.takeFirst();
+    auto& checkpoint = speculativeToken.tokenizerCheckpoint;
+    auto type = speculativeToken.token.type();
+
+    if (speculativeToken.hasTokenizerCheckpoint) {
+        // Put the tokenizer in the state it would be in had it produced the token itself, so that the
+        // tree builder switches it the same way, and so that it can take over from here if need be.
+        if (type == HTMLToken::StartTag)
+            checkpoint.appropriateEndTagName = speculativeToken.token.name();
+        m_tokenizer.restoreFromCheckpoint(checkpoint);
+        if (type != HTMLToken::Character)
+            m_tokenizer.setDataState();
+    }
+
+    m_textPosition = speculativeToken.textPosition;
+    m_speculativeInputOffset = speculativeToken.inputOffset;
+
+    AtomicHTMLToken token(speculativeToken.token);
+    m_treeBuilder->constructTree(token);
+
+    // The tree builder can run script that stops the parser.
+    if (!m_backgroundParser || !speculativeToken.hasTokenizerCheckpoint)
+        return true;
+
+    // If the tree builder didn't switch the tokenizer as predicted, the tokens that follow are wrong.
+    if (!m_tokenizer.matchesCheckpoint(checkpoint) || type == HTMLToken::EndOfFile)
+        stopSpeculating();
+
+    return true;
+}
+
 bool HTMLDocumentParser::hasInsertionPoint()
 {
     // FIXME: The wasCreatedByScript() branch here might not be fully correct.
@@ -330,6 +429,10 @@ void HTMLDocumentParser::insert(const SegmentedString& source)
     // but we need to ensure it isn't deleted yet.
     Ref<HTMLDocumentParser> protect(*this);
 
+    // document.write() changes the input that the background parser is working on.
+    if (m_backgroundParser)
+        stopSpeculating();
+
     SegmentedString excludedLineNumberSource(source);
     excludedLineNumberSource.setExcludeLineNumbers();
     m_input.insertAtCurrentInsertionPoint(excludedLineNumberSource);
@@ -358,6 +461,11 @@ void HTMLDocumentParser::append(RefPtr<StringImpl>&& inputSource)
 
     String source(WTFMove(inputSource));
 
+    if (m_backgroundParser)
+        synchronizeInputWithSpeculation();
+    else if (canStartSpeculating())
+        startSpeculating();
+
     if (m_preloadScanner) {
         if (m_input.current().isEmpty() && !isWaitingForScripts()) {
             // We have parsed until the end of the current input and so are now moving ahead of the preload scanner.
@@ -371,6 +479,8 @@ void HTMLDocumentParser::append(RefPtr<StringImpl>&& inputSource)
     }
 
     m_input.appendToEnd(source);
+    if (m_backgroundParser)
+        m_backgroundParser->append(source);
 
     if (inPumpSession()) {
         // We've gotten data off the network in a nested write.
@@ -438,6 +548,8 @@ void HTMLDocumentParser::finish()
     // than once, if the first time does not call end().
     if (!m_input.haveSeenEndOfFile())
         m_input.markEndOfFile();
+    if (m_backgroundParser)
+        m_backgroundParser->finish();
 
     attemptToEnd();
 }
@@ -449,6 +561,9 @@ bool HTMLDocumentParser::isExecutingScript() const
 
 TextPosition HTMLDocumentParser::textPosition() const
 {
+    if (m_backgroundParser)
+        return m_textPosition;
+
     auto& currentString = m_input.current();
     return TextPosition(currentString.currentLine(), currentString.currentColumn());
 }
@@ -488,6 +603,20 @@ void HTMLDocumentParser::resumeParsingAfterScriptExecution()
     endIfDelayed();
 }
 
+void HTMLDocumentParser::didReceiveTokensFromBackgroundParser()
+{
+    // The pump session in progress, or the one that follows the script, will take the tokens.
+    if (isStopped() || inPumpSession() || isExecutingScript())
+        return;
+
+    // pumpTokenizer can cause this parser to be detached from the Document,
+    // but we need to ensure it isn't deleted yet.
+    Ref<HTMLDocumentParser> protect(*this);
+
+    pumpTokenizerIfPossible(AllowYield);
+    endIfDelayed();
+}
+
 void HTMLDocumentParser::watchForLoad(CachedResource* cachedScript)
 {
     ASSERT(!cachedScript->isLoaded());
@@ -505,6 +634,8 @@ void HTMLDocumentParser::stopWatchingForLoad(CachedResource* cachedScript)
 void HTMLDocumentParser::appendCurrentInputStreamToPreloadScannerAndScan()
 {
     ASSERT(m_preloadScanner);
+    if (m_backgroundParser)
+        synchronizeInputWithSpeculation();
     m_preloadScanner->appendToEnd(m_input.current());
     m_preloadScanner->scan(*m_preloader, *document());
 }
@@ -27,6 +27,7 @@
 #ifndef HTMLDocumentParser_h
 #define HTMLDocumentParser_h
 
+#include "BackgroundHTMLParser.h"
 #include "CachedResourceClient.h"
 #include "HTMLInputStream.h"
 #include "HTMLScriptRunnerHost.h"
@@ -62,6 +63,9 @@ public:
     HTMLTokenizer& tokenizer();
     virtual TextPosition textPosition() const override final;
 
+    // For BackgroundHTMLParser.
+    void didReceiveTokensFromBackgroundParser();
+
 protected:
     explicit HTMLDocumentParser(HTMLDocument&);
 
@@ -107,6 +111,12 @@ private:
     void pumpTokenizerIfPossible(SynchronousMode);
     void constructTreeFromHTMLToken(HTMLTokenizer::TokenPtr&);
 
+    bool canStartSpeculating() const;
+    void startSpeculating();
+    void stopSpeculating();
+    void synchronizeInputWithSpeculation();
+    bool constructTreeFromSpeculativeToken();
+
     void runScriptsForPausedTreeBuilder();
     void resumeParsingAfterScriptExecution();
 
@@ -136,6 +146,13 @@ private:
 
     std::unique_ptr<HTMLResourcePreloader> m_preloader;
 
+    // While a BackgroundHTMLParser tokenizes the input, m_input only catches up with the tree builder on demand,
+    // and m_textPosition is the position right after the last token the tree builder processed.
+    RefPtr<BackgroundHTMLParser> m_backgroundParser;
+    Deque<BackgroundHTMLParser::SpeculativeToken> m_speculativeTokens;
+    unsigned m_speculativeInputOffset { 0 };
+    unsigned m_synchronizedInputOffset { 0 };
+
     bool m_endWasDelayed { false };
     unsigned m_pumpSessionNestingLevel { 0 };
 };
@@ -147,6 +164,9 @@ inline HTMLTokenizer& HTMLDocumentParser::tokenizer()
 
 inline HTMLInputStream& HTMLDocumentParser::inputStream()
 {
+    // HTMLScriptRunner marks the insertion point for document.write() at the current position.
+    if (m_backgroundParser)
+        synchronizeInputWithSpeculation();
     return m_input;
 }
 
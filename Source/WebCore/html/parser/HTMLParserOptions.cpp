@@ -39,6 +39,7 @@ HTMLParserOptions::HTMLParserOptions()
     : scriptEnabled(false)
     , pluginsEnabled(false)
     , usePreHTML5ParserQuirks(false)
+    , useThreading(false)
     , maximumDOMTreeDepth(Settings::defaultMaximumHTMLParserDOMTreeDepth)
 {
 }
@@ -51,6 +52,8 @@ HTMLParserOptions::HTMLParserOptions(Document& document)
 
     Settings* settings = document.settings();
     usePreHTML5ParserQuirks = settings && settings->usePreHTML5ParserQuirks();
+    // The XSS auditor needs the source of every token, which only the main thread tokenizer keeps track of.
+    useThreading = settings && settings->threadedHTMLParserEnabled() && !settings->xssAuditorEnabled();
     maximumDOMTreeDepth = settings ? settings->maximumHTMLParserDOMTreeDepth() : Settings::defaultMaximumHTMLParserDOMTreeDepth;
 }
 
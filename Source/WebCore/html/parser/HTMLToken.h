@@ -108,6 +108,7 @@ public:
     void beginAttribute(unsigned offset);
     void appendToAttributeName(UChar);
     void appendToAttributeValue(UChar);
+    void appendToAttributeValue(StringView);
     void endAttribute(unsigned offset);
 
     void setSelfClosing();
@@ -132,6 +133,7 @@ public:
     void appendToCharacter(LChar);
     void appendToCharacter(UChar);
     void appendToCharacter(const Vector<LChar, 32>&);
+    void appendToCharacter(StringView, UChar characterBits);
 
     // Comment.
 
@@ -347,6 +349,16 @@ inline void HTMLToken::appendToAttributeValue(UChar character)
     m_currentAttribute->value.append(character);
 }
 
+inline void HTMLToken::appendToAttributeValue(StringView characters)
+{
+    ASSERT(m_type == StartTag || m_type == EndTag);
+    ASSERT(m_currentAttribute);
+    if (characters.is8Bit())
+        m_currentAttribute->value.append(characters.characters8(), characters.length());
+    else
+        m_currentAttribute->value.append(characters.characters16(), characters.length());
+}
+
 inline void HTMLToken::appendToAttributeValue(unsigned i, StringView value)
 {
     ASSERT(!value.isEmpty());
@@ -402,6 +414,20 @@ inline void HTMLToken::appendToCharacter(const Vector<LChar, 32>& characters)
     m_data.appendVector(characters);
 }
 
+// characterBits is the OR of the characters, which InputStreamPreprocessor::advancePastCharacterRun() computes as it
+// scans them.
+inline void HTMLToken::appendToCharacter(StringView characters, UChar characterBits)
+{
+    ASSERT(m_type == Uninitialized || m_type == Character);
+    m_type = Character;
+    if (characters.is8Bit()) {
+        m_data.append(characters.characters8(), characters.length());
+        return;
+    }
+    m_data.append(characters.characters16(), characters.length());
+    m_data8BitCheck |= characterBits;
+}
+
 inline const HTMLToken::DataVector& HTMLToken::comment() const
 {
     ASSERT(m_type == Comment);
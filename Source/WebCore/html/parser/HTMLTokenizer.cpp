@@ -39,6 +39,24 @@ namespace WebCore {
 
 using namespace HTMLNames;
 
+// Like ADVANCE_TO, for states that buffer most characters as they are: also consumes the run of characters after the
+// current one that are neither one of the delimiters nor special to the preprocessor, and appends it to the token.
+#define ADVANCE_PAST_CHARACTER_RUN_TO(newState, delimiter1, delimiter2) \
+    do {                                                        \
+        UChar characterBits = 0;                                \
+        StringView run = m_preprocessor.advancePastCharacterRun(source, delimiter1, delimiter2, characterBits); \
+        m_token.appendToCharacter(run, characterBits);          \
+        SWITCH_TO(newState);                                    \
+    } while (false)
+
+// Same, for the quoted attribute value states, whose runs end at the closing quote or at a character reference.
+#define ADVANCE_PAST_ATTRIBUTE_VALUE_RUN_TO(newState, quote)   \
+    do {                                                        \
+        UChar characterBits = 0;                                \
+        m_token.appendToAttributeValue(m_preprocessor.advancePastCharacterRun(source, quote, '&', characterBits)); \
+        SWITCH_TO(newState);                                    \
+    } while (false)
+
 static inline LChar convertASCIIAlphaToLower(UChar character)
 {
     ASSERT(isASCIIAlpha(character));
@@ -221,7 +239,7 @@ bool HTMLTokenizer::processToken(SegmentedString& source)
         if (character == kEndOfFileMarker)
             return emitEndOfFile(source);
         bufferCharacter(character);
-        ADVANCE_TO(DataState);
+        ADVANCE_PAST_CHARACTER_RUN_TO(DataState, '<', '&');
     END_STATE()
 
     BEGIN_STATE(CharacterReferenceInDataState)
@@ -238,7 +256,7 @@ bool HTMLTokenizer::processToken(SegmentedString& source)
         if (character == kEndOfFileMarker)
             RECONSUME_IN(DataState);
         bufferCharacter(character);
-        ADVANCE_TO(RCDATAState);
+        ADVANCE_PAST_CHARACTER_RUN_TO(RCDATAState, '<', '&');
     END_STATE()
 
     BEGIN_STATE(CharacterReferenceInRCDATAState)
@@ -253,7 +271,7 @@ bool HTMLTokenizer::processToken(SegmentedString& source)
         if (character == kEndOfFileMarker)
             RECONSUME_IN(DataState);
         bufferCharacter(character);
-        ADVANCE_TO(RAWTEXTState);
+        ADVANCE_PAST_CHARACTER_RUN_TO(RAWTEXTState, '<', '<');
     END_STATE()
 
     BEGIN_STATE(ScriptDataState)
@@ -262,14 +280,14 @@ bool HTMLTokenizer::processToken(SegmentedString& source)
         if (character == kEndOfFileMarker)
             RECONSUME_IN(DataState);
         bufferCharacter(character);
-        ADVANCE_TO(ScriptDataState);
+        ADVANCE_PAST_CHARACTER_RUN_TO(ScriptDataState, '<', '<');
     END_STATE()
 
     BEGIN_STATE(PLAINTEXTState)
         if (character == kEndOfFileMarker)
             RECONSUME_IN(DataState);
         bufferCharacter(character);
-        ADVANCE_TO(PLAINTEXTState);
+        ADVANCE_PAST_CHARACTER_RUN_TO(PLAINTEXTState, kEndOfFileMarker, kEndOfFileMarker);
     END_STATE()
 
     BEGIN_STATE(TagOpenState)
@@ -808,7 +826,7 @@ bool HTMLTokenizer::processToken(SegmentedString& source)
             RECONSUME_IN(DataState);
         }
         m_token.appendToAttributeValue(character);
-        ADVANCE_TO(AttributeValueDoubleQuotedState);
+        ADVANCE_PAST_ATTRIBUTE_VALUE_RUN_TO(AttributeValueDoubleQuotedState, '"');
     END_STATE()
 
     BEGIN_STATE(AttributeValueSingleQuotedState)
@@ -826,7 +844,7 @@ bool HTMLTokenizer::processToken(SegmentedString& source)
             RECONSUME_IN(DataState);
         }
         m_token.appendToAttributeValue(character);
-        ADVANCE_TO(AttributeValueSingleQuotedState);
+        ADVANCE_PAST_ATTRIBUTE_VALUE_RUN_TO(AttributeValueSingleQuotedState, '\'');
     END_STATE()
 
     BEGIN_STATE(AttributeValueUnquotedState)
@@ -1406,6 +1424,50 @@ String HTMLTokenizer::bufferedCharacters() const
     return characters.toString();
 }
 
+bool HTMLTokenizer::canCreateCheckpoint() const
+{
+    switch (m_state) {
+    case DataState:
+    case RCDATAState:
+    case RAWTEXTState:
+    case ScriptDataState:
+    case PLAINTEXTState:
+        return m_token.type() == HTMLToken::Uninitialized && m_bufferedEndTagName.isEmpty();
+    default:
+        return false;
+    }
+}
+
+void HTMLTokenizer::createCheckpoint(Checkpoint& checkpoint) const
+{
+    ASSERT(canCreateCheckpoint());
+    checkpoint.state = m_state;
+    checkpoint.forceNullCharacterReplacement = m_forceNullCharacterReplacement;
+    checkpoint.shouldAllowCDATA = m_shouldAllowCDATA;
+    checkpoint.skipNextNewLine = m_preprocessor.skipNextNewLine();
+    if (m_state != DataState)
+        checkpoint.appropriateEndTagName = String(m_appropriateEndTagName);
+    else
+        checkpoint.appropriateEndTagName = String();
+}
+
+void HTMLTokenizer::restoreFromCheckpoint(const Checkpoint& checkpoint)
+{
+    ASSERT(m_token.type() == HTMLToken::Uninitialized);
+    m_state = static_cast<State>(checkpoint.state);
+    m_forceNullCharacterReplacement = checkpoint.forceNullCharacterReplacement;
+    m_shouldAllowCDATA = checkpoint.shouldAllowCDATA;
+    m_preprocessor.reset(checkpoint.skipNextNewLine);
+
+    const String& appropriateEndTagName = checkpoint.appropriateEndTagName;
+    m_appropriateEndTagName.clear();
+    for (unsigned i = 0; i < appropriateEndTagName.length(); ++i)
+        m_appropriateEndTagName.append(appropriateEndTagName[i]);
+
+    m_temporaryBuffer.clear();
+    m_bufferedEndTagName.clear();
+}
+
 void HTMLTokenizer::updateStateFor(const AtomicString& tagName)
 {
     if (tagName == textareaTag || tagName == titleTag)
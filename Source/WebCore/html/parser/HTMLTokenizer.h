@@ -80,6 +80,22 @@ public:
 
     bool neverSkipNullCharacters() const;
 
+    // Used by HTMLDocumentParser to hand tokenization over between the main thread and a BackgroundHTMLParser.
+    // Checkpoints can only be created between tokens, while no characters are buffered in the tokenizer.
+    struct Checkpoint {
+        unsigned state;
+        bool forceNullCharacterReplacement;
+        bool shouldAllowCDATA;
+        bool skipNextNewLine;
+        String appropriateEndTagName; // Only kept outside the data state, where no end tag can be pending.
+    };
+    bool canCreateCheckpoint() const;
+    void createCheckpoint(Checkpoint&) const;
+    void restoreFromCheckpoint(const Checkpoint&);
+
+    // Only compares the state the tree builder controls.
+    bool matchesCheckpoint(const Checkpoint&) const;
+
 private:
     enum State {
         DataState,
@@ -353,6 +369,13 @@ inline bool HTMLTokenizer::neverSkipNullCharacters() const
     return m_forceNullCharacterReplacement;
 }
 
+inline bool HTMLTokenizer::matchesCheckpoint(const Checkpoint& checkpoint) const
+{
+    return m_state == checkpoint.state
+        && m_forceNullCharacterReplacement == checkpoint.forceNullCharacterReplacement
+        && m_shouldAllowCDATA == checkpoint.shouldAllowCDATA;
+}
+
 }
 
 #endif
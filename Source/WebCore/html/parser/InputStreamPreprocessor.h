@@ -30,12 +30,114 @@
 
 #include "SegmentedString.h"
 #include <wtf/Noncopyable.h>
+#include <wtf/text/StringView.h>
 #include <wtf/unicode/CharacterNames.h>
 
+#if CPU(X86_SSE2)
+#include <emmintrin.h>
+#elif HAVE(ARM_NEON_INTRINSICS)
+#include <arm_neon.h>
+#endif
+
 namespace WebCore {
 
 const LChar kEndOfFileMarker = 0;
 
+// Characters that are neither one of two delimiters picked by the tokenizer state nor one of the characters
+// the preprocessor has to see: newlines, carriage returns and null characters (which include kEndOfFileMarker).
+template<typename CharacterType>
+ALWAYS_INLINE bool isPlainCharacter(CharacterType character, LChar delimiter1, LChar delimiter2)
+{
+    return character != delimiter1 && character != delimiter2 && character != '\n' && character != '\r' && character;
+}
+
+// Returns how many of the given characters are plain characters before the first one that isn't.
+inline unsigned lengthOfPlainCharacterRun(const LChar* characters, unsigned length, LChar delimiter1, LChar delimiter2)
+{
+    unsigned i = 0;
+#if CPU(X86_SSE2)
+    const __m128i delimiter1Mask = _mm_set1_epi8(delimiter1);
+    const __m128i delimiter2Mask = _mm_set1_epi8(delimiter2);
+    const __m128i newlineMask = _mm_set1_epi8('\n');
+    const __m128i carriageReturnMask = _mm_set1_epi8('\r');
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(characters + i));
+        __m128i delimiters = _mm_or_si128(_mm_cmpeq_epi8(chunk, delimiter1Mask), _mm_cmpeq_epi8(chunk, delimiter2Mask));
+        __m128i specials = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, newlineMask), _mm_cmpeq_epi8(chunk, carriageReturnMask)), _mm_cmpeq_epi8(chunk, zero));
+        if (_mm_movemask_epi8(_mm_or_si128(delimiters, specials)))
+            break;
+    }
+#elif HAVE(ARM_NEON_INTRINSICS)
+    const uint8x16_t delimiter1Mask = vdupq_n_u8(delimiter1);
+    const uint8x16_t delimiter2Mask = vdupq_n_u8(delimiter2);
+    const uint8x16_t newlineMask = vdupq_n_u8('\n');
+    const uint8x16_t carriageReturnMask = vdupq_n_u8('\r');
+    const uint8x16_t zero = vdupq_n_u8(0);
+    for (; i + 16 <= length; i += 16) {
+        uint8x16_t chunk = vld1q_u8(characters + i);
+        uint8x16_t delimiters = vorrq_u8(vceqq_u8(chunk, delimiter1Mask), vceqq_u8(chunk, delimiter2Mask));
+        uint8x16_t specials = vorrq_u8(vorrq_u8(vceqq_u8(chunk, newlineMask), vceqq_u8(chunk, carriageReturnMask)), vceqq_u8(chunk, zero));
+        uint64x2_t matches = vreinterpretq_u64_u8(vorrq_u8(delimiters, specials));
+        if (vgetq_lane_u64(matches, 0) | vgetq_lane_u64(matches, 1))
+            break;
+    }
+#endif
+    // Find the exact position within the chunk that stopped the loop above, or scan what is left.
+    for (; i < length && isPlainCharacter(characters[i], delimiter1, delimiter2); ++i) { }
+    return i;
+}
+
+// Also ORs the characters of the run into characterBits, so that HTMLToken can tell whether they all fit in 8 bits
+// without looking at them again.
+inline unsigned lengthOfPlainCharacterRun(const UChar* characters, unsigned length, LChar delimiter1, LChar delimiter2, UChar& characterBits)
+{
+    unsigned i = 0;
+#if CPU(X86_SSE2)
+    const __m128i delimiter1Mask = _mm_set1_epi16(delimiter1);
+    const __m128i delimiter2Mask = _mm_set1_epi16(delimiter2);
+    const __m128i newlineMask = _mm_set1_epi16('\n');
+    const __m128i carriageReturnMask = _mm_set1_epi16('\r');
+    const __m128i zero = _mm_setzero_si128();
+    __m128i chunkBits = zero;
+    for (; i + 8 <= length; i += 8) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(characters + i));
+        __m128i delimiters = _mm_or_si128(_mm_cmpeq_epi16(chunk, delimiter1Mask), _mm_cmpeq_epi16(chunk, delimiter2Mask));
+        __m128i specials = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi16(chunk, newlineMask), _mm_cmpeq_epi16(chunk, carriageReturnMask)), _mm_cmpeq_epi16(chunk, zero));
+        if (_mm_movemask_epi8(_mm_or_si128(delimiters, specials)))
+            break;
+        chunkBits = _mm_or_si128(chunkBits, chunk);
+    }
+    chunkBits = _mm_or_si128(chunkBits, _mm_srli_si128(chunkBits, 8));
+    chunkBits = _mm_or_si128(chunkBits, _mm_srli_si128(chunkBits, 4));
+    chunkBits = _mm_or_si128(chunkBits, _mm_srli_si128(chunkBits, 2));
+    characterBits |= static_cast<UChar>(_mm_cvtsi128_si32(chunkBits));
+#elif HAVE(ARM_NEON_INTRINSICS)
+    const uint16x8_t delimiter1Mask = vdupq_n_u16(delimiter1);
+    const uint16x8_t delimiter2Mask = vdupq_n_u16(delimiter2);
+    const uint16x8_t newlineMask = vdupq_n_u16('\n');
+    const uint16x8_t carriageReturnMask = vdupq_n_u16('\r');
+    const uint16x8_t zero = vdupq_n_u16(0);
+    uint16x8_t chunkBits = zero;
+    for (; i + 8 <= length; i += 8) {
+        uint16x8_t chunk = vld1q_u16(reinterpret_cast<const uint16_t*>(characters + i));
+        uint16x8_t delimiters = vorrq_u16(vceqq_u16(chunk, delimiter1Mask), vceqq_u16(chunk, delimiter2Mask));
+        uint16x8_t specials = vorrq_u16(vorrq_u16(vceqq_u16(chunk, newlineMask), vceqq_u16(chunk, carriageReturnMask)), vceqq_u16(chunk, zero));
+        uint64x2_t matches = vreinterpretq_u64_u16(vorrq_u16(delimiters, specials));
+        if (vgetq_lane_u64(matches, 0) | vgetq_lane_u64(matches, 1))
+            break;
+        chunkBits = vorrq_u16(chunkBits, chunk);
+    }
+    uint64_t laneBits = vget_lane_u64(vreinterpret_u64_u16(vorr_u16(vget_low_u16(chunkBits), vget_high_u16(chunkBits))), 0);
+    laneBits |= laneBits >> 32;
+    laneBits |= laneBits >> 16;
+    characterBits |= static_cast<UChar>(laneBits);
+#endif
+    for (; i < length && isPlainCharacter(characters[i], delimiter1, delimiter2); ++i)
+        characterBits |= characters[i];
+    return i;
+}
+
 // http://www.whatwg.org/specs/web-apps/current-work/#preprocessing-the-input-stream
 template <typename Tokenizer>
 class InputStreamPreprocessor {
@@ -78,6 +180,30 @@ public:
         return peek(source, skipNullCharacters);
     }
 
+    // Consumes the current character like advance(), along with the plain characters that follow it in the current
+    // substring, and returns those so that the tokenizer can buffer a whole run of text at once. The caller has to
+    // peek() at the next character afterwards. The characters of a 16-bit run are ORed into characterBits.
+    ALWAYS_INLINE StringView advancePastCharacterRun(SegmentedString& source, LChar delimiter1, LChar delimiter2, UChar& characterBits)
+    {
+        // The last character of the substring is left to advance(), which moves on to the next substring.
+        unsigned length = source.lengthOfCurrentSubstring();
+        if (length <= 2 || !isPlainCharacter(source.currentChar(), delimiter1, delimiter2)) {
+            source.advanceAndUpdateLineNumber();
+            return StringView();
+        }
+
+        StringView run;
+        if (source.currentSubstringIs8Bit()) {
+            const LChar* characters = source.currentSubstringCharacters8() + 1;
+            run = StringView(characters, lengthOfPlainCharacterRun(characters, length - 2, delimiter1, delimiter2));
+        } else {
+            const UChar* characters = source.currentSubstringCharacters16() + 1;
+            run = StringView(characters, lengthOfPlainCharacterRun(characters, length - 2, delimiter1, delimiter2, characterBits));
+        }
+        source.advancePastNonNewlinesInCurrentSubstring(1 + run.length());
+        return run;
+    }
+
     bool skipNextNewLine() const { return m_skipNextNewLine; }
 
     void reset(bool skipNextNewLine = false)
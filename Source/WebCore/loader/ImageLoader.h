@@ -77,6 +77,9 @@ public:
 protected:
     explicit ImageLoader(Element&);
     virtual void notifyFinished(CachedResource*) override;
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+    virtual bool drawsCachedImage() const override { return false; }
+#endif
 
 private:
     virtual void dispatchLoadEvent() = 0;
@@ -127,6 +127,11 @@ void CachedImage::didAddClient(CachedResourceClient* client)
         static_cast<CachedImageClient*>(client)->imageChanged(this);
 
     CachedResource::didAddClient(client);
+
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+    // A new client has not drawn the image yet, so it may need the full size.
+    updateMaximumDecodedSize();
+#endif
 }
 
 void CachedImage::didRemoveClient(CachedResourceClient* client)
@@ -139,6 +144,13 @@ void CachedImage::didRemoveClient(CachedResourceClient* client)
     if (m_svgImageCache)
         m_svgImageCache->removeClientFromCache(static_cast<CachedImageClient*>(client));
 
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+    if (!m_clients.contains(client)) {
+        m_displayedSizes.remove(static_cast<CachedImageClient*>(client));
+        updateMaximumDecodedSize();
+    }
+#endif
+
     CachedResource::didRemoveClient(client);
 }
 
@@ -357,6 +369,9 @@ inline void CachedImage::createImage()
                 setContainerSizeForRenderer(request.key, request.value.first, request.value.second);
         }
         m_pendingContainerSizeRequests.clear();
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+        updateMaximumDecodedSize();
+#endif
     }
 }
 
@@ -522,6 +537,62 @@ bool CachedImage::isOriginClean(SecurityOrigin* securityOrigin)
     return !securityOrigin->taintsCanvas(responseForSameOriginPolicyChecks().url());
 }
 
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+void CachedImage::updateDisplayedSize(const CachedImageClient& client, const IntSize& displayedSize)
+{
+    // Sizes are forgotten in didRemoveClient(), so only clients may keep one.
+    if (!m_clients.contains(const_cast<CachedImageClient*>(&client)))
+        return;
+
+    auto result = m_displayedSizes.add(&client, displayedSize);
+    if (!result.isNewEntry)
+        result.iterator->value = result.iterator->value.expandedTo(displayedSize);
+
+    // Forwarded every time, as the image may not have known its own size
+    // since the last call.
+    updateMaximumDecodedSize();
+}
+
+void CachedImage::requireFullSizeDecode()
+{
+    if (m_requiresFullSizeDecode)
+        return;
+
+    m_requiresFullSizeDecode = true;
+    updateMaximumDecodedSize();
+}
+
+void CachedImage::updateMaximumDecodedSize()
+{
+    if (!is<BitmapImage>(m_image.get()))
+        return;
+
+    BitmapImage& image = downcast<BitmapImage>(*m_image);
+    if (m_requiresFullSizeDecode) {
+        image.clearMaximumDecodedSize();
+        return;
+    }
+
+    // Clients that do not draw the image, like ImageLoader, have no say. Any
+    // other client that has not reported a size, like a renderer painting a
+    // CSS background, may draw the image at its natural size.
+    IntSize largestDisplayedSize;
+    for (auto& client : m_clients) {
+        CachedImageClient* imageClient = static_cast<CachedImageClient*>(client.key);
+        if (!imageClient->drawsCachedImage())
+            continue;
+        auto it = m_displayedSizes.find(imageClient);
+        if (it == m_displayedSizes.end()) {
+            image.clearMaximumDecodedSize();
+            return;
+        }
+        largestDisplayedSize = largestDisplayedSize.expandedTo(it->value);
+    }
+
+    image.updateMaximumDecodedSize(largestDisplayedSize);
+}
+#endif
+
 CachedResource::RevalidationDecision CachedImage::makeRevalidationDecision(CachePolicy cachePolicy) const
 {
     if (UNLIKELY(isManuallyCached())) {
@@ -89,11 +89,28 @@ public:
 
     bool isOriginClean(SecurityOrigin*);
 
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+    // Called by renderers at layout time with the size, in device pixels,
+    // they display the image at. Bitmap images are only decoded smaller than their
+    // natural size when every client that draws them has reported a size, and
+    // then no smaller than the largest reported size.
+    void updateDisplayedSize(const CachedImageClient&, const IntSize&);
+
+    // Called when the decoded pixels are exposed other than through a client,
+    // e.g. to a canvas. The image is decoded at its natural size from then on.
+    void requireFullSizeDecode();
+#else
+    void requireFullSizeDecode() { }
+#endif
+
 private:
     void clear();
 
     void createImage();
     void clearImage();
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+    void updateMaximumDecodedSize();
+#endif
     // If not null, changeRect is the changed part of the image.
     void notifyObservers(const IntRect* changeRect = nullptr);
     void checkShouldPaintBrokenImage();
@@ -135,6 +152,10 @@ private:
     std::unique_ptr<SVGImageCache> m_svgImageCache;
     unsigned m_isManuallyCached : 1;
     unsigned m_shouldPaintBrokenImage : 1;
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+    HashMap<const CachedImageClient*, IntSize> m_displayedSizes;
+    bool m_requiresFullSizeDecode { false };
+#endif
 };
 
 } // namespace WebCore
@@ -42,6 +42,12 @@ public:
 
     // Called when GIF animation progresses.
     virtual void newImageAnimationFrameAvailable(CachedImage& image) { imageChanged(&image); }
+
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+    // Clients that only observe the load return false, so that the image can be
+    // decoded at the size the drawing clients need.
+    virtual bool drawsCachedImage() const { return true; }
+#endif
 };
 
 }
@@ -47,6 +47,10 @@
 #include <wtf/FastMalloc.h>
 #include <wtf/StdLibExtras.h>
 
+#if PLATFORM(QT)
+#include "ComplexTextLayoutCacheQt.h"
+#endif
+
 namespace WebCore {
 
 WEBCORE_EXPORT bool MemoryPressureHandler::ReliefLogger::s_loggingEnabled = false;
@@ -62,6 +66,8 @@ MemoryPressureHandler::MemoryPressureHandler()
     , m_lastRespondTime(0)
     , m_lowMemoryHandler([this] (Critical critical, Synchronous synchronous) { releaseMemory(critical, synchronous); })
     , m_underMemoryPressure(false)
+    , m_fastMallocStatisticsBeforeLastRelief()
+    , m_fastMallocStatisticsAfterLastRelief()
 #if PLATFORM(IOS)
     // FIXME: Can we share more of this with OpenSource?
     , m_memoryPressureReason(MemoryPressureReasonNone)
@@ -89,6 +95,13 @@ void MemoryPressureHandler::releaseNoncriticalMemory()
         clearWidthCaches();
     }
 
+#if PLATFORM(QT)
+    {
+        ReliefLogger log("Clear complex text layout cache");
+        ComplexTextLayoutCacheQt::singleton().clear();
+    }
+#endif
+
     {
         ReliefLogger log("Discard Selector Query Cache");
         for (auto* document : Document::allDocuments())
@@ -160,8 +173,19 @@ void MemoryPressureHandler::releaseCriticalMemory(Synchronous synchronous)
     });
 }
 
+// Relief logging is opt-in, so this reports heap statistics in release builds too.
+static void logFastMallocStatistics(const WTF::FastMallocStatistics& before, const WTF::FastMallocStatistics& after)
+{
+    WTFLogAlways("FastMalloc after pressure relief: %lu bytes committed (from %lu), %lu bytes free (from %lu), %lu bytes reserved",
+        static_cast<unsigned long>(after.committedVMBytes), static_cast<unsigned long>(before.committedVMBytes),
+        static_cast<unsigned long>(after.freeListBytes), static_cast<unsigned long>(before.freeListBytes),
+        static_cast<unsigned long>(after.reservedVMBytes));
+}
+
 void MemoryPressureHandler::releaseMemory(Critical critical, Synchronous synchronous)
 {
+    m_fastMallocStatisticsBeforeLastRelief = WTF::fastMallocStatistics();
+
     if (critical == Critical::Yes)
         releaseCriticalMemory(synchronous);
 
@@ -178,6 +202,10 @@ void MemoryPressureHandler::releaseMemory(Critical critical, Synchronous synchro
 #endif
         WTF::releaseFastMallocFreeMemory();
     }
+
+    m_fastMallocStatisticsAfterLastRelief = WTF::fastMallocStatistics();
+    if (ReliefLogger::loggingEnabled())
+        logFastMallocStatistics(m_fastMallocStatisticsBeforeLastRelief, m_fastMallocStatisticsAfterLastRelief);
 }
 
 #if !PLATFORM(COCOA) && !OS(LINUX) && !PLATFORM(WIN)
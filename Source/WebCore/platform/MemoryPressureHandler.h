@@ -113,6 +113,11 @@ public:
 
     WEBCORE_EXPORT void releaseMemory(Critical, Synchronous = Synchronous::No);
 
+    // The FastMalloc heap right before and after the most recent memory pressure relief, so that
+    // callers can tell how much it gave back and how much of what is left is free.
+    const WTF::FastMallocStatistics& fastMallocStatisticsBeforeLastRelief() const { return m_fastMallocStatisticsBeforeLastRelief; }
+    const WTF::FastMallocStatistics& fastMallocStatisticsAfterLastRelief() const { return m_fastMallocStatisticsAfterLastRelief; }
+
 private:
     void releaseNoncriticalMemory();
     void releaseCriticalMemory(Synchronous);
@@ -133,6 +138,9 @@ private:
 
     std::atomic<bool> m_underMemoryPressure;
 
+    WTF::FastMallocStatistics m_fastMallocStatisticsBeforeLastRelief;
+    WTF::FastMallocStatistics m_fastMallocStatisticsAfterLastRelief;
+
 #if PLATFORM(IOS)
     uint32_t m_memoryPressureReason;
     bool m_clearPressureOnMemoryRelease;
@@ -138,6 +138,11 @@ const char* SharedBuffer::data() const
         return buffer;
 #endif
 
+#if PLATFORM(QT)
+    if (const char* buffer = singleByteArrayBuffer())
+        return buffer;
+#endif
+
     return this->buffer().data();
 }
 
@@ -173,6 +178,10 @@ void SharedBuffer::append(SharedBuffer* data)
     if (maybeAppendDataArray(data))
         return;
 #endif
+#if PLATFORM(QT)
+    if (maybeAppendByteArrays(data))
+        return;
+#endif
 
     const char* segment;
     size_t position = 0;
@@ -189,6 +198,9 @@ void SharedBuffer::append(const char* data, unsigned length)
 
     maybeTransferMappedFileData();
     maybeTransferPlatformData();
+#if PLATFORM(QT)
+    maybeTransferByteArrays();
+#endif
 
 #if !USE(NETWORK_CFDATA_ARRAY_CALLBACK)
     unsigned positionInSegment = offsetInSegment(m_size - m_buffer->data.size());
@@ -250,6 +262,11 @@ void SharedBuffer::clear()
     m_dataArray.clear();
 #endif
 
+#if PLATFORM(QT)
+    m_byteArrays.clear();
+    m_byteArraysSize = 0;
+#endif
+
     m_size = 0;
     clearDataBuffer();
 }
@@ -274,11 +291,18 @@ Ref<SharedBuffer> SharedBuffer::copy() const
             clone->m_buffer->data.append(m_segments[i], segmentSize);
 
         unsigned sizeOfLastSegment = m_size - m_buffer->data.size() - lastIndex * segmentSize;
+#if PLATFORM(QT)
+        sizeOfLastSegment -= m_byteArraysSize;
+#endif
         clone->m_buffer->data.append(m_segments.last(), sizeOfLastSegment);
     }
 #else
     for (auto& data : m_dataArray)
         clone->m_dataArray.append(data.get());
+#endif
+#if PLATFORM(QT)
+    clone->m_byteArrays = m_byteArrays;
+    clone->m_byteArraysSize = m_byteArraysSize;
 #endif
     ASSERT(clone->size() == size());
 
@@ -322,6 +346,17 @@ void SharedBuffer::hintMemoryNotNeededSoon()
 
 void SharedBuffer::copyBufferAndClear(char* destination, unsigned bytesToCopy) const
 {
+#if PLATFORM(QT)
+    bytesToCopy -= m_byteArraysSize;
+    char* byteArrayDestination = destination + bytesToCopy;
+    for (auto& byteArray : m_byteArrays) {
+        memcpy(byteArrayDestination, byteArray.constData(), byteArray.size());
+        byteArrayDestination += byteArray.size();
+    }
+    m_byteArrays.clear();
+    m_byteArraysSize = 0;
+#endif
+
     for (char* segment : m_segments) {
         unsigned effectiveBytesToCopy = std::min(bytesToCopy, segmentSize);
         memcpy(destination, segment, effectiveBytesToCopy);
@@ -368,11 +403,16 @@ unsigned SharedBuffer::getSomeData(const char*& someData, unsigned position) con
  
     position -= consecutiveSize;
 #if !USE(NETWORK_CFDATA_ARRAY_CALLBACK)
+    unsigned bytesLeft = totalSize - consecutiveSize;
+#if PLATFORM(QT)
+    bytesLeft -= m_byteArraysSize;
+    if (position >= bytesLeft)
+        return copySomeDataFromByteArrays(someData, position - bytesLeft);
+#endif
     unsigned segments = m_segments.size();
     unsigned maxSegmentedSize = segments * segmentSize;
     unsigned segment = segmentIndex(position);
     if (segment < segments) {
-        unsigned bytesLeft = totalSize - consecutiveSize;
         unsigned segmentedSize = std::min(maxSegmentedSize, bytesLeft);
 
         unsigned positionInSegment = offsetInSegment(position);
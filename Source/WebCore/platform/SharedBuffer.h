@@ -44,6 +44,10 @@
 #include "GUniquePtrSoup.h"
 #endif
 
+#if PLATFORM(QT)
+#include <QByteArray>
+#endif
+
 #if USE(FOUNDATION)
 OBJC_CLASS NSData;
 #endif
@@ -103,6 +107,13 @@ public:
     void append(CFDataRef);
 #endif
 
+#if PLATFORM(QT)
+    // The byte array is referenced rather than copied. Appending a buffer that only
+    // holds byte arrays to another one shares them as additional segments.
+    static PassRefPtr<SharedBuffer> wrapQByteArray(const QByteArray&);
+    void append(const QByteArray&);
+#endif
+
     WEBCORE_EXPORT Ref<SharedBuffer> copy() const;
     
     // Return the number of consecutive bytes after "position". "data"
@@ -167,6 +178,17 @@ private:
     mutable Vector<char*> m_segments;
 #endif
 
+#if PLATFORM(QT)
+    explicit SharedBuffer(const QByteArray&);
+    // Byte arrays hold the data following m_buffer and m_segments.
+    mutable Vector<QByteArray> m_byteArrays;
+    mutable unsigned m_byteArraysSize { 0 };
+    void maybeTransferByteArrays();
+    bool maybeAppendByteArrays(SharedBuffer*);
+    unsigned copySomeDataFromByteArrays(const char*& someData, unsigned position) const;
+    const char* singleByteArrayBuffer() const;
+#endif
+
 #if USE(CF)
     explicit SharedBuffer(CFDataRef);
     RetainPtr<CFDataRef> m_cfData;
@@ -36,6 +36,7 @@
 #include "TextStream.h"
 #include "Timer.h"
 #include <wtf/CurrentTime.h>
+#include <wtf/MainThread.h>
 #include <wtf/Vector.h>
 #include <wtf/text/WTFString.h>
 
@@ -45,6 +46,22 @@
 
 namespace WebCore {
 
+unsigned AsynchronousImageDecodingScope::s_activeScopeCount = 0;
+
+AsynchronousImageDecodingScope::AsynchronousImageDecodingScope(bool allowsAsynchronousDecoding)
+    : m_allowsAsynchronousDecoding(allowsAsynchronousDecoding)
+{
+    ASSERT(isMainThread());
+    if (m_allowsAsynchronousDecoding)
+        ++s_activeScopeCount;
+}
+
+AsynchronousImageDecodingScope::~AsynchronousImageDecodingScope()
+{
+    if (m_allowsAsynchronousDecoding)
+        --s_activeScopeCount;
+}
+
 BitmapImage::BitmapImage(ImageObserver* observer)
     : Image(observer)
     , m_minimumSubsamplingLevel(0)
@@ -76,6 +93,11 @@ BitmapImage::BitmapImage(ImageObserver* observer)
     , m_haveFrameCount(false)
     , m_animationFinishedWhenCatchingUp(false)
 {
+#if !USE(CG)
+    m_source.setFrameDecodedCallback([this](size_t index) {
+        frameDecodedAsynchronously(index);
+    });
+#endif
 }
 
 BitmapImage::~BitmapImage()
@@ -344,6 +366,77 @@ bool BitmapImage::dataChanged(bool allDataReceived)
     return isSizeAvailable();
 }
 
+#if !USE(CG)
+void BitmapImage::frameDecodedAsynchronously(size_t index)
+{
+    // The frame was cached as empty or partial while the decode was in flight;
+    // drop it so the next paint picks up the decoded pixels.
+    if (index < m_frames.size() && m_frames[index].m_haveMetadata && !m_frames[index].m_isComplete) {
+        unsigned frameBytes = m_frames[index].m_frameBytes;
+        destroyMetadataAndNotify(m_frames[index].clear(true) ? frameBytes : 0, ClearedSource::No);
+    }
+
+    if (imageObserver()) {
+        updateSize();
+        imageObserver()->changedInRect(this, IntRect(IntPoint(), m_size));
+    }
+}
+#endif
+
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+void BitmapImage::updateMaximumDecodedSize(const IntSize& displayedSize)
+{
+    updateSize();
+    if (m_size.isEmpty() || displayedSize.isEmpty())
+        return;
+
+    // The displayed size may be rotated relative to the decoded pixels.
+    IntSize coveredSize = displayedSize;
+    if (frameOrientationAtIndex(0).usesWidthAsHeight()) {
+        int maximumDimension = std::max(displayedSize.width(), displayedSize.height());
+        coveredSize = IntSize(maximumDimension, maximumDimension);
+    }
+
+    // Only ever halve the image size, so that a growing displayed size causes
+    // a handful of re-decodes at most and JPEG can decode at exactly that size.
+    IntSize decodedSize = m_size;
+    while (decodedSize.width() > 1 && decodedSize.height() > 1) {
+        IntSize halfSize((decodedSize.width() + 1) / 2, (decodedSize.height() + 1) / 2);
+        if (halfSize.width() < coveredSize.width() || halfSize.height() < coveredSize.height())
+            break;
+        decodedSize = halfSize;
+    }
+
+    IntSize maximumDecodedSize = m_source.maximumDecodedSize();
+    if (maximumDecodedSize.isEmpty()) {
+        if (decodedSize == m_size)
+            return;
+    } else {
+        // Never shrink below a size the image was already displayed at.
+        decodedSize = decodedSize.expandedTo(maximumDecodedSize);
+        if (decodedSize == maximumDecodedSize)
+            return;
+    }
+
+    m_source.setMaximumDecodedSize(decodedSize);
+
+    // The scale is fixed when a decoder reads the image size, so frames need a
+    // new decoder to be decoded at the new size.
+    if (m_source.initialized())
+        destroyDecodedData(true);
+}
+
+void BitmapImage::clearMaximumDecodedSize()
+{
+    if (m_source.maximumDecodedSize().isEmpty())
+        return;
+
+    m_source.setMaximumDecodedSize(IntSize());
+    if (m_source.initialized())
+        destroyDecodedData(true);
+}
+#endif
+
 String BitmapImage::filenameExtension() const
 {
     return m_source.filenameExtension();
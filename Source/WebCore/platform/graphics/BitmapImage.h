@@ -98,6 +98,23 @@ public:
     unsigned m_frameBytes;
 };
 
+// Marks painting that is redone once an image finishes decoding, such as
+// painting an <img> into the page. While a scope that allows it is alive on
+// the main thread, decoders may return an empty frame for a large image and
+// decode it in the background, notifying the BitmapImage when it is ready.
+class AsynchronousImageDecodingScope {
+    WTF_MAKE_NONCOPYABLE(AsynchronousImageDecodingScope);
+public:
+    explicit AsynchronousImageDecodingScope(bool allowsAsynchronousDecoding);
+    ~AsynchronousImageDecodingScope();
+
+    static bool isActive() { return s_activeScopeCount; }
+
+private:
+    bool m_allowsAsynchronousDecoding;
+    static unsigned s_activeScopeCount;
+};
+
 // =================================================
 // BitmapImage Class
 // =================================================
@@ -184,6 +201,16 @@ public:
     bool allowSubsampling() const { return m_allowSubsampling; }
     void setAllowSubsampling(bool allowSubsampling) { m_allowSubsampling = allowSubsampling; }
 
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+    // Lets frames be decoded at a fraction of the image size that still covers
+    // |displayedSize|, in device pixels. Frames already decoded at a different
+    // size are dropped and decoded again.
+    void updateMaximumDecodedSize(const IntSize& displayedSize);
+    // Decodes frames at the natural image size again.
+    void clearMaximumDecodedSize();
+    IntSize maximumDecodedSize() const { return m_source.maximumDecodedSize(); }
+#endif
+
     size_t currentFrame() const { return m_currentFrame; }
     
 private:
@@ -291,6 +318,10 @@ private:
     void clearTimer();
     void startTimer(double delay);
 
+#if !USE(CG)
+    void frameDecodedAsynchronously(size_t index);
+#endif
+
     virtual void dump(TextStream&) const override;
 
     ImageSource m_source;
@@ -41,6 +41,7 @@
 #include <QRawFont>
 QT_BEGIN_NAMESPACE
 class QTextLayout;
+class QTextLine;
 QT_END_NAMESPACE
 #endif
 
@@ -343,6 +344,7 @@ private:
 
 #if PLATFORM(QT)
     void initFormatForTextLayout(QTextLayout*, const TextRun&) const;
+    QTextLine lineForComplexText(const TextRun&) const;
 #endif
 
     FontCascadeDescription m_fontDescription;
@@ -266,6 +266,7 @@ public:
     bool updatingControlTints() const { return m_nonPaintingReasons == NonPaintingReasons::UpdatingControlTints; }
 
     void setDisplayListRecorder(DisplayList::Recorder* recorder) { m_displayListRecorder = recorder; }
+    DisplayList::Recorder* displayListRecorder() const { return m_displayListRecorder; }
     bool isRecording() const { return m_displayListRecorder; }
 
     void setStrokeThickness(float);
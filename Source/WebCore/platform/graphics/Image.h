@@ -94,6 +94,10 @@ public:
     virtual bool currentFrameKnownToBeOpaque() = 0;
     virtual bool isAnimated() const { return false; }
 
+    // Derived classes should override this if drawing the image only reads pixels
+    // the image owns, without decoding or advancing animations.
+    virtual bool canBeDrawnFromAnyThread() const { return false; }
+
     // Derived classes should override this if they can assure that 
     // the image contains only resources from its own security origin.
     virtual bool hasSingleSecurityOrigin() const { return false; }
@@ -39,8 +39,13 @@
 namespace WebCore {
 
 #if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+#if PLATFORM(QT)
+// Qt only decodes images smaller than their natural size to fit their displayed size.
+unsigned ImageSource::s_maxPixelsPerDecodedImage = 0;
+#else
 unsigned ImageSource::s_maxPixelsPerDecodedImage = 1024 * 1024;
 #endif
+#endif
 
 ImageSource::ImageSource(ImageSource::AlphaOption alphaOption, ImageSource::GammaAndColorProfileOption gammaAndColorProfileOption)
     : m_decoder(0)
@@ -84,7 +89,11 @@ void ImageSource::setData(SharedBuffer* data, bool allDataReceived)
 #if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
         if (m_decoder && s_maxPixelsPerDecodedImage)
             m_decoder->setMaxNumPixels(s_maxPixelsPerDecodedImage);
+        if (m_decoder && !m_maximumDecodedSize.isEmpty())
+            m_decoder->setMaxDecodedSize(m_maximumDecodedSize);
 #endif
+        if (m_decoder && m_frameDecodedCallback)
+            m_decoder->setFrameDecodedCallback(m_frameDecodedCallback);
     }
 
     if (m_decoder)
@@ -214,6 +223,13 @@ unsigned ImageSource::frameBytesAtIndex(size_t index, SubsamplingLevel) const
     return m_decoder->frameBytesAtIndex(index);
 }
 
+void ImageSource::setFrameDecodedCallback(std::function<void (size_t)> callback)
+{
+    m_frameDecodedCallback = WTFMove(callback);
+    if (m_decoder)
+        m_decoder->setFrameDecodedCallback(m_frameDecodedCallback);
+}
+
 }
 
 #endif // USE(CG)
@@ -28,11 +28,13 @@
 #define ImageSource_h
 
 #include "ImageOrientation.h"
+#include "IntSize.h"
 #include "NativeImagePtr.h"
 
 #include <wtf/Forward.h>
 #include <wtf/Noncopyable.h>
 #include <wtf/Vector.h>
+#include <functional>
 
 #if USE(CG)
 typedef struct CGImageSource* CGImageSourceRef;
@@ -43,7 +45,6 @@ namespace WebCore {
 
 class ImageOrientation;
 class IntPoint;
-class IntSize;
 class SharedBuffer;
 
 #if USE(CG)
@@ -157,9 +158,20 @@ public:
     // decoded then return 0.
     unsigned frameBytesAtIndex(size_t, SubsamplingLevel = 0) const;
 
+#if !USE(CG)
+    // Called on the main thread when the decoder finishes decoding a frame
+    // asynchronously, so that cached incomplete data for it can be replaced.
+    void setFrameDecodedCallback(std::function<void (size_t)>);
+#endif
+
 #if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
     static unsigned maxPixelsPerDecodedImage() { return s_maxPixelsPerDecodedImage; }
     static void setMaxPixelsPerDecodedImage(unsigned maxPixels) { s_maxPixelsPerDecodedImage = maxPixels; }
+
+    // Frames are decoded no larger than needed to cover this size. Only applies
+    // to decoders created afterwards; see clear().
+    IntSize maximumDecodedSize() const { return m_maximumDecodedSize; }
+    void setMaximumDecodedSize(const IntSize& size) { m_maximumDecodedSize = size; }
 #endif
 
 private:
@@ -168,9 +180,11 @@ private:
 #if !USE(CG)
     AlphaOption m_alphaOption;
     GammaAndColorProfileOption m_gammaAndColorProfileOption;
+    std::function<void (size_t)> m_frameDecodedCallback;
 #endif
 #if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
     static unsigned s_maxPixelsPerDecodedImage;
+    IntSize m_maximumDecodedSize;
 #endif
 };
 
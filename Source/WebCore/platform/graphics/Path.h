@@ -109,6 +109,8 @@ namespace WebCore {
         WEBCORE_EXPORT Path();
 #if USE(CG)
         Path(RetainPtr<CGMutablePathRef>);
+#elif PLATFORM(QT)
+        explicit Path(const QPainterPath&);
 #endif
         WEBCORE_EXPORT ~Path();
 
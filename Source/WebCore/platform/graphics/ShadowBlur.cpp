@@ -38,6 +38,7 @@
 #include <wtf/MathExtras.h>
 #include <wtf/NeverDestroyed.h>
 #include <wtf/Noncopyable.h>
+#include <wtf/Vector.h>
 
 namespace WebCore {
 
@@ -160,6 +161,114 @@ ScratchBuffer& ScratchBuffer::singleton()
     return scratchBuffer;
 }
 
+// The tiled paths only need a small template of the shadow, which depends on
+// the blur and the corner radii but not on the size of the box. Pages tend to
+// use a few shadow styles for many boxes, so recently used templates are kept
+// here instead of being redrawn and blurred for every box.
+class ShadowTemplateCache {
+    WTF_MAKE_NONCOPYABLE(ShadowTemplateCache); WTF_MAKE_FAST_ALLOCATED;
+public:
+    enum TemplateType {
+        OuterShadowTemplate,
+        InnerShadowTemplate
+    };
+
+    struct Key {
+        Key(TemplateType type, const FloatSize& blurRadius, const FloatRoundedRect::Radii& radii, const Color& color, bool shadowsIgnoreTransforms)
+            : type(type)
+            , blurRadius(blurRadius)
+            , radii(radii)
+            , color(color)
+            , shadowsIgnoreTransforms(shadowsIgnoreTransforms)
+        {
+        }
+
+        bool operator==(const Key& other) const
+        {
+            return type == other.type && blurRadius == other.blurRadius && radii == other.radii
+                && color == other.color && shadowsIgnoreTransforms == other.shadowsIgnoreTransforms;
+        }
+
+        TemplateType type;
+        FloatSize blurRadius;
+        FloatRoundedRect::Radii radii;
+        Color color;
+        bool shadowsIgnoreTransforms;
+    };
+
+    ShadowTemplateCache()
+        : m_purgeTimer(*this, &ShadowTemplateCache::clear)
+    {
+    }
+
+    ImageBuffer* find(const Key& key)
+    {
+        for (size_t i = 0; i < m_entries.size(); ++i) {
+            if (m_entries[i].key == key) {
+                // Keep the entries ordered from the least to the most recently used.
+                Entry entry = WTFMove(m_entries[i]);
+                m_entries.remove(i);
+                m_entries.append(WTFMove(entry));
+                return m_entries.last().image.get();
+            }
+        }
+        return nullptr;
+    }
+
+    // The new template is kept even if it is larger than the budget on its own,
+    // since it is about to be drawn.
+    ImageBuffer* add(const Key& key, std::unique_ptr<ImageBuffer> image, const IntSize& size)
+    {
+        size_t bytes = static_cast<size_t>(size.area()) * 4;
+        while (!m_entries.isEmpty() && m_bytesHeld + bytes > maximumBytes) {
+            m_bytesHeld -= m_entries.first().bytes;
+            m_entries.remove(0);
+        }
+
+        ImageBuffer* result = image.get();
+        m_entries.append(Entry { key, WTFMove(image), bytes });
+        m_bytesHeld += bytes;
+        return result;
+    }
+
+    void scheduleTemplateCachePurge()
+    {
+        if (m_purgeTimer.isActive())
+            m_purgeTimer.stop();
+
+        // Templates are small, so they are kept longer than the scratch buffer.
+        const double templateCachePurgeInterval = 10;
+        m_purgeTimer.startOneShot(templateCachePurgeInterval);
+    }
+
+    static ShadowTemplateCache& singleton();
+
+private:
+    static const size_t maximumBytes = 2 * 1024 * 1024;
+
+    void clear()
+    {
+        m_entries.clear();
+        m_bytesHeld = 0;
+    }
+
+    struct Entry {
+        Key key;
+        std::unique_ptr<ImageBuffer> image;
+        size_t bytes;
+    };
+
+    Vector<Entry> m_entries;
+    size_t m_bytesHeld { 0 };
+    Timer m_purgeTimer;
+};
+
+ShadowTemplateCache& ShadowTemplateCache::singleton()
+{
+    static NeverDestroyed<ShadowTemplateCache> templateCache;
+    return templateCache;
+}
+
 static const int templateSideLength = 1;
 
 #if USE(CG)
@@ -667,21 +776,23 @@ void ShadowBlur::drawInsetShadowWithoutTiling(GraphicsContext& graphicsContext,
 
 void ShadowBlur::drawInsetShadowWithTiling(GraphicsContext& graphicsContext, const FloatRect& rect, const FloatRoundedRect& holeRect, const IntSize& templateSize, const IntSize& edgeSize)
 {
-    m_layerImage = ScratchBuffer::singleton().getScratchBuffer(templateSize);
-    if (!m_layerImage)
-        return;
+    auto& templateCache = ShadowTemplateCache::singleton();
+    ShadowTemplateCache::Key templateKey(ShadowTemplateCache::InnerShadowTemplate, m_blurRadius, holeRect.radii(), m_color, m_shadowsIgnoreTransforms);
+    m_layerImage = templateCache.find(templateKey);
+    if (!m_layerImage) {
+        // ShadowBlur is not used with accelerated drawing, so it's OK to make an unconditionally unaccelerated buffer.
+        std::unique_ptr<ImageBuffer> templateImage = ImageBuffer::create(templateSize, Unaccelerated, 1);
+        if (!templateImage)
+            return;
+        m_layerImage = templateCache.add(templateKey, WTFMove(templateImage), templateSize);
 
-    // Draw the rectangle with hole.
-    FloatRect templateBounds(0, 0, templateSize.width(), templateSize.height());
-    FloatRect templateHole = FloatRect(edgeSize.width(), edgeSize.height(), templateSize.width() - 2 * edgeSize.width(), templateSize.height() - 2 * edgeSize.height());
+        // Draw the rectangle with hole.
+        FloatRect templateBounds(0, 0, templateSize.width(), templateSize.height());
+        FloatRect templateHole = FloatRect(edgeSize.width(), edgeSize.height(), templateSize.width() - 2 * edgeSize.width(), templateSize.height() - 2 * edgeSize.height());
 
-    // Only redraw in the scratch buffer if its cached contents don't match our needs
-    bool redrawNeeded = ScratchBuffer::singleton().setCachedInsetShadowValues(m_blurRadius, m_color, templateBounds, templateHole, holeRect.radii());
-    if (redrawNeeded) {
         // Draw shadow into a new ImageBuffer.
         GraphicsContext& shadowContext = m_layerImage->context();
         GraphicsContextStateSaver shadowStateSaver(shadowContext);
-        shadowContext.clearRect(templateBounds);
         shadowContext.setFillRule(RULE_EVENODD);
         shadowContext.setFillColor(Color::black);
 
@@ -727,28 +838,29 @@ void ShadowBlur::drawInsetShadowWithTiling(GraphicsContext& graphicsContext, con
     drawLayerPieces(graphicsContext, destHoleBounds, holeRect.radii(), edgeSize, templateSize, InnerShadow);
 
     m_layerImage = nullptr;
-    ScratchBuffer::singleton().scheduleScratchBufferPurge();
+    templateCache.scheduleTemplateCachePurge();
 }
 
 void ShadowBlur::drawRectShadowWithTiling(GraphicsContext& graphicsContext, const FloatRoundedRect& shadowedRect, const IntSize& templateSize, const IntSize& edgeSize)
 {
-    auto& scratchBuffer = ScratchBuffer::singleton();
-    m_layerImage = scratchBuffer.getScratchBuffer(templateSize);
-    if (!m_layerImage)
-        return;
+    auto& templateCache = ShadowTemplateCache::singleton();
+    ShadowTemplateCache::Key templateKey(ShadowTemplateCache::OuterShadowTemplate, m_blurRadius, shadowedRect.radii(), m_color, m_shadowsIgnoreTransforms);
+    m_layerImage = templateCache.find(templateKey);
+    if (!m_layerImage) {
+        // ShadowBlur is not used with accelerated drawing, so it's OK to make an unconditionally unaccelerated buffer.
+        std::unique_ptr<ImageBuffer> templateImage = ImageBuffer::create(templateSize, Unaccelerated, 1);
+        if (!templateImage)
+            return;
+        m_layerImage = templateCache.add(templateKey, WTFMove(templateImage), templateSize);
 
-    FloatRect templateShadow = FloatRect(edgeSize.width(), edgeSize.height(), templateSize.width() - 2 * edgeSize.width(), templateSize.height() - 2 * edgeSize.height());
+        FloatRect templateShadow = FloatRect(edgeSize.width(), edgeSize.height(), templateSize.width() - 2 * edgeSize.width(), templateSize.height() - 2 * edgeSize.height());
 
-    // Only redraw in the scratch buffer if its cached contents don't match our needs
-    bool redrawNeeded = scratchBuffer.setCachedShadowValues(m_blurRadius, m_color, templateShadow, shadowedRect.radii(), m_layerSize);
-    if (redrawNeeded) {
         // Draw shadow into the ImageBuffer.
         GraphicsContext& shadowContext = m_layerImage->context();
         GraphicsContextStateSaver shadowStateSaver(shadowContext);
 
-        shadowContext.clearRect(FloatRect(0, 0, templateSize.width(), templateSize.height()));
         shadowContext.setFillColor(Color::black);
-        
+
         if (shadowedRect.radii().isZero())
             shadowContext.fillRect(templateShadow);
         else {
@@ -773,7 +885,7 @@ void ShadowBlur::drawRectShadowWithTiling(GraphicsContext& graphicsContext, cons
     drawLayerPieces(graphicsContext, shadowBounds, shadowedRect.radii(), edgeSize, templateSize, OuterShadow);
 
     m_layerImage = nullptr;
-    ScratchBuffer::singleton().scheduleScratchBufferPurge();
+    templateCache.scheduleTemplateCachePurge();
 }
 
 void ShadowBlur::drawLayerPieces(GraphicsContext& graphicsContext, const FloatRect& shadowBounds, const FloatRoundedRect::Radii& radii, const IntSize& bufferPadding, const IntSize& templateSize, ShadowDirection direction)
@@ -887,7 +999,7 @@ GraphicsContext* ShadowBlur::beginShadowLayer(GraphicsContext& context, const Fl
         return nullptr;
 
     // We reset the scratch buffer values here, because the buffer will no longer contain
-    // data from any previous rectangle or inset shadows drawn via the tiling path.
+    // data from any previous rectangle or inset shadows drawn without tiling.
     auto& scratchBuffer = ScratchBuffer::singleton();
     scratchBuffer.setCachedShadowValues(FloatSize(), Color::black, IntRect(), FloatRoundedRect::Radii(), m_layerSize);
     m_layerImage = scratchBuffer.getScratchBuffer(layerRect.size());
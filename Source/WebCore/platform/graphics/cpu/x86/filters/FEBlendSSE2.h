@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FEBlendSSE2_h
+#define FEBlendSSE2_h
+
+#if HAVE(X86_SSE2_INTRINSICS)
+
+#include "FEBlend.h"
+#include "FilterKernelsAVX2.h"
+#include "SSE2Helpers.h"
+#include <string.h>
+
+namespace WebCore {
+
+// The same arithmetic as FEBlendUtilitiesNEON, on premultiplied pixels widened
+// to 16 bits. Every intermediate value fits in 16 bits, and the values that are
+// compared never exceed 510, so signed comparisons can be used.
+class FEBlendUtilitiesSSE2 {
+public:
+    static inline bool isSupportedMode(BlendMode mode)
+    {
+        return mode == BlendModeNormal || mode == BlendModeMultiply || mode == BlendModeScreen
+            || mode == BlendModeDarken || mode == BlendModeLighten;
+    }
+
+    // Exact for every product of two bytes.
+    static inline __m128i div255(__m128i num)
+    {
+        __m128i one = _mm_set1_epi16(1);
+        return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(num, one), _mm_srli_epi16(num, 8)), 8);
+    }
+
+    static inline __m128i normal(__m128i pixelA, __m128i pixelB, __m128i alphaA, __m128i, __m128i sixteenConst255)
+    {
+        __m128i tmp1 = _mm_sub_epi16(sixteenConst255, alphaA);
+        __m128i tmp2 = _mm_mullo_epi16(tmp1, pixelB);
+        return _mm_add_epi16(div255(tmp2), pixelA);
+    }
+
+    static inline __m128i multiply(__m128i pixelA, __m128i pixelB, __m128i alphaA, __m128i alphaB, __m128i sixteenConst255)
+    {
+        __m128i tmp1 = _mm_sub_epi16(sixteenConst255, alphaA);
+        __m128i tmp2 = _mm_mullo_epi16(tmp1, pixelB);
+        __m128i tmp3 = _mm_add_epi16(_mm_sub_epi16(sixteenConst255, alphaB), pixelB);
+        __m128i tmp4 = _mm_mullo_epi16(tmp3, pixelA);
+        return div255(_mm_add_epi16(tmp2, tmp4));
+    }
+
+    static inline __m128i screen(__m128i pixelA, __m128i pixelB, __m128i, __m128i, __m128i)
+    {
+        __m128i tmp1 = _mm_add_epi16(pixelA, pixelB);
+        __m128i tmp2 = _mm_mullo_epi16(pixelA, pixelB);
+        return _mm_sub_epi16(tmp1, div255(tmp2));
+    }
+
+    static inline __m128i darken(__m128i pixelA, __m128i pixelB, __m128i alphaA, __m128i alphaB, __m128i sixteenConst255)
+    {
+        __m128i tmp1 = normal(pixelA, pixelB, alphaA, alphaB, sixteenConst255);
+        __m128i tmp2 = normal(pixelB, pixelA, alphaB, alphaA, sixteenConst255);
+        return _mm_min_epi16(tmp1, tmp2);
+    }
+
+    static inline __m128i lighten(__m128i pixelA, __m128i pixelB, __m128i alphaA, __m128i alphaB, __m128i sixteenConst255)
+    {
+        __m128i tmp1 = normal(pixelA, pixelB, alphaA, alphaB, sixteenConst255);
+        __m128i tmp2 = normal(pixelB, pixelA, alphaB, alphaA, sixteenConst255);
+        return _mm_max_epi16(tmp1, tmp2);
+    }
+
+    // Blends two pixels held in 16 bit channels. The alpha of the result is
+    // 1 - (1 - alphaA) * (1 - alphaB) for every mode.
+    static inline __m128i blend(BlendMode mode, __m128i pixelA, __m128i pixelB, __m128i sixteenConst255, __m128i alphaMask)
+    {
+        __m128i alphaA = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixelA, 0xff), 0xff);
+        __m128i alphaB = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixelB, 0xff), 0xff);
+
+        __m128i result;
+        switch (mode) {
+        case BlendModeNormal:
+            result = normal(pixelA, pixelB, alphaA, alphaB, sixteenConst255);
+            break;
+        case BlendModeMultiply:
+            result = multiply(pixelA, pixelB, alphaA, alphaB, sixteenConst255);
+            break;
+        case BlendModeScreen:
+            result = screen(pixelA, pixelB, alphaA, alphaB, sixteenConst255);
+            break;
+        case BlendModeDarken:
+            result = darken(pixelA, pixelB, alphaA, alphaB, sixteenConst255);
+            break;
+        case BlendModeLighten:
+            result = lighten(pixelA, pixelB, alphaA, alphaB, sixteenConst255);
+            break;
+        default:
+            ASSERT_NOT_REACHED();
+            result = _mm_setzero_si128();
+            break;
+        }
+
+        __m128i inverseAlpha = div255(_mm_mullo_epi16(_mm_sub_epi16(sixteenConst255, alphaA), _mm_sub_epi16(sixteenConst255, alphaB)));
+        __m128i alphaR = _mm_sub_epi16(sixteenConst255, inverseAlpha);
+        return _mm_or_si128(_mm_andnot_si128(alphaMask, result), _mm_and_si128(alphaMask, alphaR));
+    }
+
+    static inline __m128i blendPixels(BlendMode mode, __m128i pixelsA, __m128i pixelsB)
+    {
+        __m128i zero = _mm_setzero_si128();
+        __m128i sixteenConst255 = _mm_set1_epi16(255);
+        __m128i alphaMask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+
+        __m128i low = blend(mode, _mm_unpacklo_epi8(pixelsA, zero), _mm_unpacklo_epi8(pixelsB, zero), sixteenConst255, alphaMask);
+        __m128i high = blend(mode, _mm_unpackhi_epi8(pixelsA, zero), _mm_unpackhi_epi8(pixelsB, zero), sixteenConst255, alphaMask);
+        return _mm_packus_epi16(low, high);
+    }
+};
+
+void FEBlend::platformApplySSE2(unsigned char* srcPixelArrayA, unsigned char* srcPixelArrayB, unsigned char* dstPixelArray,
+                                unsigned colorArrayLength)
+{
+    ASSERT(FEBlendUtilitiesSSE2::isSupportedMode(m_mode));
+
+#if HAVE(X86_AVX2_INTRINSICS)
+    if (cpuSupportsAVX2()) {
+        blendAVX2(srcPixelArrayA, srcPixelArrayB, dstPixelArray, colorArrayLength, m_mode);
+        return;
+    }
+#endif
+
+    unsigned vectorLength = colorArrayLength & ~15u;
+    for (unsigned colorOffset = 0; colorOffset < vectorLength; colorOffset += 16) {
+        __m128i pixelsA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcPixelArrayA + colorOffset));
+        __m128i pixelsB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcPixelArrayB + colorOffset));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dstPixelArray + colorOffset), FEBlendUtilitiesSSE2::blendPixels(m_mode, pixelsA, pixelsB));
+    }
+
+    // Blend the last few pixels in padded copies.
+    unsigned remainingLength = colorArrayLength - vectorLength;
+    if (remainingLength) {
+        unsigned char lastPixelsA[16] = { 0 };
+        unsigned char lastPixelsB[16] = { 0 };
+        memcpy(lastPixelsA, srcPixelArrayA + vectorLength, remainingLength);
+        memcpy(lastPixelsB, srcPixelArrayB + vectorLength, remainingLength);
+        __m128i result = FEBlendUtilitiesSSE2::blendPixels(m_mode, _mm_loadu_si128(reinterpret_cast<const __m128i*>(lastPixelsA)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(lastPixelsB)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lastPixelsA), result);
+        memcpy(dstPixelArray + vectorLength, lastPixelsA, remainingLength);
+    }
+}
+
+} // namespace WebCore
+
+#endif // HAVE(X86_SSE2_INTRINSICS)
+
+#endif // FEBlendSSE2_h
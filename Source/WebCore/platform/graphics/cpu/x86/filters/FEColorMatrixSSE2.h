@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FEColorMatrixSSE2_h
+#define FEColorMatrixSSE2_h
+
+#if HAVE(X86_SSE2_INTRINSICS)
+
+#include "SSE2Helpers.h"
+#include <string.h>
+#include <xmmintrin.h>
+
+namespace WebCore {
+
+inline __m128i colorMatrixPixelsSSE2(__m128i pixels, const __m128 matrix[20])
+{
+    __m128 channels[4];
+    unpackRGBA8AsFloat(pixels, channels);
+    _MM_TRANSPOSE4_PS(channels[0], channels[1], channels[2], channels[3]);
+
+    // Summed in the same order as matrix() in FEColorMatrix.cpp, so the results are identical.
+    __m128 result[4];
+    for (int row = 0; row < 4; ++row) {
+        const __m128* values = matrix + row * 5;
+        __m128 sum = _mm_mul_ps(values[0], channels[0]);
+        sum = _mm_add_ps(sum, _mm_mul_ps(values[1], channels[1]));
+        sum = _mm_add_ps(sum, _mm_mul_ps(values[2], channels[2]));
+        sum = _mm_add_ps(sum, _mm_mul_ps(values[3], channels[3]));
+        result[row] = _mm_add_ps(sum, values[4]);
+    }
+
+    _MM_TRANSPOSE4_PS(result[0], result[1], result[2], result[3]);
+    return packFloatAsRGBA8Rounded(result);
+}
+
+// Applies a 4x5 color matrix to unmultiplied RGBA pixels.
+inline void colorMatrixSSE2(unsigned char* pixels, unsigned pixelArrayLength, const float* values)
+{
+    __m128 matrix[20];
+    for (int i = 0; i < 20; ++i)
+        matrix[i] = _mm_set1_ps(i % 5 == 4 ? values[i] * 255 : values[i]);
+
+    unsigned vectorLength = pixelArrayLength & ~15u;
+    for (unsigned offset = 0; offset < vectorLength; offset += 16) {
+        __m128i* pixel = reinterpret_cast<__m128i*>(pixels + offset);
+        _mm_storeu_si128(pixel, colorMatrixPixelsSSE2(_mm_loadu_si128(pixel), matrix));
+    }
+
+    // Process the last few pixels in a padded copy.
+    unsigned remainingLength = pixelArrayLength - vectorLength;
+    if (remainingLength) {
+        unsigned char lastPixels[16] = { 0 };
+        memcpy(lastPixels, pixels + vectorLength, remainingLength);
+        __m128i* pixel = reinterpret_cast<__m128i*>(lastPixels);
+        _mm_storeu_si128(pixel, colorMatrixPixelsSSE2(_mm_loadu_si128(pixel), matrix));
+        memcpy(pixels + vectorLength, lastPixels, remainingLength);
+    }
+}
+
+// The saturate and hueRotate types are a color matrix that keeps alpha and has no offsets.
+inline void saturateAndHueRotateSSE2(unsigned char* pixels, unsigned pixelArrayLength, const float* components)
+{
+    const float values[20] = {
+        components[0], components[1], components[2], 0, 0,
+        components[3], components[4], components[5], 0, 0,
+        components[6], components[7], components[8], 0, 0,
+        0, 0, 0, 1, 0
+    };
+    colorMatrixSSE2(pixels, pixelArrayLength, values);
+}
+
+} // namespace WebCore
+
+#endif // HAVE(X86_SSE2_INTRINSICS)
+
+#endif // FEColorMatrixSSE2_h
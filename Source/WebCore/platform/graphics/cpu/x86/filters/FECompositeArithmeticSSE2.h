@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FECompositeArithmeticSSE2_h
+#define FECompositeArithmeticSSE2_h
+
+#if HAVE(X86_SSE2_INTRINSICS)
+
+#include "FEComposite.h"
+#include "FilterKernelsAVX2.h"
+#include "SSE2Helpers.h"
+
+namespace WebCore {
+
+template <int b1, int b4>
+inline void FEComposite::computeArithmeticPixelsSSE2(unsigned char* source, unsigned char* destination,
+    unsigned pixelArrayLength, float k1, float k2, float k3, float k4)
+{
+    float scaledK1 = k1 / 255.0f;
+    float scaledK4 = k4 * 255.0f;
+    __m128 k1x4 = _mm_set1_ps(scaledK1);
+    __m128 k2x4 = _mm_set1_ps(k2);
+    __m128 k3x4 = _mm_set1_ps(k3);
+    __m128 k4x4 = _mm_set1_ps(scaledK4);
+
+    // The operations are done in the same order as computeArithmeticPixels(), so the results are identical.
+    unsigned vectorLength = pixelArrayLength & ~15u;
+    for (unsigned offset = 0; offset < vectorLength; offset += 16) {
+        __m128 sourceValues[4];
+        __m128 destinationValues[4];
+        unpackRGBA8AsFloat(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + offset)), sourceValues);
+        unpackRGBA8AsFloat(_mm_loadu_si128(reinterpret_cast<const __m128i*>(destination + offset)), destinationValues);
+
+        __m128 result[4];
+        for (int i = 0; i < 4; ++i) {
+            result[i] = _mm_add_ps(_mm_mul_ps(k2x4, sourceValues[i]), _mm_mul_ps(k3x4, destinationValues[i]));
+            if (b1)
+                result[i] = _mm_add_ps(result[i], _mm_mul_ps(_mm_mul_ps(k1x4, sourceValues[i]), destinationValues[i]));
+            if (b4)
+                result[i] = _mm_add_ps(result[i], k4x4);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + offset), packFloatAsRGBA8Truncated(result));
+    }
+
+    for (unsigned offset = vectorLength; offset < pixelArrayLength; ++offset) {
+        unsigned char i1 = source[offset];
+        unsigned char i2 = destination[offset];
+        float result = k2 * i1 + k3 * i2;
+        if (b1)
+            result += scaledK1 * i1 * i2;
+        if (b4)
+            result += scaledK4;
+        destination[offset] = static_cast<unsigned char>(std::min(std::max(result, 0.0f), 255.0f));
+    }
+}
+
+inline void FEComposite::platformArithmeticSSE2(unsigned char* source, unsigned char* destination,
+    unsigned pixelArrayLength, float k1, float k2, float k3, float k4)
+{
+#if HAVE(X86_AVX2_INTRINSICS)
+    if (cpuSupportsAVX2()) {
+        arithmeticAVX2(source, destination, pixelArrayLength, k1, k2, k3, k4);
+        return;
+    }
+#endif
+
+    if (!k4) {
+        if (!k1) {
+            computeArithmeticPixelsSSE2<0, 0>(source, destination, pixelArrayLength, k1, k2, k3, k4);
+            return;
+        }
+
+        computeArithmeticPixelsSSE2<1, 0>(source, destination, pixelArrayLength, k1, k2, k3, k4);
+        return;
+    }
+
+    if (!k1) {
+        computeArithmeticPixelsSSE2<0, 1>(source, destination, pixelArrayLength, k1, k2, k3, k4);
+        return;
+    }
+    computeArithmeticPixelsSSE2<1, 1>(source, destination, pixelArrayLength, k1, k2, k3, k4);
+}
+
+} // namespace WebCore
+
+#endif // HAVE(X86_SSE2_INTRINSICS)
+
+#endif // FECompositeArithmeticSSE2_h
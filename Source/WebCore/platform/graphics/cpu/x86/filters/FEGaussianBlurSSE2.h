@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FEGaussianBlurSSE2_h
+#define FEGaussianBlurSSE2_h
+
+#if HAVE(X86_SSE2_INTRINSICS)
+
+#include "FEGaussianBlur.h"
+#include "FilterKernelsAVX2.h"
+#include "SSE2Helpers.h"
+
+namespace WebCore {
+
+// Same as boxBlur() with EDGEMODE_NONE for RGBA images. The sums are kept as
+// integers, and (sum + 0.5) / dx truncates to the same value as the integer
+// division for every kernel size up to gMaxKernelSize.
+inline void boxBlurSSE2(Uint8ClampedArray* srcPixelArray, Uint8ClampedArray* dstPixelArray,
+                        unsigned dx, int dxLeft, int dxRight, int stride, int strideLine, int effectWidth, int effectHeight)
+{
+#if HAVE(X86_AVX2_INTRINSICS)
+    if (cpuSupportsAVX2()) {
+        boxBlurAVX2(srcPixelArray->data(), dstPixelArray->data(), dx, dxLeft, dxRight, stride, strideLine, effectWidth, effectHeight);
+        return;
+    }
+#endif
+
+    uint32_t* sourcePixel = reinterpret_cast<uint32_t*>(srcPixelArray->data());
+    uint32_t* destinationPixel = reinterpret_cast<uint32_t*>(dstPixelArray->data());
+
+    __m128 deltaX = _mm_set1_ps(1.0f / dx);
+    __m128 half = _mm_set1_ps(0.5f);
+    int pixelLine = strideLine / 4;
+    int pixelStride = stride / 4;
+    int maxKernelSize = std::min(dxRight, effectWidth);
+
+    for (int y = 0; y < effectHeight; ++y) {
+        int line = y * pixelLine;
+        __m128i sum = _mm_setzero_si128();
+        // Fill the kernel
+        for (int i = 0; i < maxKernelSize; ++i)
+            sum = _mm_add_epi32(sum, loadRGBA8AsInt32(sourcePixel + line + i * pixelStride));
+
+        // Blurring
+        for (int x = 0; x < effectWidth; ++x) {
+            int pixelOffset = line + x * pixelStride;
+            __m128 result = _mm_mul_ps(_mm_add_ps(_mm_cvtepi32_ps(sum), half), deltaX);
+            storeInt32AsRGBA8(_mm_cvttps_epi32(result), destinationPixel + pixelOffset);
+            if (x >= dxLeft)
+                sum = _mm_sub_epi32(sum, loadRGBA8AsInt32(sourcePixel + pixelOffset - dxLeft * pixelStride));
+            if (x + dxRight < effectWidth)
+                sum = _mm_add_epi32(sum, loadRGBA8AsInt32(sourcePixel + pixelOffset + dxRight * pixelStride));
+        }
+    }
+}
+
+} // namespace WebCore
+
+#endif // HAVE(X86_SSE2_INTRINSICS)
+
+#endif // FEGaussianBlurSSE2_h
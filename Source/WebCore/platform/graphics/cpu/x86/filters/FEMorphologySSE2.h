@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FEMorphologySSE2_h
+#define FEMorphologySSE2_h
+
+#if HAVE(X86_SSE2_INTRINSICS)
+
+#include "FEMorphology.h"
+#include "FilterKernelsAVX2.h"
+#include "SSE2Helpers.h"
+#include <string.h>
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+template<MorphologyOperatorType type>
+inline __m128i morphologyExtremumSSE2(__m128i a, __m128i b)
+{
+    return type == FEMORPHOLOGY_OPERATOR_ERODE ? _mm_min_epu8(a, b) : _mm_max_epu8(a, b);
+}
+
+template<MorphologyOperatorType type>
+inline unsigned char morphologyExtremum(unsigned char a, unsigned char b)
+{
+    return type == FEMORPHOLOGY_OPERATOR_ERODE ? std::min(a, b) : std::max(a, b);
+}
+
+// The kernel is separable: every row first takes the extrema of its source
+// columns, then the extrema of the neighbouring column results. Each channel
+// is independent, so sixteen of them are processed at once.
+template<MorphologyOperatorType type>
+inline void morphologySSE2(const unsigned char* source, unsigned char* destination,
+    int width, int height, int radiusX, int radiusY, int yStart, int yEnd)
+{
+    const int rowLength = width * 4;
+    const int padding = radiusX * 4;
+
+    // Padding the column extrema with the identity of the operator lets the
+    // horizontal pass run over the edges without bounds checks.
+    Vector<unsigned char> columnExtremaBuffer(rowLength + 2 * padding);
+    columnExtremaBuffer.fill(type == FEMORPHOLOGY_OPERATOR_ERODE ? 255 : 0);
+    unsigned char* columnExtrema = columnExtremaBuffer.data() + padding;
+
+    for (int y = yStart; y < yEnd; ++y) {
+        int yStartExtrema = std::max(0, y - radiusY);
+        int yEndExtrema = std::min(height - 1, y + radiusY);
+
+        memcpy(columnExtrema, source + yStartExtrema * rowLength, rowLength);
+        for (int row = yStartExtrema + 1; row <= yEndExtrema; ++row) {
+            const unsigned char* sourceLine = source + row * rowLength;
+            int offset = 0;
+            for (; offset + 16 <= rowLength; offset += 16) {
+                __m128i* extrema = reinterpret_cast<__m128i*>(columnExtrema + offset);
+                __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sourceLine + offset));
+                _mm_storeu_si128(extrema, morphologyExtremumSSE2<type>(_mm_loadu_si128(extrema), pixels));
+            }
+            for (; offset < rowLength; ++offset)
+                columnExtrema[offset] = morphologyExtremum<type>(columnExtrema[offset], sourceLine[offset]);
+        }
+
+        unsigned char* destinationLine = destination + y * rowLength;
+        int offset = 0;
+        for (; offset + 16 <= rowLength; offset += 16) {
+            const unsigned char* kernel = columnExtrema + offset - padding;
+            __m128i result = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kernel));
+            for (int i = 4; i <= 2 * padding; i += 4)
+                result = morphologyExtremumSSE2<type>(result, _mm_loadu_si128(reinterpret_cast<const __m128i*>(kernel + i)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destinationLine + offset), result);
+        }
+        for (; offset < rowLength; ++offset) {
+            const unsigned char* kernel = columnExtrema + offset - padding;
+            unsigned char result = *kernel;
+            for (int i = 4; i <= 2 * padding; i += 4)
+                result = morphologyExtremum<type>(result, kernel[i]);
+            destinationLine[offset] = result;
+        }
+    }
+}
+
+inline void FEMorphology::platformApplySSE2(PaintingData* paintingData, const int yStart, const int yEnd)
+{
+    if (m_type != FEMORPHOLOGY_OPERATOR_ERODE && m_type != FEMORPHOLOGY_OPERATOR_DILATE) {
+        platformApplyGeneric(paintingData, yStart, yEnd);
+        return;
+    }
+
+    const unsigned char* source = paintingData->srcPixelArray->data();
+    unsigned char* destination = paintingData->dstPixelArray->data();
+
+#if HAVE(X86_AVX2_INTRINSICS)
+    if (cpuSupportsAVX2()) {
+        morphologyAVX2(source, destination, paintingData->width, paintingData->height, paintingData->radiusX, paintingData->radiusY,
+            yStart, yEnd, m_type == FEMORPHOLOGY_OPERATOR_ERODE);
+        return;
+    }
+#endif
+
+    if (m_type == FEMORPHOLOGY_OPERATOR_ERODE)
+        morphologySSE2<FEMORPHOLOGY_OPERATOR_ERODE>(source, destination, paintingData->width, paintingData->height, paintingData->radiusX, paintingData->radiusY, yStart, yEnd);
+    else
+        morphologySSE2<FEMORPHOLOGY_OPERATOR_DILATE>(source, destination, paintingData->width, paintingData->height, paintingData->radiusX, paintingData->radiusY, yStart, yEnd);
+}
+
+} // namespace WebCore
+
+#endif // HAVE(X86_SSE2_INTRINSICS)
+
+#endif // FEMorphologySSE2_h
@@ -0,0 +1,323 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "FilterKernelsAVX2.h"
+
+#if HAVE(X86_AVX2_INTRINSICS)
+
+#include <algorithm>
+#include <immintrin.h>
+#include <stdint.h>
+#include <string.h>
+#include <wtf/Vector.h>
+
+// Only these functions are compiled for AVX2, so the rest of WebCore still runs on any x86 CPU.
+#define AVX2_FUNCTION __attribute__((target("avx2")))
+
+namespace WebCore {
+
+bool cpuSupportsAVX2()
+{
+    static bool supportsAVX2 = __builtin_cpu_supports("avx2");
+    return supportsAVX2;
+}
+
+AVX2_FUNCTION static inline __m256i loadRGBA8PairAsInt32(const uint32_t* first, const uint32_t* second)
+{
+    return _mm256_cvtepu8_epi32(_mm_unpacklo_epi32(_mm_cvtsi32_si128(*first), _mm_cvtsi32_si128(*second)));
+}
+
+AVX2_FUNCTION static inline void storeInt32PairAsRGBA8(__m256i data, uint32_t* first, uint32_t* second)
+{
+    __m256i words = _mm256_packs_epi32(data, data);
+    __m256i bytes = _mm256_packus_epi16(words, words);
+    *first = _mm_cvtsi128_si32(_mm256_castsi256_si128(bytes));
+    *second = _mm_cvtsi128_si32(_mm256_extracti128_si256(bytes, 1));
+}
+
+AVX2_FUNCTION void boxBlurAVX2(const unsigned char* source, unsigned char* destination,
+    unsigned dx, int dxLeft, int dxRight, int stride, int strideLine, int effectWidth, int effectHeight)
+{
+    const uint32_t* sourcePixel = reinterpret_cast<const uint32_t*>(source);
+    uint32_t* destinationPixel = reinterpret_cast<uint32_t*>(destination);
+
+    __m256 deltaX = _mm256_set1_ps(1.0f / dx);
+    __m256 half = _mm256_set1_ps(0.5f);
+    int pixelLine = strideLine / 4;
+    int pixelStride = stride / 4;
+    int maxKernelSize = std::min(dxRight, effectWidth);
+
+    // Two lines are blurred at once. If the number of lines is odd, the last
+    // one is blurred twice and the second result is dropped.
+    uint32_t droppedPixel;
+    for (int y = 0; y < effectHeight; y += 2) {
+        bool hasSecondLine = y + 1 < effectHeight;
+        const uint32_t* firstSource = sourcePixel + y * pixelLine;
+        const uint32_t* secondSource = hasSecondLine ? firstSource + pixelLine : firstSource;
+        uint32_t* firstDestination = destinationPixel + y * pixelLine;
+        uint32_t* secondDestination = firstDestination + pixelLine;
+
+        __m256i sum = _mm256_setzero_si256();
+        for (int i = 0; i < maxKernelSize; ++i)
+            sum = _mm256_add_epi32(sum, loadRGBA8PairAsInt32(firstSource + i * pixelStride, secondSource + i * pixelStride));
+
+        for (int x = 0; x < effectWidth; ++x) {
+            int pixelOffset = x * pixelStride;
+            __m256 result = _mm256_mul_ps(_mm256_add_ps(_mm256_cvtepi32_ps(sum), half), deltaX);
+            storeInt32PairAsRGBA8(_mm256_cvttps_epi32(result), firstDestination + pixelOffset,
+                hasSecondLine ? secondDestination + pixelOffset : &droppedPixel);
+            if (x >= dxLeft) {
+                int leftOffset = pixelOffset - dxLeft * pixelStride;
+                sum = _mm256_sub_epi32(sum, loadRGBA8PairAsInt32(firstSource + leftOffset, secondSource + leftOffset));
+            }
+            if (x + dxRight < effectWidth) {
+                int rightOffset = pixelOffset + dxRight * pixelStride;
+                sum = _mm256_add_epi32(sum, loadRGBA8PairAsInt32(firstSource + rightOffset, secondSource + rightOffset));
+            }
+        }
+    }
+}
+
+template <int b1, int b4>
+AVX2_FUNCTION static void computeArithmeticPixelsAVX2(const unsigned char* source, unsigned char* destination,
+    unsigned pixelArrayLength, float k1, float k2, float k3, float k4)
+{
+    float scaledK1 = k1 / 255.0f;
+    float scaledK4 = k4 * 255.0f;
+    __m256 k1x8 = _mm256_set1_ps(scaledK1);
+    __m256 k2x8 = _mm256_set1_ps(k2);
+    __m256 k3x8 = _mm256_set1_ps(k3);
+    __m256 k4x8 = _mm256_set1_ps(scaledK4);
+    __m256 zero = _mm256_setzero_ps();
+    __m256 max255 = _mm256_set1_ps(255);
+    // Packing works within 128 bit lanes, this restores the order of the 4 byte groups.
+    __m256i packOrder = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    unsigned vectorLength = pixelArrayLength & ~31u;
+    for (unsigned offset = 0; offset < vectorLength; offset += 32) {
+        __m256i result[4];
+        for (int i = 0; i < 4; ++i) {
+            __m256 sourceValues = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + offset + i * 8))));
+            __m256 destinationValues = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(destination + offset + i * 8))));
+            __m256 value = _mm256_add_ps(_mm256_mul_ps(k2x8, sourceValues), _mm256_mul_ps(k3x8, destinationValues));
+            if (b1)
+                value = _mm256_add_ps(value, _mm256_mul_ps(_mm256_mul_ps(k1x8, sourceValues), destinationValues));
+            if (b4)
+                value = _mm256_add_ps(value, k4x8);
+            result[i] = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(value, zero), max255));
+        }
+        __m256i bytes = _mm256_packus_epi16(_mm256_packs_epi32(result[0], result[1]), _mm256_packs_epi32(result[2], result[3]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + offset), _mm256_permutevar8x32_epi32(bytes, packOrder));
+    }
+
+    for (unsigned offset = vectorLength; offset < pixelArrayLength; ++offset) {
+        unsigned char i1 = source[offset];
+        unsigned char i2 = destination[offset];
+        float result = k2 * i1 + k3 * i2;
+        if (b1)
+            result += scaledK1 * i1 * i2;
+        if (b4)
+            result += scaledK4;
+        destination[offset] = static_cast<unsigned char>(std::min(std::max(result, 0.0f), 255.0f));
+    }
+}
+
+void arithmeticAVX2(const unsigned char* source, unsigned char* destination,
+    unsigned pixelArrayLength, float k1, float k2, float k3, float k4)
+{
+    if (!k4) {
+        if (!k1) {
+            computeArithmeticPixelsAVX2<0, 0>(source, destination, pixelArrayLength, k1, k2, k3, k4);
+            return;
+        }
+
+        computeArithmeticPixelsAVX2<1, 0>(source, destination, pixelArrayLength, k1, k2, k3, k4);
+        return;
+    }
+
+    if (!k1) {
+        computeArithmeticPixelsAVX2<0, 1>(source, destination, pixelArrayLength, k1, k2, k3, k4);
+        return;
+    }
+    computeArithmeticPixelsAVX2<1, 1>(source, destination, pixelArrayLength, k1, k2, k3, k4);
+}
+
+AVX2_FUNCTION static inline __m256i div255AVX2(__m256i num)
+{
+    __m256i one = _mm256_set1_epi16(1);
+    return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(num, one), _mm256_srli_epi16(num, 8)), 8);
+}
+
+AVX2_FUNCTION static inline __m256i blendNormalAVX2(__m256i pixelA, __m256i pixelB, __m256i alphaA, __m256i sixteenConst255)
+{
+    __m256i tmp1 = _mm256_sub_epi16(sixteenConst255, alphaA);
+    return _mm256_add_epi16(div255AVX2(_mm256_mullo_epi16(tmp1, pixelB)), pixelA);
+}
+
+// See FEBlendUtilitiesSSE2, this is the same arithmetic on twice as many pixels.
+AVX2_FUNCTION static inline __m256i blendAVX2(BlendMode mode, __m256i pixelA, __m256i pixelB, __m256i sixteenConst255, __m256i alphaMask)
+{
+    __m256i alphaA = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(pixelA, 0xff), 0xff);
+    __m256i alphaB = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(pixelB, 0xff), 0xff);
+
+    __m256i result;
+    switch (mode) {
+    case BlendModeNormal:
+        result = blendNormalAVX2(pixelA, pixelB, alphaA, sixteenConst255);
+        break;
+    case BlendModeMultiply: {
+        __m256i tmp1 = _mm256_mullo_epi16(_mm256_sub_epi16(sixteenConst255, alphaA), pixelB);
+        __m256i tmp2 = _mm256_mullo_epi16(_mm256_add_epi16(_mm256_sub_epi16(sixteenConst255, alphaB), pixelB), pixelA);
+        result = div255AVX2(_mm256_add_epi16(tmp1, tmp2));
+        break;
+    }
+    case BlendModeScreen:
+        result = _mm256_sub_epi16(_mm256_add_epi16(pixelA, pixelB), div255AVX2(_mm256_mullo_epi16(pixelA, pixelB)));
+        break;
+    case BlendModeDarken:
+        result = _mm256_min_epi16(blendNormalAVX2(pixelA, pixelB, alphaA, sixteenConst255), blendNormalAVX2(pixelB, pixelA, alphaB, sixteenConst255));
+        break;
+    case BlendModeLighten:
+        result = _mm256_max_epi16(blendNormalAVX2(pixelA, pixelB, alphaA, sixteenConst255), blendNormalAVX2(pixelB, pixelA, alphaB, sixteenConst255));
+        break;
+    default:
+        ASSERT_NOT_REACHED();
+        result = _mm256_setzero_si256();
+        break;
+    }
+
+    __m256i inverseAlpha = div255AVX2(_mm256_mullo_epi16(_mm256_sub_epi16(sixteenConst255, alphaA), _mm256_sub_epi16(sixteenConst255, alphaB)));
+    __m256i alphaR = _mm256_sub_epi16(sixteenConst255, inverseAlpha);
+    return _mm256_or_si256(_mm256_andnot_si256(alphaMask, result), _mm256_and_si256(alphaMask, alphaR));
+}
+
+AVX2_FUNCTION static inline __m256i blendPixelsAVX2(BlendMode mode, __m256i pixelsA, __m256i pixelsB)
+{
+    __m256i zero = _mm256_setzero_si256();
+    __m256i sixteenConst255 = _mm256_set1_epi16(255);
+    __m256i alphaMask = _mm256_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0);
+
+    // Unpacking and packing both work within 128 bit lanes, so the pixel order is kept.
+    __m256i low = blendAVX2(mode, _mm256_unpacklo_epi8(pixelsA, zero), _mm256_unpacklo_epi8(pixelsB, zero), sixteenConst255, alphaMask);
+    __m256i high = blendAVX2(mode, _mm256_unpackhi_epi8(pixelsA, zero), _mm256_unpackhi_epi8(pixelsB, zero), sixteenConst255, alphaMask);
+    return _mm256_packus_epi16(low, high);
+}
+
+AVX2_FUNCTION void blendAVX2(const unsigned char* sourceA, const unsigned char* sourceB, unsigned char* destination,
+    unsigned pixelArrayLength, BlendMode mode)
+{
+    unsigned vectorLength = pixelArrayLength & ~31u;
+    for (unsigned offset = 0; offset < vectorLength; offset += 32) {
+        __m256i pixelsA = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sourceA + offset));
+        __m256i pixelsB = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sourceB + offset));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + offset), blendPixelsAVX2(mode, pixelsA, pixelsB));
+    }
+
+    unsigned remainingLength = pixelArrayLength - vectorLength;
+    if (remainingLength) {
+        unsigned char lastPixelsA[32] = { 0 };
+        unsigned char lastPixelsB[32] = { 0 };
+        memcpy(lastPixelsA, sourceA + vectorLength, remainingLength);
+        memcpy(lastPixelsB, sourceB + vectorLength, remainingLength);
+        __m256i result = blendPixelsAVX2(mode, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lastPixelsA)),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lastPixelsB)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lastPixelsA), result);
+        memcpy(destination + vectorLength, lastPixelsA, remainingLength);
+    }
+}
+
+template<bool erode>
+AVX2_FUNCTION static inline __m256i morphologyExtremumAVX2(__m256i a, __m256i b)
+{
+    return erode ? _mm256_min_epu8(a, b) : _mm256_max_epu8(a, b);
+}
+
+template<bool erode>
+static inline unsigned char morphologyExtremumScalar(unsigned char a, unsigned char b)
+{
+    return erode ? std::min(a, b) : std::max(a, b);
+}
+
+// See morphologySSE2().
+template<bool erode>
+AVX2_FUNCTION static void morphologyRowsAVX2(const unsigned char* source, unsigned char* destination,
+    int width, int height, int radiusX, int radiusY, int yStart, int yEnd)
+{
+    const int rowLength = width * 4;
+    const int padding = radiusX * 4;
+
+    Vector<unsigned char> columnExtremaBuffer(rowLength + 2 * padding);
+    columnExtremaBuffer.fill(erode ? 255 : 0);
+    unsigned char* columnExtrema = columnExtremaBuffer.data() + padding;
+
+    for (int y = yStart; y < yEnd; ++y) {
+        int yStartExtrema = std::max(0, y - radiusY);
+        int yEndExtrema = std::min(height - 1, y + radiusY);
+
+        memcpy(columnExtrema, source + yStartExtrema * rowLength, rowLength);
+        for (int row = yStartExtrema + 1; row <= yEndExtrema; ++row) {
+            const unsigned char* sourceLine = source + row * rowLength;
+            int offset = 0;
+            for (; offset + 32 <= rowLength; offset += 32) {
+                __m256i* extrema = reinterpret_cast<__m256i*>(columnExtrema + offset);
+                __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sourceLine + offset));
+                _mm256_storeu_si256(extrema, morphologyExtremumAVX2<erode>(_mm256_loadu_si256(extrema), pixels));
+            }
+            for (; offset < rowLength; ++offset)
+                columnExtrema[offset] = morphologyExtremumScalar<erode>(columnExtrema[offset], sourceLine[offset]);
+        }
+
+        unsigned char* destinationLine = destination + y * rowLength;
+        int offset = 0;
+        for (; offset + 32 <= rowLength; offset += 32) {
+            const unsigned char* kernel = columnExtrema + offset - padding;
+            __m256i result = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kernel));
+            for (int i = 4; i <= 2 * padding; i += 4)
+                result = morphologyExtremumAVX2<erode>(result, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kernel + i)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(destinationLine + offset), result);
+        }
+        for (; offset < rowLength; ++offset) {
+            const unsigned char* kernel = columnExtrema + offset - padding;
+            unsigned char result = *kernel;
+            for (int i = 4; i <= 2 * padding; i += 4)
+                result = morphologyExtremumScalar<erode>(result, kernel[i]);
+            destinationLine[offset] = result;
+        }
+    }
+}
+
+void morphologyAVX2(const unsigned char* source, unsigned char* destination,
+    int width, int height, int radiusX, int radiusY, int yStart, int yEnd, bool erode)
+{
+    if (erode)
+        morphologyRowsAVX2<true>(source, destination, width, height, radiusX, radiusY, yStart, yEnd);
+    else
+        morphologyRowsAVX2<false>(source, destination, width, height, radiusX, radiusY, yStart, yEnd);
+}
+
+} // namespace WebCore
+
+#endif // HAVE(X86_AVX2_INTRINSICS)
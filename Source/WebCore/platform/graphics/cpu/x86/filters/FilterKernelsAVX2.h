@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FilterKernelsAVX2_h
+#define FilterKernelsAVX2_h
+
+#if HAVE(X86_AVX2_INTRINSICS)
+
+#include "GraphicsTypes.h"
+
+namespace WebCore {
+
+// The SSE2 filter kernels call these instead when the CPU supports AVX2. They
+// produce the same results as the SSE2 kernels, two rows or twice the pixels at a time.
+bool cpuSupportsAVX2();
+
+void boxBlurAVX2(const unsigned char* source, unsigned char* destination,
+    unsigned dx, int dxLeft, int dxRight, int stride, int strideLine, int effectWidth, int effectHeight);
+void arithmeticAVX2(const unsigned char* source, unsigned char* destination,
+    unsigned pixelArrayLength, float k1, float k2, float k3, float k4);
+void blendAVX2(const unsigned char* sourceA, const unsigned char* sourceB, unsigned char* destination,
+    unsigned pixelArrayLength, BlendMode);
+void morphologyAVX2(const unsigned char* source, unsigned char* destination,
+    int width, int height, int radiusX, int radiusY, int yStart, int yEnd, bool erode);
+
+} // namespace WebCore
+
+#endif // HAVE(X86_AVX2_INTRINSICS)
+
+#endif // FilterKernelsAVX2_h
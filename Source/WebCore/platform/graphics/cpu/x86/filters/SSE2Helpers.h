@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SSE2Helpers_h
+#define SSE2Helpers_h
+
+#if HAVE(X86_SSE2_INTRINSICS)
+
+#include <emmintrin.h>
+#include <stdint.h>
+
+namespace WebCore {
+
+inline __m128i loadRGBA8AsInt32(const uint32_t* source)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i pixel = _mm_cvtsi32_si128(*source);
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(pixel, zero), zero);
+}
+
+// Channels outside of [0, 255] saturate.
+inline void storeInt32AsRGBA8(__m128i data, uint32_t* destination)
+{
+    __m128i words = _mm_packs_epi32(data, data);
+    *destination = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+}
+
+// Converts four pixels to four vectors of channel values.
+inline void unpackRGBA8AsFloat(__m128i pixels, __m128 result[4])
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i low = _mm_unpacklo_epi8(pixels, zero);
+    __m128i high = _mm_unpackhi_epi8(pixels, zero);
+    result[0] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero));
+    result[1] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero));
+    result[2] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero));
+    result[3] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero));
+}
+
+inline __m128 clampToByteRange(__m128 data)
+{
+    // _mm_max_ps returns its second operand for NaN, so NaN becomes 0.
+    return _mm_min_ps(_mm_max_ps(data, _mm_setzero_ps()), _mm_set1_ps(255));
+}
+
+inline __m128i packInt32AsRGBA8(const __m128i data[4])
+{
+    return _mm_packus_epi16(_mm_packs_epi32(data[0], data[1]), _mm_packs_epi32(data[2], data[3]));
+}
+
+// Truncates like a float to integer cast.
+inline __m128i packFloatAsRGBA8Truncated(const __m128 data[4])
+{
+    __m128i integers[4];
+    for (int i = 0; i < 4; ++i)
+        integers[i] = _mm_cvttps_epi32(clampToByteRange(data[i]));
+    return packInt32AsRGBA8(integers);
+}
+
+// Rounds half to even like Uint8ClampedArray::set().
+inline __m128i packFloatAsRGBA8Rounded(const __m128 data[4])
+{
+    __m128i integers[4];
+    for (int i = 0; i < 4; ++i)
+        integers[i] = _mm_cvtps_epi32(clampToByteRange(data[i]));
+    return packInt32AsRGBA8(integers);
+}
+
+} // namespace WebCore
+
+#endif // HAVE(X86_SSE2_INTRINSICS)
+
+#endif // SSE2Helpers_h
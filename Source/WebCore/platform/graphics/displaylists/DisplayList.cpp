@@ -48,13 +48,44 @@ void DisplayList::dump() const
 }
 #endif
 
+DisplayList::~DisplayList()
+{
+    clear();
+}
+
+DisplayList& DisplayList::operator=(DisplayList&& other)
+{
+    clear();
+    m_storageMode = other.m_storageMode;
+    m_list = WTFMove(other.m_list);
+    m_arenaItems = WTFMove(other.m_arenaItems);
+    m_arena = WTFMove(other.m_arena);
+    return *this;
+}
+
 void DisplayList::clear()
 {
+    if (m_storageMode == StorageMode::Arena) {
+        removeItemsFromIndex(0);
+        return;
+    }
+
     m_list.clear();
 }
 
 void DisplayList::removeItemsFromIndex(size_t index)
 {
+    if (m_storageMode == StorageMode::Arena) {
+        if (index >= m_arenaItems.size())
+            return;
+
+        for (size_t i = m_arenaItems.size(); i-- > index;)
+            Item::destroyArenaItem(*m_arenaItems[i]);
+        m_arena.rewindTo(m_arenaItems[index]);
+        m_arenaItems.shrink(index);
+        return;
+    }
+
     m_list.resize(index);
 }
 
@@ -91,7 +122,7 @@ bool DisplayList::shouldDumpForFlags(AsTextFlags flags, const Item& item)
 String DisplayList::asText(AsTextFlags flags) const
 {
     TextStream stream;
-    for (auto& item : m_list) {
+    for (auto& item : *this) {
         if (!shouldDumpForFlags(flags, item))
             continue;
         stream << item;
@@ -104,10 +135,9 @@ void DisplayList::dump(TextStream& ts) const
     TextStream::GroupScope group(ts);
     ts << "display list";
 
-    size_t numItems = m_list.size();
-    for (size_t i = 0; i < numItems; ++i) {
+    for (auto it = begin(); it != end(); ++it) {
         TextStream::GroupScope scope(ts);
-        ts << i << " " << m_list[i].get();
+        ts << it.index() << " " << *it;
     }
     ts.startGroup();
     ts << "size in bytes: " << sizeInBytes();
@@ -116,6 +146,9 @@ void DisplayList::dump(TextStream& ts) const
 
 size_t DisplayList::sizeInBytes() const
 {
+    if (m_storageMode == StorageMode::Arena)
+        return m_arena.sizeInBytes();
+
     size_t result = 0;
     for (auto& ref : m_list)
         result += Item::sizeInBytes(ref);
@@ -26,6 +26,7 @@
 #ifndef DisplayList_h
 #define DisplayList_h
 
+#include "DisplayListItemArena.h"
 #include "DisplayListItems.h"
 #include <wtf/FastMalloc.h>
 #include <wtf/Noncopyable.h>
@@ -53,24 +54,74 @@ class DisplayList {
     friend class Recorder;
     friend class Replayer;
 public:
-    DisplayList() = default;
+    enum class StorageMode {
+        // Each item is a separately allocated, ref-counted object.
+        RefCountedItems,
+        // Items are placement-constructed into a bump-allocated ItemArena owned by the list.
+        // Items cannot be shared with other lists, so replay tracking is not supported.
+        Arena,
+    };
+
+    explicit DisplayList(StorageMode storageMode = StorageMode::RefCountedItems)
+        : m_storageMode(storageMode)
+    {
+    }
     DisplayList(DisplayList&&) = default;
+    ~DisplayList();
+
+    DisplayList& operator=(DisplayList&&);
+
+    class Iterator {
+    public:
+        Iterator(const DisplayList& displayList, size_t index)
+            : m_displayList(&displayList)
+            , m_index(index)
+        {
+        }
+
+        const Item& operator*() const { return m_displayList->itemAt(m_index); }
+        const Item* operator->() const { return &m_displayList->itemAt(m_index); }
+
+        Iterator& operator++()
+        {
+            ++m_index;
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const { return m_index == other.m_index && m_displayList == other.m_displayList; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+        size_t index() const { return m_index; }
 
-    DisplayList& operator=(DisplayList&&) = default;
+    private:
+        const DisplayList* m_displayList;
+        size_t m_index;
+    };
+
+    Iterator begin() const { return Iterator(*this, 0); }
+    Iterator end() const { return Iterator(*this, itemCount()); }
+
+    StorageMode storageMode() const { return m_storageMode; }
 
     void dump(TextStream&) const;
 
-    const Vector<Ref<Item>>& list() const { return m_list; }
     Item& itemAt(size_t index)
     {
-        ASSERT(index < m_list.size());
+        ASSERT(index < itemCount());
+        if (m_storageMode == StorageMode::Arena)
+            return *m_arenaItems[index];
         return m_list[index].get();
     }
 
+    const Item& itemAt(size_t index) const
+    {
+        return const_cast<DisplayList&>(*this).itemAt(index);
+    }
+
     void clear();
     void removeItemsFromIndex(size_t);
 
-    size_t itemCount() const { return m_list.size(); }
+    size_t itemCount() const { return m_storageMode == StorageMode::Arena ? m_arenaItems.size() : m_list.size(); }
     size_t sizeInBytes() const;
     
     String asText(AsTextFlags) const;
@@ -81,23 +132,36 @@ public:
 #endif
 
 private:
-    Item& append(Ref<Item>&& item)
+    template<typename T, typename... Args>
+    T& append(Args&&... args)
     {
+        if (m_storageMode == StorageMode::Arena) {
+            T* item = new (NotNull, m_arena.allocate(sizeof(T))) T(std::forward<Args>(args)...);
+            item->relaxAdoptionRequirement();
+            m_arenaItems.append(item);
+            return *item;
+        }
+
+        Ref<T> item = T::create(std::forward<Args>(args)...);
+        T& result = item.get();
         m_list.append(WTFMove(item));
-        return m_list.last().get();
+        return result;
     }
 
     // Less efficient append, only used for tracking replay.
     void appendItem(Item& item)
     {
+        ASSERT(m_storageMode == StorageMode::RefCountedItems);
         m_list.append(item);
     }
 
     static bool shouldDumpForFlags(AsTextFlags, const Item&);
 
-    Vector<Ref<Item>>& list() { return m_list; }
-
+    StorageMode m_storageMode;
     Vector<Ref<Item>> m_list;
+
+    Vector<Item*> m_arenaItems;
+    ItemArena m_arena;
 };
 
 } // DisplayList
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "DisplayListItemArena.h"
+
+#include <wtf/StdLibExtras.h>
+
+namespace WebCore {
+namespace DisplayList {
+
+ItemArena::ItemArena(ItemArena&& other)
+{
+    swap(other);
+}
+
+ItemArena& ItemArena::operator=(ItemArena&& other)
+{
+    ItemArena discarded(WTFMove(other));
+    swap(discarded);
+    return *this;
+}
+
+ItemArena::~ItemArena()
+{
+    for (auto& chunk : m_chunks)
+        fastAlignedFree(chunk.data);
+}
+
+void ItemArena::swap(ItemArena& other)
+{
+    m_chunks.swap(other.m_chunks);
+    std::swap(m_currentChunk, other.m_currentChunk);
+}
+
+void* ItemArena::allocate(size_t size)
+{
+    size = WTF::roundUpToMultipleOf<alignment>(size);
+
+    // Chunks past the current one are always empty, either freshly allocated or rewound.
+    for (size_t i = m_currentChunk; i < m_chunks.size(); ++i) {
+        Chunk& chunk = m_chunks[i];
+        if (chunk.capacity - chunk.used < size)
+            continue;
+
+        m_currentChunk = i;
+        void* result = chunk.data + chunk.used;
+        chunk.used += size;
+        return result;
+    }
+
+    size_t capacity = std::max(defaultChunkSize, size);
+    Chunk chunk { static_cast<char*>(fastAlignedMalloc(alignment, capacity)), capacity, size };
+    m_chunks.append(chunk);
+    m_currentChunk = m_chunks.size() - 1;
+    return chunk.data;
+}
+
+void ItemArena::rewindTo(void* position)
+{
+    char* address = static_cast<char*>(position);
+    for (size_t i = m_currentChunk + 1; i--;) {
+        Chunk& chunk = m_chunks[i];
+        if (address >= chunk.data && address < chunk.data + chunk.used) {
+            chunk.used = address - chunk.data;
+            m_currentChunk = i;
+            return;
+        }
+        chunk.used = 0;
+    }
+    ASSERT_NOT_REACHED();
+}
+
+size_t ItemArena::sizeInBytes() const
+{
+    size_t result = 0;
+    for (auto& chunk : m_chunks)
+        result += chunk.used;
+    return result;
+}
+
+} // namespace DisplayList
+} // namespace WebCore
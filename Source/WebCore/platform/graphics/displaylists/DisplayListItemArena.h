@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#ifndef DisplayListItemArena_h
+#define DisplayListItemArena_h
+
+#include <wtf/FastMalloc.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/Vector.h>
+
+namespace WebCore {
+namespace DisplayList {
+
+// Bump allocator that backs DisplayLists using StorageMode::Arena. Items are placement-constructed
+// back to back into large chunks, so recording costs no malloc per item and replay walks memory
+// linearly. The arena only hands out raw storage; the owning DisplayList runs the item destructors.
+class ItemArena {
+    WTF_MAKE_NONCOPYABLE(ItemArena); WTF_MAKE_FAST_ALLOCATED;
+public:
+    static const size_t alignment = 16;
+
+    ItemArena() = default;
+    ItemArena(ItemArena&&);
+    ItemArena& operator=(ItemArena&&);
+    ~ItemArena();
+
+    void* allocate(size_t);
+
+    // Returns the arena to the state it was in just before the allocation at the given address.
+    void rewindTo(void*);
+
+    // Bytes handed out so far, including alignment padding.
+    size_t sizeInBytes() const;
+
+private:
+    struct Chunk {
+        char* data;
+        size_t capacity;
+        size_t used;
+    };
+
+    static const size_t defaultChunkSize = 16 * 1024;
+
+    void swap(ItemArena&);
+
+    Vector<Chunk, 1> m_chunks;
+    size_t m_currentChunk { 0 };
+};
+
+} // namespace DisplayList
+} // namespace WebCore
+
+#endif // DisplayListItemArena_h
@@ -154,6 +154,14 @@ public:
 #endif
     static size_t sizeInBytes(const Item&);
 
+    // Runs the destructor of an item that a DisplayList placement-constructed into its ItemArena.
+    static void destroyArenaItem(Item& item)
+    {
+        bool lastReference = item.derefBase();
+        ASSERT_UNUSED(lastReference, lastReference); // Arena items must never be shared.
+        item.~Item();
+    }
+
 private:
     ItemType m_type;
 };
@@ -192,6 +200,8 @@ public:
     void setRestoreIndex(size_t index) { m_restoreIndex = index; }
 
 private:
+    friend class DisplayList;
+
     Save()
         : Item(ItemType::Save)
     {
@@ -210,6 +220,8 @@ public:
     }
 
 private:
+    friend class DisplayList;
+
     Restore()
         : Item(ItemType::Restore)
     {
@@ -229,6 +241,8 @@ public:
     float y() const { return m_y; }
 
 private:
+    friend class DisplayList;
+
     Translate(float x, float y)
         : Item(ItemType::Translate)
         , m_x(x)
@@ -252,6 +266,8 @@ public:
     float angle() const { return m_angle; }
 
 private:
+    friend class DisplayList;
+
     Rotate(float angle)
         : Item(ItemType::Rotate)
         , m_angle(angle)
@@ -273,6 +289,8 @@ public:
     const FloatSize& amount() const { return m_size; }
 
 private:
+    friend class DisplayList;
+
     Scale(const FloatSize& size)
         : Item(ItemType::Scale)
         , m_size(size)
@@ -294,6 +312,8 @@ public:
     const AffineTransform& transform() const { return m_transform; }
 
 private:
+    friend class DisplayList;
+
     ConcatenateCTM(const AffineTransform&);
 
     virtual void apply(GraphicsContext&) const override;
@@ -318,6 +338,8 @@ public:
 
     static void dumpStateChanges(TextStream&, const GraphicsContextState&, GraphicsContextState::StateChangeFlags);
 private:
+    friend class DisplayList;
+
     SetState(const GraphicsContextState& state, GraphicsContextState::StateChangeFlags flags)
         : Item(ItemType::SetState)
         , m_state(state, flags)
@@ -339,6 +361,8 @@ public:
     LineCap lineCap() const { return m_lineCap; }
 
 private:
+    friend class DisplayList;
+
     SetLineCap(LineCap lineCap)
         : Item(ItemType::SetLineCap)
         , m_lineCap(lineCap)
@@ -361,6 +385,8 @@ public:
     float dashOffset() const { return m_dashOffset; }
 
 private:
+    friend class DisplayList;
+
     SetLineDash(const DashArray& dashArray, float dashOffset)
         : Item(ItemType::SetLineDash)
         , m_dashArray(dashArray)
@@ -384,6 +410,8 @@ public:
     LineJoin lineJoin() const { return m_lineJoin; }
 
 private:
+    friend class DisplayList;
+
     SetLineJoin(LineJoin lineJoin)
         : Item(ItemType::SetLineJoin)
         , m_lineJoin(lineJoin)
@@ -405,6 +433,8 @@ public:
     float miterLimit() const { return m_miterLimit; }
 
 private:
+    friend class DisplayList;
+
     SetMiterLimit(float miterLimit)
         : Item(ItemType::SetMiterLimit)
         , m_miterLimit(miterLimit)
@@ -424,6 +454,8 @@ public:
     }
 
 private:
+    friend class DisplayList;
+
     ClearShadow()
         : Item(ItemType::ClearShadow)
     {
@@ -443,6 +475,8 @@ public:
     FloatRect rect() const { return m_rect; }
 
 private:
+    friend class DisplayList;
+
     Clip(const FloatRect& rect)
         : Item(ItemType::Clip)
         , m_rect(rect)
@@ -464,6 +498,8 @@ public:
     FloatRect rect() const { return m_rect; }
 
 private:
+    friend class DisplayList;
+
     ClipOut(const FloatRect& rect)
         : Item(ItemType::ClipOut)
         , m_rect(rect)
@@ -485,6 +521,8 @@ public:
     const Path& path() const { return m_path; }
 
 private:
+    friend class DisplayList;
+
     ClipOutToPath(const Path& path)
         : Item(ItemType::ClipOutToPath)
         , m_path(path)
@@ -507,6 +545,8 @@ public:
     WindRule windRule() const { return m_windRule; }
 
 private:
+    friend class DisplayList;
+
     ClipPath(const Path& path, WindRule windRule)
         : Item(ItemType::ClipPath)
         , m_path(path)
@@ -537,6 +577,8 @@ public:
     const Vector<GlyphBufferGlyph, 128>& glyphs() const { return m_glyphs; }
 
 private:
+    friend class DisplayList;
+
     DrawGlyphs(const Font&, const GlyphBufferGlyph*, const GlyphBufferAdvance*, unsigned count, const FloatPoint& blockLocation, const FloatSize& localAnchor, FontSmoothingMode);
 
     void computeBounds();
@@ -568,6 +610,8 @@ public:
     FloatRect destination() const { return m_destination; }
 
 private:
+    friend class DisplayList;
+
     DrawImage(Image&, const FloatRect& destination, const FloatRect& source, const ImagePaintingOptions&);
 
     virtual void apply(GraphicsContext&) const override;
@@ -595,6 +639,8 @@ public:
     FloatSize spacing() const { return m_spacing; }
 
 private:
+    friend class DisplayList;
+
     DrawTiledImage(Image&, const FloatRect& destination, const FloatPoint& source, const FloatSize& tileSize, const FloatSize& spacing, const ImagePaintingOptions&);
 
     virtual void apply(GraphicsContext&) const override;
@@ -621,6 +667,8 @@ public:
     FloatRect destination() const { return m_destination; }
 
 private:
+    friend class DisplayList;
+
     DrawTiledScaledImage(Image&, const FloatRect& destination, const FloatRect& source, const FloatSize& tileScaleFactor, Image::TileRule hRule, Image::TileRule vRule, const ImagePaintingOptions&);
 
     virtual void apply(GraphicsContext&) const override;
@@ -648,6 +696,8 @@ public:
     FloatRect destination() const { return m_destination; }
 
 private:
+    friend class DisplayList;
+
     DrawNativeImage(PassNativeImagePtr, const FloatSize& selfSize, const FloatRect& destRect, const FloatRect& srcRect, CompositeOperator, BlendMode, ImageOrientation);
 
     virtual void apply(GraphicsContext&) const override;
@@ -683,6 +733,8 @@ public:
     FloatSize spacing() const { return m_spacing; }
 
 private:
+    friend class DisplayList;
+
     DrawPattern(Image&, const FloatRect& srcRect, const AffineTransform&, const FloatPoint& phase, const FloatSize& spacing, CompositeOperator, const FloatRect& destRect, BlendMode = BlendModeNormal);
 
     virtual void apply(GraphicsContext&) const override;
@@ -710,6 +762,8 @@ public:
     float opacity() const { return m_opacity; }
 
 private:
+    friend class DisplayList;
+
     BeginTransparencyLayer(float opacity)
         : DrawingItem(ItemType::BeginTransparencyLayer)
         , m_opacity(opacity)
@@ -729,6 +783,8 @@ public:
     }
 
 private:
+    friend class DisplayList;
+
     EndTransparencyLayer()
         : DrawingItem(ItemType::EndTransparencyLayer)
     {
@@ -748,6 +804,8 @@ public:
     float borderThickness() const { return m_borderThickness; }
 
 private:
+    friend class DisplayList;
+
     DrawRect(const FloatRect& rect, float borderThickness)
         : DrawingItem(ItemType::DrawRect)
         , m_rect(rect)
@@ -773,6 +831,8 @@ public:
     FloatPoint point2() const { return m_point2; }
 
 private:
+    friend class DisplayList;
+
     DrawLine(const FloatPoint& point1, const FloatPoint& point2)
         : DrawingItem(ItemType::DrawLine)
         , m_point1(point1)
@@ -803,6 +863,8 @@ public:
     bool doubleLines() const { return m_doubleLines; }
 
 private:
+    friend class DisplayList;
+
     DrawLinesForText(const FloatPoint& blockLocation, const FloatSize& localAnchor, const DashArray& widths, bool printing, bool doubleLines, float strokeWidth)
         : DrawingItem(ItemType::DrawLinesForText)
         , m_blockLocation(blockLocation)
@@ -837,6 +899,8 @@ public:
     float width() const { return m_width; }
 
 private:
+    friend class DisplayList;
+
     DrawLineForDocumentMarker(const FloatPoint& point, float width, GraphicsContext::DocumentMarkerLineStyle style)
         : DrawingItem(ItemType::DrawLineForDocumentMarker)
         , m_point(point)
@@ -864,6 +928,8 @@ public:
     FloatRect rect() const { return m_rect; }
 
 private:
+    friend class DisplayList;
+
     DrawEllipse(const FloatRect& rect)
         : DrawingItem(ItemType::DrawEllipse)
         , m_rect(rect)
@@ -886,6 +952,8 @@ public:
     const Path& path() const { return m_path; }
 
 private:
+    friend class DisplayList;
+
     DrawPath(const Path& path)
         : DrawingItem(ItemType::DrawPath)
         , m_path(path)
@@ -912,6 +980,8 @@ public:
     Color color() const { return m_color; }
 
 private:
+    friend class DisplayList;
+
     DrawFocusRingPath(const Path& path, int width, int offset, const Color& color)
         : DrawingItem(ItemType::DrawFocusRingPath)
         , m_path(path)
@@ -944,6 +1014,8 @@ public:
     Color color() const { return m_color; }
 
 private:
+    friend class DisplayList;
+
     DrawFocusRingRects(const Vector<FloatRect>& rects, int width, int offset, const Color& color)
         : DrawingItem(ItemType::DrawFocusRingRects)
         , m_rects(rects)
@@ -973,6 +1045,8 @@ public:
     FloatRect rect() const { return m_rect; }
 
 private:
+    friend class DisplayList;
+
     FillRect(const FloatRect& rect)
         : DrawingItem(ItemType::FillRect)
         , m_rect(rect)
@@ -997,6 +1071,8 @@ public:
     Color color() const { return m_color; }
 
 private:
+    friend class DisplayList;
+
     FillRectWithColor(const FloatRect& rect, const Color& color)
         : DrawingItem(ItemType::FillRectWithColor)
         , m_rect(rect)
@@ -1021,6 +1097,8 @@ public:
     FloatRect rect() const { return m_rect; }
 
 private:
+    friend class DisplayList;
+
     FillRectWithGradient(const FloatRect& rect, Gradient& gradient)
         : DrawingItem(ItemType::FillRectWithGradient)
         , m_rect(rect)
@@ -1048,6 +1126,8 @@ public:
     BlendMode blendMode() const { return m_blendMode; }
 
 private:
+    friend class DisplayList;
+
     FillCompositedRect(const FloatRect& rect, const Color& color, CompositeOperator op, BlendMode blendMode)
         : DrawingItem(ItemType::FillCompositedRect)
         , m_rect(rect)
@@ -1078,6 +1158,8 @@ public:
     BlendMode blendMode() const { return m_blendMode; }
 
 private:
+    friend class DisplayList;
+
     FillRoundedRect(const FloatRoundedRect& rect, const Color& color, BlendMode blendMode)
         : DrawingItem(ItemType::FillRoundedRect)
         , m_rect(rect)
@@ -1106,6 +1188,8 @@ public:
     Color color() const { return m_color; }
 
 private:
+    friend class DisplayList;
+
     FillRectWithRoundedHole(const FloatRect& rect, const FloatRoundedRect& roundedHoleRect, const Color& color)
         : DrawingItem(ItemType::FillRectWithRoundedHole)
         , m_rect(rect)
@@ -1132,6 +1216,8 @@ public:
     const Path& path() const { return m_path; }
 
 private:
+    friend class DisplayList;
+
     FillPath(const Path& path)
         : DrawingItem(ItemType::FillPath)
         , m_path(path)
@@ -1154,6 +1240,8 @@ public:
     FloatRect rect() const { return m_rect; }
 
 private:
+    friend class DisplayList;
+
     FillEllipse(const FloatRect& rect)
         : DrawingItem(ItemType::FillEllipse)
         , m_rect(rect)
@@ -1178,6 +1266,8 @@ public:
     float lineWidth() const { return m_lineWidth; }
 
 private:
+    friend class DisplayList;
+
     StrokeRect(const FloatRect& rect, float lineWidth)
         : DrawingItem(ItemType::StrokeRect)
         , m_rect(rect)
@@ -1202,6 +1292,8 @@ public:
     const Path& path() const { return m_path; }
 
 private:
+    friend class DisplayList;
+
     StrokePath(const Path& path)
         : DrawingItem(ItemType::StrokePath)
         , m_path(path)
@@ -1225,6 +1317,8 @@ public:
     FloatRect rect() const { return m_rect; }
 
 private:
+    friend class DisplayList;
+
     StrokeEllipse(const FloatRect& rect)
         : DrawingItem(ItemType::StrokeEllipse)
         , m_rect(rect)
@@ -1247,6 +1341,8 @@ public:
     FloatRect rect() const { return m_rect; }
 
 private:
+    friend class DisplayList;
+
     ClearRect(const FloatRect& rect)
         : DrawingItem(ItemType::ClearRect)
         , m_rect(rect)
@@ -1268,6 +1364,8 @@ public:
     }
 
 private:
+    friend class DisplayList;
+
     ApplyStrokePattern()
         : Item(ItemType::ApplyStrokePattern)
     {
@@ -1284,6 +1382,8 @@ public:
     }
 
 private:
+    friend class DisplayList;
+
     ApplyFillPattern()
         : Item(ItemType::ApplyFillPattern)
     {
@@ -1303,6 +1403,8 @@ public:
     float scaleFactor() const { return m_scaleFactor; }
 
 private:
+    friend class DisplayList;
+
     ApplyDeviceScaleFactor(float scaleFactor)
         : Item(ItemType::ApplyDeviceScaleFactor)
         , m_scaleFactor(scaleFactor)
@@ -28,6 +28,7 @@
 
 #include "DisplayList.h"
 #include "DisplayListItems.h"
+#include "DisplayListReplayer.h"
 #include "GraphicsContext.h"
 #include "Logging.h"
 #include "TextStream.h"
@@ -51,18 +52,14 @@ Recorder::~Recorder()
     LOG(DisplayLists, "Recorded display list:\n%s", m_displayList.description().data());
 }
 
-void Recorder::willAppendItem(const Item& item)
+void Recorder::willAppendItem(bool isDrawingItem)
 {
-    if (item.isDrawingItem()
-#if USE(CG)
-        || item.type() == ItemType::ApplyStrokePattern || item.type() == ItemType::ApplyStrokePattern
-#endif
-    ) {
+    if (isDrawingItem) {
         GraphicsContextStateChange& stateChanges = currentState().stateChange;
         GraphicsContextState::StateChangeFlags changesFromLastState = stateChanges.changesFromState(currentState().lastDrawingState);
         if (changesFromLastState) {
             LOG_WITH_STREAM(DisplayLists, stream << "pre-drawing, saving state " << GraphicsContextStateChange(stateChanges.m_state, changesFromLastState));
-            m_displayList.append(SetState::create(stateChanges.m_state, changesFromLastState));
+            m_displayList.append<SetState>(stateChanges.m_state, changesFromLastState);
             stateChanges.m_changeFlags = 0;
             currentState().lastDrawingState = stateChanges.m_state;
         }
@@ -70,6 +67,35 @@ void Recorder::willAppendItem(const Item& item)
     }
 }
 
+void Recorder::convertToRefCountedItems()
+{
+    ASSERT(m_displayList.storageMode() == DisplayList::StorageMode::Arena);
+
+    const ContextState& baseState = m_stateStack.first();
+    DisplayList refCountedList(DisplayList::StorageMode::RefCountedItems);
+    GraphicsContext context;
+    {
+        Recorder recorder(context, refCountedList, baseState.clipBounds, baseState.ctm);
+        Replayer replayer(context, m_displayList);
+        replayer.replay(baseState.clipBounds);
+
+        // The open saves were replayed too, but the Save items may have moved.
+        ASSERT(recorder.m_stateStack.size() == m_stateStack.size());
+        for (size_t i = 1; i < m_stateStack.size(); ++i)
+            m_stateStack[i].saveItemIndex = recorder.m_stateStack[i].saveItemIndex;
+
+        m_displayList = WTFMove(refCountedList);
+
+        // Balance the replayed saves. This only appends Restore items to the moved-from list.
+        for (size_t i = 1; i < recorder.m_stateStack.size(); ++i) {
+            recorder.m_stateStack[i].saveItemIndex = 0;
+            recorder.m_stateStack[i].wasUsedForDrawing = true;
+        }
+        while (recorder.m_stateStack.size() > 1)
+            context.restore();
+    }
+}
+
 void Recorder::updateState(const GraphicsContextState& state, GraphicsContextState::StateChangeFlags flags)
 {
     currentState().stateChange.accumulate(state, flags);
@@ -77,70 +103,70 @@ void Recorder::updateState(const GraphicsContextState& state, GraphicsContextSta
 
 void Recorder::clearShadow()
 {
-    appendItem(ClearShadow::create());
+    append<ClearShadow>();
 }
 
 void Recorder::setLineCap(LineCap lineCap)
 {
-    appendItem(SetLineCap::create(lineCap));
+    append<SetLineCap>(lineCap);
 }
 
 void Recorder::setLineDash(const DashArray& dashArray, float dashOffset)
 {
-    appendItem(SetLineDash::create(dashArray, dashOffset));
+    append<SetLineDash>(dashArray, dashOffset);
 }
 
 void Recorder::setLineJoin(LineJoin lineJoin)
 {
-    appendItem(SetLineJoin::create(lineJoin));
+    append<SetLineJoin>(lineJoin);
 }
 
 void Recorder::setMiterLimit(float miterLimit)
 {
-    appendItem(SetMiterLimit::create(miterLimit));
+    append<SetMiterLimit>(miterLimit);
 }
 
 void Recorder::drawGlyphs(const Font& font, const GlyphBuffer& glyphBuffer, int from, int numGlyphs, const FloatPoint& startPoint, FontSmoothingMode smoothingMode)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(DrawGlyphs::create(font, glyphBuffer.glyphs(from), glyphBuffer.advances(from), numGlyphs, FloatPoint(), toFloatSize(startPoint), smoothingMode)));
+    DrawingItem& newItem = append<DrawGlyphs>(font, glyphBuffer.glyphs(from), glyphBuffer.advances(from), numGlyphs, FloatPoint(), toFloatSize(startPoint), smoothingMode);
     updateItemExtent(newItem);
 }
 
 void Recorder::drawImage(Image& image, const FloatRect& destination, const FloatRect& source, const ImagePaintingOptions& imagePaintingOptions)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(DrawImage::create(image, destination, source, imagePaintingOptions)));
+    DrawingItem& newItem = append<DrawImage>(image, destination, source, imagePaintingOptions);
     updateItemExtent(newItem);
 }
 
 void Recorder::drawTiledImage(Image& image, const FloatRect& destination, const FloatPoint& source, const FloatSize& tileSize, const FloatSize& spacing, const ImagePaintingOptions& imagePaintingOptions)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(DrawTiledImage::create(image, destination, source, tileSize, spacing, imagePaintingOptions)));
+    DrawingItem& newItem = append<DrawTiledImage>(image, destination, source, tileSize, spacing, imagePaintingOptions);
     updateItemExtent(newItem);
 }
 
 #if USE(CG) || USE(CAIRO)
 void Recorder::drawNativeImage(PassNativeImagePtr imagePtr, const FloatSize& imageSize, const FloatRect& destRect, const FloatRect& srcRect, CompositeOperator op, BlendMode blendMode, ImageOrientation orientation)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(DrawNativeImage::create(imagePtr, imageSize, destRect, srcRect, op, blendMode, orientation)));
+    DrawingItem& newItem = append<DrawNativeImage>(imagePtr, imageSize, destRect, srcRect, op, blendMode, orientation);
     updateItemExtent(newItem);
 }
 #endif
 
 void Recorder::drawTiledImage(Image& image, const FloatRect& destination, const FloatRect& source, const FloatSize& tileScaleFactor, Image::TileRule hRule, Image::TileRule vRule, const ImagePaintingOptions& imagePaintingOptions)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(DrawTiledScaledImage::create(image, destination, source, tileScaleFactor, hRule, vRule, imagePaintingOptions)));
+    DrawingItem& newItem = append<DrawTiledScaledImage>(image, destination, source, tileScaleFactor, hRule, vRule, imagePaintingOptions);
     updateItemExtent(newItem);
 }
 
 void Recorder::drawPattern(Image& image, const FloatRect& tileRect, const AffineTransform& patternTransform, const FloatPoint& phase, const FloatSize& spacing, CompositeOperator op, const FloatRect& destRect, BlendMode blendMode)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(DrawPattern::create(image, tileRect, patternTransform, phase, spacing, op, destRect, blendMode)));
+    DrawingItem& newItem = append<DrawPattern>(image, tileRect, patternTransform, phase, spacing, op, destRect, blendMode);
     updateItemExtent(newItem);
 }
 
 void Recorder::save()
 {
-    appendItem(Save::create());
+    append<Save>();
     m_stateStack.append(m_stateStack.last().cloneForSave(m_displayList.itemCount() - 1));
 }
 
@@ -162,7 +188,7 @@ void Recorder::restore()
         return;
     }
 
-    appendItem(Restore::create());
+    append<Restore>();
     
     if (saveIndex) {
         Save& saveItem = downcast<Save>(m_displayList.itemAt(saveIndex));
@@ -173,203 +199,197 @@ void Recorder::restore()
 void Recorder::translate(float x, float y)
 {
     currentState().translate(x, y);
-    appendItem(Translate::create(x, y));
+    append<Translate>(x, y);
 }
 
 void Recorder::rotate(float angleInRadians)
 {
     currentState().rotate(angleInRadians);
-    appendItem(Rotate::create(angleInRadians));
+    append<Rotate>(angleInRadians);
 }
 
 void Recorder::scale(const FloatSize& size)
 {
     currentState().scale(size);
-    appendItem(Scale::create(size));
+    append<Scale>(size);
 }
 
 void Recorder::concatCTM(const AffineTransform& transform)
 {
     currentState().concatCTM(transform);
-    appendItem(ConcatenateCTM::create(transform));
+    append<ConcatenateCTM>(transform);
 }
 
 void Recorder::beginTransparencyLayer(float opacity)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(BeginTransparencyLayer::create(opacity)));
+    DrawingItem& newItem = append<BeginTransparencyLayer>(opacity);
     updateItemExtent(newItem);
 }
 
 void Recorder::endTransparencyLayer()
 {
-    appendItem(EndTransparencyLayer::create());
+    append<EndTransparencyLayer>();
 }
 
 void Recorder::drawRect(const FloatRect& rect, float borderThickness)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(DrawRect::create(rect, borderThickness)));
+    DrawingItem& newItem = append<DrawRect>(rect, borderThickness);
     updateItemExtent(newItem);
 }
 
 void Recorder::drawLine(const FloatPoint& point1, const FloatPoint& point2)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(DrawLine::create(point1, point2)));
+    DrawingItem& newItem = append<DrawLine>(point1, point2);
     updateItemExtent(newItem);
 }
 
 void Recorder::drawLinesForText(const FloatPoint& point, const DashArray& widths, bool printing, bool doubleLines, float strokeThickness)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(DrawLinesForText::create(FloatPoint(), toFloatSize(point), widths, printing, doubleLines, strokeThickness)));
+    DrawingItem& newItem = append<DrawLinesForText>(FloatPoint(), toFloatSize(point), widths, printing, doubleLines, strokeThickness);
     updateItemExtent(newItem);
 }
 
 void Recorder::drawLineForDocumentMarker(const FloatPoint& point, float width, GraphicsContext::DocumentMarkerLineStyle style)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(DrawLineForDocumentMarker::create(point, width, style)));
+    DrawingItem& newItem = append<DrawLineForDocumentMarker>(point, width, style);
     updateItemExtent(newItem);
 }
 
 void Recorder::drawEllipse(const FloatRect& rect)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(DrawEllipse::create(rect)));
+    DrawingItem& newItem = append<DrawEllipse>(rect);
     updateItemExtent(newItem);
 }
 
 void Recorder::drawPath(const Path& path)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(DrawPath::create(path)));
+    DrawingItem& newItem = append<DrawPath>(path);
     updateItemExtent(newItem);
 }
 
 void Recorder::drawFocusRing(const Path& path, int width, int offset, const Color& color)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(DrawFocusRingPath::create(path, width, offset, color)));
+    DrawingItem& newItem = append<DrawFocusRingPath>(path, width, offset, color);
     updateItemExtent(newItem);
 }
 
 void Recorder::drawFocusRing(const Vector<FloatRect>& rects, int width, int offset, const Color& color)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(DrawFocusRingRects::create(rects, width, offset, color)));
+    DrawingItem& newItem = append<DrawFocusRingRects>(rects, width, offset, color);
     updateItemExtent(newItem);
 }
 
 void Recorder::fillRect(const FloatRect& rect)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(FillRect::create(rect)));
+    DrawingItem& newItem = append<FillRect>(rect);
     updateItemExtent(newItem);
 }
 
 void Recorder::fillRect(const FloatRect& rect, const Color& color)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(FillRectWithColor::create(rect, color)));
+    DrawingItem& newItem = append<FillRectWithColor>(rect, color);
     updateItemExtent(newItem);
 }
 
 void Recorder::fillRect(const FloatRect& rect, Gradient& gradient)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(FillRectWithGradient::create(rect, gradient)));
+    DrawingItem& newItem = append<FillRectWithGradient>(rect, gradient);
     updateItemExtent(newItem);
 }
 
 void Recorder::fillRect(const FloatRect& rect, const Color& color, CompositeOperator op, BlendMode blendMode)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(FillCompositedRect::create(rect, color, op, blendMode)));
+    DrawingItem& newItem = append<FillCompositedRect>(rect, color, op, blendMode);
     updateItemExtent(newItem);
 }
 
 void Recorder::fillRoundedRect(const FloatRoundedRect& rect, const Color& color, BlendMode blendMode)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(FillRoundedRect::create(rect, color, blendMode)));
+    DrawingItem& newItem = append<FillRoundedRect>(rect, color, blendMode);
     updateItemExtent(newItem);
 }
 
 void Recorder::fillRectWithRoundedHole(const FloatRect& rect, const FloatRoundedRect& roundedHoleRect, const Color& color)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(FillRectWithRoundedHole::create(rect, roundedHoleRect, color)));
+    DrawingItem& newItem = append<FillRectWithRoundedHole>(rect, roundedHoleRect, color);
     updateItemExtent(newItem);
 }
 
 void Recorder::fillPath(const Path& path)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(FillPath::create(path)));
+    DrawingItem& newItem = append<FillPath>(path);
     updateItemExtent(newItem);
 }
 
 void Recorder::fillEllipse(const FloatRect& rect)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(FillEllipse::create(rect)));
+    DrawingItem& newItem = append<FillEllipse>(rect);
     updateItemExtent(newItem);
 }
 
 void Recorder::strokeRect(const FloatRect& rect, float lineWidth)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(StrokeRect::create(rect, lineWidth)));
+    DrawingItem& newItem = append<StrokeRect>(rect, lineWidth);
     updateItemExtent(newItem);
 }
 
 void Recorder::strokePath(const Path& path)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(StrokePath::create(path)));
+    DrawingItem& newItem = append<StrokePath>(path);
     updateItemExtent(newItem);
 }
 
 void Recorder::strokeEllipse(const FloatRect& rect)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(StrokeEllipse::create(rect)));
+    DrawingItem& newItem = append<StrokeEllipse>(rect);
     updateItemExtent(newItem);
 }
 
 void Recorder::clearRect(const FloatRect& rect)
 {
-    DrawingItem& newItem = downcast<DrawingItem>(appendItem(ClearRect::create(rect)));
+    DrawingItem& newItem = append<ClearRect>(rect);
     updateItemExtent(newItem);
 }
 
 #if USE(CG)
 void Recorder::applyStrokePattern()
 {
-    appendItem(ApplyStrokePattern::create());
+    append<ApplyStrokePattern>();
 }
 
 void Recorder::applyFillPattern()
 {
-    appendItem(ApplyFillPattern::create());
+    append<ApplyFillPattern>();
 }
 #endif
 
 void Recorder::clip(const FloatRect& rect)
 {
     currentState().clipBounds.intersect(rect);
-    appendItem(Clip::create(rect));
+    append<Clip>(rect);
 }
 
 void Recorder::clipOut(const FloatRect& rect)
 {
-    appendItem(ClipOut::create(rect));
+    append<ClipOut>(rect);
 }
 
 void Recorder::clipOut(const Path& path)
 {
-    appendItem(ClipOutToPath::create(path));
+    append<ClipOutToPath>(path);
 }
 
 void Recorder::clipPath(const Path& path, WindRule windRule)
 {
     currentState().clipBounds.intersect(path.fastBoundingRect());
-    appendItem(ClipPath::create(path, windRule));
+    append<ClipPath>(path, windRule);
 }
 
 void Recorder::applyDeviceScaleFactor(float deviceScaleFactor)
 {
     // FIXME: this changes the baseCTM, which will invalidate all of our cached extents.
     // Assert that it's only called early on?
-    appendItem(ApplyDeviceScaleFactor::create(deviceScaleFactor));
-}
-
-Item& Recorder::appendItem(Ref<Item>&& item)
-{
-    willAppendItem(item.get());
-    return m_displayList.append(WTFMove(item));
+    append<ApplyDeviceScaleFactor>(deviceScaleFactor);
 }
 
 void Recorder::updateItemExtent(DrawingItem& item) const
@@ -120,15 +120,39 @@ public:
 
     size_t itemCount() const { return m_displayList.itemCount(); }
 
+    // Re-records the items of an arena-backed list into ref-counted storage. The recording carries on
+    // with the same save/restore stack and the same state changes not yet written to the list.
+    void convertToRefCountedItems();
+
+    const AffineTransform& ctm() const;
+    const FloatRect& clipBounds() const;
+
+    // Set by platform code that had to skip drawing it can only do through a platform painter.
+    void setHasUnrecordedContent() { m_hasUnrecordedContent = true; }
+    bool hasUnrecordedContent() const { return m_hasUnrecordedContent; }
+
 private:
-    Item& appendItem(Ref<Item>&&);
-    void willAppendItem(const Item&);
+    template<typename T, typename... Args>
+    T& append(Args&&... args)
+    {
+        willAppendItem(isDrawingItem<T>());
+        return m_displayList.append<T>(std::forward<Args>(args)...);
+    }
+
+    template<typename T>
+    static constexpr bool isDrawingItem()
+    {
+        return std::is_base_of<DrawingItem, T>::value
+#if USE(CG)
+            || std::is_same<T, ApplyStrokePattern>::value || std::is_same<T, ApplyFillPattern>::value
+#endif
+            ;
+    }
+
+    void willAppendItem(bool isDrawingItem);
 
     FloatRect extentFromLocalBounds(const FloatRect&) const;
     void updateItemExtent(DrawingItem&) const;
-    
-    const AffineTransform& ctm() const;
-    const FloatRect& clipBounds() const;
 
     struct ContextState {
         AffineTransform ctm;
@@ -166,6 +190,7 @@ private:
     DisplayList& m_displayList;
 
     Vector<ContextState, 32> m_stateStack;
+    bool m_hasUnrecordedContent { false };
 };
 
 }
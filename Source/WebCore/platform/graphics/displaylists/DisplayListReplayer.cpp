@@ -49,23 +49,27 @@ std::unique_ptr<DisplayList> Replayer::replay(const FloatRect& initialClip, bool
     LOG_WITH_STREAM(DisplayLists, stream << "\nReplaying with clip " << initialClip);
     UNUSED_PARAM(initialClip);
 
+    // Items of an arena-backed list are owned by its ItemArena and cannot be shared with a replay list.
+    ASSERT(!trackReplayList || m_displayList.storageMode() == DisplayList::StorageMode::RefCountedItems);
+    if (m_displayList.storageMode() != DisplayList::StorageMode::RefCountedItems)
+        trackReplayList = false;
+
     std::unique_ptr<DisplayList> replayList;
     if (UNLIKELY(trackReplayList))
         replayList = std::make_unique<DisplayList>();
 
-    size_t numItems = m_displayList.itemCount();
-    for (size_t i = 0; i < numItems; ++i) {
-        auto& item = m_displayList.list()[i].get();
+    for (auto it = m_displayList.begin(), end = m_displayList.end(); it != end; ++it) {
+        auto& item = *it;
 
         if (is<DrawingItem>(item)) {
             const DrawingItem& drawingItem = downcast<DrawingItem>(item);
             if (drawingItem.extentKnown() && !drawingItem.extent().intersects(initialClip)) {
-                LOG_WITH_STREAM(DisplayLists, stream << "skipping " << i << " " << item);
+                LOG_WITH_STREAM(DisplayLists, stream << "skipping " << it.index() << " " << item);
                 continue;
             }
         }
 
-        LOG_WITH_STREAM(DisplayLists, stream << "applying " << i << " " << item);
+        LOG_WITH_STREAM(DisplayLists, stream << "applying " << it.index() << " " << item);
         item.apply(m_context);
 
         if (UNLIKELY(trackReplayList))
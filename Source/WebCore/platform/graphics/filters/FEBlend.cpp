@@ -26,6 +26,7 @@
 #include "FEBlend.h"
 
 #include "FEBlendNEON.h"
+#include "FEBlendSSE2.h"
 #include "Filter.h"
 #include "FloatPoint.h"
 #include "GraphicsContext.h"
@@ -65,6 +66,25 @@ void FEBlend::platformApplySoftware()
     FilterEffect* in = inputEffect(0);
     FilterEffect* in2 = inputEffect(1);
 
+#if HAVE(X86_SSE2_INTRINSICS)
+    if (FEBlendUtilitiesSSE2::isSupportedMode(m_mode)) {
+        Uint8ClampedArray* dstPixelArray = createPremultipliedImageResult();
+        if (!dstPixelArray)
+            return;
+
+        IntRect effectADrawingRect = requestedRegionOfInputImageData(in->absolutePaintRect());
+        RefPtr<Uint8ClampedArray> srcPixelArrayA = in->asPremultipliedImage(effectADrawingRect);
+
+        IntRect effectBDrawingRect = requestedRegionOfInputImageData(in2->absolutePaintRect());
+        RefPtr<Uint8ClampedArray> srcPixelArrayB = in2->asPremultipliedImage(effectBDrawingRect);
+
+        unsigned pixelArrayLength = srcPixelArrayA->length();
+        ASSERT(pixelArrayLength == srcPixelArrayB->length());
+        platformApplySSE2(srcPixelArrayA->data(), srcPixelArrayB->data(), dstPixelArray->data(), pixelArrayLength);
+        return;
+    }
+#endif
+
     ImageBuffer* resultImage = createImageBufferResult();
     if (!resultImage)
         return;
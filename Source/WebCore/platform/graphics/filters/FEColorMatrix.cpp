@@ -23,6 +23,7 @@
 #include "config.h"
 #include "FEColorMatrix.h"
 
+#include "FEColorMatrixSSE2.h"
 #include "Filter.h"
 #include "GraphicsContext.h"
 #include "TextStream.h"
@@ -113,6 +114,20 @@ void effectType(Uint8ClampedArray* pixelArray, const Vector<float>& values)
     else if (filterType == FECOLORMATRIX_TYPE_HUEROTATE)
         FEColorMatrix::calculateHueRotateComponents(components, values[0]);
 
+#if HAVE(X86_SSE2_INTRINSICS)
+    switch (filterType) {
+    case FECOLORMATRIX_TYPE_MATRIX:
+        colorMatrixSSE2(pixelArray->data(), pixelArrayLength, values.data());
+        return;
+    case FECOLORMATRIX_TYPE_SATURATE:
+    case FECOLORMATRIX_TYPE_HUEROTATE:
+        saturateAndHueRotateSSE2(pixelArray->data(), pixelArrayLength, components);
+        return;
+    default:
+        break;
+    }
+#endif
+
     for (unsigned pixelByteOffset = 0; pixelByteOffset < pixelArrayLength; pixelByteOffset += 4) {
         float red = pixelArray->item(pixelByteOffset);
         float green = pixelArray->item(pixelByteOffset + 1);
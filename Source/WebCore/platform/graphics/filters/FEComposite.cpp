@@ -25,6 +25,7 @@
 #include "FEComposite.h"
 
 #include "FECompositeArithmeticNEON.h"
+#include "FECompositeArithmeticSSE2.h"
 #include "Filter.h"
 #include "GraphicsContext.h"
 #include "TextStream.h"
@@ -181,7 +182,7 @@ static inline void computeArithmeticPixelsUnclamped(unsigned char* source, unsig
     }
 }
 
-#if !HAVE(ARM_NEON_INTRINSICS)
+#if !HAVE(ARM_NEON_INTRINSICS) && !HAVE(X86_SSE2_INTRINSICS)
 static inline void arithmeticSoftware(unsigned char* source, unsigned char* destination, int pixelArrayLength, float k1, float k2, float k3, float k4)
 {
     float upperLimit = std::max(0.0f, k1) + std::max(0.0f, k2) + std::max(0.0f, k3) + k4;
@@ -224,6 +225,8 @@ inline void FEComposite::platformArithmeticSoftware(Uint8ClampedArray* source, U
 #if HAVE(ARM_NEON_INTRINSICS)
     ASSERT(!(length & 0x3));
     platformArithmeticNeon(source->data(), destination->data(), length, k1, k2, k3, k4);
+#elif HAVE(X86_SSE2_INTRINSICS)
+    platformArithmeticSSE2(source->data(), destination->data(), length, k1, k2, k3, k4);
 #else
     arithmeticSoftware(source->data(), destination->data(), length, k1, k2, k3, k4);
 #endif
@@ -81,6 +81,11 @@ private:
         unsigned pixelArrayLength, float k1, float k2, float k3, float k4);
     static inline void platformArithmeticNeon(unsigned char* source, unsigned  char* destination,
         unsigned pixelArrayLength, float k1, float k2, float k3, float k4);
+    template <int b1, int b4>
+    static inline void computeArithmeticPixelsSSE2(unsigned char* source, unsigned char* destination,
+        unsigned pixelArrayLength, float k1, float k2, float k3, float k4);
+    static inline void platformArithmeticSSE2(unsigned char* source, unsigned char* destination,
+        unsigned pixelArrayLength, float k1, float k2, float k3, float k4);
 
     CompositeOperationType m_type;
     float m_k1;
@@ -27,6 +27,7 @@
 #include "FEGaussianBlur.h"
 
 #include "FEGaussianBlurNEON.h"
+#include "FEGaussianBlurSSE2.h"
 #include "Filter.h"
 #include "GraphicsContext.h"
 #include "TextStream.h"
@@ -349,6 +350,11 @@ inline void standardBoxBlur(Uint8ClampedArray* src, Uint8ClampedArray* dst, unsi
                 boxBlurNEON(src, dst, kernelSizeX, dxLeft, dxRight, 4, stride, paintSize.width(), paintSize.height());
             else
                 boxBlur(src, dst, kernelSizeX, dxLeft, dxRight, 4, stride, paintSize.width(), paintSize.height(), true, edgeMode);
+#elif HAVE(X86_SSE2_INTRINSICS)
+            if (!isAlphaImage && edgeMode == EDGEMODE_NONE)
+                boxBlurSSE2(src, dst, kernelSizeX, dxLeft, dxRight, 4, stride, paintSize.width(), paintSize.height());
+            else
+                boxBlur(src, dst, kernelSizeX, dxLeft, dxRight, 4, stride, paintSize.width(), paintSize.height(), isAlphaImage, edgeMode);
 #else
             boxBlur(src, dst, kernelSizeX, dxLeft, dxRight, 4, stride, paintSize.width(), paintSize.height(), isAlphaImage, edgeMode);
 #endif
@@ -362,6 +368,11 @@ inline void standardBoxBlur(Uint8ClampedArray* src, Uint8ClampedArray* dst, unsi
                 boxBlurNEON(src, dst, kernelSizeY, dyLeft, dyRight, stride, 4, paintSize.height(), paintSize.width());
             else
                 boxBlur(src, dst, kernelSizeY, dyLeft, dyRight, stride, 4, paintSize.height(), paintSize.width(), true, edgeMode);
+#elif HAVE(X86_SSE2_INTRINSICS)
+            if (!isAlphaImage && edgeMode == EDGEMODE_NONE)
+                boxBlurSSE2(src, dst, kernelSizeY, dyLeft, dyRight, stride, 4, paintSize.height(), paintSize.width());
+            else
+                boxBlur(src, dst, kernelSizeY, dyLeft, dyRight, stride, 4, paintSize.height(), paintSize.width(), isAlphaImage, edgeMode);
 #else
             boxBlur(src, dst, kernelSizeY, dyLeft, dyRight, stride, 4, paintSize.height(), paintSize.width(), isAlphaImage, edgeMode);
 #endif
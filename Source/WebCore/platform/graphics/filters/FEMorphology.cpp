@@ -24,6 +24,7 @@
 #include "config.h"
 #include "FEMorphology.h"
 
+#include "FEMorphologySSE2.h"
 #include "Filter.h"
 #include "TextStream.h"
 
@@ -137,7 +138,7 @@ void FEMorphology::platformApplyGeneric(PaintingData* paintingData, int yStart,
             extrema.clear();
             // Compute extremas for each columns
             for (int x = 0; x < radiusX; ++x)
-                extrema.append(columnExtremum(srcPixelArray, x, yStartExtrema, yEndExtrema, width, colorChannel, m_type));
+                extrema.append(columnExtremum(srcPixelArray, x, yStartExtrema, yEndExtrema + 1, width, colorChannel, m_type));
 
             // Kernel is filled, get extrema of next column
             for (int x = 0; x < width; ++x) {
@@ -161,7 +162,11 @@ void FEMorphology::platformApplyGeneric(PaintingData* paintingData, int yStart,
 
 void FEMorphology::platformApplyWorker(PlatformApplyParameters* param)
 {
+#if HAVE(X86_SSE2_INTRINSICS)
+    param->filter->platformApplySSE2(param->paintingData, param->startY, param->endY);
+#else
     param->filter->platformApplyGeneric(param->paintingData, param->startY, param->endY);
+#endif
 }
 
 void FEMorphology::platformApply(PaintingData* paintingData)
@@ -190,7 +195,11 @@ void FEMorphology::platformApply(PaintingData* paintingData)
         // Fallback to single thread model
     }
 
+#if HAVE(X86_SSE2_INTRINSICS)
+    platformApplySSE2(paintingData, 0, paintingData->height);
+#else
     platformApplyGeneric(paintingData, 0, paintingData->height);
+#endif
 }
 
 bool FEMorphology::platformApplyDegenerate(Uint8ClampedArray* dstPixelArray, const IntRect& imageRect, int radiusX, int radiusY)
@@ -75,6 +75,7 @@ public:
 
     inline void platformApply(PaintingData*);
     inline void platformApplyGeneric(PaintingData*, const int yStart, const int yEnd);
+    inline void platformApplySSE2(PaintingData*, const int yStart, const int yEnd);
 private:
     FEMorphology(Filter&, MorphologyOperatorType, float radiusX, float radiusY);
     bool platformApplyDegenerate(Uint8ClampedArray* dstPixelArray, const IntRect& imageRect, int radiusX, int radiusY);
@@ -0,0 +1,109 @@
+/*
+    Copyright (C) 2016 The Qt Company Ltd.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Library General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Library General Public License for more details.
+
+    You should have received a copy of the GNU Library General Public License
+    along with this library; see the file COPYING.LIB.  If not, write to
+    the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+    Boston, MA 02110-1301, USA.
+*/
+
+#include "config.h"
+#include "ComplexTextLayoutCacheQt.h"
+
+#include <wtf/Hasher.h>
+#include <wtf/MainThread.h>
+#include <wtf/StdLibExtras.h>
+
+namespace WebCore {
+
+// A line of shaped text is typically a few kilobytes, so this keeps the cache well below a megabyte.
+static const unsigned maximumCacheSize = 256;
+
+ComplexTextLayoutCacheQt::Key::Key(const QString& text, const QRawFont& rawFont, unsigned fontHash, bool rtl, float expansion, float wordSpacing, float letterSpacing, bool kerning, bool smallCaps)
+    : m_text(text)
+    , m_rawFont(rawFont)
+    , m_expansion(expansion)
+    , m_wordSpacing(wordSpacing)
+    , m_letterSpacing(letterSpacing)
+    , m_rtl(rtl)
+    , m_kerning(kerning)
+    , m_smallCaps(smallCaps)
+{
+    IntegerHasher hasher;
+    hasher.add(StringHasher::computeHashAndMaskTop8Bits(reinterpret_cast<const UChar*>(text.constData()), text.length()));
+    hasher.add(fontHash);
+    hasher.add(bitwise_cast<unsigned>(expansion));
+    hasher.add(bitwise_cast<unsigned>(wordSpacing));
+    hasher.add(bitwise_cast<unsigned>(letterSpacing));
+    hasher.add(rtl << 2 | kerning << 1 | smallCaps);
+    m_hash = hasher.hash();
+}
+
+bool ComplexTextLayoutCacheQt::Key::operator==(const Key& other) const
+{
+    return m_hash == other.m_hash
+        && m_isDeletedValue == other.m_isDeletedValue
+        && m_rtl == other.m_rtl
+        && m_kerning == other.m_kerning
+        && m_smallCaps == other.m_smallCaps
+        && m_expansion == other.m_expansion
+        && m_wordSpacing == other.m_wordSpacing
+        && m_letterSpacing == other.m_letterSpacing
+        && m_text == other.m_text
+        && m_rawFont == other.m_rawFont;
+}
+
+ComplexTextLayoutCacheQt& ComplexTextLayoutCacheQt::singleton()
+{
+    ASSERT(isMainThread());
+    static NeverDestroyed<ComplexTextLayoutCacheQt> cache;
+    return cache;
+}
+
+QTextLayout* ComplexTextLayoutCacheQt::find(const Key& key)
+{
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        ++m_missCount;
+        return nullptr;
+    }
+
+    ++m_hitCount;
+    Entry* entry = it->value.get();
+    m_usageList.appendOrMoveToLast(entry);
+    return entry->layout.get();
+}
+
+QTextLayout& ComplexTextLayoutCacheQt::add(const Key& key, std::unique_ptr<QTextLayout> layout)
+{
+    ASSERT(!m_entries.contains(key));
+
+    if (m_entries.size() >= maximumCacheSize) {
+        Entry* leastRecentlyUsed = m_usageList.takeFirst();
+        m_entries.remove(leastRecentlyUsed->key);
+    }
+
+    auto entry = std::make_unique<Entry>(key, WTFMove(layout));
+    QTextLayout& result = *entry->layout;
+    m_usageList.add(entry.get());
+    m_entries.add(key, WTFMove(entry));
+    return result;
+}
+
+void ComplexTextLayoutCacheQt::clear()
+{
+    m_usageList.clear();
+    m_entries.clear();
+}
+
+} // namespace WebCore
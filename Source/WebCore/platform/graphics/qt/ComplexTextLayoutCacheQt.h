@@ -0,0 +1,116 @@
+/*
+    Copyright (C) 2016 The Qt Company Ltd.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Library General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Library General Public License for more details.
+
+    You should have received a copy of the GNU Library General Public License
+    along with this library; see the file COPYING.LIB.  If not, write to
+    the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+    Boston, MA 02110-1301, USA.
+*/
+
+#ifndef ComplexTextLayoutCacheQt_h
+#define ComplexTextLayoutCacheQt_h
+
+#include <QRawFont>
+#include <QString>
+#include <QTextLayout>
+#include <memory>
+#include <wtf/HashMap.h>
+#include <wtf/HashTraits.h>
+#include <wtf/ListHashSet.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/Noncopyable.h>
+
+namespace WebCore {
+
+// Keeps the shaped QTextLayouts of recently used complex text runs, so that
+// measuring, hit testing, selecting and painting the same run shapes it once.
+class ComplexTextLayoutCacheQt {
+    WTF_MAKE_NONCOPYABLE(ComplexTextLayoutCacheQt); WTF_MAKE_FAST_ALLOCATED;
+public:
+    class Key {
+    public:
+        Key() { }
+        Key(const QString& text, const QRawFont&, unsigned fontHash, bool rtl, float expansion, float wordSpacing, float letterSpacing, bool kerning, bool smallCaps);
+        Key(WTF::HashTableDeletedValueType) : m_isDeletedValue(true) { }
+
+        bool isHashTableDeletedValue() const { return m_isDeletedValue; }
+        unsigned hash() const { return m_hash; }
+
+        bool operator==(const Key&) const;
+
+    private:
+        QString m_text;
+        QRawFont m_rawFont;
+        unsigned m_hash { 0 };
+        float m_expansion { 0 };
+        float m_wordSpacing { 0 };
+        float m_letterSpacing { 0 };
+        bool m_rtl { false };
+        bool m_kerning { false };
+        bool m_smallCaps { false };
+        bool m_isDeletedValue { false };
+    };
+
+    static ComplexTextLayoutCacheQt& singleton();
+
+    // Returns the cached layout for the key, or 0 if there is none.
+    QTextLayout* find(const Key&);
+    // Takes ownership of a laid out layout, evicting the least recently used one if needed.
+    QTextLayout& add(const Key&, std::unique_ptr<QTextLayout>);
+
+    void clear();
+
+    unsigned size() const { return m_entries.size(); }
+    unsigned hitCount() const { return m_hitCount; }
+    unsigned missCount() const { return m_missCount; }
+
+private:
+    friend class WTF::NeverDestroyed<ComplexTextLayoutCacheQt>;
+    ComplexTextLayoutCacheQt() { }
+
+    struct KeyHash {
+        static unsigned hash(const Key& key) { return key.hash(); }
+        static bool equal(const Key& a, const Key& b) { return a == b; }
+        static const bool safeToCompareToEmptyOrDeleted = true;
+    };
+
+    // QString and QRawFont are not valid when zero filled, so the empty value
+    // has to be constructed.
+    struct KeyTraits : WTF::GenericHashTraits<Key> {
+        static const bool emptyValueIsZero = false;
+        static void constructDeletedValue(Key& slot) { new (NotNull, &slot) Key(WTF::HashTableDeletedValue); }
+        static bool isDeletedValue(const Key& key) { return key.isHashTableDeletedValue(); }
+    };
+
+    struct Entry {
+        WTF_MAKE_FAST_ALLOCATED;
+    public:
+        Entry(const Key& key, std::unique_ptr<QTextLayout> layout)
+            : key(key)
+            , layout(WTFMove(layout))
+        {
+        }
+
+        Key key;
+        std::unique_ptr<QTextLayout> layout;
+    };
+
+    HashMap<Key, std::unique_ptr<Entry>, KeyHash, KeyTraits> m_entries;
+    ListHashSet<Entry*> m_usageList;
+    unsigned m_hitCount { 0 };
+    unsigned m_missCount { 0 };
+};
+
+} // namespace WebCore
+
+#endif // ComplexTextLayoutCacheQt_h
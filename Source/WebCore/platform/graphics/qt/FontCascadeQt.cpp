@@ -24,6 +24,7 @@
 
 #include "Font.h"
 
+#include "ComplexTextLayoutCacheQt.h"
 #include "FontDescription.h"
 #include "GlyphBuffer.h"
 #include "Gradient.h"
@@ -42,6 +43,7 @@
 #include <qalgorithms.h>
 
 #include <limits.h>
+#include <wtf/Lock.h>
 
 namespace WebCore {
 
@@ -124,8 +126,24 @@ static QPainterPath pathForGlyphs(const QGlyphRun& glyphRun, const QPointF& offs
     return path;
 }
 
+// Display lists of tiles are replayed on several threads at once. Glyph runs are rasterized through
+// the glyph caches and outlines of the shared font engines, which aren't safe to use concurrently.
+static StaticLock glyphRasterizationLock;
+
 static void drawQtGlyphRun(GraphicsContext& context, const QGlyphRun& qtGlyphRun, const QPointF& point, qreal baseLineOffset)
 {
+    if (context.isRecording()) {
+        // Glyph runs can't be recorded, so record their outlines. The context state supplies the
+        // fill and stroke style and the shadow.
+        Path path(pathForGlyphs(qtGlyphRun, point));
+        if (context.textDrawingMode() & TextModeStroke)
+            context.strokePath(path);
+        if (context.textDrawingMode() & TextModeFill)
+            context.fillPath(path);
+        return;
+    }
+
+    LockHolder locker(glyphRasterizationLock);
     QPainter* painter = context.platformContext();
 
     QPainterPath textStrokePath;
@@ -177,12 +195,7 @@ static void drawQtGlyphRun(GraphicsContext& context, const QGlyphRun& qtGlyphRun
 
 void FontCascade::drawComplexText(GraphicsContext& ctx, const TextRun& run, const FloatPoint& point, int from, int to) const
 {
-    QString string = toNormalizedQString(run);
-
-    QTextLayout layout(string);
-    layout.setRawFont(rawFont());
-    initFormatForTextLayout(&layout, run);
-    QTextLine line = setupLayout(&layout, run);
+    QTextLine line = lineForComplexText(run);
     const QPointF adjustedPoint(point.x(), point.y() - line.ascent());
 
     QList<QGlyphRun> runs = line.glyphRuns(from, to - from);
@@ -200,12 +213,8 @@ float FontCascade::floatWidthForComplexText(const TextRun& run, HashSet<const Fo
 
     if (run.length() == 1 && treatAsSpace(run[0]))
         return primaryFont().spaceWidth() + run.expansion();
-    QString string = toNormalizedQString(run);
 
-    QTextLayout layout(string);
-    layout.setRawFont(rawFont());
-    initFormatForTextLayout(&layout, run);
-    QTextLine line = setupLayout(&layout, run);
+    QTextLine line = lineForComplexText(run);
     float x1 = line.cursorToX(0);
     float x2 = line.cursorToX(run.length());
     float width = qAbs(x2 - x1);
@@ -215,23 +224,13 @@ float FontCascade::floatWidthForComplexText(const TextRun& run, HashSet<const Fo
 
 int FontCascade::offsetForPositionForComplexText(const TextRun& run, float position, bool) const
 {
-    QString string = toNormalizedQString(run);
-
-    QTextLayout layout(string);
-    layout.setRawFont(rawFont());
-    initFormatForTextLayout(&layout, run);
-    QTextLine line = setupLayout(&layout, run);
+    QTextLine line = lineForComplexText(run);
     return line.xToCursor(position);
 }
 
 void FontCascade::adjustSelectionRectForComplexText(const TextRun& run, LayoutRect& selectionRect, int from, int to) const
 {
-    QString string = toNormalizedQString(run);
-
-    QTextLayout layout(string);
-    layout.setRawFont(rawFont());
-    initFormatForTextLayout(&layout, run);
-    QTextLine line = setupLayout(&layout, run);
+    QTextLine line = lineForComplexText(run);
 
     float x1 = line.cursorToX(from);
     float x2 = line.cursorToX(to);
@@ -271,6 +270,26 @@ void FontCascade::initFormatForTextLayout(QTextLayout* layout, const TextRun& ru
     }
 }
 
+// The returned line belongs to a layout owned by ComplexTextLayoutCacheQt and
+// stays valid until the next complex text layout is requested.
+QTextLine FontCascade::lineForComplexText(const TextRun& run) const
+{
+    QString string = toNormalizedQString(run);
+    bool spacingEnabled = !run.spacingDisabled();
+    ComplexTextLayoutCacheQt::Key key(string, rawFont(), primaryFont().platformData().hash(), run.rtl(), run.expansion(),
+        spacingEnabled ? m_wordSpacing : 0, spacingEnabled ? m_letterSpacing : 0, enableKerning(), isSmallCaps());
+
+    ComplexTextLayoutCacheQt& cache = ComplexTextLayoutCacheQt::singleton();
+    if (QTextLayout* layout = cache.find(key))
+        return layout->lineAt(0);
+
+    auto layout = std::make_unique<QTextLayout>(string);
+    layout->setRawFont(rawFont());
+    initFormatForTextLayout(layout.get(), run);
+    setupLayout(layout.get(), run);
+    return cache.add(key, WTFMove(layout)).lineAt(0);
+}
+
 bool FontCascade::canReturnFallbackFontsForComplexText()
 {
     return false;
@@ -332,7 +332,8 @@ void GraphicsContext::platformDestroy()
 
 PlatformGraphicsContext* GraphicsContext::platformContext() const
 {
-    return m_data->p();
+    // Recording contexts don't have a painter.
+    return m_data ? m_data->p() : nullptr;
 }
 
 AffineTransform GraphicsContext::getCTM(IncludeDeviceScale includeScale) const
@@ -340,6 +341,9 @@ AffineTransform GraphicsContext::getCTM(IncludeDeviceScale includeScale) const
     if (paintingDisabled())
         return AffineTransform();
 
+    if (isRecording())
+        return m_displayListRecorder->ctm();
+
     const QTransform& matrix = (includeScale == DefinitelyIncludeDeviceScale)
         ? platformContext()->combinedTransform()
         : platformContext()->worldTransform();
@@ -371,6 +375,11 @@ void GraphicsContext::drawRect(const FloatRect& rect, float borderThickness)
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->drawRect(rect, borderThickness);
+        return;
+    }
+
     ASSERT(!rect.isEmpty());
 
     QPainter* p = m_data->p();
@@ -495,6 +504,11 @@ void GraphicsContext::drawEllipse(const FloatRect& rect)
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->drawEllipse(rect);
+        return;
+    }
+
     m_data->p()->drawEllipse(rect);
 }
 
@@ -514,7 +528,7 @@ void GraphicsContext::drawPattern(Image& image, const FloatRect& tileRect, const
     }
 
 #if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
-    FloatRect tileRectAdjusted = adjustSourceRectForDownSampling(tileRect, framePixmap->size());
+    FloatRect tileRectAdjusted = image.adjustSourceRectForDownSampling(tileRect, framePixmap->size());
 #else
     FloatRect tileRectAdjusted = tileRect;
 #endif
@@ -634,6 +648,11 @@ void GraphicsContext::fillPath(const Path& path)
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->fillPath(path);
+        return;
+    }
+
     QPainter* p = m_data->p();
     QPainterPath platformPath = path.platformPath();
     platformPath.setFillRule(toQtFillRule(fillRule()));
@@ -697,6 +716,12 @@ void GraphicsContext::strokePath(const Path& path)
 {
     if (paintingDisabled())
         return;
+
+    if (isRecording()) {
+        m_displayListRecorder->strokePath(path);
+        return;
+    }
+
     QPainter* p = m_data->p();
     QPen pen(p->pen());
     QPainterPath platformPath = path.platformPath();
@@ -793,6 +818,11 @@ void GraphicsContext::fillRect(const FloatRect& rect)
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->fillRect(rect);
+        return;
+    }
+
     QPainter* p = m_data->p();
     QRectF normalizedRect = rect.normalized();
 
@@ -854,6 +884,11 @@ void GraphicsContext::fillRect(const FloatRect& rect, const Color& color)
     if (paintingDisabled() || !color.isValid())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->fillRect(rect, color);
+        return;
+    }
+
     QRectF platformRect(rect);
     QPainter* p = m_data->p();
     if (hasShadow()) {
@@ -896,6 +931,11 @@ void GraphicsContext::fillRectWithRoundedHole(const FloatRect& rect, const Float
     if (paintingDisabled() || !color.isValid())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->fillRectWithRoundedHole(rect, roundedHoleRect, color);
+        return;
+    }
+
     Path path;
     path.addRect(rect);
     if (!roundedHoleRect.radii().isZero())
@@ -927,11 +967,19 @@ void GraphicsContext::clip(const FloatRect& rect)
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->clip(rect);
+        return;
+    }
+
     m_data->p()->setClipRect(rect, Qt::IntersectClip);
 }
 
 IntRect GraphicsContext::clipBounds() const
 {
+    if (isRecording())
+        return enclosingIntRect(m_displayListRecorder->clipBounds());
+
     QPainter* p = m_data->p();
     QRectF clipRect;
 
@@ -948,6 +996,11 @@ void GraphicsContext::clipPath(const Path& path, WindRule clipRule)
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->clipPath(path, clipRule);
+        return;
+    }
+
     QPainter* p = m_data->p();
     QPainterPath platformPath = path.platformPath();
     platformPath.setFillRule(clipRule == RULE_EVENODD ? Qt::OddEvenFill : Qt::WindingFill);
@@ -959,6 +1012,12 @@ void GraphicsContext::clipToImageBuffer(ImageBuffer& buffer, const FloatRect& de
     if (paintingDisabled())
         return;
 
+    // FIXME: Image buffer clips can't be recorded yet.
+    if (isRecording()) {
+        m_displayListRecorder->setHasUnrecordedContent();
+        return;
+    }
+
     IntRect rect = enclosingIntRect(destRect);
     buffer.m_data.m_impl->clip(*this, rect);
 }
@@ -983,13 +1042,18 @@ void drawFocusRingForPath(QPainter* p, const QPainterPath& path, const Color& co
     p->setRenderHint(QPainter::Antialiasing, antiAlias);
 }
 
-void GraphicsContext::drawFocusRing(const Path& path, float /* width */, float /* offset */, const Color& color)
+void GraphicsContext::drawFocusRing(const Path& path, float width, float offset, const Color& color)
 {
     // FIXME: Use 'offset' for something? http://webkit.org/b/49909
 
     if (paintingDisabled() || !color.isValid())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->drawFocusRing(path, width, offset, color);
+        return;
+    }
+
     drawFocusRingForPath(m_data->p(), path.platformPath(), color, m_data->antiAliasingForRectsAndLines);
 }
 
@@ -1003,6 +1067,11 @@ void GraphicsContext::drawFocusRing(const Vector<FloatRect>& rects, float width,
     if (paintingDisabled() || !color.isValid())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->drawFocusRing(rects, width, offset, color);
+        return;
+    }
+
     unsigned rectCount = rects.size();
 
     if (!rects.size())
@@ -1212,6 +1281,11 @@ void GraphicsContext::drawLineForDocumentMarker(const FloatPoint& origin, float
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->drawLineForDocumentMarker(origin, width, style);
+        return;
+    }
+
     QPainter* painter = platformContext();
     const QPen originalPen = painter->pen();
 
@@ -1236,8 +1310,7 @@ FloatRect GraphicsContext::roundToDevicePixels(const FloatRect& frect, RoundingM
     // affine transform matrix to device space can mess with this conversion if we have a
     // rotating image like the hands of the world clock widget. We just need the scale, so
     // we get the affine transform matrix and extract the scale.
-    QPainter* painter = platformContext();
-    QTransform deviceTransform = painter->deviceTransform();
+    QTransform deviceTransform = isRecording() ? QTransform(m_displayListRecorder->ctm()) : platformContext()->deviceTransform();
     if (deviceTransform.isIdentity())
         return frect;
 
@@ -1368,6 +1441,11 @@ void GraphicsContext::clearRect(const FloatRect& rect)
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->clearRect(rect);
+        return;
+    }
+
     QPainter* p = m_data->p();
     QPainter::CompositionMode currentCompositionMode = p->compositionMode();
     p->setCompositionMode(QPainter::CompositionMode_Source);
@@ -1380,6 +1458,11 @@ void GraphicsContext::strokeRect(const FloatRect& rect, float lineWidth)
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->strokeRect(rect, lineWidth);
+        return;
+    }
+
     Path path;
     path.addRect(rect);
 
@@ -1399,6 +1482,11 @@ void GraphicsContext::setLineCap(LineCap lc)
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->setLineCap(lc);
+        return;
+    }
+
     QPainter* p = m_data->p();
     QPen nPen = p->pen();
     nPen.setCapStyle(toQtLineCap(lc));
@@ -1407,6 +1495,14 @@ void GraphicsContext::setLineCap(LineCap lc)
 
 void GraphicsContext::setLineDash(const DashArray& dashes, float dashOffset)
 {
+    if (paintingDisabled())
+        return;
+
+    if (isRecording()) {
+        m_displayListRecorder->setLineDash(dashes, dashOffset);
+        return;
+    }
+
     QPainter* p = m_data->p();
     QPen pen = p->pen();
     unsigned dashLength = dashes.size();
@@ -1435,6 +1531,11 @@ void GraphicsContext::setLineJoin(LineJoin lj)
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->setLineJoin(lj);
+        return;
+    }
+
     QPainter* p = m_data->p();
     QPen nPen = p->pen();
     nPen.setJoinStyle(toQtLineJoin(lj));
@@ -1446,6 +1547,11 @@ void GraphicsContext::setMiterLimit(float limit)
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->setMiterLimit(limit);
+        return;
+    }
+
     QPainter* p = m_data->p();
     QPen nPen = p->pen();
     nPen.setMiterLimit(limit);
@@ -1478,6 +1584,11 @@ void GraphicsContext::canvasClip(const Path& path, WindRule windRule)
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->clipPath(path, windRule);
+        return;
+    }
+
     QPainterPath clipPath = path.platformPath();
     clipPath.setFillRule(toQtFillRule(windRule));
     m_data->p()->setClipPath(clipPath, Qt::IntersectClip);
@@ -1488,6 +1599,11 @@ void GraphicsContext::clipOut(const Path& path)
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->clipOut(path);
+        return;
+    }
+
     QPainter* p = m_data->p();
     QPainterPath clippedOut = path.platformPath();
     QPainterPath newClip;
@@ -1509,6 +1625,11 @@ void GraphicsContext::translate(float x, float y)
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->translate(x, y);
+        return;
+    }
+
     m_data->p()->translate(x, y);
 }
 
@@ -1517,6 +1638,11 @@ void GraphicsContext::rotate(float radians)
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->rotate(radians);
+        return;
+    }
+
     QTransform rotation = QTransform().rotateRadians(radians);
     m_data->p()->setTransform(rotation, true);
 }
@@ -1526,6 +1652,11 @@ void GraphicsContext::scale(const FloatSize& s)
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->scale(s);
+        return;
+    }
+
     m_data->p()->scale(s.width(), s.height());
 }
 
@@ -1534,6 +1665,11 @@ void GraphicsContext::clipOut(const FloatRect& rect)
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->clipOut(rect);
+        return;
+    }
+
     QPainter* p = m_data->p();
     QPainterPath newClip;
     newClip.setFillRule(Qt::OddEvenFill);
@@ -1556,6 +1692,11 @@ void GraphicsContext::concatCTM(const AffineTransform& transform)
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->concatCTM(transform);
+        return;
+    }
+
     m_data->p()->setWorldTransform(transform, true);
 }
 
@@ -1564,6 +1705,12 @@ void GraphicsContext::setCTM(const AffineTransform& transform)
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        if (Optional<AffineTransform> inverse = m_displayListRecorder->ctm().inverse())
+            m_displayListRecorder->concatCTM(inverse.value() * transform);
+        return;
+    }
+
     m_data->p()->setWorldTransform(transform);
 }
 
@@ -1573,6 +1720,9 @@ TransformationMatrix GraphicsContext::get3DTransform() const
     if (paintingDisabled())
         return TransformationMatrix();
 
+    if (isRecording())
+        return m_displayListRecorder->ctm();
+
     return platformContext()->worldTransform();
 }
 
@@ -1581,6 +1731,14 @@ void GraphicsContext::concat3DTransform(const TransformationMatrix& transform)
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        // Recorded transforms are affine.
+        if (!transform.isAffine())
+            m_displayListRecorder->setHasUnrecordedContent();
+        concatCTM(transform.toAffineTransform());
+        return;
+    }
+
     m_data->p()->setWorldTransform(transform, true);
 }
 
@@ -1589,6 +1747,13 @@ void GraphicsContext::set3DTransform(const TransformationMatrix& transform)
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        if (!transform.isAffine())
+            m_displayListRecorder->setHasUnrecordedContent();
+        setCTM(transform.toAffineTransform());
+        return;
+    }
+
     m_data->p()->setWorldTransform(transform, false);
 }
 #endif
@@ -1596,7 +1761,7 @@ void GraphicsContext::set3DTransform(const TransformationMatrix& transform)
 void GraphicsContext::setURLForRect(const URL& url, const IntRect& rect)
 {
 #if QT_VERSION >= QT_VERSION_CHECK(5, 6, 0)
-    if (paintingDisabled())
+    if (paintingDisabled() || isRecording())
         return;
 
     QPainter* p = m_data->p();
@@ -1774,6 +1939,9 @@ void GraphicsContext::takeOwnershipOfPlatformContext()
 
 bool GraphicsContext::isAcceleratedContext() const
 {
+    if (isRecording())
+        return false;
+
     return (platformContext()->paintEngine()->type() == QPaintEngine::OpenGL2);
 }
 
@@ -21,6 +21,7 @@
 #include "config.h"
 #include "Icon.h"
 
+#include "DisplayListRecorder.h"
 #include "GraphicsContext.h"
 #include "IntRect.h"
 #include <QMimeDatabase>
@@ -79,6 +80,11 @@ void Icon::paint(GraphicsContext& context, const FloatRect& rect)
     if (m_icon.isNull() || context.paintingDisabled())
         return;
 
+    if (context.isRecording()) {
+        context.displayListRecorder()->setHasUnrecordedContent();
+        return;
+    }
+
     m_icon.paint(context.platformContext(), enclosingIntRect(rect));
 }
 
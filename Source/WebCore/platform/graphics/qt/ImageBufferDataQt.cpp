@@ -415,6 +415,11 @@ void ImageBufferDataPrivateUnaccelerated::draw(GraphicsContext& destContext, con
         // We're drawing into our own buffer. In order for this to work, we need to copy the source buffer first.
         RefPtr<Image> copy = copyImage();
         destContext.drawImage(*copy, destRect, srcRect, ImagePaintingOptions(op, blendMode, ImageOrientationDescription()));
+    } else if (destContext.isRecording()) {
+        // The display list keeps the image until it is replayed, which can be after this buffer was
+        // painted again or destroyed, so it has to hold a snapshot of the pixels.
+        RefPtr<Image> snapshot = StillImage::create(m_pixmap.copy());
+        destContext.drawImage(*snapshot, destRect, srcRect, ImagePaintingOptions(op, blendMode, ImageOrientationDescription()));
     } else
         destContext.drawImage(*m_image, destRect, srcRect, ImagePaintingOptions(op, blendMode, ImageOrientationDescription()));
 }
@@ -427,6 +432,9 @@ void ImageBufferDataPrivateUnaccelerated::drawPattern(GraphicsContext& destConte
         // We're drawing into our own buffer. In order for this to work, we need to copy the source buffer first.
         RefPtr<Image> copy = copyImage();
         copy->drawPattern(destContext, srcRect, patternTransform, phase, spacing, op, destRect, blendMode);
+    } else if (destContext.isRecording()) {
+        RefPtr<Image> snapshot = StillImage::create(m_pixmap.copy());
+        snapshot->drawPattern(destContext, srcRect, patternTransform, phase, spacing, op, destRect, blendMode);
     } else
         m_image->drawPattern(destContext, srcRect, patternTransform, phase, spacing, op, destRect, blendMode);
 }
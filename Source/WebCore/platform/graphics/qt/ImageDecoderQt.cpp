@@ -29,16 +29,66 @@
 #include "config.h"
 #include "ImageDecoderQt.h"
 
+#include "BitmapImage.h"
 #include <QtCore/QBuffer>
 #include <QtCore/QByteArray>
 #include <QtCore/QSet>
 #include <QtGui/QImageReader>
+#include <wtf/MainThread.h>
+#include <wtf/ThreadSafeRefCounted.h>
+#include <wtf/WorkQueue.h>
 
 namespace WebCore {
 
+// QImageReader cannot resume from where it stopped, so a partial decode starts
+// over from the first byte. Only redo one once enough new data has arrived.
+static const size_t minimumDataGrowthForPartialDecode = 32 * 1024;
+
+// Smaller images decode quickly enough that a background decode and the extra
+// repaint would cost more than they save.
+static const unsigned minimumPixelsForAsynchronousDecode = 512 * 512;
+
+class ImageDecoderQt::DecodeJob : public ThreadSafeRefCounted<DecodeJob> {
+public:
+    static Ref<DecodeJob> create(SharedBuffer& data, const QByteArray& format, const QSize& scaledSize, bool premultiplyAlpha, WeakPtr<ImageDecoderQt> decoder)
+    {
+        return adoptRef(*new DecodeJob(data, format, scaledSize, premultiplyAlpha, WTFMove(decoder)));
+    }
+
+    // Only touched on the main thread; keeps the bytes behind m_encodedData alive.
+    RefPtr<SharedBuffer> m_data;
+
+    QByteArray m_encodedData;
+    QByteArray m_format;
+    QSize m_scaledSize;
+    ImageFrame m_frame;
+    bool m_succeeded;
+    WeakPtr<ImageDecoderQt> m_decoder;
+
+private:
+    DecodeJob(SharedBuffer& data, const QByteArray& format, const QSize& scaledSize, bool premultiplyAlpha, WeakPtr<ImageDecoderQt> decoder)
+        : m_data(&data)
+        , m_encodedData(QByteArray::fromRawData(data.data(), data.size()))
+        , m_format(format)
+        , m_scaledSize(scaledSize)
+        , m_succeeded(false)
+        , m_decoder(WTFMove(decoder))
+    {
+        m_frame.setPremultiplyAlpha(premultiplyAlpha);
+    }
+};
+
+static WorkQueue& decodeQueue()
+{
+    static auto& queue = WorkQueue::create("org.webkit.ImageDecoderQt").leakRef();
+    return queue;
+}
+
 ImageDecoderQt::ImageDecoderQt(ImageSource::AlphaOption alphaOption, ImageSource::GammaAndColorProfileOption gammaAndColorProfileOption)
     : ImageDecoder(alphaOption, gammaAndColorProfileOption)
     , m_repetitionCount(cAnimationNone)
+    , m_partialDecodeDataSize(0)
+    , m_weakFactory(this)
 {
 }
 
@@ -65,23 +115,55 @@ static bool isFormatWhiteListed(const QByteArray &format)
     return whiteListSet.contains(format);
 }
 
+// Reads the current image of |reader| into |buffer|. This does not touch any
+// decoder state, so it is also used on the decode queue.
+static bool readCurrentImage(QImageReader& reader, ImageFrame& buffer)
+{
+    QSize imageSize = reader.scaledSize();
+    if (imageSize.isEmpty())
+        imageSize = reader.size();
+
+    // A partially decoded frame already has a buffer of the right size.
+    if (!buffer.hasPixelData() && !buffer.setSize(imageSize.width(), imageSize.height()))
+        return false;
+
+    QImage image(reinterpret_cast<uchar*>(buffer.getAddr(0, 0)), imageSize.width(), imageSize.height(), sizeof(ImageFrame::PixelData) * imageSize.width(), reader.imageFormat());
+
+    buffer.setDuration(reader.nextImageDelay());
+    reader.read(&image);
+
+    // ImageFrame expects ARGB32.
+    if (buffer.premultiplyAlpha()) {
+        if (image.format() != QImage::Format_ARGB32_Premultiplied)
+            image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    } else {
+        if (image.format() != QImage::Format_ARGB32)
+            image = image.convertToFormat(QImage::Format_ARGB32);
+    }
+
+    if (reinterpret_cast<const uchar*>(image.constBits()) != reinterpret_cast<const uchar*>(buffer.getAddr(0, 0))) {
+        // The in-buffer was replaced during decoding with another, so copy into it manually.
+        memcpy(buffer.getAddr(0, 0), image.constBits(),  image.byteCount());
+    }
+
+    if (image.isNull())
+        return false;
+
+    buffer.setOriginalFrameRect(image.rect());
+    buffer.setHasAlpha(image.hasAlphaChannel());
+    return true;
+}
+
 void ImageDecoderQt::setData(SharedBuffer* data, bool allDataReceived)
 {
     if (failed())
         return;
 
-    // No progressive loading possible
-    if (!allDataReceived)
-        return;
-
     // Cache our own new data.
     ImageDecoder::setData(data, allDataReceived);
 
-    // We expect to be only called once with allDataReceived
-    ASSERT(!m_buffer);
-    ASSERT(!m_reader);
-
-    // Attempt to load the data
+    // QImageReader cannot wait for more data on a device that ran dry, so
+    // every update gets a fresh reader over everything received so far.
     QByteArray imageData = QByteArray::fromRawData(m_data->data(), m_data->size());
     m_buffer = std::make_unique<QBuffer>();
     m_buffer->setData(imageData);
@@ -97,7 +179,11 @@ void ImageDecoderQt::setData(SharedBuffer* data, bool allDataReceived)
         qWarning("Image of format '%s' blocked because it is not considered safe. If you are sure it is safe to do so, you can white-list the format by setting the environment variable QTWEBKIT_IMAGEFORMAT_WHITELIST=%s", m_format.constData(), m_format.constData());
         setFailed();
         m_reader = nullptr;
+        return;
     }
+
+    if (m_scaled)
+        m_reader->setScaledSize(scaledSize());
 }
 
 bool ImageDecoderQt::isSizeAvailable()
@@ -111,7 +197,15 @@ bool ImageDecoderQt::isSizeAvailable()
 size_t ImageDecoderQt::frameCount()
 {
     if (m_frameBufferCache.isEmpty() && m_reader) {
+        // Without the header the reader cannot tell whether the image is animated.
+        if (!isAllDataReceived() && !ImageDecoder::isSizeAvailable())
+            return 0;
+
         if (m_reader->supportsAnimation()) {
+            // Frames of animated images are only decoded once all data is in.
+            if (!isAllDataReceived())
+                return 0;
+
             int imageCount = m_reader->imageCount();
 
             // Fixup for Qt decoders... imageCount() is wrong
@@ -151,8 +245,9 @@ ImageFrame* ImageDecoderQt::frameBufferAtIndex(size_t index)
     // yet how many images we are going to have and need to
     // find that out now.
     size_t count = m_frameBufferCache.size();
-    if (!failed() && !count) {
-        internalDecodeSize();
+    if (!failed() && !count && m_reader) {
+        if (!ImageDecoder::isSizeAvailable())
+            internalDecodeSize();
         count = frameCount();
     }
 
@@ -160,7 +255,12 @@ ImageFrame* ImageDecoderQt::frameBufferAtIndex(size_t index)
         return 0;
 
     ImageFrame& frame = m_frameBufferCache[index];
-    if (frame.status() != ImageFrame::FrameComplete && m_reader)
+    if (frame.status() == ImageFrame::FrameComplete || !m_reader || m_pendingDecode)
+        return &frame;
+
+    if (!isAllDataReceived())
+        internalReadPartialImage(index);
+    else if (!startAsynchronousDecode(index))
         internalReadImage(index);
     return &frame;
 }
@@ -176,6 +276,9 @@ void ImageDecoderQt::internalDecodeSize()
     // If we have a QSize() something failed
     QSize size = m_reader->size();
     if (size.isEmpty()) {
+        // The header may simply not have arrived yet.
+        if (!isAllDataReceived())
+            return;
         setFailed();
         return clearPointers();
     }
@@ -212,49 +315,104 @@ void ImageDecoderQt::internalReadImage(size_t frameIndex)
     clearPointers();
 }
 
-bool ImageDecoderQt::internalHandleCurrentImage(size_t frameIndex)
+void ImageDecoderQt::internalReadPartialImage(size_t frameIndex)
 {
-    ImageFrame* const buffer = &m_frameBufferCache[frameIndex];
-    QSize imageSize = m_reader->scaledSize();
-    if (imageSize.isEmpty())
-        imageSize = m_reader->size();
-
-    if (!buffer->setSize(imageSize.width(), imageSize.height()))
-        return false;
-
-    QImage image(reinterpret_cast<uchar*>(buffer->getAddr(0, 0)), imageSize.width(), imageSize.height(), sizeof(ImageFrame::PixelData) * imageSize.width(), m_reader->imageFormat());
+    ASSERT(m_reader);
+    ASSERT(!isAllDataReceived());
 
-    buffer->setDuration(m_reader->nextImageDelay());
-    m_reader->read(&image);
+    // frameCount() only exposes the single frame of non-animated images
+    // while data is still arriving.
+    ASSERT(!frameIndex);
 
-    // ImageFrame expects ARGB32.
-    if (buffer->premultiplyAlpha()) {
-        if (image.format() != QImage::Format_ARGB32_Premultiplied)
-            image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
-    } else {
-        if (image.format() != QImage::Format_ARGB32)
-            image = image.convertToFormat(QImage::Format_ARGB32);
-    }
+    size_t dataSize = m_data->size();
+    if (dataSize < m_partialDecodeDataSize + std::max(minimumDataGrowthForPartialDecode, m_partialDecodeDataSize / 4))
+        return;
+    m_partialDecodeDataSize = dataSize;
 
-    if (reinterpret_cast<const uchar*>(image.constBits()) != reinterpret_cast<const uchar*>(buffer->getAddr(0, 0))) {
-        // The in-buffer was replaced during decoding with another, so copy into it manually.
-        memcpy(buffer->getAddr(0, 0), image.constBits(),  image.byteCount());
-    }
+    // A truncated image is not an error yet; keep whatever was decoded and
+    // try again once more data has arrived.
+    ImageFrame& buffer = m_frameBufferCache[frameIndex];
+    if (readCurrentImage(*m_reader, buffer))
+        buffer.setStatus(ImageFrame::FramePartial);
+}
 
-    if (image.isNull()) {
+bool ImageDecoderQt::internalHandleCurrentImage(size_t frameIndex)
+{
+    ImageFrame& buffer = m_frameBufferCache[frameIndex];
+    if (!readCurrentImage(*m_reader, buffer)) {
         frameCount();
         repetitionCount();
         clearPointers();
         return false;
     }
 
-    buffer->setOriginalFrameRect(image.rect());
-    buffer->setHasAlpha(image.hasAlphaChannel());
-    buffer->setStatus(ImageFrame::FrameComplete);
+    buffer.setStatus(ImageFrame::FrameComplete);
+    return true;
+}
+
+bool ImageDecoderQt::startAsynchronousDecode(size_t frameIndex)
+{
+    ASSERT(isMainThread());
+    ASSERT(m_reader);
+    ASSERT(!m_pendingDecode);
+
+    if (!AsynchronousImageDecodingScope::isActive())
+        return false;
+
+    // Animations need their frames in order and on time.
+    if (frameIndex || m_frameBufferCache.size() != 1 || m_reader->supportsAnimation())
+        return false;
+
+    IntSize decodedSize = scaledSize();
+    if (static_cast<unsigned long long>(decodedSize.width()) * decodedSize.height() < minimumPixelsForAsynchronousDecode)
+        return false;
+
+    QSize readerScaledSize = m_scaled ? QSize(decodedSize.width(), decodedSize.height()) : QSize();
+    m_pendingDecode = DecodeJob::create(*m_data, m_format, readerScaledSize, m_premultiplyAlpha, m_weakFactory.createWeakPtr());
+
+    RefPtr<DecodeJob> job = m_pendingDecode;
+    decodeQueue().dispatch([job] {
+        QBuffer buffer;
+        buffer.setData(job->m_encodedData);
+        buffer.open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+        QImageReader reader(&buffer, job->m_format);
+        reader.setQuality(49);
+        if (!job->m_scaledSize.isEmpty())
+            reader.setScaledSize(job->m_scaledSize);
 
+        job->m_succeeded = readCurrentImage(reader, job->m_frame);
+
+        callOnMainThread([job] {
+            job->m_data = nullptr;
+            if (ImageDecoderQt* decoder = job->m_decoder.get())
+                decoder->didFinishAsynchronousDecode(*job);
+        });
+    });
     return true;
 }
 
+void ImageDecoderQt::didFinishAsynchronousDecode(DecodeJob& job)
+{
+    ASSERT(m_pendingDecode == &job);
+    m_pendingDecode = nullptr;
+
+    if (failed())
+        return;
+
+    if (job.m_succeeded) {
+        ImageFrame& buffer = m_frameBufferCache[0];
+        buffer.adoptBitmapData(job.m_frame);
+        buffer.setOriginalFrameRect(job.m_frame.originalFrameRect());
+        buffer.setDuration(job.m_frame.duration());
+        buffer.setStatus(ImageFrame::FrameComplete);
+    } else
+        setFailed();
+
+    clearPointers();
+    notifyFrameDecoded(0);
+}
+
 // The QImageIOHandler is not able to tell us how many frames
 // we have and we need to parse every image. We do this by
 // increasing the m_frameBufferCache by one and try to parse
@@ -33,6 +33,8 @@
 #include <QtCore/QList>
 #include <QtGui/QImageReader>
 #include <QtGui/QPixmap>
+#include <wtf/RefPtr.h>
+#include <wtf/WeakPtr.h>
 
 namespace WebCore {
 
@@ -58,9 +60,14 @@ private:
     ImageDecoderQt &operator=(const ImageDecoderQt&);
 
 private:
+    class DecodeJob;
+
     void internalDecodeSize();
     void internalReadImage(size_t);
+    void internalReadPartialImage(size_t);
     bool internalHandleCurrentImage(size_t);
+    bool startAsynchronousDecode(size_t);
+    void didFinishAsynchronousDecode(DecodeJob&);
     void forceLoadEverything();
     void clearPointers();
 
@@ -69,6 +76,9 @@ private:
     std::unique_ptr<QBuffer> m_buffer;
     std::unique_ptr<QImageReader> m_reader;
     mutable int m_repetitionCount;
+    size_t m_partialDecodeDataSize;
+    RefPtr<DecodeJob> m_pendingDecode;
+    WeakPtrFactory<ImageDecoderQt> m_weakFactory;
 };
 
 
@@ -20,6 +20,7 @@
 #include "config.h"
 #include "MediaPlayerPrivateQt.h"
 
+#include "DisplayListRecorder.h"
 #include "Frame.h"
 #include "FrameView.h"
 #include "GraphicsContext.h"
@@ -620,6 +621,11 @@ void MediaPlayerPrivateQt::paintCurrentFrameInContext(GraphicsContext& context,
     if (!m_currentVideoFrame.isValid())
         return;
 
+    if (context.isRecording()) {
+        context.displayListRecorder()->setHasUnrecordedContent();
+        return;
+    }
+
     QPainter* painter = context.platformContext();
 
     if (m_currentVideoFrame.handleType() == QAbstractVideoBuffer::QPixmapHandle) {
@@ -57,6 +57,11 @@ Path::Path(const Path& other)
 {
 }
 
+Path::Path(const QPainterPath& path)
+    : m_path(path)
+{
+}
+
 Path& Path::operator=(const Path& other)
 {
     m_path = other.m_path;
@@ -50,6 +50,7 @@ namespace WebCore {
         }
 
         bool currentFrameKnownToBeOpaque() override;
+        bool canBeDrawnFromAnyThread() const override { return m_ownsPixmap; }
 
         // FIXME: StillImages are underreporting decoded sizes and will be unable
         // to prune because these functions are not implemented yet.
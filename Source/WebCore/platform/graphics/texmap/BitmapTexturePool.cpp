@@ -35,15 +35,19 @@
 #include "BitmapTextureImageBuffer.h"
 #endif
 
+#include <wtf/MathExtras.h>
+#include <wtf/StdLibExtras.h>
+
 namespace WebCore {
 
 static const double s_releaseUnusedSecondsTolerance = 3;
 static const double s_releaseUnusedTexturesTimerInterval = 0.5;
-
+static const size_t s_defaultMemoryBudget = 64 * 1024 * 1024;
 
 #if PLATFORM(QT)
 BitmapTexturePool::BitmapTexturePool()
     : m_releaseUnusedTexturesTimer(*this, &BitmapTexturePool::releaseUnusedTexturesTimerFired)
+    , m_memoryBudget(s_defaultMemoryBudget)
 {
 }
 #endif
@@ -52,27 +56,112 @@ BitmapTexturePool::BitmapTexturePool()
 BitmapTexturePool::BitmapTexturePool(RefPtr<GraphicsContext3D>&& context3D)
     : m_context3D(WTFMove(context3D))
     , m_releaseUnusedTexturesTimer(*this, &BitmapTexturePool::releaseUnusedTexturesTimerFired)
+    , m_memoryBudget(s_defaultMemoryBudget)
 {
 }
 #endif
 
-RefPtr<BitmapTexture> BitmapTexturePool::acquireTexture(const IntSize& size, const BitmapTexture::Flags flags)
+static int roundUpToSizeClass(int length)
 {
-    Vector<Entry>& list = flags & BitmapTexture::FBOAttachment ? m_attachmentTextures : m_textures;
+    // Multiples of 32 pixels up to 256, then eight classes per power of two.
+    if (length <= 256)
+        return std::max<int>(32, roundUpToMultipleOf<32>(std::max(length, 0)));
+    unsigned step = 1 << (fastLog2(static_cast<unsigned>(length)) - 4);
+    return (length + step - 1) & ~(step - 1);
+}
 
-    Entry* selectedEntry = std::find_if(list.begin(), list.end(),
-        [&size](Entry& entry) { return entry.m_texture->refCount() == 1 && entry.m_texture->size() == size; });
+IntSize BitmapTexturePool::sizeClass(const IntSize& size)
+{
+    return IntSize(roundUpToSizeClass(size.width()), roundUpToSizeClass(size.height()));
+}
+
+RefPtr<BitmapTexture> BitmapTexturePool::acquireTexture(const IntSize& size, const BitmapTexture::Flags flags)
+{
+    Buckets& buckets = flags & BitmapTexture::FBOAttachment ? m_attachmentTextures : m_textures;
+    IntSize bucketSize = sizeClass(size);
+    size_t bytes = static_cast<size_t>(size.width()) * size.height() * 4;
+
+    // Prefer a texture of exactly this size, whose storage does not need to be reallocated.
+    Entry* selectedEntry = nullptr;
+    auto bucket = buckets.find(bucketSize);
+    if (bucket != buckets.end()) {
+        for (auto& entry : bucket->value) {
+            if (entry.isInUse())
+                continue;
+            if (entry.m_size == size) {
+                selectedEntry = &entry;
+                break;
+            }
+            if (!selectedEntry)
+                selectedEntry = &entry;
+        }
+    }
 
-    if (selectedEntry == list.end()) {
-        list.append(Entry(createTexture(flags)));
-        selectedEntry = &list.last();
+    if (selectedEntry) {
+        ++m_hitCount;
+        m_bytesHeld -= selectedEntry->m_bytes;
+    } else {
+        ++m_missCount;
+        releaseTexturesOverBudget(bytes);
+        Vector<Entry>& entries = buckets.add(bucketSize, Vector<Entry>()).iterator->value;
+        entries.append(Entry(createTexture(flags)));
+        selectedEntry = &entries.last();
     }
 
+    selectedEntry->m_size = size;
+    selectedEntry->m_bytes = bytes;
+    m_bytesHeld += bytes;
+
     scheduleReleaseUnusedTextures();
     selectedEntry->markIsInUse();
     return selectedEntry->m_texture.copyRef();
 }
 
+void BitmapTexturePool::setMemoryBudget(size_t bytes)
+{
+    m_memoryBudget = bytes;
+    releaseTexturesOverBudget(0);
+}
+
+void BitmapTexturePool::releaseTexturesOverBudget(size_t incomingBytes)
+{
+    while (m_bytesHeld + incomingBytes > m_memoryBudget) {
+        Buckets* oldestBuckets = nullptr;
+        Buckets::iterator oldestBucket;
+        size_t oldestIndex = 0;
+        double oldestUsedTime = std::numeric_limits<double>::infinity();
+
+        auto findOldestUnusedEntry = [&](Buckets& buckets) {
+            for (auto it = buckets.begin(); it != buckets.end(); ++it) {
+                for (size_t i = 0; i < it->value.size(); ++i) {
+                    const Entry& entry = it->value[i];
+                    if (entry.isInUse() || entry.m_lastUsedTime >= oldestUsedTime)
+                        continue;
+                    oldestBuckets = &buckets;
+                    oldestBucket = it;
+                    oldestIndex = i;
+                    oldestUsedTime = entry.m_lastUsedTime;
+                }
+            }
+        };
+        findOldestUnusedEntry(m_textures);
+        findOldestUnusedEntry(m_attachmentTextures);
+
+        // Textures in use cannot be released, so the pool may stay over budget until they are returned.
+        if (!oldestBuckets)
+            return;
+        removeEntry(*oldestBuckets, oldestBucket, oldestIndex);
+    }
+}
+
+void BitmapTexturePool::removeEntry(Buckets& buckets, Buckets::iterator bucket, size_t index)
+{
+    m_bytesHeld -= bucket->value[index].m_bytes;
+    bucket->value.remove(index);
+    if (bucket->value.isEmpty())
+        buckets.remove(bucket);
+}
+
 void BitmapTexturePool::scheduleReleaseUnusedTextures()
 {
     if (m_releaseUnusedTexturesTimer.isActive())
@@ -86,29 +175,23 @@ void BitmapTexturePool::releaseUnusedTexturesTimerFired()
     // Delete entries, which have been unused in s_releaseUnusedSecondsTolerance.
     double minUsedTime = monotonicallyIncreasingTime() - s_releaseUnusedSecondsTolerance;
 
-    if (!m_textures.isEmpty()) {
-        std::sort(m_textures.begin(), m_textures.end(),
-            [](const Entry& a, const Entry& b) { return a.m_lastUsedTime > b.m_lastUsedTime; });
-
-        for (size_t i = 0; i < m_textures.size(); ++i) {
-            if (m_textures[i].m_lastUsedTime < minUsedTime) {
-                m_textures.remove(i, m_textures.size() - i);
-                break;
-            }
-        }
-    }
-
-    if (!m_attachmentTextures.isEmpty()) {
-        std::sort(m_attachmentTextures.begin(), m_attachmentTextures.end(),
-            [](const Entry& a, const Entry& b) { return a.m_lastUsedTime > b.m_lastUsedTime; });
-
-        for (size_t i = 0; i < m_attachmentTextures.size(); ++i) {
-            if (m_attachmentTextures[i].m_lastUsedTime < minUsedTime) {
-                m_attachmentTextures.remove(i, m_attachmentTextures.size() - i);
-                break;
-            }
+    auto releaseUnusedTextures = [this, minUsedTime](Buckets& buckets) {
+        Vector<IntSize> emptyBuckets;
+        for (auto& bucket : buckets) {
+            bucket.value.removeAllMatching([this, minUsedTime](const Entry& entry) {
+                if (entry.m_lastUsedTime >= minUsedTime)
+                    return false;
+                m_bytesHeld -= entry.m_bytes;
+                return true;
+            });
+            if (bucket.value.isEmpty())
+                emptyBuckets.append(bucket.key);
         }
-    }
+        for (auto& bucketSize : emptyBuckets)
+            buckets.remove(bucketSize);
+    };
+    releaseUnusedTextures(m_textures);
+    releaseUnusedTextures(m_attachmentTextures);
 
     if (!m_textures.isEmpty() || !m_attachmentTextures.isEmpty())
         scheduleReleaseUnusedTextures();
@@ -28,8 +28,10 @@
 #define BitmapTexturePool_h
 
 #include "BitmapTexture.h"
+#include "IntSizeHash.h"
 #include "Timer.h"
 #include <wtf/CurrentTime.h>
+#include <wtf/HashMap.h>
 
 #if USE(TEXTURE_MAPPER_GL)
 #include "GraphicsContext3D.h"
@@ -51,20 +53,41 @@ public:
     explicit BitmapTexturePool(RefPtr<GraphicsContext3D>&&);
 #endif
 
+    // The returned texture may have a different size than requested; the caller
+    // resets it to the requested size, as TextureMapper::acquireTextureFromPool() does.
     RefPtr<BitmapTexture> acquireTexture(const IntSize&, const BitmapTexture::Flags);
 
+    // Textures that are not in use are released, least recently used first, to
+    // keep the pool within this many bytes.
+    void setMemoryBudget(size_t bytes);
+    size_t memoryBudget() const { return m_memoryBudget; }
+
+    size_t bytesHeld() const { return m_bytesHeld; }
+    unsigned hitCount() const { return m_hitCount; }
+    unsigned missCount() const { return m_missCount; }
+
 private:
     struct Entry {
         explicit Entry(RefPtr<BitmapTexture>&& texture)
             : m_texture(WTFMove(texture))
         { }
 
+        bool isInUse() const { return m_texture->refCount() > 1; }
         void markIsInUse() { m_lastUsedTime = monotonicallyIncreasingTime(); }
 
         RefPtr<BitmapTexture> m_texture;
+        IntSize m_size;
+        size_t m_bytes { 0 };
         double m_lastUsedTime { 0.0 };
     };
 
+    // Textures are kept in buckets of similar sizes, so that a layer whose size
+    // changes slightly keeps reusing the same texture.
+    typedef HashMap<IntSize, Vector<Entry>> Buckets;
+
+    static IntSize sizeClass(const IntSize&);
+    void releaseTexturesOverBudget(size_t incomingBytes);
+    void removeEntry(Buckets&, Buckets::iterator, size_t index);
     void scheduleReleaseUnusedTextures();
     void releaseUnusedTexturesTimerFired();
     RefPtr<BitmapTexture> createTexture(const BitmapTexture::Flags);
@@ -73,9 +96,13 @@ private:
     RefPtr<GraphicsContext3D> m_context3D;
 #endif
 
-    Vector<Entry> m_textures;
-    Vector<Entry> m_attachmentTextures;
+    Buckets m_textures;
+    Buckets m_attachmentTextures;
     Timer m_releaseUnusedTexturesTimer;
+    size_t m_memoryBudget;
+    size_t m_bytesHeld { 0 };
+    unsigned m_hitCount { 0 };
+    unsigned m_missCount { 0 };
 };
 
 } // namespace WebCore
@@ -377,6 +377,8 @@ void CompositingCoordinator::purgeBackingStores()
     m_updateAtlases.clear();
 }
 
+static const int ScratchBufferDimension = 1024; // Should be a power of two.
+
 bool CompositingCoordinator::paintToSurface(const IntSize& size, CoordinatedSurface::Flags flags, uint32_t& atlasID, IntPoint& offset, CoordinatedSurface::Client* client)
 {
     for (auto& updateAtlas : m_updateAtlases) {
@@ -388,12 +390,35 @@ bool CompositingCoordinator::paintToSurface(const IntSize& size, CoordinatedSurf
         }
     }
 
-    static const int ScratchBufferDimension = 1024; // Should be a power of two.
     m_updateAtlases.append(std::make_unique<UpdateAtlas>(this, ScratchBufferDimension, flags));
     scheduleReleaseInactiveAtlases();
     return m_updateAtlases.last()->paintOnAvailableBuffer(size, atlasID, offset, client);
 }
 
+bool CompositingCoordinator::reserveSurfaceBuffer(const IntSize& size, CoordinatedSurface::Flags flags, uint32_t& atlasID, IntPoint& offset, RefPtr<CoordinatedSurface>& surface)
+{
+    // All atlases come from the same surface factory, so don't keep creating atlases that can't be used.
+    if (!m_updateAtlases.isEmpty() && !m_updateAtlases.first()->supportsConcurrentPainting())
+        return false;
+
+    for (auto& updateAtlas : m_updateAtlases) {
+        UpdateAtlas* atlas = updateAtlas.get();
+        if (atlas->supportsAlpha() == (flags & CoordinatedSurface::SupportsAlpha)) {
+            if (atlas->reserveAvailableBuffer(size, atlasID, offset, surface))
+                return true;
+        }
+    }
+
+    m_updateAtlases.append(std::make_unique<UpdateAtlas>(this, ScratchBufferDimension, flags));
+    scheduleReleaseInactiveAtlases();
+    return m_updateAtlases.last()->reserveAvailableBuffer(size, atlasID, offset, surface);
+}
+
+bool CompositingCoordinator::parallelTileRasterizationEnabled() const
+{
+    return m_page->settings().parallelTileRasterizationEnabled();
+}
+
 const double ReleaseInactiveAtlasesTimerInterval = 0.5;
 
 void CompositingCoordinator::scheduleReleaseInactiveAtlases()
@@ -107,6 +107,8 @@ private:
     virtual PassRefPtr<CoordinatedImageBacking> createImageBackingIfNeeded(Image*) override;
     virtual void detachLayer(CoordinatedGraphicsLayer*) override;
     virtual bool paintToSurface(const WebCore::IntSize&, WebCore::CoordinatedSurface::Flags, uint32_t& /* atlasID */, WebCore::IntPoint&, WebCore::CoordinatedSurface::Client*) override;
+    virtual bool reserveSurfaceBuffer(const WebCore::IntSize&, WebCore::CoordinatedSurface::Flags, uint32_t& /* atlasID */, WebCore::IntPoint&, RefPtr<WebCore::CoordinatedSurface>&) override;
+    virtual bool parallelTileRasterizationEnabled() const override;
     virtual void syncLayerState(CoordinatedLayerID, CoordinatedGraphicsLayerState&) override;
 
     // UpdateAtlas::Client
@@ -965,6 +965,18 @@ bool CoordinatedGraphicsLayer::paintToSurface(const IntSize& size, uint32_t& atl
     return m_coordinator->paintToSurface(size, contentsOpaque() ? CoordinatedSurface::NoFlags : CoordinatedSurface::SupportsAlpha, atlas, offset, client);
 }
 
+bool CoordinatedGraphicsLayer::reserveSurfaceBuffer(const IntSize& size, uint32_t& atlas, IntPoint& offset, RefPtr<CoordinatedSurface>& surface)
+{
+    ASSERT(m_coordinator);
+    ASSERT(m_coordinator->isFlushingLayerChanges());
+    return m_coordinator->reserveSurfaceBuffer(size, contentsOpaque() ? CoordinatedSurface::NoFlags : CoordinatedSurface::SupportsAlpha, atlas, offset, surface);
+}
+
+bool CoordinatedGraphicsLayer::tiledBackingStoreUsesParallelRasterization() const
+{
+    return m_coordinator && m_coordinator->parallelTileRasterizationEnabled();
+}
+
 void CoordinatedGraphicsLayer::createTile(uint32_t tileID, float scaleFactor)
 {
     ASSERT(m_coordinator);
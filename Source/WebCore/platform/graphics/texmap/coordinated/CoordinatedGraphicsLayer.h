@@ -52,6 +52,8 @@ public:
     virtual PassRefPtr<CoordinatedImageBacking> createImageBackingIfNeeded(Image*) = 0;
     virtual void detachLayer(CoordinatedGraphicsLayer*) = 0;
     virtual bool paintToSurface(const IntSize&, CoordinatedSurface::Flags, uint32_t& atlasID, IntPoint&, CoordinatedSurface::Client*) = 0;
+    virtual bool reserveSurfaceBuffer(const IntSize&, CoordinatedSurface::Flags, uint32_t& atlasID, IntPoint&, RefPtr<CoordinatedSurface>&) = 0;
+    virtual bool parallelTileRasterizationEnabled() const = 0;
 
     virtual void syncLayerState(CoordinatedLayerID, CoordinatedGraphicsLayerState&) = 0;
 };
@@ -140,6 +142,8 @@ public:
     virtual void updateTile(uint32_t tileID, const SurfaceUpdateInfo&, const IntRect&) override;
     virtual void removeTile(uint32_t tileID) override;
     virtual bool paintToSurface(const IntSize&, uint32_t& /* atlasID */, IntPoint&, CoordinatedSurface::Client*) override;
+    virtual bool reserveSurfaceBuffer(const IntSize&, uint32_t& /* atlasID */, IntPoint&, RefPtr<CoordinatedSurface>&) override;
+    virtual bool tiledBackingStoreUsesParallelRasterization() const override;
 
     void setCoordinator(CoordinatedGraphicsLayerClient*);
 
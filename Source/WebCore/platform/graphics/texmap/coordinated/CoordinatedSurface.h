@@ -55,6 +55,9 @@ public:
 
     virtual void paintToSurface(const IntRect&, Client*) = 0;
 
+    // Whether paintToSurface() may be called from several threads at once for disjoint rects.
+    virtual bool supportsConcurrentPainting() const { return false; }
+
 #if USE(TEXTURE_MAPPER)
     virtual void copyToTexture(PassRefPtr<BitmapTexture>, const IntRect& target, const IntPoint& sourceOffset) = 0;
 #endif
@@ -27,10 +27,11 @@
 #include "Tile.h"
 
 #if USE(COORDINATED_GRAPHICS)
+#include "DisplayListReplayer.h"
 #include "GraphicsContext.h"
-#include "SurfaceUpdateInfo.h"
 #include "TiledBackingStore.h"
 #include "TiledBackingStoreClient.h"
+#include <wtf/MainThread.h>
 
 namespace WebCore {
 
@@ -65,16 +66,82 @@ void Tile::invalidate(const IntRect& dirtyRect)
     m_dirtyRect.unite(tileDirtyRect);
 }
 
-bool Tile::updateBackBuffer()
+class BackBufferPainter final : public CoordinatedSurface::Client {
+public:
+    BackBufferPainter(Tile& tile, const DisplayList::DisplayList* displayList, bool clearsBackground)
+        : m_tile(tile)
+        , m_displayList(displayList)
+        , m_clearsBackground(clearsBackground)
+    {
+    }
+
+    virtual void paintToSurfaceContext(GraphicsContext& context) override
+    {
+        const IntRect& dirtyRect = m_tile.dirtyRect();
+        if (m_clearsBackground) {
+            context.setCompositeOperation(CompositeCopy);
+            context.fillRect(IntRect(IntPoint::zero(), dirtyRect.size()), Color::transparent);
+            context.setCompositeOperation(CompositeSourceOver);
+        }
+
+        if (!m_displayList) {
+            m_tile.paintToSurfaceContext(context);
+            return;
+        }
+
+        // The display list was recorded in the scaled coordinate space of the backing store.
+        context.translate(-dirtyRect.x(), -dirtyRect.y());
+        DisplayList::Replayer replayer(context, *m_displayList);
+        replayer.replay(dirtyRect);
+    }
+
+private:
+    Tile& m_tile;
+    const DisplayList::DisplayList* m_displayList;
+    bool m_clearsBackground;
+};
+
+bool Tile::updateBackBuffer(const DisplayList::DisplayList* displayList)
 {
     if (!isDirty())
         return false;
 
     SurfaceUpdateInfo updateInfo;
 
-    if (!m_tiledBackingStore.client()->paintToSurface(m_dirtyRect.size(), updateInfo.atlasID, updateInfo.surfaceOffset, this))
+    // UpdateAtlas clears the buffer before handing it to the painter.
+    BackBufferPainter painter(*this, displayList, false);
+    if (!m_tiledBackingStore.client()->paintToSurface(m_dirtyRect.size(), updateInfo.atlasID, updateInfo.surfaceOffset, &painter))
         return false;
 
+    commitBackBuffer(updateInfo);
+    return true;
+}
+
+bool Tile::reserveBackBuffer()
+{
+    ASSERT(isDirty());
+    ASSERT(!m_reservedSurface);
+    return m_tiledBackingStore.client()->reserveSurfaceBuffer(m_dirtyRect.size(), m_reservedUpdateInfo.atlasID, m_reservedUpdateInfo.surfaceOffset, m_reservedSurface);
+}
+
+void Tile::paintReservedBackBuffer(const DisplayList::DisplayList* displayList)
+{
+    ASSERT(m_reservedSurface);
+    ASSERT(displayList || isMainThread());
+    BackBufferPainter painter(*this, displayList, m_tiledBackingStore.supportsAlpha());
+    m_reservedSurface->paintToSurface(IntRect(m_reservedUpdateInfo.surfaceOffset, m_dirtyRect.size()), &painter);
+}
+
+void Tile::commitReservedBackBuffer()
+{
+    ASSERT(isMainThread());
+    ASSERT(m_reservedSurface);
+    m_reservedSurface = nullptr;
+    commitBackBuffer(m_reservedUpdateInfo);
+}
+
+void Tile::commitBackBuffer(SurfaceUpdateInfo& updateInfo)
+{
     updateInfo.updateRect = m_dirtyRect;
     updateInfo.updateRect.move(-m_rect.x(), -m_rect.y());
 
@@ -89,8 +156,6 @@ bool Tile::updateBackBuffer()
     m_tiledBackingStore.client()->updateTile(m_ID, updateInfo, m_rect);
 
     m_dirtyRect = IntRect();
-
-    return true;
 }
 
 void Tile::paintToSurfaceContext(GraphicsContext& context)
@@ -31,13 +31,19 @@
 #include "IntPoint.h"
 #include "IntPointHash.h"
 #include "IntRect.h"
+#include "SurfaceUpdateInfo.h"
 #include <wtf/RefCounted.h>
+#include <wtf/RefPtr.h>
 
 namespace WebCore {
 
 class GraphicsContext;
 class TiledBackingStore;
 
+namespace DisplayList {
+class DisplayList;
+}
+
 class Tile : public CoordinatedSurface::Client {
 public:
     typedef IntPoint Coordinate;
@@ -47,22 +53,35 @@ public:
 
     bool isDirty() const;
     void invalidate(const IntRect&);
-    bool updateBackBuffer();
+    // When a display list is given, the dirty rect is replayed from it instead of being painted by the client.
+    bool updateBackBuffer(const DisplayList::DisplayList* = nullptr);
     bool isReadyToPaint() const;
 
+    // Parallel rasterization: space for the update is reserved on the main thread, the reserved
+    // buffer is painted from a worker thread, and the update is committed back on the main thread.
+    bool reserveBackBuffer();
+    void paintReservedBackBuffer(const DisplayList::DisplayList*);
+    void commitReservedBackBuffer();
+
     const Coordinate& coordinate() const { return m_coordinate; }
     const IntRect& rect() const { return m_rect; }
+    const IntRect& dirtyRect() const { return m_dirtyRect; }
     void resize(const IntSize&);
 
     virtual void paintToSurfaceContext(GraphicsContext&) override;
 
 private:
+    void commitBackBuffer(SurfaceUpdateInfo&);
+
     TiledBackingStore& m_tiledBackingStore;
     Coordinate m_coordinate;
     IntRect m_rect;
 
     uint32_t m_ID;
     IntRect m_dirtyRect;
+
+    SurfaceUpdateInfo m_reservedUpdateInfo;
+    RefPtr<CoordinatedSurface> m_reservedSurface;
 };
 
 } // namespace WebCore
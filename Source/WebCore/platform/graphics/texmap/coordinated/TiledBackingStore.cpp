@@ -21,14 +21,31 @@
 #include "TiledBackingStore.h"
 
 #if USE(COORDINATED_GRAPHICS)
+#include "DisplayListRecorder.h"
 #include "GraphicsContext.h"
 #include "TiledBackingStoreClient.h"
+#include <atomic>
+#include <mutex>
 #include <wtf/CheckedArithmetic.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/NumberOfCores.h>
+#include <wtf/ParallelHelperPool.h>
 
 namespace WebCore {
 
 static const int defaultTileDimension = 512;
 
+// How far ahead the cover rect reaches while scrolling, in seconds of movement at the current velocity.
+static const double scrollPredictionInterval = 0.5;
+// Velocity samples further apart than this belong to separate scroll gestures.
+static const double scrollVelocityResetInterval = 0.25;
+// Weight of the newest sample in the smoothed scroll velocity.
+static const float scrollVelocitySmoothing = 0.5;
+// Slower movement is treated as no movement at all.
+static const float minimumScrollSpeed = 20;
+// Time per frame spent painting tiles outside the visible rect; visible tiles are always painted.
+static const double tileCreationTimeBudget = 0.008;
+
 static IntPoint innerBottomRight(const IntRect& rect)
 {
     // Actually, the rect does not contain rect.maxX(). Refer to IntRect::contain.
@@ -39,9 +56,11 @@ TiledBackingStore::TiledBackingStore(TiledBackingStoreClient* client, float cont
     : m_client(client)
     , m_tileSize(defaultTileDimension, defaultTileDimension)
     , m_coverAreaMultiplier(2.0f)
+    , m_lastVisibleRectUpdateTime(0)
     , m_contentsScale(contentsScale)
     , m_supportsAlpha(false)
     , m_pendingTileCreation(false)
+    , m_updatesToPaintWithoutRecording(0)
 {
 }
 
@@ -88,12 +107,154 @@ void TiledBackingStore::invalidate(const IntRect& contentsDirtyRect)
     }
 }
 
+static ParallelHelperPool& tileRasterizationPool()
+{
+    static std::once_flag initializeTileRasterizationPoolOnceFlag;
+    static ParallelHelperPool* tileRasterizationPool;
+    std::call_once(
+        initializeTileRasterizationPoolOnceFlag,
+        [] {
+            tileRasterizationPool = new ParallelHelperPool();
+            // The main thread helps too while it waits for the tiles.
+            tileRasterizationPool->ensureThreads(std::max(WTF::numberOfProcessorCores(), 2) - 1);
+        });
+    return *tileRasterizationPool;
+}
+
+// Content that can't be replayed in parallel usually stays on the layer for a while, so after a recording that
+// had to be replayed serially, the next updates skip the recording instead of paying for it again.
+static const unsigned updatesToPaintWithoutRecordingAfterSerialReplay = 8;
+
+static bool canReplayConcurrently(const DisplayList::DisplayList& displayList)
+{
+    // Drawing most Images may decode frames and start animation timers, which must happen on the main thread,
+    // and shadows are painted through the process-wide ShadowBlur scratch buffer. Gradients and patterns
+    // create their platform objects lazily, which isn't safe to do from several threads at once.
+    for (auto& item : displayList) {
+        switch (item.type()) {
+        case DisplayList::ItemType::SetState: {
+            const GraphicsContextStateChange& stateChange = downcast<DisplayList::SetState>(item).state();
+            const GraphicsContextState& state = stateChange.m_state;
+            if (stateChange.m_changeFlags & (GraphicsContextState::StrokePatternChange | GraphicsContextState::FillPatternChange))
+                return false;
+            if ((stateChange.m_changeFlags & GraphicsContextState::StrokeGradientChange) && state.strokeGradient)
+                return false;
+            if ((stateChange.m_changeFlags & GraphicsContextState::FillGradientChange) && state.fillGradient)
+                return false;
+            if ((stateChange.m_changeFlags & GraphicsContextState::ShadowChange) && state.shadowColor.isValid() && state.shadowColor.alpha()
+                && (state.shadowBlur || !state.shadowOffset.isZero()))
+                return false;
+            break;
+        }
+        case DisplayList::ItemType::DrawImage:
+            if (!downcast<DisplayList::DrawImage>(item).image().canBeDrawnFromAnyThread())
+                return false;
+            break;
+        case DisplayList::ItemType::DrawTiledImage:
+        case DisplayList::ItemType::DrawTiledScaledImage:
+#if USE(CG) || USE(CAIRO)
+        case DisplayList::ItemType::DrawNativeImage:
+#endif
+        case DisplayList::ItemType::DrawPattern:
+        case DisplayList::ItemType::FillRectWithGradient:
+            return false;
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+bool TiledBackingStore::updateTileBuffersInParallel(bool& updated)
+{
+    Vector<Tile*> dirtyTiles;
+    IntRect dirtyRect;
+    for (auto& tile : m_tiles.values()) {
+        if (!tile->isDirty())
+            continue;
+        dirtyTiles.append(tile.get());
+        dirtyRect.unite(tile->dirtyRect());
+    }
+
+    // Recording only pays off when the work can be spread over several tiles.
+    if (dirtyTiles.size() < 2)
+        return false;
+
+    // The last recordings of this layer couldn't be replayed in parallel, so paint the tiles directly for a while.
+    if (m_updatesToPaintWithoutRecording) {
+        --m_updatesToPaintWithoutRecording;
+        return false;
+    }
+
+    // Reserve the buffers before anything is painted, so that falling back doesn't paint the content twice.
+    Vector<Tile*> reservedTiles;
+    reservedTiles.reserveInitialCapacity(dirtyTiles.size());
+    for (auto* tile : dirtyTiles) {
+        if (!tile->reserveBackBuffer())
+            break;
+        reservedTiles.uncheckedAppend(tile);
+    }
+
+    if (reservedTiles.isEmpty())
+        return false;
+
+    // Paint the dirty region once, in the same scaled coordinate space Tile::paintToSurfaceContext() uses.
+    DisplayList::DisplayList displayList(DisplayList::DisplayList::StorageMode::Arena);
+    bool recordedAllContent;
+    {
+        GraphicsContext recordingContext;
+        DisplayList::Recorder recorder(recordingContext, displayList, dirtyRect, AffineTransform());
+        recordingContext.scale(FloatSize(m_contentsScale, m_contentsScale));
+        m_client->tiledBackingStorePaint(recordingContext, mapToContents(dirtyRect));
+        recordedAllContent = !recorder.hasUnrecordedContent();
+    }
+
+    // Content that was painted straight to a platform painter is missing from the list, so the tiles
+    // have to be painted by the client after all. Otherwise they are only ever replayed from the list.
+    const DisplayList::DisplayList* replayList = recordedAllContent ? &displayList : nullptr;
+
+    bool canReplayInParallel = replayList && canReplayConcurrently(displayList);
+    if (!canReplayInParallel)
+        m_updatesToPaintWithoutRecording = updatesToPaintWithoutRecordingAfterSerialReplay;
+
+    if (canReplayInParallel && reservedTiles.size() > 1) {
+        // One tile per task; idle helpers pick up the next unclaimed tile.
+        std::atomic<size_t> nextTileIndex(0);
+        ParallelHelperClient helperClient(&tileRasterizationPool());
+        helperClient.runFunctionInParallel(
+            [&] () {
+                for (size_t index = nextTileIndex++; index < reservedTiles.size(); index = nextTileIndex++)
+                    reservedTiles[index]->paintReservedBackBuffer(replayList);
+            });
+    } else {
+        for (auto* tile : reservedTiles)
+            tile->paintReservedBackBuffer(replayList);
+    }
+
+    // All workers are done at this point, so the updates can be handed to the coordinator.
+    for (auto* tile : reservedTiles)
+        tile->commitReservedBackBuffer();
+    updated = true;
+
+    // Tiles that didn't fit in the reserved update atlas space are painted the regular way.
+    for (size_t i = reservedTiles.size(); i < dirtyTiles.size(); ++i)
+        updated |= dirtyTiles[i]->updateBackBuffer(replayList);
+
+    return true;
+}
+
 void TiledBackingStore::updateTileBuffers()
 {
+    bool updated = false;
+    if (m_client->tiledBackingStoreUsesParallelRasterization() && updateTileBuffersInParallel(updated)) {
+        if (updated)
+            m_client->didUpdateTileBuffers();
+        return;
+    }
+
     // FIXME: In single threaded case, tile back buffers could be updated asynchronously 
     // one by one and then swapped to front in one go. This would minimize the time spent
     // blocking on tile updates.
-    bool updated = false;
     for (auto& tile : m_tiles.values()) {
         if (!tile->isDirty())
             continue;
@@ -105,6 +266,31 @@ void TiledBackingStore::updateTileBuffers()
         m_client->didUpdateTileBuffers();
 }
 
+static double timeToReach(int visibleStart, int visibleEnd, int tileStart, int tileEnd, float velocity)
+{
+    if (tileEnd > visibleStart && tileStart < visibleEnd)
+        return 0;
+
+    bool tileIsAhead = tileStart >= visibleEnd;
+    if (tileIsAhead ? velocity <= 0 : velocity >= 0)
+        return std::numeric_limits<double>::infinity();
+
+    int distance = tileIsAhead ? tileStart - visibleEnd : visibleStart - tileEnd;
+    return distance / std::abs(velocity);
+}
+
+// Returns the number of seconds until the visible rect, moving at the current scroll velocity,
+// reaches the given rect, or infinity if it is not moving towards it.
+double TiledBackingStore::predictedTimeToVisible(const IntRect& rect) const
+{
+    if (m_visibleRect.intersects(rect))
+        return 0;
+
+    double timeX = timeToReach(m_visibleRect.x(), m_visibleRect.maxX(), rect.x(), rect.maxX(), m_scrollVelocity.width());
+    double timeY = timeToReach(m_visibleRect.y(), m_visibleRect.maxY(), rect.y(), rect.maxY(), m_scrollVelocity.height());
+    return std::max(timeX, timeY);
+}
+
 double TiledBackingStore::tileDistance(const IntRect& viewport, const Tile::Coordinate& tileCoordinate) const
 {
     if (viewport.intersects(tileRectForCoordinate(tileCoordinate)))
@@ -143,12 +329,30 @@ bool TiledBackingStore::visibleAreaIsCovered() const
     return coverageRatio(intersection(m_visibleRect, m_rect)) == 1.0f;
 }
 
+void TiledBackingStore::updateScrollVelocity(const IntRect& visibleRect)
+{
+    double now = monotonicallyIncreasingTime();
+    double elapsedTime = now - m_lastVisibleRectUpdateTime;
+
+    if (!m_lastVisibleRectUpdateTime || elapsedTime > scrollVelocityResetInterval || visibleRect.size() != m_visibleRect.size())
+        m_scrollVelocity = FloatSize();
+    else if (elapsedTime > 0) {
+        FloatSize sample = FloatSize(visibleRect.location() - m_visibleRect.location()) * static_cast<float>(1 / elapsedTime);
+        m_scrollVelocity = m_scrollVelocity * (1 - scrollVelocitySmoothing) + sample * scrollVelocitySmoothing;
+        if (m_scrollVelocity.diagonalLength() < minimumScrollSpeed)
+            m_scrollVelocity = FloatSize();
+    }
+
+    m_lastVisibleRectUpdateTime = now;
+}
+
 void TiledBackingStore::createTiles(const IntRect& visibleRect, const IntRect& scaledContentsRect)
 {
     // Update our backing store geometry.
     const IntRect previousRect = m_rect;
     m_rect = scaledContentsRect;
     m_trajectoryVector = m_pendingTrajectoryVector;
+    updateScrollVelocity(visibleRect);
     m_visibleRect = visibleRect;
 
     if (m_rect.isEmpty()) {
@@ -194,15 +398,16 @@ void TiledBackingStore::createTiles(const IntRect& visibleRect, const IntRect& s
     if (previousRect != m_rect)
         didResizeTiles = resizeEdgeTiles();
 
-    // Search for the tile position closest to the viewport center that does not yet contain a tile.
-    // Which position is considered the closest depends on the tileDistance function.
-    double shortestDistance = std::numeric_limits<double>::infinity();
-    Vector<Tile::Coordinate> tilesToCreate;
-    unsigned requiredTileCount = 0;
+    // Order the positions that do not yet contain a tile by how soon the visible rect is predicted
+    // to reach them. Positions it is not moving towards, or all of them when it is not moving,
+    // are ordered by the tileDistance function.
+    struct TileToCreate {
+        Tile::Coordinate coordinate;
+        double timeToVisible;
+        double distance;
+    };
+    Vector<TileToCreate> tilesToCreate;
 
-    // Cover areas (in tiles) with minimum distance from the visible rect. If the visible rect is
-    // not covered already it will be covered first in one go, due to the distance being 0 for tiles
-    // inside the visible rect.
     Tile::Coordinate topLeft = tileCoordinateForPoint(coverRect.location());
     Tile::Coordinate bottomRight = tileCoordinateForPoint(innerBottomRight(coverRect));
     for (int yCoordinate = topLeft.y(); yCoordinate <= bottomRight.y(); ++yCoordinate) {
@@ -210,32 +415,39 @@ void TiledBackingStore::createTiles(const IntRect& visibleRect, const IntRect& s
             Tile::Coordinate currentCoordinate(xCoordinate, yCoordinate);
             if (m_tiles.contains(currentCoordinate))
                 continue;
-            ++requiredTileCount;
-            double distance = tileDistance(m_visibleRect, currentCoordinate);
-            if (distance > shortestDistance)
-                continue;
-            if (distance < shortestDistance) {
-                tilesToCreate.clear();
-                shortestDistance = distance;
-            }
-            tilesToCreate.append(currentCoordinate);
+            tilesToCreate.append({ currentCoordinate, predictedTimeToVisible(tileRectForCoordinate(currentCoordinate)), tileDistance(m_visibleRect, currentCoordinate) });
         }
     }
-
-    // Now construct the tile(s) within the shortest distance.
-    unsigned tilesToCreateCount = tilesToCreate.size();
-    for (unsigned n = 0; n < tilesToCreateCount; ++n) {
-        Tile::Coordinate coordinate = tilesToCreate[n];
-        m_tiles.add(coordinate, std::make_unique<Tile>(*this, coordinate));
-    }
-    requiredTileCount -= tilesToCreateCount;
+    std::sort(tilesToCreate.begin(), tilesToCreate.end(),
+        [](const TileToCreate& a, const TileToCreate& b) {
+            if (a.timeToVisible != b.timeToVisible)
+                return a.timeToVisible < b.timeToVisible;
+            return a.distance < b.distance;
+        });
+
+    // If the visible rect is not covered already it will be covered first in one go, due to
+    // the distance being 0 for tiles inside the visible rect.
+    double startTime = monotonicallyIncreasingTime();
+    size_t createdTileCount = 0;
+    for (; createdTileCount < tilesToCreate.size() && !tilesToCreate[createdTileCount].distance; ++createdTileCount)
+        m_tiles.add(tilesToCreate[createdTileCount].coordinate, std::make_unique<Tile>(*this, tilesToCreate[createdTileCount].coordinate));
 
     // Paint the content of the newly created tiles or resized tiles.
-    if (tilesToCreateCount || didResizeTiles)
+    if (createdTileCount || didResizeTiles)
+        updateTileBuffers();
+
+    // Then create and paint the remaining tiles in order, a batch at a time, while there is time left in this frame.
+    size_t batchSize = m_client->tiledBackingStoreUsesParallelRasterization() ? std::max(WTF::numberOfProcessorCores(), 1) : 1;
+    while (createdTileCount < tilesToCreate.size() && monotonicallyIncreasingTime() - startTime < tileCreationTimeBudget) {
+        size_t batchEnd = std::min(createdTileCount + batchSize, tilesToCreate.size());
+        for (; createdTileCount < batchEnd; ++createdTileCount)
+            m_tiles.add(tilesToCreate[createdTileCount].coordinate, std::make_unique<Tile>(*this, tilesToCreate[createdTileCount].coordinate));
         updateTileBuffers();
+    }
 
-    // Re-call createTiles on a timer to cover the visible area with the newest shortest distance.
-    m_pendingTileCreation = requiredTileCount;
+    // Re-call createTiles on a timer to create the tiles that did not fit in this frame, and
+    // to restore the regular cover rect once scrolling has stopped.
+    m_pendingTileCreation = createdTileCount < tilesToCreate.size() || !m_scrollVelocity.isZero();
     if (m_pendingTileCreation)
         m_client->tiledBackingStoreHasPendingTileCreation();
 }
@@ -294,7 +506,22 @@ void TiledBackingStore::computeCoverAndKeepRect(const IntRect& visibleRect, IntR
         coverRect.inflateY(visibleRect.height() * (m_coverAreaMultiplier - 1) / 2);
         keepRect = coverRect;
 
-        if (m_trajectoryVector != FloatPoint::zero()) {
+        if (!m_scrollVelocity.isZero()) {
+            // While scrolling, cover the area the visible rect is predicted to move over soon, and keep
+            // nothing behind it. The faster the scroll, the further ahead the cover rect reaches.
+            float speed = m_scrollVelocity.diagonalLength();
+            auto leadDistance = [&](float velocity, int visibleLength) {
+                float minimumLead = visibleLength * (m_coverAreaMultiplier - 1) / 2 * std::abs(velocity) / speed;
+                float maximumLead = visibleLength * m_coverAreaMultiplier;
+                float lead = std::min(std::max(std::abs(velocity) * static_cast<float>(scrollPredictionInterval), minimumLead), maximumLead);
+                return velocity < 0 ? -lead : lead;
+            };
+
+            coverRect = visibleRect;
+            coverRect.move(leadDistance(m_scrollVelocity.width(), visibleRect.width()), leadDistance(m_scrollVelocity.height(), visibleRect.height()));
+            coverRect.unite(visibleRect);
+            keepRect = coverRect;
+        } else if (m_trajectoryVector != FloatPoint::zero()) {
             // A null trajectory vector (no motion) means that tiles for the coverArea will be created.
             // A non-null trajectory vector will shrink the covered rect to visibleRect plus its expansion from its
             // center toward the cover area edges in the direction of the given vector.
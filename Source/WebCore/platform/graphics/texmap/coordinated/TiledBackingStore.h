@@ -23,6 +23,7 @@
 #if USE(COORDINATED_GRAPHICS)
 
 #include "FloatPoint.h"
+#include "FloatSize.h"
 #include "IntPoint.h"
 #include "IntRect.h"
 #include "Tile.h"
@@ -58,14 +59,19 @@ public:
     IntRect tileRectForCoordinate(const Tile::Coordinate&) const;
     Tile::Coordinate tileCoordinateForPoint(const IntPoint&) const;
     double tileDistance(const IntRect& viewport, const Tile::Coordinate&) const;
+    double predictedTimeToVisible(const IntRect&) const;
 
     IntRect coverRect() const { return m_coverRect; }
     bool visibleAreaIsCovered() const;
     void removeAllNonVisibleTiles(const IntRect& unscaledVisibleRect, const IntRect& contentsRect);
 
     void setSupportsAlpha(bool);
+    bool supportsAlpha() const { return m_supportsAlpha; }
 
 private:
+    bool updateTileBuffersInParallel(bool& updated);
+
+    void updateScrollVelocity(const IntRect& visibleRect);
     void createTiles(const IntRect& visibleRect, const IntRect& scaledContentsRect);
     void computeCoverAndKeepRect(const IntRect& visibleRect, IntRect& coverRect, IntRect& keepRect) const;
 
@@ -91,6 +97,10 @@ private:
     FloatPoint m_pendingTrajectoryVector;
     IntRect m_visibleRect;
 
+    // In scaled pixels per second, measured from the movement of the visible rect.
+    FloatSize m_scrollVelocity;
+    double m_lastVisibleRectUpdateTime;
+
     IntRect m_coverRect;
     IntRect m_keepRect;
     IntRect m_rect;
@@ -100,6 +110,8 @@ private:
     bool m_supportsAlpha;
     bool m_pendingTileCreation;
 
+    unsigned m_updatesToPaintWithoutRecording;
+
     friend class Tile;
 };
 
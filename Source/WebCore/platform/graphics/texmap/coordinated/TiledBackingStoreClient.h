@@ -21,6 +21,7 @@
 #define TiledBackingStoreClient_h
 
 #include "CoordinatedSurface.h"
+#include <wtf/RefPtr.h>
 
 namespace WebCore {
 
@@ -40,6 +41,10 @@ public:
     virtual void updateTile(uint32_t tileID, const SurfaceUpdateInfo&, const IntRect&) = 0;
     virtual void removeTile(uint32_t tileID) = 0;
     virtual bool paintToSurface(const IntSize&, uint32_t& atlasID, IntPoint&, CoordinatedSurface::Client*) = 0;
+
+    // Parallel rasterization records the dirty region once and replays it into the tiles on worker threads.
+    virtual bool tiledBackingStoreUsesParallelRasterization() const { return false; }
+    virtual bool reserveSurfaceBuffer(const IntSize&, uint32_t& /* atlasID */, IntPoint&, RefPtr<CoordinatedSurface>&) { return false; }
 };
 
 #endif
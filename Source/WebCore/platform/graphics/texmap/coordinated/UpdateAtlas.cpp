@@ -88,7 +88,7 @@ void UpdateAtlas::didSwapBuffers()
 }
 
 
-bool UpdateAtlas::paintOnAvailableBuffer(const IntSize& size, uint32_t& atlasID, IntPoint& offset, CoordinatedSurface::Client* client)
+IntRect UpdateAtlas::allocateBuffer(const IntSize& size, uint32_t& atlasID, IntPoint& offset)
 {
     m_inactivityInSeconds = 0;
     buildLayoutIfNeeded();
@@ -96,15 +96,23 @@ bool UpdateAtlas::paintOnAvailableBuffer(const IntSize& size, uint32_t& atlasID,
 
     // No available buffer was found.
     if (rect.isEmpty())
-        return false;
+        return IntRect();
 
     if (!m_surface)
-        return false;
+        return IntRect();
 
     atlasID = m_ID;
 
     // FIXME: Use tri-state buffers, to allow faster updates.
     offset = rect.location();
+    return rect;
+}
+
+bool UpdateAtlas::paintOnAvailableBuffer(const IntSize& size, uint32_t& atlasID, IntPoint& offset, CoordinatedSurface::Client* client)
+{
+    IntRect rect = allocateBuffer(size, atlasID, offset);
+    if (rect.isEmpty())
+        return false;
 
     UpdateAtlasSurfaceClient surfaceClient(client, size, supportsAlpha());
     m_surface->paintToSurface(rect, &surfaceClient);
@@ -112,5 +120,18 @@ bool UpdateAtlas::paintOnAvailableBuffer(const IntSize& size, uint32_t& atlasID,
     return true;
 }
 
+bool UpdateAtlas::reserveAvailableBuffer(const IntSize& size, uint32_t& atlasID, IntPoint& offset, RefPtr<CoordinatedSurface>& surface)
+{
+    if (!supportsConcurrentPainting())
+        return false;
+
+    IntRect rect = allocateBuffer(size, atlasID, offset);
+    if (rect.isEmpty())
+        return false;
+
+    surface = m_surface;
+    return true;
+}
+
 } // namespace WebCore
 #endif // USE(COORDINATED_GRAPHICS)
@@ -49,6 +49,10 @@ public:
 
     // Returns false if there is no available buffer.
     bool paintOnAvailableBuffer(const IntSize&, uint32_t& atlasID, IntPoint& offset, CoordinatedSurface::Client*);
+    // Like paintOnAvailableBuffer(), but leaves painting the reserved area to the caller, which
+    // may do it from another thread. Returns false if there is no available buffer.
+    bool reserveAvailableBuffer(const IntSize&, uint32_t& atlasID, IntPoint& offset, RefPtr<CoordinatedSurface>&);
+    bool supportsConcurrentPainting() const { return m_surface && m_surface->supportsConcurrentPainting(); }
     void didSwapBuffers();
     bool supportsAlpha() const { return m_surface->supportsAlpha(); }
 
@@ -66,6 +70,7 @@ public:
 
 private:
     void buildLayoutIfNeeded();
+    IntRect allocateBuffer(const IntSize&, uint32_t& atlasID, IntPoint& offset);
 
 private:
     Client* m_client;
@@ -201,6 +201,21 @@ bool ImageFrame::copyBitmapData(const ImageFrame& other)
     return true;
 }
 
+void ImageFrame::adoptBitmapData(ImageFrame& other)
+{
+    if (this == &other)
+        return;
+
+    m_backingStore.swap(other.m_backingStore);
+    m_bytes = m_backingStore.data();
+    m_size = other.m_size;
+    setHasAlpha(other.m_hasAlpha);
+
+    other.m_backingStore.clear();
+    other.m_bytes = 0;
+    other.m_size = IntSize();
+}
+
 bool ImageFrame::setSize(int newWidth, int newHeight)
 {
     ASSERT(!width() && !height());
@@ -255,6 +270,16 @@ inline void fillScaledValues(Vector<int>& scaledValues, double scaleRate, int le
     }
 }
 
+// Picks exactly |count| evenly spread indices into |length| values.
+inline void fillScaledValuesForCount(Vector<int>& scaledValues, int count, int length)
+{
+    ASSERT(count <= length);
+    double inflateRate = static_cast<double>(length) / count;
+    scaledValues.reserveCapacity(count);
+    for (int scaledIndex = 0; scaledIndex < count; ++scaledIndex)
+        scaledValues.append(std::min(static_cast<int>(scaledIndex * inflateRate + 0.5), length - 1));
+}
+
 template <MatchType type> int getScaledValue(const Vector<int>& scaledValues, int valueToMatch, int searchStart)
 {
     if (scaledValues.isEmpty())
@@ -290,7 +315,7 @@ unsigned ImageDecoder::frameBytesAtIndex(size_t index) const
     if (m_frameBufferCache.size() <= index)
         return 0;
     // FIXME: Use the dimension of the requested frame.
-    return m_size.area() * sizeof(ImageFrame::PixelData);
+    return scaledSize().area() * sizeof(ImageFrame::PixelData);
 }
 
 void ImageDecoder::prepareScaleDataIfNecessary()
@@ -302,15 +327,34 @@ void ImageDecoder::prepareScaleDataIfNecessary()
     int width = size().width();
     int height = size().height();
     int numPixels = height * width;
-    if (m_maxNumPixels <= 0 || numPixels <= m_maxNumPixels)
+    double scale = 1;
+    if (m_maxNumPixels > 0 && numPixels > m_maxNumPixels)
+        scale = sqrt(m_maxNumPixels / (double)numPixels);
+
+    // Keep enough pixels to cover the maximum size along both axes, as the
+    // image may be stretched to a different aspect ratio when displayed.
+    if (!m_maxDecodedSize.isEmpty())
+        scale = std::min(scale, std::max(m_maxDecodedSize.width() / (double)width, m_maxDecodedSize.height() / (double)height));
+
+    if (scale >= 1)
         return;
 
     m_scaled = true;
-    double scale = sqrt(m_maxNumPixels / (double)numPixels);
     fillScaledValues(m_scaledColumns, scale, width);
     fillScaledValues(m_scaledRows, scale, height);
 }
 
+void ImageDecoder::prepareScaleDataForSourceSize(const IntSize& sourceSize)
+{
+    ASSERT(m_scaled);
+    IntSize targetSize = scaledSize();
+
+    m_scaledColumns.clear();
+    m_scaledRows.clear();
+    fillScaledValuesForCount(m_scaledColumns, targetSize.width(), sourceSize.width());
+    fillScaledValuesForCount(m_scaledRows, targetSize.height(), sourceSize.height());
+}
+
 int ImageDecoder::upperBoundScaledX(int origX, int searchStart)
 {
     return getScaledValue<UpperBound>(m_scaledColumns, origX, searchStart);
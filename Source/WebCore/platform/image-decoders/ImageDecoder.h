@@ -37,6 +37,7 @@
 #include <wtf/RefPtr.h>
 #include <wtf/Vector.h>
 #include <wtf/text/WTFString.h>
+#include <functional>
 
 #if USE(QCMSLIB)
 #include "qcms.h"
@@ -84,6 +85,10 @@ namespace WebCore {
         // the other.  Returns whether the copy succeeded.
         bool copyBitmapData(const ImageFrame&);
 
+        // Takes over the provided frame's pixel data without copying it.  The
+        // provided frame is left without pixel data.
+        void adoptBitmapData(ImageFrame&);
+
         // Copies the pixel data at [(startX, startY), (endX, startY)) to the
         // same X-coordinates on each subsequent row up to but not including
         // endY.
@@ -239,7 +244,8 @@ namespace WebCore {
     //
     // ENABLE(IMAGE_DECODER_DOWN_SAMPLING) allows image decoders to downsample
     // at decode time.  Image decoders will downsample any images larger than
-    // |m_maxNumPixels|.  FIXME: Not yet supported by all decoders.
+    // |m_maxNumPixels|, or larger than needed to cover |m_maxDecodedSize|.
+    // FIXME: Not yet supported by all decoders.
     class ImageDecoder {
         WTF_MAKE_NONCOPYABLE(ImageDecoder); WTF_MAKE_FAST_ALLOCATED;
     public:
@@ -397,20 +403,36 @@ namespace WebCore {
 
 #if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
         void setMaxNumPixels(int m) { m_maxNumPixels = m; }
+        // Must be called before the size is decoded; the scale is fixed then.
+        void setMaxDecodedSize(const IntSize& size) { m_maxDecodedSize = size; }
 #endif
 
         // If the image has a cursor hot-spot, stores it in the argument
         // and returns true. Otherwise returns false.
         virtual bool hotSpot(IntPoint&) const { return false; }
 
+        // Decoders that decode frames asynchronously invoke this callback on
+        // the main thread, with the frame index, once the frame is available.
+        void setFrameDecodedCallback(std::function<void (size_t)> callback) { m_frameDecodedCallback = WTFMove(callback); }
+
     protected:
         void prepareScaleDataIfNecessary();
+        // For decoders that shrink the image themselves while decoding (e.g.
+        // JPEG DCT scaling): maps rows and columns of |sourceSize|, the size
+        // the codec outputs, onto the already computed scaledSize().
+        void prepareScaleDataForSourceSize(const IntSize& sourceSize);
         int upperBoundScaledX(int origX, int searchStart = 0);
         int lowerBoundScaledX(int origX, int searchStart = 0);
         int upperBoundScaledY(int origY, int searchStart = 0);
         int lowerBoundScaledY(int origY, int searchStart = 0);
         int scaledY(int origY, int searchStart = 0);
 
+        void notifyFrameDecoded(size_t index)
+        {
+            if (m_frameDecodedCallback)
+                m_frameDecodedCallback(index);
+        }
+
         RefPtr<SharedBuffer> m_data; // The encoded data.
         Vector<ImageFrame, 1> m_frameBufferCache;
         // FIXME: Do we need m_colorProfile any more, for any port?
@@ -435,8 +457,10 @@ namespace WebCore {
         IntSize m_size;
         bool m_sizeAvailable;
         int m_maxNumPixels;
+        IntSize m_maxDecodedSize;
         bool m_isAllDataReceived;
         bool m_failed;
+        std::function<void (size_t)> m_frameDecodedCallback;
     };
 
 } // namespace WebCore
@@ -373,6 +373,23 @@ public:
             // be applied. Revert to using JSC_RGB in that case.
             if (m_decoder->willDownSample() && turboSwizzled(m_info.out_color_space))
                 m_info.out_color_space = JCS_RGB;
+#endif
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+            // Let libjpeg do as much of the down sampling as it can in the
+            // DCT, which is faster and smoother than sampling full scanlines.
+            // The output must stay at least as large as the scaled size.
+            if (m_decoder->willDownSample()) {
+                IntSize scaledSize = m_decoder->scaledSize();
+                m_info.scale_num = 1;
+                m_info.scale_denom = 1;
+                while (m_info.scale_denom < 8) {
+                    unsigned denominator = m_info.scale_denom * 2;
+                    if ((m_info.image_width + denominator - 1) / denominator < static_cast<unsigned>(scaledSize.width())
+                        || (m_info.image_height + denominator - 1) / denominator < static_cast<unsigned>(scaledSize.height()))
+                        break;
+                    m_info.scale_denom = denominator;
+                }
+            }
 #endif
             // Allow color management of the decoded RGBA pixels if possible.
             if (!m_decoder->ignoresGammaAndColorProfile()) {
@@ -395,6 +412,10 @@ public:
 
             // Used to set up image size so arrays can be allocated.
             jpeg_calc_output_dimensions(&m_info);
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+            if (m_decoder->willDownSample())
+                m_decoder->setDCTScaledSize(IntSize(m_info.output_width, m_info.output_height));
+#endif
 
             // Make a one-row-high sample array that will go away when done with
             // image. Always make it big enough to hold an RGB row. Since this
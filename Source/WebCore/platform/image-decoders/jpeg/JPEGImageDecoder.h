@@ -63,6 +63,12 @@ namespace WebCore {
             return m_scaled;
         }
 
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+        // Called once libjpeg has been asked to shrink the image in the DCT to
+        // |size|; the remaining down sampling is done on its scanlines.
+        void setDCTScaledSize(const IntSize& size) { prepareScaleDataForSourceSize(size); }
+#endif
+
         bool outputScanlines();
         void jpegComplete();
 
@@ -92,6 +92,15 @@ bool WEBPImageDecoder::isSizeAvailable()
     return ImageDecoder::isSizeAvailable();
 }
 
+bool WEBPImageDecoder::setSize(unsigned width, unsigned height)
+{
+    if (!ImageDecoder::setSize(width, height))
+        return false;
+
+    prepareScaleDataIfNecessary();
+    return true;
+}
+
 ImageFrame* WEBPImageDecoder::frameBufferAtIndex(size_t index)
 {
     if (index)
@@ -250,7 +259,7 @@ bool WEBPImageDecoder::decode(bool onlySize)
     ASSERT(buffer.status() != ImageFrame::FrameComplete);
 
     if (buffer.status() == ImageFrame::FrameEmpty) {
-        if (!buffer.setSize(size().width(), size().height()))
+        if (!buffer.setSize(scaledSize().width(), scaledSize().height()))
             return setFailed();
         buffer.setStatus(ImageFrame::FramePartial);
         buffer.setHasAlpha(m_hasAlpha);
@@ -263,9 +272,26 @@ bool WEBPImageDecoder::decode(bool onlySize)
             mode = outputMode(false);
         if ((m_formatFlags & ICCP_FLAG) && !ignoresGammaAndColorProfile())
             mode = MODE_RGBA; // Decode to RGBA for input to libqcms.
-        int rowStride = size().width() * sizeof(ImageFrame::PixelData);
+        int rowStride = scaledSize().width() * sizeof(ImageFrame::PixelData);
         uint8_t* output = reinterpret_cast<uint8_t*>(buffer.getAddr(0, 0));
-        int outputSize = size().height() * rowStride;
+        int outputSize = scaledSize().height() * rowStride;
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+        if (m_scaled) {
+            // libwebp resamples while decoding, which is smoother than
+            // sampling rows and columns of the full size image.
+            if (!WebPInitDecoderConfig(&m_decoderConfig))
+                return setFailed();
+            m_decoderConfig.output.colorspace = mode;
+            m_decoderConfig.output.is_external_memory = 1;
+            m_decoderConfig.output.u.RGBA.rgba = output;
+            m_decoderConfig.output.u.RGBA.stride = rowStride;
+            m_decoderConfig.output.u.RGBA.size = outputSize;
+            m_decoderConfig.options.use_scaling = 1;
+            m_decoderConfig.options.scaled_width = scaledSize().width();
+            m_decoderConfig.options.scaled_height = scaledSize().height();
+            m_decoder = WebPIDecode(0, 0, &m_decoderConfig);
+        } else
+#endif
         m_decoder = WebPINewRGB(mode, output, outputSize, rowStride);
         if (!m_decoder)
             return setFailed();
@@ -47,6 +47,7 @@ public:
 
     virtual String filenameExtension() const { return "webp"; }
     virtual bool isSizeAvailable();
+    virtual bool setSize(unsigned width, unsigned height);
     virtual ImageFrame* frameBufferAtIndex(size_t index);
 
 private:
@@ -55,6 +56,10 @@ private:
     WebPIDecoder* m_decoder;
     bool m_hasAlpha;
     int m_formatFlags;
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+    // Must outlive |m_decoder|, which keeps pointers into it.
+    WebPDecoderConfig m_decoderConfig;
+#endif
 
 #ifdef QCMS_WEBP_COLOR_CORRECTION
     qcms_transform* colorTransform() const { return m_transform; }
@@ -193,9 +193,18 @@ void MemoryPressureHandler::respondToMemoryPressure(Critical critical, Synchrono
 {
     uninstall();
 
+    // Not every low memory handler goes through releaseMemory(), so the statistics are taken here as well.
+    m_fastMallocStatisticsBeforeLastRelief = WTF::fastMallocStatistics();
     double startTime = monotonicallyIncreasingTime();
     m_lowMemoryHandler(critical, synchronous);
     unsigned holdOffTime = (monotonicallyIncreasingTime() - startTime) * s_holdOffMultiplier;
+    m_fastMallocStatisticsAfterLastRelief = WTF::fastMallocStatistics();
+
+    // When relief gave no FastMalloc memory back, the heap holds live objects, and responding again soon won't help.
+    // Without bmalloc nothing is reserved, and the committed size is the peak RSS, which never goes down.
+    if (m_fastMallocStatisticsAfterLastRelief.reservedVMBytes
+        && m_fastMallocStatisticsAfterLastRelief.committedVMBytes >= m_fastMallocStatisticsBeforeLastRelief.committedVMBytes)
+        holdOffTime *= 2;
     holdOff(std::max(holdOffTime, s_minimumHoldOffTime));
 }
 
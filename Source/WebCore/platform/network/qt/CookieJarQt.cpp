@@ -42,8 +42,10 @@
 #include <QNetworkCookie>
 #include <QStringList>
 #include <QVariant>
+#include <limits>
 #include <wtf/text/StringBuilder.h>
 #include <wtf/text/WTFString.h>
+#include <wtf/threads/BinarySemaphore.h>
 
 namespace WebCore {
 
@@ -191,9 +193,8 @@ void SharedCookieJarQt::destroy()
 
 void SharedCookieJarQt::getHostnamesWithCookies(HashSet<String>& hostnames)
 {
-    QList<QNetworkCookie> cookies = allCookies();
-    foreach (const QNetworkCookie& networkCookie, cookies)
-        hostnames.add(networkCookie.domain());
+    for (auto& domain : m_domainIndex)
+        hostnames.add(domain.key);
 }
 
 bool SharedCookieJarQt::deleteCookie(const QNetworkCookie& cookie)
@@ -201,71 +202,48 @@ bool SharedCookieJarQt::deleteCookie(const QNetworkCookie& cookie)
     if (!QNetworkCookieJar::deleteCookie(cookie))
         return false;
 
-    if (!m_database.isOpen())
-        return false;
-
-    SQLiteStatement sqlQuery(m_database, ASCIILiteral("DELETE FROM cookies WHERE cookieId=?"));
-    if (sqlQuery.prepare() != SQLITE_OK) {
-        qWarning("Failed to prepare delete statement - cannot write to cookie database");
-        return false;
-    }
-
-    sqlQuery.bindText(1, cookie.domain().append(QLatin1String(cookie.name())));
-    int result = sqlQuery.step();
-    if (result != SQLITE_DONE) {
-        qWarning("Failed to delete cookie from database - %i", result);
-        return false;
-    }
+    m_domainIndex.remove(cookie.domain());
+    scheduleDatabaseDelete(cookie);
     return true;
 }
 
 void SharedCookieJarQt::deleteCookiesForHostnames(const Vector<WTF::String>& hostNames)
 {
-    // QTFIXME: Implement as one statement or transaction
-    for (auto& hostname : hostNames)
-        deleteCookiesForHostname(hostname);
-}
-
-void SharedCookieJarQt::deleteCookiesForHostname(const String& hostname)
-{
-    if (!m_database.isOpen())
+    HashSet<String> hostnamesWithCookies;
+    for (auto& hostname : hostNames) {
+        if (m_domainIndex.contains(hostname))
+            hostnamesWithCookies.add(hostname);
+    }
+    if (hostnamesWithCookies.isEmpty())
         return;
 
     QList<QNetworkCookie> cookies = allCookies();
     QList<QNetworkCookie>::Iterator it = cookies.begin();
-    QList<QNetworkCookie>::Iterator end = cookies.end();
-    SQLiteStatement sqlQuery(m_database, ASCIILiteral("DELETE FROM cookies WHERE cookieId=?"));
-    if (sqlQuery.prepare() != SQLITE_OK) {
-        qWarning("Failed to prepare delete statement - cannot write to cookie database");
-        return;
-    }
-
-    SQLiteTransaction transaction(m_database);
-    transaction.begin();
-    while (it != end) {
-        if (it->domain() == QString(hostname)) {
-            sqlQuery.bindText(1, it->domain().append(QLatin1String(it->name())));
-            int result = sqlQuery.step();
-            if (result != SQLITE_DONE)
-                qWarning("Failed to remove cookie from database - %i", result);
-            sqlQuery.reset();
+    while (it != cookies.end()) {
+        if (hostnamesWithCookies.contains(it->domain())) {
+            scheduleDatabaseDelete(*it);
             it = cookies.erase(it);
         } else
             it++;
     }
-    transaction.commit();
 
+    for (auto& hostname : hostnamesWithCookies)
+        m_domainIndex.removeAll(hostname);
     setAllCookies(cookies);
 }
 
 void SharedCookieJarQt::deleteAllCookies()
 {
+    setAllCookies(QList<QNetworkCookie>());
+    m_domainIndex.clear();
+
     if (!m_database.isOpen())
         return;
 
-    if (!m_database.executeCommand(ASCIILiteral("DELETE FROM cookies")))
-        qWarning("Failed to clear cookies database");
-    setAllCookies(QList<QNetworkCookie>());
+    m_pendingWrites.clear();
+    m_pendingDeletes.clear();
+    m_pendingDeleteAll = true;
+    scheduleCommit();
 }
 
 void SharedCookieJarQt::deleteAllCookiesModifiedSince(std::chrono::system_clock::time_point)
@@ -275,6 +253,8 @@ void SharedCookieJarQt::deleteAllCookiesModifiedSince(std::chrono::system_clock:
 }
 
 SharedCookieJarQt::SharedCookieJarQt(const String& cookieStorageDirectory)
+    : m_databaseQueue(WorkQueue::create("org.webkit.CookieJarQt"))
+    , m_commitTimer(*this, &SharedCookieJarQt::commitPendingChanges)
 {
     if (!m_database.open(cookieStorageDirectory + ASCIILiteral("/cookies.db"))) {
         qWarning("Can't open cookie database");
@@ -283,6 +263,8 @@ SharedCookieJarQt::SharedCookieJarQt(const String& cookieStorageDirectory)
 
     m_database.setSynchronous(SQLiteDatabase::SyncOff);
     m_database.executeCommand(ASCIILiteral("PRAGMA secure_delete = 1;"));
+    // Changes are committed on m_databaseQueue, which only runs while the main thread does not touch the database.
+    m_database.disableThreadingChecks();
 
     if (ensureDatabaseTable())
         loadCookies();
@@ -292,37 +274,127 @@ SharedCookieJarQt::SharedCookieJarQt(const String& cookieStorageDirectory)
 
 SharedCookieJarQt::~SharedCookieJarQt()
 {
+    commitPendingChanges();
+    waitForPendingCommits();
     m_database.close();
 }
 
-bool SharedCookieJarQt::setCookiesFromUrl(const QList<QNetworkCookie>& cookieList, const QUrl& url)
+bool SharedCookieJarQt::insertCookie(const QNetworkCookie& cookie)
 {
-    if (!QNetworkCookieJar::setCookiesFromUrl(cookieList, url))
+    // QNetworkCookieJar::insertCookie() calls deleteCookie() for any cookie it replaces.
+    if (!QNetworkCookieJar::insertCookie(cookie))
         return false;
 
+    m_domainIndex.add(cookie.domain());
+    if (!cookie.isSessionCookie())
+        scheduleDatabaseWrite(cookie);
+    return true;
+}
+
+static QString cookieId(const QNetworkCookie& cookie)
+{
+    return cookie.domain().append(QLatin1String(cookie.name()));
+}
+
+void SharedCookieJarQt::scheduleDatabaseWrite(const QNetworkCookie& cookie)
+{
     if (!m_database.isOpen())
-        return false;
+        return;
 
-    SQLiteStatement sqlQuery(m_database, ASCIILiteral("INSERT OR REPLACE INTO cookies (cookieId, cookie) VALUES (?, ?)"));
-    if (sqlQuery.prepare() != SQLITE_OK)
-        return false;
+    QString id = cookieId(cookie);
+    m_pendingDeletes.remove(id);
+    m_pendingWrites.insert(id, cookie.toRawForm());
+    scheduleCommit();
+}
 
-    SQLiteTransaction transaction(m_database);
-    transaction.begin();
-    foreach (const QNetworkCookie &cookie, cookiesForUrl(url)) {
-        if (cookie.isSessionCookie())
-            continue;
-        sqlQuery.bindText(1, cookie.domain().append(QLatin1String(cookie.name())));
-        QByteArray rawCookie = cookie.toRawForm();
-        sqlQuery.bindBlob(2, rawCookie.constData(), rawCookie.size());
-        int result = sqlQuery.step();
-        if (result != SQLITE_DONE)
-            qWarning("Failed to insert cookie into database - %i", result);
-        sqlQuery.reset();
-    }
-    transaction.commit();
+void SharedCookieJarQt::scheduleDatabaseDelete(const QNetworkCookie& cookie)
+{
+    if (!m_database.isOpen())
+        return;
 
-    return true;
+    QString id = cookieId(cookie);
+    m_pendingWrites.remove(id);
+    m_pendingDeletes.insert(id);
+    scheduleCommit();
+}
+
+void SharedCookieJarQt::scheduleCommit()
+{
+    // Pages tend to set many cookies while loading, so collect them into a single transaction.
+    static const double commitDelay = 1;
+    if (!m_commitTimer.isActive())
+        m_commitTimer.startOneShot(commitDelay);
+}
+
+void SharedCookieJarQt::commitPendingChanges()
+{
+    m_commitTimer.stop();
+    if (!m_pendingDeleteAll && m_pendingWrites.isEmpty() && m_pendingDeletes.isEmpty())
+        return;
+
+    bool deleteAll = m_pendingDeleteAll;
+    QHash<QString, QByteArray> writes;
+    QSet<QString> deletes;
+    writes.swap(m_pendingWrites);
+    deletes.swap(m_pendingDeletes);
+    m_pendingDeleteAll = false;
+
+    m_databaseQueue->dispatch([this, deleteAll, writes, deletes] {
+        SQLiteTransaction transaction(m_database);
+        transaction.begin();
+
+        if (deleteAll && !m_database.executeCommand(ASCIILiteral("DELETE FROM cookies")))
+            qWarning("Failed to clear cookies database");
+
+        if (!deletes.isEmpty()) {
+            SQLiteStatement deleteQuery(m_database, ASCIILiteral("DELETE FROM cookies WHERE cookieId=?"));
+            if (deleteQuery.prepare() != SQLITE_OK)
+                qWarning("Failed to prepare delete statement - cannot write to cookie database");
+            else {
+                foreach (const QString& id, deletes) {
+                    deleteQuery.bindText(1, id);
+                    int result = deleteQuery.step();
+                    if (result != SQLITE_DONE)
+                        qWarning("Failed to delete cookie from database - %i", result);
+                    deleteQuery.reset();
+                }
+            }
+        }
+
+        if (!writes.isEmpty()) {
+            SQLiteStatement insertQuery(m_database, ASCIILiteral("INSERT OR REPLACE INTO cookies (cookieId, cookie) VALUES (?, ?)"));
+            if (insertQuery.prepare() != SQLITE_OK)
+                qWarning("Failed to prepare insert statement - cannot write to cookie database");
+            else {
+                for (QHash<QString, QByteArray>::const_iterator it = writes.constBegin(); it != writes.constEnd(); ++it) {
+                    insertQuery.bindText(1, it.key());
+                    insertQuery.bindBlob(2, it.value().constData(), it.value().size());
+                    int result = insertQuery.step();
+                    if (result != SQLITE_DONE)
+                        qWarning("Failed to insert cookie into database - %i", result);
+                    insertQuery.reset();
+                }
+            }
+        }
+
+        transaction.commit();
+    });
+}
+
+void SharedCookieJarQt::waitForPendingCommits()
+{
+    BinarySemaphore semaphore;
+    m_databaseQueue->dispatch([&semaphore] {
+        semaphore.signal();
+    });
+    semaphore.wait(std::numeric_limits<double>::max());
+}
+
+void SharedCookieJarQt::rebuildDomainIndex()
+{
+    m_domainIndex.clear();
+    foreach (const QNetworkCookie& cookie, allCookies())
+        m_domainIndex.add(cookie.domain());
 }
 
 bool SharedCookieJarQt::ensureDatabaseTable()
@@ -339,6 +411,9 @@ void SharedCookieJarQt::loadCookies()
     if (!m_database.isOpen())
         return;
 
+    commitPendingChanges();
+    waitForPendingCommits();
+
     QList<QNetworkCookie> cookies;
     SQLiteStatement sqlQuery(m_database, ASCIILiteral("SELECT cookie FROM cookies"));
     if (sqlQuery.prepare() != SQLITE_OK)
@@ -358,6 +433,7 @@ void SharedCookieJarQt::loadCookies()
     }
 
     setAllCookies(cookies);
+    rebuildDomainIndex();
 }
 
 #include "moc_CookieJarQt.cpp"
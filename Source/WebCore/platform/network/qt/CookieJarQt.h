@@ -22,11 +22,16 @@
 #define CookieJarQt_h
 
 #include "SQLiteDatabase.h"
+#include "Timer.h"
 
+#include <QtCore/QHash>
 #include <QtCore/QObject>
+#include <QtCore/QSet>
 #include <QtNetwork/QNetworkCookieJar>
 
+#include <wtf/HashCountedSet.h>
 #include <wtf/HashSet.h>
+#include <wtf/WorkQueue.h>
 #include <wtf/text/WTFString.h>
 
 namespace WebCore {
@@ -43,16 +48,35 @@ public:
     void deleteCookiesForHostnames(const Vector<String>&);
     void deleteAllCookies();
     void deleteAllCookiesModifiedSince(std::chrono::system_clock::time_point);
-    bool setCookiesFromUrl(const QList<QNetworkCookie>&, const QUrl&) final;
     void loadCookies();
 
+protected:
+    bool insertCookie(const QNetworkCookie&) final;
+
 private:
     SharedCookieJarQt(const String&);
     ~SharedCookieJarQt();
     bool ensureDatabaseTable();
-    void deleteCookiesForHostname(const String&);
+    void rebuildDomainIndex();
+
+    void scheduleDatabaseWrite(const QNetworkCookie&);
+    void scheduleDatabaseDelete(const QNetworkCookie&);
+    void scheduleCommit();
+    void commitPendingChanges();
+    void waitForPendingCommits();
 
+    // Only used on m_databaseQueue once the cookies have been loaded.
     SQLiteDatabase m_database;
+    Ref<WorkQueue> m_databaseQueue;
+
+    // Number of cookies held in memory for each domain.
+    HashCountedSet<String> m_domainIndex;
+
+    // Changes that have not been handed to m_databaseQueue yet, keyed by cookie id.
+    QHash<QString, QByteArray> m_pendingWrites;
+    QSet<QString> m_pendingDeletes;
+    bool m_pendingDeleteAll { false };
+    Timer m_commitTimer;
 };
 
 }
@@ -708,29 +708,17 @@ void QNetworkReplyHandler::forwardData()
     // and https://bugs.webkit.org/show_bug.cgi?id=118448#c32
     // NetworkResourceLoader implements only didReceiveBuffer and sends it over IPC to WebProcess
 
-    // See also https://codereview.qt-project.org/#/c/79565/
-    //
-    // FIXME: We need API to get unflattened array of data segments to convert it to non-contiguous SharedBuffer
-
-    qint64 bytesAvailable = m_replyWrapper->reply()->bytesAvailable();
-    Vector<char> buffer(8128); // smaller than 8192 to fit within 8k including overhead.
-    while (bytesAvailable > 0 && !m_queue.deferSignals()) {
-        qint64 readSize = m_replyWrapper->reply()->read(buffer.data(), buffer.size());
-        if (readSize <= 0)
-            break;
-        buffer.shrink(readSize);
-        bytesAvailable -= readSize;
-
-        // FIXME: https://bugs.webkit.org/show_bug.cgi?id=19793
-        // -1 means we do not provide any data about transfer size to inspector so it would use
-        // Content-Length headers or content size to show transfer size.
-        client->didReceiveBuffer(m_resourceHandle, SharedBuffer::adoptVector(buffer), -1);
-        // Check if the request has been aborted or this reply-handler was otherwise released.
-        if (wasAborted() || !m_replyWrapper)
-            break;
-    }
-    if (bytesAvailable > 0 && m_replyWrapper)
-        m_queue.requeue(&QNetworkReplyHandler::forwardData);
+    // Forward everything that is available in one buffer. The byte array returned by the
+    // reply is wrapped rather than copied, and the loader appends it to the resource data
+    // as a separate segment.
+    QByteArray data = m_replyWrapper->reply()->readAll();
+    if (data.isEmpty())
+        return;
+
+    // FIXME: https://bugs.webkit.org/show_bug.cgi?id=19793
+    // -1 means we do not provide any data about transfer size to inspector so it would use
+    // Content-Length headers or content size to show transfer size.
+    client->didReceiveBuffer(m_resourceHandle, SharedBuffer::wrapQByteArray(data), -1);
 }
 
 void QNetworkReplyHandler::uploadProgress(qint64 bytesSent, qint64 bytesTotal)
@@ -33,6 +33,7 @@
 #include "CSSValueKeywords.h"
 #include "ChromeClient.h"
 #include "Color.h"
+#include "DisplayListRecorder.h"
 #include "ExceptionCodePlaceholder.h"
 #include "FileList.h"
 #include "GraphicsContext.h"
@@ -902,6 +903,10 @@ void RenderThemeQt::updateCachedSystemFontDescription(CSSValueID, FontCascadeDes
 StylePainter::StylePainter(GraphicsContext& context)
     : painter(context.platformContext())
 {
+    // Styles paint straight to the QPainter, which a recording context doesn't have.
+    if (context.isRecording())
+        context.displayListRecorder()->setHasUnrecordedContent();
+
     if (painter) {
         // the styles often assume being called with a pristine painter where no brush is set,
         // so reset it manually
@@ -44,4 +44,78 @@ RefPtr<SharedBuffer> SharedBuffer::createFromReadingFile(const String& fileName)
     return SharedBuffer::adoptVector(buffer);
 }
 
+PassRefPtr<SharedBuffer> SharedBuffer::wrapQByteArray(const QByteArray& byteArray)
+{
+    return adoptRef(new SharedBuffer(byteArray));
+}
+
+SharedBuffer::SharedBuffer(const QByteArray& byteArray)
+    : m_buffer(adoptRef(new DataBuffer))
+{
+    append(byteArray);
+}
+
+void SharedBuffer::append(const QByteArray& byteArray)
+{
+    if (byteArray.isEmpty())
+        return;
+
+    maybeTransferMappedFileData();
+    maybeTransferPlatformData();
+
+    m_byteArrays.append(byteArray);
+    m_byteArraysSize += byteArray.size();
+    m_size += byteArray.size();
+}
+
+void SharedBuffer::maybeTransferByteArrays()
+{
+    if (m_byteArrays.isEmpty())
+        return;
+
+    // Data appended after the byte arrays has to go behind them, so copy them into segments first.
+    Vector<QByteArray> byteArrays = WTFMove(m_byteArrays);
+    m_size -= m_byteArraysSize;
+    m_byteArraysSize = 0;
+    for (auto& byteArray : byteArrays)
+        append(byteArray.constData(), byteArray.size());
+}
+
+bool SharedBuffer::maybeAppendByteArrays(SharedBuffer* data)
+{
+    if (data->m_byteArrays.isEmpty() || data->m_buffer->data.size() || !data->m_segments.isEmpty() || data->m_fileData || data->hasPlatformData())
+        return false;
+
+    // Copy the list first, since the buffer might be appended to itself.
+    Vector<QByteArray> byteArrays = data->m_byteArrays;
+    for (auto& byteArray : byteArrays)
+        append(byteArray);
+    return true;
+}
+
+unsigned SharedBuffer::copySomeDataFromByteArrays(const char*& someData, unsigned position) const
+{
+    unsigned totalOffset = 0;
+    for (auto& byteArray : m_byteArrays) {
+        unsigned byteArrayLength = byteArray.size();
+        ASSERT(totalOffset <= position);
+        unsigned localOffset = position - totalOffset;
+        if (localOffset < byteArrayLength) {
+            someData = byteArray.constData() + localOffset;
+            return byteArrayLength - localOffset;
+        }
+        totalOffset += byteArrayLength;
+    }
+    ASSERT_NOT_REACHED();
+    return 0;
+}
+
+const char* SharedBuffer::singleByteArrayBuffer() const
+{
+    if (m_buffer->data.size() || !m_segments.isEmpty() || m_byteArrays.size() != 1)
+        return 0;
+
+    return m_byteArrays.at(0).constData();
+}
+
 } // namespace WebCore
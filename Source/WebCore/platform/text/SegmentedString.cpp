@@ -335,6 +335,37 @@ void SegmentedString::advanceAndUpdateLineNumberSlowCase()
     m_currentChar = m_currentString.m_length ? m_currentString.getCurrentChar() : 0;
 }
 
+void SegmentedString::advance(unsigned count)
+{
+    // There are at most two pushed characters.
+    for (; count && m_pushedChar1; --count)
+        advance();
+
+    while (count) {
+        unsigned length = m_currentString.m_length;
+        if (!length) {
+            ASSERT_NOT_REACHED();
+            return;
+        }
+
+        if (count < length) {
+            m_currentString.m_length -= count;
+            if (m_currentString.is8Bit())
+                m_currentString.m_data.string8Ptr += count;
+            else
+                m_currentString.m_data.string16Ptr += count;
+            m_currentChar = m_currentString.getCurrentChar();
+            updateAdvanceFunctionPointers();
+            return;
+        }
+
+        count -= length;
+        m_currentString.m_length = 0;
+        advanceSubstring();
+        m_currentChar = m_currentString.m_length ? m_currentString.getCurrentChar() : 0;
+    }
+}
+
 void SegmentedString::advanceEmpty()
 {
     ASSERT(!m_currentString.m_length && !isComposite());
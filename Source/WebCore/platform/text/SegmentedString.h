@@ -56,7 +56,7 @@ public:
 
     void clear() { m_length = 0; m_data.string16Ptr = 0; m_is8Bit = false;}
     
-    bool is8Bit() { return m_is8Bit; }
+    bool is8Bit() const { return m_is8Bit; }
     
     bool excludeLineNumbers() const { return !m_doNotExcludeLineNumbers; }
     bool doNotExcludeLineNumbers() const { return m_doNotExcludeLineNumbers; }
@@ -280,6 +280,21 @@ public:
 
     UChar currentChar() const { return m_currentChar; }    
 
+    // The characters of the current substring, starting with the current character, for scanning ahead of it.
+    // There are none while characters are pushed back.
+    unsigned lengthOfCurrentSubstring() const { return m_pushedChar1 ? 0 : m_currentString.m_length; }
+    bool currentSubstringIs8Bit() const { return m_currentString.is8Bit(); }
+    const LChar* currentSubstringCharacters8() const { return m_currentString.m_data.string8Ptr; }
+    const UChar* currentSubstringCharacters16() const { return m_currentString.m_data.string16Ptr; }
+
+    // Advances past the given number of characters of the current substring at once. None of them may be a
+    // newline, and the last character of the substring must be left for advance() to move on to the next one.
+    void advancePastNonNewlinesInCurrentSubstring(unsigned count);
+
+    // Same as calling advance() |count| times, but skips whole substrings at once. Like advance(), this
+    // doesn't update the line number, so callers that skip newlines should call setCurrentPosition().
+    void advance(unsigned count);
+
     OrdinalNumber currentColumn() const;
     OrdinalNumber currentLine() const;
 
@@ -377,6 +392,24 @@ inline void SegmentedString::advancePastNonNewlines(unsigned count)
         advancePastNonNewline();
 }
 
+inline void SegmentedString::advancePastNonNewlinesInCurrentSubstring(unsigned count)
+{
+    ASSERT(!m_pushedChar1);
+    ASSERT(count < static_cast<unsigned>(m_currentString.m_length));
+    if (!count)
+        return;
+
+    m_currentString.m_length -= count;
+    if (m_currentString.is8Bit())
+        m_currentString.m_data.string8Ptr += count;
+    else
+        m_currentString.m_data.string16Ptr += count;
+    m_currentChar = m_currentString.getCurrentChar();
+
+    if (m_currentString.m_length == 1)
+        updateSlowCaseFunctionPointers();
+}
+
 inline SegmentedString::AdvancePastResult SegmentedString::advancePast(const char* literal, unsigned length, bool caseSensitive)
 {
     ASSERT(strlen(literal) == length);
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "OverlapMapContainer.h"
+
+namespace WebCore {
+
+// Composited layers are typically a few hundred pixels wide.
+static const int cellSize = 256;
+
+// A rect is added to at most this many cells, bigger ones go to the list of large rects.
+static const unsigned maximumCellsPerRect = 64;
+
+static inline int cellCoordinate(int coordinate)
+{
+    // Round towards negative infinity so that the cells on both sides of zero have the same size.
+    return coordinate >= 0 ? coordinate / cellSize : -((-coordinate - 1) / cellSize) - 1;
+}
+
+unsigned OverlapMapContainer::CellRange::cellCount() const
+{
+    uint64_t width = static_cast<int64_t>(maxCell.x()) - minCell.x() + 1;
+    uint64_t height = static_cast<int64_t>(maxCell.y()) - minCell.y() + 1;
+    return std::min<uint64_t>(width * height, std::numeric_limits<unsigned>::max());
+}
+
+auto OverlapMapContainer::cellRangeForRect(const LayoutRect& rect) -> CellRange
+{
+    // The enclosing rect can't be empty either, so it has a first and a last pixel on each axis.
+    ASSERT(!rect.isEmpty());
+    IntRect enclosingRect = enclosingIntRect(rect);
+    return { IntPoint(cellCoordinate(enclosingRect.x()), cellCoordinate(enclosingRect.y())),
+        IntPoint(cellCoordinate(enclosingRect.maxX() - 1), cellCoordinate(enclosingRect.maxY() - 1)) };
+}
+
+void OverlapMapContainer::addToGrid(unsigned rectIndex)
+{
+    CellRange range = cellRangeForRect(m_layerRects[rectIndex]);
+    if (range.cellCount() > maximumCellsPerRect) {
+        m_largeRectIndices.append(rectIndex);
+        return;
+    }
+    for (int y = range.minCell.y(); y <= range.maxCell.y(); ++y) {
+        for (int x = range.minCell.x(); x <= range.maxCell.x(); ++x)
+            m_cells.add(IntPoint(x, y), Vector<unsigned>()).iterator->value.append(rectIndex);
+    }
+}
+
+void OverlapMapContainer::add(const LayoutRect& bounds)
+{
+    m_boundingBox.unite(bounds);
+    // Empty rects don't intersect anything.
+    if (bounds.isEmpty())
+        return;
+    m_layerRects.append(bounds);
+    addToGrid(m_layerRects.size() - 1);
+}
+
+bool OverlapMapContainer::overlapsLayers(const LayoutRect& bounds) const
+{
+    // Checking with the bounding box will quickly reject cases when
+    // layers are created for lists of items going in one direction and
+    // never overlap with each other.
+    if (!bounds.intersects(m_boundingBox))
+        return false;
+
+    for (unsigned rectIndex : m_largeRectIndices) {
+        if (m_layerRects[rectIndex].intersects(bounds))
+            return true;
+    }
+
+    CellRange range = cellRangeForRect(bounds);
+    if (range.cellCount() > m_layerRects.size()) {
+        // Looking at every rect is cheaper than looking at every cell.
+        for (const auto& layerRect : m_layerRects) {
+            if (layerRect.intersects(bounds))
+                return true;
+        }
+        return false;
+    }
+
+    for (int y = range.minCell.y(); y <= range.maxCell.y(); ++y) {
+        for (int x = range.minCell.x(); x <= range.maxCell.x(); ++x) {
+            auto it = m_cells.find(IntPoint(x, y));
+            if (it == m_cells.end())
+                continue;
+            for (unsigned rectIndex : it->value) {
+                if (m_layerRects[rectIndex].intersects(bounds))
+                    return true;
+            }
+        }
+    }
+    return false;
+}
+
+void OverlapMapContainer::unite(OverlapMapContainer&& otherContainer)
+{
+    // Always move the smaller container into the bigger one, so that a rect is re-bucketed
+    // a logarithmic number of times as it travels down the overlap stack.
+    if (m_layerRects.size() < otherContainer.m_layerRects.size())
+        std::swap(*this, otherContainer);
+
+    m_boundingBox.unite(otherContainer.m_boundingBox);
+    for (const auto& layerRect : otherContainer.m_layerRects) {
+        m_layerRects.append(layerRect);
+        addToGrid(m_layerRects.size() - 1);
+    }
+
+    otherContainer = OverlapMapContainer();
+}
+
+} // namespace WebCore
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OverlapMapContainer_h
+#define OverlapMapContainer_h
+
+#include "IntPointHash.h"
+#include "LayoutRect.h"
+#include <wtf/HashMap.h>
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+// The bounds of the composited layers of one level of RenderLayerCompositor's overlap stack.
+// The rects are bucketed in a uniform grid, so that testing a layer for overlap only looks at
+// the rects near it instead of at all the layers painted before it.
+class OverlapMapContainer {
+public:
+    WEBCORE_EXPORT void add(const LayoutRect&);
+    WEBCORE_EXPORT bool overlapsLayers(const LayoutRect&) const;
+
+    // Takes the rects of the other container, which is left empty.
+    WEBCORE_EXPORT void unite(OverlapMapContainer&&);
+
+    bool isEmpty() const { return m_layerRects.isEmpty(); }
+
+private:
+    struct CellRange {
+        IntPoint minCell;
+        IntPoint maxCell;
+        unsigned cellCount() const;
+    };
+    static CellRange cellRangeForRect(const LayoutRect&);
+
+    void addToGrid(unsigned rectIndex);
+
+    Vector<LayoutRect> m_layerRects;
+    HashMap<IntPoint, Vector<unsigned>> m_cells;
+    // Rects that span too many cells to be worth bucketing are tested one by one.
+    Vector<unsigned> m_largeRectIndices;
+    LayoutRect m_boundingBox;
+};
+
+} // namespace WebCore
+
+#endif // OverlapMapContainer_h
@@ -434,6 +434,11 @@ void RenderImage::paintReplaced(PaintInfo& paintInfo, const LayoutPoint& paintOf
         if (clip)
             context.clip(contentBoxRect);
 
+        // Large images may finish decoding in the background; they are repainted once
+        // done. Printing and flattened snapshots need the pixels right away.
+        bool allowsAsynchronousDecoding = frame().settings().asynchronousImageDecodingEnabled()
+            && !document().printing() && !(paintInfo.paintBehavior & PaintBehaviorFlattenCompositingLayers);
+        AsynchronousImageDecodingScope decodingScope(allowsAsynchronousDecoding);
         paintIntoRect(context, snapRectToDevicePixels(replacedContentRect, deviceScaleFactor));
         
         if (cachedImage() && page && paintInfo.phase == PaintPhaseForeground) {
@@ -637,10 +642,35 @@ void RenderImage::layout()
 
     updateInnerContentRect();
 
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+    updateDisplayedSizeForDecoding();
+#endif
+
     if (m_hasShadowControls)
         layoutShadowControls(oldSize);
 }
 
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+void RenderImage::updateDisplayedSizeForDecoding()
+{
+    CachedImage* cachedImage = imageResource().cachedImage();
+    if (!cachedImage)
+        return;
+
+    // This runs at layout rather than paint time, since a new size can make the image drop its decoded
+    // frames. Transforms that change without a layout are only seen at the next one, so err on the large
+    // side and apply the page scale on top of the absolute quad.
+    FloatRect contentRect = replacedContentRect(intrinsicSize());
+    FloatSize displayedSize = localToAbsoluteQuad(FloatQuad(contentRect)).boundingBox().size();
+    float scale = document().deviceScaleFactor();
+    if (Page* page = frame().page())
+        scale *= page->pageScaleFactor();
+    displayedSize.scale(scale);
+
+    cachedImage->updateDisplayedSize(*this, expandedIntSize(displayedSize));
+}
+#endif
+
 void RenderImage::layoutShadowControls(const LayoutSize& oldSize)
 {
     auto* controlsRenderer = downcast<RenderBox>(firstChild());
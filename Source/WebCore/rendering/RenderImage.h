@@ -121,6 +121,10 @@ private:
     
     void layoutShadowControls(const LayoutSize& oldSize);
 
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+    void updateDisplayedSizeForDecoding();
+#endif
+
     // Text to display as long as the image isn't available.
     String m_altText;
     std::unique_ptr<RenderImageResource> m_imageResource;
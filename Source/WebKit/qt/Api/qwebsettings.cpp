@@ -313,6 +313,14 @@ void QWebSettingsPrivate::apply()
         value = attributes.value(QWebSettings::ImagesEnabled, global->attributes.value(QWebSettings::ImagesEnabled));
         settings->setImagesEnabled(value);
 
+        value = attributes.value(QWebSettings::DeferredCSSParserEnabled,
+                                      global->attributes.value(QWebSettings::DeferredCSSParserEnabled));
+        settings->setDeferredCSSParserEnabled(value);
+
+        value = attributes.value(QWebSettings::ThreadedHTMLParserEnabled,
+                                      global->attributes.value(QWebSettings::ThreadedHTMLParserEnabled));
+        settings->setThreadedHTMLParserEnabled(value);
+
         settings->setUsesPageCache(WebCore::PageCache::singleton().maxSize());
     } else {
         QList<QWebSettingsPrivate*> settings = *::allSettings();
@@ -538,6 +546,13 @@ QWebSettings* QWebSettings::globalSettings()
         It is enabled by default.
     \value HyperlinkAuditingEnabled This setting enables support for hyperlink auditing (<a ping>).
         It is disabled by default.
+    \value DeferredCSSParserEnabled Specifies whether the declaration blocks of style sheet rules are only
+        parsed once the rule matches an element. Syntax errors in such blocks are not reported to the console.
+        It is disabled by default.
+    \value ThreadedHTMLParserEnabled Specifies whether HTML documents are tokenized on a background thread,
+        ahead of the construction of the document tree. This has no effect while XSSAuditingEnabled is set,
+        as the XSS auditor needs the source text of every token, which only the main thread tokenizer keeps.
+        It is disabled by default.
 */
 
 /*!
@@ -600,6 +615,8 @@ QWebSettings::QWebSettings()
     d->attributes.insert(QWebSettings::FullScreenSupportEnabled, true);
     d->attributes.insert(QWebSettings::ImagesEnabled, true);
     d->attributes.insert(QWebSettings::AllowRunningInsecureContent, false);
+    d->attributes.insert(QWebSettings::DeferredCSSParserEnabled, false);
+    d->attributes.insert(QWebSettings::ThreadedHTMLParserEnabled, false);
     d->offlineStorageDefaultQuota = 5 * 1024 * 1024;
     d->defaultTextEncoding = QLatin1String("iso-8859-1");
     d->thirdPartyCookiePolicy = AlwaysAllowThirdPartyCookies;
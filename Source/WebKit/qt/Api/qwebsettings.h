@@ -92,7 +92,9 @@ public:
         WebSecurityEnabled,
         FullScreenSupportEnabled,
         ImagesEnabled,
-        AllowRunningInsecureContent
+        AllowRunningInsecureContent,
+        DeferredCSSParserEnabled,
+        ThreadedHTMLParserEnabled
     };
     enum WebGraphic {
         MissingImageGraphic,
@@ -96,6 +96,8 @@ private Q_SLOTS:
     void loadFinishedAfterNotFoundError();
     void loadInSignalHandlers_data();
     void loadInSignalHandlers();
+    void threadedParser_data();
+    void threadedParser();
 
 private:
     QWebView* m_view;
@@ -1565,5 +1567,148 @@ void tst_QWebFrame::loadInSignalHandlers()
     QCOMPARE(frame->url(), urlForSetter);
 }
 
+// Delivers the document one chunk per event loop iteration, so that each chunk is appended to the parser separately.
+class ChunkedReply : public QNetworkReply {
+    Q_OBJECT
+
+public:
+    ChunkedReply(const QNetworkRequest& request, const QList<QByteArray>& chunks, QObject* parent)
+        : QNetworkReply(parent)
+        , m_chunks(chunks)
+    {
+        setOperation(QNetworkAccessManager::GetOperation);
+        setRequest(request);
+        setUrl(request.url());
+        setHeader(QNetworkRequest::ContentTypeHeader, QString("text/html; charset=utf-8"));
+        setAttribute(QNetworkRequest::HttpStatusCodeAttribute, 200);
+        open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+        QTimer::singleShot(0, this, SLOT(deliverNextChunk()));
+    }
+
+    virtual qint64 bytesAvailable() const { return m_buffer.size() + QNetworkReply::bytesAvailable(); }
+    virtual bool isSequential() const { return true; }
+    virtual void abort() {}
+
+protected:
+    qint64 readData(char* data, qint64 maxSize)
+    {
+        qint64 size = qMin<qint64>(maxSize, m_buffer.size());
+        memcpy(data, m_buffer.constData(), size);
+        m_buffer.remove(0, size);
+        return size;
+    }
+
+private Q_SLOTS:
+    void deliverNextChunk()
+    {
+        if (m_chunks.isEmpty()) {
+            emit finished();
+            return;
+        }
+        m_buffer.append(m_chunks.takeFirst());
+        emit readyRead();
+        QTimer::singleShot(0, this, SLOT(deliverNextChunk()));
+    }
+
+private:
+    QList<QByteArray> m_chunks;
+    QByteArray m_buffer;
+};
+
+class ChunkedNetworkManager : public QNetworkAccessManager {
+    Q_OBJECT
+
+public:
+    static const QUrl documentUrl;
+
+    ChunkedNetworkManager(const QList<QByteArray>& chunks, QObject* parent)
+        : QNetworkAccessManager(parent)
+        , m_chunks(chunks)
+    {
+    }
+
+protected:
+    virtual QNetworkReply* createRequest(Operation op, const QNetworkRequest& request, QIODevice* outgoingData)
+    {
+        if (op == QNetworkAccessManager::GetOperation && request.url() == documentUrl)
+            return new ChunkedReply(request, m_chunks, this);
+        return QNetworkAccessManager::createRequest(op, request, outgoingData);
+    }
+
+private:
+    QList<QByteArray> m_chunks;
+};
+
+const QUrl ChunkedNetworkManager::documentUrl = QUrl("http://parser.test/");
+
+static QString parseChunks(const QList<QByteArray>& chunks, bool useThreadedParser)
+{
+    QWebPage page;
+    // The threaded parser is off while the XSS auditor is on.
+    page.settings()->setAttribute(QWebSettings::XSSAuditingEnabled, false);
+    page.settings()->setAttribute(QWebSettings::ThreadedHTMLParserEnabled, useThreadedParser);
+    page.setNetworkAccessManager(new ChunkedNetworkManager(chunks, &page));
+
+    page.mainFrame()->setUrl(ChunkedNetworkManager::documentUrl);
+    if (!::waitForSignal(&page, SIGNAL(loadFinished(bool))))
+        return QString();
+    return page.mainFrame()->toHtml();
+}
+
+void tst_QWebFrame::threadedParser_data()
+{
+    // Chunks are separated by '|'.
+    QTest::addColumn<QByteArray>("content");
+
+    QTest::newRow("split tag name") << QByteArray("<p>one</p><di|v>two</div>");
+    QTest::newRow("split attribute") << QByteArray("<a hr|ef='x|y' title=\"t|\">link</a>");
+    QTest::newRow("split character reference") << QByteArray("<p>a &am|p; b &l|t; c &#x3|C;</p>");
+    QTest::newRow("split CRLF") << QByteArray("<pre>a\r|\nb\r|c</pre>");
+    QTest::newRow("split UTF-8 sequence") << QByteArray("<p>caf\xc3|\xa9</p>");
+    QTest::newRow("split comment") << QByteArray("<!-|- a -|- b --|><p>c</p>");
+    QTest::newRow("split doctype") << QByteArray("<!DOCT|YPE html><p>a</p>");
+    QTest::newRow("split script end tag") << QByteArray("<script>var a = '</scr|';</scr|ipt><p id=a>b</p>");
+    QTest::newRow("split textarea") << QByteArray("<textarea><b>|a</b></texta|rea><b>c</b>");
+    QTest::newRow("split CDATA in foreign content") << QByteArray("<svg><![CDA|TA[a<b]|]></svg><![CDATA[c]]>");
+    QTest::newRow("split between foreign and HTML content") << QByteArray("<math><mi>|<textarea><b></textarea></mi><|/math><style>a{}</style>");
+    QTest::newRow("empty chunks") << QByteArray("|<p>a||</p>|");
+
+    QTest::newRow("end of file in tag") << QByteArray("<p>a</p>|<b class='c");
+    QTest::newRow("end of file in comment") << QByteArray("<p>a</p><!-- b|");
+    QTest::newRow("end of file in character reference") << QByteArray("<p>a &am|p");
+    QTest::newRow("end of file in script") << QByteArray("<p>a</p><script>document.title = 'b'|");
+    QTest::newRow("end of file in textarea") << QByteArray("<textarea>a|</text");
+    QTest::newRow("end of file after carriage return") << QByteArray("<pre>a|\r");
+
+    QTest::newRow("document.write") << QByteArray("<p>a</p><script>document.write('<p>b</p>')</script>|<p>c</p>");
+    QTest::newRow("document.write of partial tag") << QByteArray("<script>document.write('<p title=\"')</script>a\">b|</p><p>c</p>");
+    QTest::newRow("document.write at chunk boundary") << QByteArray("<script>document.write('<b>a')</scr|ipt>b|</b>");
+    QTest::newRow("nested document.write") << QByteArray("<script>document.write('<scr' + 'ipt>document.write(\"<i>a</i>\")</scr' + 'ipt>b')</script>|c");
+
+    QTest::newRow("document.write of textarea") << QByteArray("<script>document.write('<textarea>')</script><b>a</b>|</textarea><b>c</b>");
+    QTest::newRow("document.write of plaintext") << QByteArray("<script>document.write('<plaintext>')</script><b>a</b>|<p>c</p>");
+    QTest::newRow("document.write of script") << QByteArray("<script>document.write('<script>var a = \"')</script>\";document.title = a;</script>|<p>b</p>");
+    QTest::newRow("document.write of svg") << QByteArray("<script>document.write('<svg>')</script>|<title><b>a</b></title>|<style><b>c</b></style></svg>|<title><b>d</b></title>");
+    QTest::newRow("document.write closing foreign content") << QByteArray("<svg><script>document.write('</svg>')</script>|<title><b>a</b></title>");
+
+    QByteArray longDocument;
+    for (int i = 0; i < 3000; ++i)
+        longDocument.append(QString("<span class='s%1'>%1 &amp; %1</span>\n").arg(i).toUtf8());
+    for (int i = longDocument.size() - 97; i > 0; i -= 97)
+        longDocument.insert(i, '|');
+    QTest::newRow("long document") << longDocument;
+}
+
+// The threaded parser has to build the same document as the main thread parser, whatever the chunks and scripts.
+void tst_QWebFrame::threadedParser()
+{
+    QFETCH(QByteArray, content);
+    QList<QByteArray> chunks = content.split('|');
+
+    QString expected = parseChunks(chunks, false);
+    QVERIFY(!expected.isEmpty());
+    QCOMPARE(parseChunks(chunks, true), expected);
+}
+
 QTEST_MAIN(tst_QWebFrame)
 #include "tst_qwebframe.moc"
@@ -176,6 +176,9 @@ AuthenticationManager& NetworkProcess::downloadsAuthenticationManager()
 void NetworkProcess::lowMemoryHandler(Critical critical)
 {
     platformLowMemoryHandler(critical);
+#if USE(UNIX_DOMAIN_SOCKETS)
+    parentProcessConnection()->releaseMessageBodySegments();
+#endif
     WTF::releaseFastMallocFreeMemory();
 }
 
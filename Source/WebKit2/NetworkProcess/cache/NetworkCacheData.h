@@ -101,6 +101,34 @@ template <typename T> DispatchPtr<T> adoptDispatch(T dispatchObject)
 }
 #endif
 
+#if PLATFORM(QT)
+// Owns the bytes of a Data, either a heap buffer or a read-only file mapping.
+// Subranges share the buffer instead of copying it.
+class DataBuffer : public ThreadSafeRefCounted<DataBuffer> {
+public:
+    static Ref<DataBuffer> create(size_t);
+    static Ref<DataBuffer> adoptMap(void* map, size_t, int fd);
+    ~DataBuffer();
+
+    uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    int fileDescriptor() const { return m_fileDescriptor; }
+    bool isMap() const { return m_fileDescriptor != -1; }
+
+private:
+    DataBuffer(uint8_t* data, size_t size, int fd)
+        : m_data(data)
+        , m_size(size)
+        , m_fileDescriptor(fd)
+    {
+    }
+
+    uint8_t* m_data;
+    size_t m_size;
+    int m_fileDescriptor;
+};
+#endif
+
 class Data {
 public:
     Data() { }
@@ -115,6 +143,9 @@ public:
 #endif
 #if USE(SOUP)
     Data(GRefPtr<SoupBuffer>&&, int fd = -1);
+#endif
+#if PLATFORM(QT)
+    Data(Ref<DataBuffer>&&, size_t offset, size_t);
 #endif
     bool isNull() const;
     bool isEmpty() const { return !m_size; }
@@ -138,6 +169,9 @@ public:
     SoupBuffer* soupBuffer() const { return m_buffer.get(); }
 #endif
 private:
+#if PLATFORM(QT)
+    RefPtr<DataBuffer> m_buffer;
+#endif
 #if PLATFORM(COCOA)
     mutable DispatchPtr<dispatch_data_t> m_dispatchData;
 #endif
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2016 The Qt Company Ltd.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "NetworkCacheData.h"
+
+#if ENABLE(NETWORK_CACHE)
+
+#include "SharedMemory.h"
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace WebKit {
+namespace NetworkCache {
+
+Ref<DataBuffer> DataBuffer::create(size_t size)
+{
+    return adoptRef(*new DataBuffer(static_cast<uint8_t*>(fastMalloc(size)), size, -1));
+}
+
+Ref<DataBuffer> DataBuffer::adoptMap(void* map, size_t size, int fd)
+{
+    ASSERT(map);
+    ASSERT(map != MAP_FAILED);
+    ASSERT(fd != -1);
+    return adoptRef(*new DataBuffer(static_cast<uint8_t*>(map), size, fd));
+}
+
+DataBuffer::~DataBuffer()
+{
+    if (!isMap()) {
+        fastFree(m_data);
+        return;
+    }
+
+    munmap(m_data, m_size);
+    close(m_fileDescriptor);
+}
+
+Data::Data(const uint8_t* data, size_t size)
+    : m_size(size)
+{
+    Ref<DataBuffer> buffer = DataBuffer::create(size);
+    memcpy(buffer->data(), data, size);
+    m_data = buffer->data();
+    m_buffer = WTFMove(buffer);
+}
+
+Data::Data(Ref<DataBuffer>&& buffer, size_t offset, size_t size)
+    : m_size(size)
+    , m_isMap(size && buffer->isMap())
+{
+    ASSERT(offset <= buffer->size());
+    ASSERT(size <= buffer->size() - offset);
+    m_data = buffer->data() + offset;
+    m_buffer = WTFMove(buffer);
+}
+
+Data Data::empty()
+{
+    return { DataBuffer::create(0), 0, 0 };
+}
+
+const uint8_t* Data::data() const
+{
+    return m_data;
+}
+
+bool Data::isNull() const
+{
+    return !m_buffer;
+}
+
+bool Data::apply(const std::function<bool (const uint8_t*, size_t)>&& applier) const
+{
+    if (!m_size)
+        return false;
+
+    return applier(m_data, m_size);
+}
+
+Data Data::subrange(size_t offset, size_t size) const
+{
+    if (!m_buffer)
+        return { };
+
+    // The subrange refers to the same buffer, so it stays mapped as long as either is alive.
+    return { *m_buffer, static_cast<size_t>(m_data - m_buffer->data()) + offset, size };
+}
+
+Data concatenate(const Data& a, const Data& b)
+{
+    if (a.isNull())
+        return b;
+    if (b.isNull())
+        return a;
+
+    Ref<DataBuffer> buffer = DataBuffer::create(a.size() + b.size());
+    memcpy(buffer->data(), a.data(), a.size());
+    memcpy(buffer->data() + a.size(), b.data(), b.size());
+    size_t size = buffer->size();
+    return { WTFMove(buffer), 0, size };
+}
+
+Data Data::adoptMap(void* map, size_t size, int fd)
+{
+    return { DataBuffer::adoptMap(map, size, fd), 0, size };
+}
+
+RefPtr<SharedMemory> Data::tryCreateSharedMemory() const
+{
+    if (isNull() || !isMap())
+        return nullptr;
+
+    // Only a whole mapping can be shared, the receiver maps the file descriptor from the start.
+    if (m_data != m_buffer->data() || m_size != m_buffer->size())
+        return nullptr;
+
+    return SharedMemory::wrapMap(m_buffer->data(), m_buffer->size(), m_buffer->fileDescriptor());
+}
+
+} // namespace NetworkCache
+} // namespace WebKit
+
+#endif
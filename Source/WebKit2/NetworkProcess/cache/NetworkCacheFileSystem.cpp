@@ -37,6 +37,8 @@
 #if USE(SOUP)
 #include <gio/gio.h>
 #include <wtf/glib/GRefPtr.h>
+#elif OS(LINUX)
+#include <sys/xattr.h>
 #endif
 
 namespace WebKit {
@@ -110,6 +112,25 @@ FileTimes fileTimes(const String& path)
         return { };
     return { std::chrono::system_clock::from_time_t(g_ascii_strtoull(birthtimeString, nullptr, 10)),
         std::chrono::system_clock::from_time_t(g_file_info_get_attribute_uint64(fileInfo.get(), "time::modified")) };
+#elif OS(LINUX)
+    // IOChannel stores the creation time in the same xattr that GIO uses for "xattr::birthtime".
+    CString fileSystemPath = WebCore::fileSystemRepresentation(path);
+    struct stat fileInfo;
+    if (stat(fileSystemPath.data(), &fileInfo))
+        return { };
+    char birthtimeString[32];
+    ssize_t birthtimeLength = getxattr(fileSystemPath.data(), "user.birthtime", birthtimeString, sizeof(birthtimeString) - 1);
+    if (birthtimeLength <= 0)
+        return { };
+    birthtimeString[birthtimeLength] = '\0';
+    return { std::chrono::system_clock::from_time_t(strtoull(birthtimeString, nullptr, 10)), std::chrono::system_clock::from_time_t(fileInfo.st_mtime) };
+#else
+    // Without a way to get the creation time, the modification time is the closest approximation.
+    struct stat fileInfo;
+    if (stat(WebCore::fileSystemRepresentation(path).data(), &fileInfo))
+        return { };
+    auto modificationTime = std::chrono::system_clock::from_time_t(fileInfo.st_mtime);
+    return { modificationTime, modificationTime };
 #endif
 }
 
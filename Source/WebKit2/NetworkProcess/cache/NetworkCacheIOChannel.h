@@ -45,6 +45,9 @@ class IOChannel : public ThreadSafeRefCounted<IOChannel> {
 public:
     enum class Type { Read, Write, Create };
     static Ref<IOChannel> open(const String& file, Type);
+#if PLATFORM(QT)
+    ~IOChannel();
+#endif
 
     // Using nullptr as queue submits the result to the main queue.
     // FIXME: We should add WorkQueue::main() instead.
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2016 The Qt Company Ltd.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "NetworkCacheIOChannel.h"
+
+#if ENABLE(NETWORK_CACHE)
+
+#include "NetworkCacheFileSystem.h"
+#include <atomic>
+#include <errno.h>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <wtf/RunLoop.h>
+#include <wtf/text/CString.h>
+
+#if !HAVE(STAT_BIRTHTIME) && OS(LINUX)
+#include <sys/xattr.h>
+#endif
+
+namespace WebKit {
+namespace NetworkCache {
+
+// WorkQueue is serial on this port, so reads and writes are spread over a few of them.
+static const unsigned ioQueueCount = 4;
+
+static WorkQueue& ioQueue()
+{
+    static WorkQueue* queues[ioQueueCount];
+    static std::once_flag onceFlag;
+    std::call_once(onceFlag, [] {
+        for (auto& queue : queues)
+            queue = &WorkQueue::create("com.apple.WebKit.Cache.IOChannel").leakRef();
+    });
+
+    static std::atomic<unsigned> nextQueue;
+    return *queues[nextQueue++ % ioQueueCount];
+}
+
+IOChannel::IOChannel(const String& filePath, Type type)
+    : m_path(filePath)
+    , m_type(type)
+{
+    auto path = WebCore::fileSystemRepresentation(filePath);
+    int oflag = O_CLOEXEC;
+    mode_t mode = 0;
+
+    switch (m_type) {
+    case Type::Create:
+        // We don't want to truncate any existing file (with O_TRUNC) as another thread might be mapping it.
+        unlink(path.data());
+        oflag |= O_CREAT | O_EXCL | O_WRONLY;
+        mode = S_IRUSR | S_IWUSR;
+        break;
+    case Type::Write:
+        oflag |= O_WRONLY;
+        break;
+    case Type::Read:
+        oflag |= O_RDONLY;
+        break;
+    }
+
+    m_fileDescriptor = ::open(path.data(), oflag, mode);
+
+#if !HAVE(STAT_BIRTHTIME) && OS(LINUX)
+    // There's no st_birthtime on Linux, fileTimes() reads the creation time back from this attribute.
+    if (m_type == Type::Create && m_fileDescriptor != -1) {
+        CString birthtime = String::number(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now())).utf8();
+        fsetxattr(m_fileDescriptor, "user.birthtime", birthtime.data(), birthtime.length(), 0);
+    }
+#endif
+}
+
+IOChannel::~IOChannel()
+{
+    if (m_fileDescriptor != -1)
+        close(m_fileDescriptor);
+}
+
+Ref<IOChannel> IOChannel::open(const String& filePath, IOChannel::Type type)
+{
+    return adoptRef(*new IOChannel(filePath, type));
+}
+
+static inline void runTaskInQueue(std::function<void ()> task, WorkQueue* queue)
+{
+    if (queue) {
+        queue->dispatch(task);
+        return;
+    }
+
+    // Using nullptr as queue submits the result to the main context.
+    RunLoop::main().dispatch(WTFMove(task));
+}
+
+void IOChannel::read(size_t offset, size_t size, WorkQueue* queue, std::function<void (Data&, int error)> completionHandler)
+{
+    RefPtr<IOChannel> channel(this);
+    RefPtr<WorkQueue> completionQueue(queue);
+    ioQueue().dispatch([channel, offset, size, completionQueue, completionHandler] {
+        int fd = channel->m_fileDescriptor;
+        struct stat fileInfo;
+        if (fd == -1 || fstat(fd, &fileInfo) == -1) {
+            int error = fd == -1 ? EBADF : errno;
+            runTaskInQueue([channel, error, completionHandler] {
+                Data data;
+                completionHandler(data, error);
+            }, completionQueue.get());
+            return;
+        }
+
+        size_t fileSize = fileInfo.st_size;
+        size_t bytesToRead = offset < fileSize ? std::min(size, fileSize - offset) : 0;
+        RefPtr<DataBuffer> buffer = DataBuffer::create(bytesToRead);
+        size_t bytesRead = 0;
+        while (bytesRead < bytesToRead) {
+            ssize_t result = pread(fd, buffer->data() + bytesRead, bytesToRead - bytesRead, offset + bytesRead);
+            if (result == -1) {
+                if (errno == EINTR)
+                    continue;
+                int error = errno;
+                runTaskInQueue([channel, error, completionHandler] {
+                    Data data;
+                    completionHandler(data, error);
+                }, completionQueue.get());
+                return;
+            }
+            // The file was truncated after fstat().
+            if (!result)
+                break;
+            bytesRead += result;
+        }
+
+        runTaskInQueue([channel, buffer, bytesRead, completionHandler] {
+            Data data(*buffer, 0, bytesRead);
+            completionHandler(data, 0);
+        }, completionQueue.get());
+    });
+}
+
+void IOChannel::write(size_t offset, const Data& data, WorkQueue* queue, std::function<void (int error)> completionHandler)
+{
+    RefPtr<IOChannel> channel(this);
+    RefPtr<WorkQueue> completionQueue(queue);
+    ioQueue().dispatch([channel, offset, data, completionQueue, completionHandler] {
+        int fd = channel->m_fileDescriptor;
+        int error = fd == -1 ? EBADF : 0;
+        size_t position = offset;
+        if (!error) {
+            data.apply([fd, &error, &position](const uint8_t* bytes, size_t size) {
+                while (size) {
+                    ssize_t result = pwrite(fd, bytes, size, position);
+                    if (result == -1) {
+                        if (errno == EINTR)
+                            continue;
+                        error = errno;
+                        return false;
+                    }
+                    bytes += result;
+                    size -= result;
+                    position += result;
+                }
+                return true;
+            });
+        }
+
+        runTaskInQueue([channel, error, completionHandler] {
+            completionHandler(error);
+        }, completionQueue.get());
+    });
+}
+
+} // namespace NetworkCache
+} // namespace WebKit
+
+#endif
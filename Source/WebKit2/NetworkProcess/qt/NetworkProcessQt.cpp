@@ -26,11 +26,14 @@
 #include "config.h"
 #include "NetworkProcess.h"
 
+#include "NetworkCache.h"
 #include "NetworkProcessCreationParameters.h"
 
 #include <QNetworkDiskCache>
 #include <WebCore/CertificateInfo.h>
 #include <WebCore/CookieJarQt.h>
+#include <WebCore/FileSystem.h>
+#include <wtf/RAMSize.h>
 
 using namespace WebCore;
 
@@ -45,12 +48,29 @@ void NetworkProcess::platformInitializeNetworkProcess(const NetworkProcessCreati
         jar->setParent(0);
     }
 
-    if (!parameters.diskCacheDirectory.isEmpty()) {
-        QNetworkDiskCache* diskCache = new QNetworkDiskCache();
-        diskCache->setCacheDirectory(parameters.diskCacheDirectory);
-        // The m_networkAccessManager takes ownership of the diskCache object upon the following call.
-        m_networkAccessManager.setCache(diskCache);
+    if (parameters.diskCacheDirectory.isEmpty())
+        return;
+
+    m_diskCacheDirectory = parameters.diskCacheDirectory;
+
+#if ENABLE(NETWORK_CACHE)
+    // The network cache replaces QNetworkDiskCache, so that loads go through a single, mmap-backed disk cache.
+    if (parameters.shouldEnableNetworkCache) {
+        NetworkCache::Cache::Parameters cacheParameters {
+            parameters.shouldEnableNetworkCacheEfficacyLogging
+#if ENABLE(NETWORK_CACHE_SPECULATIVE_REVALIDATION)
+            , parameters.shouldEnableNetworkCacheSpeculativeRevalidation
+#endif
+        };
+        if (NetworkCache::singleton().initialize(m_diskCacheDirectory, cacheParameters))
+            return;
     }
+#endif
+
+    QNetworkDiskCache* diskCache = new QNetworkDiskCache();
+    diskCache->setCacheDirectory(parameters.diskCacheDirectory);
+    // The m_networkAccessManager takes ownership of the diskCache object upon the following call.
+    m_networkAccessManager.setCache(diskCache);
 }
 
 void NetworkProcess::platformTerminate()
@@ -65,12 +85,49 @@ void NetworkProcess::clearCacheForAllOrigins(uint32_t)
 {
 }
 
-void NetworkProcess::clearDiskCache(std::chrono::system_clock::time_point, std::function<void()>)
+void NetworkProcess::clearDiskCache(std::chrono::system_clock::time_point modifiedSince, std::function<void()> completionHandler)
 {
+#if ENABLE(NETWORK_CACHE)
+    if (NetworkCache::singleton().isEnabled()) {
+        NetworkCache::singleton().clear(modifiedSince, WTFMove(completionHandler));
+        return;
+    }
+#else
+    UNUSED_PARAM(modifiedSince);
+#endif
+    completionHandler();
 }
 
-void NetworkProcess::platformSetCacheModel(CacheModel)
+void NetworkProcess::platformSetCacheModel(CacheModel cacheModel)
 {
+#if ENABLE(NETWORK_CACHE)
+    if (!NetworkCache::singleton().isEnabled())
+        return;
+
+    uint64_t physicalMemorySizeInMegabytes = WTF::ramSize() / 1024 / 1024;
+    uint64_t freeVolumeSpace = WebCore::getVolumeFreeSizeForPath(WebCore::fileSystemRepresentation(m_diskCacheDirectory).data()) / 1024 / 1024;
+
+    // The following variables are initialised to 0 because calculateCacheSizes might not
+    // set them in some rare cases.
+    unsigned cacheTotalCapacity = 0;
+    unsigned cacheMinDeadCapacity = 0;
+    unsigned cacheMaxDeadCapacity = 0;
+    auto deadDecodedDataDeletionInterval = std::chrono::seconds { 0 };
+    unsigned pageCacheCapacity = 0;
+    unsigned long urlCacheMemoryCapacity = 0;
+    unsigned long urlCacheDiskCapacity = 0;
+
+    calculateCacheSizes(cacheModel, physicalMemorySizeInMegabytes, freeVolumeSpace,
+        cacheTotalCapacity, cacheMinDeadCapacity, cacheMaxDeadCapacity, deadDecodedDataDeletionInterval,
+        pageCacheCapacity, urlCacheMemoryCapacity, urlCacheDiskCapacity);
+
+    if (m_diskCacheSizeOverride >= 0)
+        urlCacheDiskCapacity = m_diskCacheSizeOverride;
+
+    NetworkCache::singleton().setCapacity(urlCacheDiskCapacity);
+#else
+    UNUSED_PARAM(cacheModel);
+#endif
 }
 
 } // namespace WebKit
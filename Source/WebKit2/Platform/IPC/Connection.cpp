@@ -31,6 +31,7 @@
 #include <wtf/HashSet.h>
 #include <wtf/NeverDestroyed.h>
 #include <wtf/RunLoop.h>
+#include <wtf/SystemTracing.h>
 #include <wtf/text/WTFString.h>
 #include <wtf/threads/BinarySemaphore.h>
 
@@ -900,6 +901,8 @@ void Connection::dispatchMessage(std::unique_ptr<MessageDecoder> message)
     if (!m_client)
         return;
 
+    TraceScope traceScope(IPCMessageDispatchStart, IPCMessageDispatchEnd, message->destinationID());
+
     if (message->shouldUseFullySynchronousModeForTesting()) {
         if (!m_fullySynchronousModeIsAllowedForTesting) {
             m_client->didReceiveInvalidMessage(*this, message->messageReceiverName(), message->messageName());
@@ -56,6 +56,10 @@
 #include "GSocketMonitor.h"
 #endif
 
+#if USE(UNIX_DOMAIN_SOCKETS)
+#include "SharedMemory.h"
+#endif
+
 #if PLATFORM(QT)
 QT_BEGIN_NAMESPACE
 class QSocketNotifier;
@@ -221,6 +225,21 @@ public:
 
     void allowFullySynchronousModeForTesting() { m_fullySynchronousModeIsAllowedForTesting = true; }
 
+#if USE(UNIX_DOMAIN_SOCKETS)
+    // Number of out-of-line message bodies that were written into an existing pooled segment,
+    // and the total size of all out-of-line message bodies sent.
+    uint64_t messageBodySegmentPoolHits() const { return m_messageBodySegmentPoolHits; }
+    uint64_t outOfLineMessageBodyBytesSent() const { return m_outOfLineMessageBodyBytesSent; }
+
+    // Bytes of pooled segments this connection has allocated for sending and mapped for receiving.
+    size_t outgoingMessageBodySegmentsSize() const { return m_outgoingMessageBodySegmentsSize; }
+    size_t incomingMessageBodySegmentsSize() const { return m_incomingMessageBodySegmentsSize; }
+
+    // Segments that go unused for a while are released automatically. This releases every
+    // segment that no message is currently using, for example under memory pressure.
+    void releaseMessageBodySegments();
+#endif
+
 private:
     Connection(Identifier, bool isServer, Client&);
     void platformInitialize(Identifier);
@@ -340,9 +359,36 @@ private:
     void readyReadHandler();
     bool processMessage();
 
+    struct OutgoingMessageBodySegment {
+        RefPtr<WebKit::SharedMemory> memory;
+        uint32_t identifier;
+        bool isMappedByReceiver;
+        bool wasUsedSinceLastRelease;
+    };
+    struct IncomingMessageBodySegment {
+        RefPtr<WebKit::SharedMemory> memory;
+        bool wasUsedSinceLastRelease;
+    };
+    // Returns null if the body does not fit in the pool. The returned segment is marked in use.
+    OutgoingMessageBodySegment* takeOutgoingMessageBodySegment(size_t bodySize);
+    // Idle segments are those no message has used since the previous release.
+    enum class MessageBodySegmentsToRelease { Idle, AllUnused };
+    void releaseOutgoingMessageBodySegments(MessageBodySegmentsToRelease);
+    void releaseIncomingMessageBodySegments(MessageBodySegmentsToRelease);
+    void scheduleReleaseOfIdleMessageBodySegments();
+
     Vector<uint8_t> m_readBuffer;
     Vector<int> m_fileDescriptors;
     int m_socketDescriptor;
+
+    Vector<OutgoingMessageBodySegment> m_outgoingMessageBodySegments;
+    std::atomic<size_t> m_outgoingMessageBodySegmentsSize { 0 };
+    uint32_t m_lastOutgoingMessageBodySegmentIdentifier { 0 };
+    HashMap<uint32_t, IncomingMessageBodySegment> m_incomingMessageBodySegments;
+    std::atomic<size_t> m_incomingMessageBodySegmentsSize { 0 };
+    bool m_isReleaseOfIdleMessageBodySegmentsScheduled { false };
+    std::atomic<uint64_t> m_messageBodySegmentPoolHits { 0 };
+    std::atomic<uint64_t> m_outOfLineMessageBodyBytesSent { 0 };
 #if PLATFORM(GTK)
     GSocketMonitor m_socketMonitor;
 #endif
@@ -36,6 +36,7 @@
 #include <fcntl.h>
 #include <poll.h>
 #include <wtf/Assertions.h>
+#include <wtf/MathExtras.h>
 #include <wtf/StdLibExtras.h>
 #include <wtf/UniStdExtras.h>
 
@@ -67,6 +68,49 @@ enum {
     MessageBodyIsOutOfLine = 1U << 31
 };
 
+// Out-of-line message bodies that fit are written into segments of a per-connection
+// pool instead of a new shared memory allocation per message. A segment is sent to the
+// receiver the first time it is used; both processes keep it mapped afterwards, and
+// later messages only refer to it by identifier. Either process releases segments that
+// have not been used for a while on its own.
+static const size_t messageBodySegmentMinimumSize = 16 * 1024;
+static const size_t messageBodySegmentMaximumSize = 1024 * 1024;
+static const size_t messageBodySegmentPoolCapacity = 8 * 1024 * 1024;
+static const size_t messageBodySegmentPoolMaximumCount = messageBodySegmentPoolCapacity / messageBodySegmentMinimumSize;
+static const auto messageBodySegmentIdleInterval = std::chrono::seconds(10);
+
+// Every segment starts with a header that the two processes use to hand it over. The
+// sender claims an unused segment before writing a body into it, and the receiver marks
+// it unused again once it is done with the body. The receiver can only unmap a segment
+// that is unused, and marks it released when it does so, which tells the sender to send
+// it again before its next use. The header is padded to a cache line so that the body
+// stays aligned.
+enum MessageBodySegmentState : uint32_t {
+    MessageBodySegmentUnused,
+    MessageBodySegmentInUse,
+    MessageBodySegmentReleasedByReceiver
+};
+struct MessageBodySegmentHeader {
+    std::atomic<uint32_t> state;
+};
+static const size_t messageBodySegmentHeaderSize = 64;
+COMPILE_ASSERT(sizeof(MessageBodySegmentHeader) <= messageBodySegmentHeaderSize, MessageBodySegmentHeaderFits);
+
+static MessageBodySegmentHeader& messageBodySegmentHeader(WebKit::SharedMemory& segment)
+{
+    return *static_cast<MessageBodySegmentHeader*>(segment.data());
+}
+
+static bool segmentCanHoldMessageBody(size_t segmentSize, size_t bodySize)
+{
+    return segmentSize >= messageBodySegmentHeaderSize && segmentSize - messageBodySegmentHeaderSize >= bodySize;
+}
+
+static bool isValidMessageBodySegmentIdentifier(uint32_t identifier)
+{
+    return HashMap<uint32_t, RefPtr<WebKit::SharedMemory>>::isValidKey(identifier);
+}
+
 class MessageInfo {
 public:
     MessageInfo() { }
@@ -75,6 +119,8 @@ public:
         : m_bodySize(bodySize)
         , m_attachmentCount(initialAttachmentCount)
         , m_isMessageBodyOutOfLine(false)
+        , m_hasMessageBodyAttachment(false)
+        , m_bodySegmentIdentifier(0)
     {
     }
 
@@ -83,10 +129,30 @@ public:
         ASSERT(!isMessageBodyIsOutOfLine());
 
         m_isMessageBodyOutOfLine = true;
+        m_hasMessageBodyAttachment = true;
         m_attachmentCount++;
     }
 
+    // The body is in a pooled segment. Unless the receiver has mapped the segment
+    // already, it is sent as the last attachment.
+    void setMessageBodyIsInSegment(uint32_t segmentIdentifier, bool segmentIsAttached)
+    {
+        ASSERT(segmentIdentifier);
+
+        if (segmentIsAttached)
+            setMessageBodyIsOutOfLine();
+        else {
+            ASSERT(!isMessageBodyIsOutOfLine());
+            m_isMessageBodyOutOfLine = true;
+        }
+        m_bodySegmentIdentifier = segmentIdentifier;
+    }
+
     bool isMessageBodyIsOutOfLine() const { return m_isMessageBodyOutOfLine; }
+    bool hasMessageBodyAttachment() const { return m_hasMessageBodyAttachment; }
+
+    // Zero unless the body is in a pooled segment.
+    uint32_t bodySegmentIdentifier() const { return m_bodySegmentIdentifier; }
 
     size_t bodySize() const { return m_bodySize; }
 
@@ -96,6 +162,8 @@ private:
     size_t m_bodySize;
     size_t m_attachmentCount;
     bool m_isMessageBodyOutOfLine;
+    bool m_hasMessageBodyAttachment;
+    uint32_t m_bodySegmentIdentifier;
 };
 
 class AttachmentInfo {
@@ -151,6 +219,11 @@ void Connection::platformInvalidate()
         closeWithRetry(m_socketDescriptor);
 #endif
 
+    m_outgoingMessageBodySegments.clear();
+    m_outgoingMessageBodySegmentsSize = 0;
+    m_incomingMessageBodySegments.clear();
+    m_incomingMessageBodySegmentsSize = 0;
+
     if (!m_isConnected)
         return;
 
@@ -230,7 +303,7 @@ bool Connection::processMessage()
             }
         }
 
-        if (messageInfo.isMessageBodyIsOutOfLine())
+        if (messageInfo.hasMessageBodyAttachment())
             attachmentCount--;
     }
 
@@ -258,31 +331,88 @@ bool Connection::processMessage()
         }
     }
 
+    uint32_t bodySegmentIdentifier = messageInfo.bodySegmentIdentifier();
+    bool exceedsMessageBodySegmentLimits = false;
     if (messageInfo.isMessageBodyIsOutOfLine()) {
         ASSERT(messageInfo.bodySize());
 
-        if (attachmentInfo[attachmentCount].isNull() || attachmentInfo[attachmentCount].getSize() != messageInfo.bodySize()) {
+        if (bodySegmentIdentifier && !isValidMessageBodySegmentIdentifier(bodySegmentIdentifier)) {
             ASSERT_NOT_REACHED();
             return false;
         }
 
-        WebKit::SharedMemory::Handle handle;
-        handle.adoptAttachment(IPC::Attachment(m_fileDescriptors[attachmentFileDescriptorCount - 1], attachmentInfo[attachmentCount].getSize()));
+        if (messageInfo.hasMessageBodyAttachment()) {
+            size_t attachmentSize = attachmentInfo[attachmentCount].getSize();
+            bool attachmentSizeIsValid = bodySegmentIdentifier ? segmentCanHoldMessageBody(attachmentSize, messageInfo.bodySize()) : attachmentSize == messageInfo.bodySize();
+            if (attachmentInfo[attachmentCount].isNull() || !attachmentSizeIsValid) {
+                ASSERT_NOT_REACHED();
+                return false;
+            }
 
-        oolMessageBody = WebKit::SharedMemory::map(handle, WebKit::SharedMemory::Protection::ReadOnly);
-        if (!oolMessageBody) {
-            ASSERT_NOT_REACHED();
-            return false;
+            WebKit::SharedMemory::Handle handle;
+            handle.adoptAttachment(IPC::Attachment(m_fileDescriptors[attachmentFileDescriptorCount - 1], attachmentSize));
+
+            // Pooled segments are written by the receiver too, to hand them back to the sender.
+            oolMessageBody = WebKit::SharedMemory::map(handle, bodySegmentIdentifier ? WebKit::SharedMemory::Protection::ReadWrite : WebKit::SharedMemory::Protection::ReadOnly);
+            if (!oolMessageBody) {
+                ASSERT_NOT_REACHED();
+                return false;
+            }
+
+            if (bodySegmentIdentifier) {
+                // A sender never has more segments mapped than its pool can hold. Keeping more
+                // would let it pin an unbounded amount of memory in this process, so such a
+                // segment is only used for this message, which is then treated as invalid.
+                size_t segmentsSize = 0;
+                auto segmentFitsInPool = [&] {
+                    size_t replacedSegmentSize = 0;
+                    auto it = m_incomingMessageBodySegments.find(bodySegmentIdentifier);
+                    if (it != m_incomingMessageBodySegments.end())
+                        replacedSegmentSize = it->value.memory->size();
+                    size_t segmentCount = m_incomingMessageBodySegments.size() + (it == m_incomingMessageBodySegments.end() ? 1 : 0);
+                    segmentsSize = m_incomingMessageBodySegmentsSize - replacedSegmentSize + attachmentSize;
+                    return attachmentSize <= messageBodySegmentMaximumSize && segmentCount <= messageBodySegmentPoolMaximumCount && segmentsSize <= messageBodySegmentPoolCapacity;
+                };
+
+                // The sender may have dropped segments that are still mapped here.
+                bool fitsInPool = segmentFitsInPool();
+                if (!fitsInPool) {
+                    releaseIncomingMessageBodySegments(MessageBodySegmentsToRelease::AllUnused);
+                    fitsInPool = segmentFitsInPool();
+                }
+
+                if (!fitsInPool)
+                    exceedsMessageBodySegmentLimits = true;
+                else {
+                    m_incomingMessageBodySegments.set(bodySegmentIdentifier, IncomingMessageBodySegment { oolMessageBody, true });
+                    m_incomingMessageBodySegmentsSize = segmentsSize;
+                    scheduleReleaseOfIdleMessageBodySegments();
+                }
+            }
+        } else {
+            auto it = m_incomingMessageBodySegments.find(bodySegmentIdentifier);
+            if (it == m_incomingMessageBodySegments.end() || !segmentCanHoldMessageBody(it->value.memory->size(), messageInfo.bodySize())) {
+                ASSERT_NOT_REACHED();
+                return false;
+            }
+            it->value.wasUsedSinceLastRelease = true;
+            oolMessageBody = it->value.memory;
         }
     }
 
-    ASSERT(attachments.size() == (messageInfo.isMessageBodyIsOutOfLine() ? messageInfo.attachmentCount() - 1 : messageInfo.attachmentCount()));
+    ASSERT(attachments.size() == (messageInfo.hasMessageBodyAttachment() ? messageInfo.attachmentCount() - 1 : messageInfo.attachmentCount()));
 
     uint8_t* messageBody = messageData;
     if (messageInfo.isMessageBodyIsOutOfLine())
-        messageBody = reinterpret_cast<uint8_t*>(oolMessageBody->data());
+        messageBody = reinterpret_cast<uint8_t*>(oolMessageBody->data()) + (bodySegmentIdentifier ? messageBodySegmentHeaderSize : 0);
 
     auto decoder = std::make_unique<MessageDecoder>(DataReference(messageBody, messageInfo.bodySize()), WTFMove(attachments));
+    if (exceedsMessageBodySegmentLimits)
+        decoder->markInvalid();
+
+    // The decoder has its own copy of the body, so the sender can reuse the segment.
+    if (bodySegmentIdentifier)
+        messageBodySegmentHeader(*oolMessageBody).state.store(MessageBodySegmentUnused, std::memory_order_release);
 
     processIncomingMessage(WTFMove(decoder));
 
@@ -456,6 +586,107 @@ bool Connection::platformCanSendOutgoingMessages() const
     return m_isConnected;
 }
 
+Connection::OutgoingMessageBodySegment* Connection::takeOutgoingMessageBodySegment(size_t bodySize)
+{
+    if (bodySize > messageBodySegmentMaximumSize - messageBodySegmentHeaderSize)
+        return nullptr;
+
+    // Reuse the smallest segment that the receiver is done with and that is large enough.
+    OutgoingMessageBodySegment* bestSegment = nullptr;
+    for (auto& segment : m_outgoingMessageBodySegments) {
+        if (!segmentCanHoldMessageBody(segment.memory->size(), bodySize))
+            continue;
+        if (bestSegment && bestSegment->memory->size() <= segment.memory->size())
+            continue;
+        if (messageBodySegmentHeader(*segment.memory).state.load(std::memory_order_acquire) == MessageBodySegmentInUse)
+            continue;
+        bestSegment = &segment;
+    }
+
+    if (bestSegment) {
+        // The receiver can release the segment until it is claimed here.
+        uint32_t state = MessageBodySegmentUnused;
+        if (!messageBodySegmentHeader(*bestSegment->memory).state.compare_exchange_strong(state, MessageBodySegmentInUse, std::memory_order_acquire)) {
+            bestSegment->isMappedByReceiver = false;
+            messageBodySegmentHeader(*bestSegment->memory).state.store(MessageBodySegmentInUse, std::memory_order_relaxed);
+        }
+        bestSegment->wasUsedSinceLastRelease = true;
+        ++m_messageBodySegmentPoolHits;
+        return bestSegment;
+    }
+
+    size_t segmentSize = std::max<size_t>(messageBodySegmentMinimumSize, WTF::roundUpToPowerOfTwo(messageBodySegmentHeaderSize + bodySize));
+    if (m_outgoingMessageBodySegmentsSize + segmentSize > messageBodySegmentPoolCapacity)
+        return nullptr;
+
+    RefPtr<WebKit::SharedMemory> memory = WebKit::SharedMemory::allocate(segmentSize);
+    if (!memory)
+        return nullptr;
+
+    new (NotNull, memory->data()) MessageBodySegmentHeader { { MessageBodySegmentInUse } };
+    m_outgoingMessageBodySegmentsSize += segmentSize;
+    m_outgoingMessageBodySegments.append({ WTFMove(memory), ++m_lastOutgoingMessageBodySegmentIdentifier, false, true });
+    scheduleReleaseOfIdleMessageBodySegments();
+    return &m_outgoingMessageBodySegments.last();
+}
+
+// Segments in use hold a body the receiver has not read yet, so they are kept. The receiver
+// releases its own mapping of a dropped segment once it is idle there too.
+void Connection::releaseOutgoingMessageBodySegments(MessageBodySegmentsToRelease segmentsToRelease)
+{
+    m_outgoingMessageBodySegments.removeAllMatching([this, segmentsToRelease] (OutgoingMessageBodySegment& segment) {
+        bool wasUsed = segment.wasUsedSinceLastRelease;
+        segment.wasUsedSinceLastRelease = false;
+        if (wasUsed && segmentsToRelease == MessageBodySegmentsToRelease::Idle)
+            return false;
+        if (messageBodySegmentHeader(*segment.memory).state.load(std::memory_order_acquire) == MessageBodySegmentInUse)
+            return false;
+        m_outgoingMessageBodySegmentsSize -= segment.memory->size();
+        return true;
+    });
+}
+
+void Connection::releaseIncomingMessageBodySegments(MessageBodySegmentsToRelease segmentsToRelease)
+{
+    m_incomingMessageBodySegments.removeIf([this, segmentsToRelease] (HashMap<uint32_t, IncomingMessageBodySegment>::KeyValuePairType& entry) {
+        IncomingMessageBodySegment& segment = entry.value;
+        bool wasUsed = segment.wasUsedSinceLastRelease;
+        segment.wasUsedSinceLastRelease = false;
+        if (wasUsed && segmentsToRelease == MessageBodySegmentsToRelease::Idle)
+            return false;
+        uint32_t state = MessageBodySegmentUnused;
+        if (!messageBodySegmentHeader(*segment.memory).state.compare_exchange_strong(state, MessageBodySegmentReleasedByReceiver, std::memory_order_acq_rel))
+            return false;
+        m_incomingMessageBodySegmentsSize -= segment.memory->size();
+        return true;
+    });
+}
+
+void Connection::scheduleReleaseOfIdleMessageBodySegments()
+{
+    if (m_isReleaseOfIdleMessageBodySegmentsScheduled)
+        return;
+    m_isReleaseOfIdleMessageBodySegmentsScheduled = true;
+
+    RefPtr<Connection> protectedThis(this);
+    m_connectionQueue->dispatchAfter(messageBodySegmentIdleInterval, [protectedThis] {
+        protectedThis->m_isReleaseOfIdleMessageBodySegmentsScheduled = false;
+        protectedThis->releaseOutgoingMessageBodySegments(MessageBodySegmentsToRelease::Idle);
+        protectedThis->releaseIncomingMessageBodySegments(MessageBodySegmentsToRelease::Idle);
+        if (!protectedThis->m_outgoingMessageBodySegments.isEmpty() || !protectedThis->m_incomingMessageBodySegments.isEmpty())
+            protectedThis->scheduleReleaseOfIdleMessageBodySegments();
+    });
+}
+
+void Connection::releaseMessageBodySegments()
+{
+    RefPtr<Connection> protectedThis(this);
+    m_connectionQueue->dispatch([protectedThis] {
+        protectedThis->releaseOutgoingMessageBodySegments(MessageBodySegmentsToRelease::AllUnused);
+        protectedThis->releaseIncomingMessageBodySegments(MessageBodySegmentsToRelease::AllUnused);
+    });
+}
+
 bool Connection::sendOutgoingMessage(std::unique_ptr<MessageEncoder> encoder)
 {
 #if PLATFORM(QT)
@@ -472,20 +703,39 @@ bool Connection::sendOutgoingMessage(std::unique_ptr<MessageEncoder> encoder)
 
     MessageInfo messageInfo(encoder->bufferSize(), attachments.size());
     size_t messageSizeWithBodyInline = sizeof(messageInfo) + (attachments.size() * sizeof(AttachmentInfo)) + encoder->bufferSize();
+    OutgoingMessageBodySegment* bodySegment = nullptr;
     if (messageSizeWithBodyInline > messageMaxSize && encoder->bufferSize()) {
-        RefPtr<WebKit::SharedMemory> oolMessageBody = WebKit::SharedMemory::allocate(encoder->bufferSize());
-        if (!oolMessageBody)
-            return false;
+        m_outOfLineMessageBodyBytesSent += encoder->bufferSize();
+
+        bodySegment = takeOutgoingMessageBodySegment(encoder->bufferSize());
+        if (bodySegment) {
+            if (!bodySegment->isMappedByReceiver) {
+                WebKit::SharedMemory::Handle handle;
+                if (!bodySegment->memory->createHandle(handle, WebKit::SharedMemory::Protection::ReadWrite)) {
+                    messageBodySegmentHeader(*bodySegment->memory).state.store(MessageBodySegmentUnused, std::memory_order_relaxed);
+                    return false;
+                }
+                attachments.append(handle.releaseAttachment());
+            }
 
-        WebKit::SharedMemory::Handle handle;
-        if (!oolMessageBody->createHandle(handle, WebKit::SharedMemory::Protection::ReadOnly))
-            return false;
+            messageInfo.setMessageBodyIsInSegment(bodySegment->identifier, !bodySegment->isMappedByReceiver);
 
-        messageInfo.setMessageBodyIsOutOfLine();
+            memcpy(static_cast<uint8_t*>(bodySegment->memory->data()) + messageBodySegmentHeaderSize, encoder->buffer(), encoder->bufferSize());
+        } else {
+            RefPtr<WebKit::SharedMemory> oolMessageBody = WebKit::SharedMemory::allocate(encoder->bufferSize());
+            if (!oolMessageBody)
+                return false;
 
-        memcpy(oolMessageBody->data(), encoder->buffer(), encoder->bufferSize());
+            WebKit::SharedMemory::Handle handle;
+            if (!oolMessageBody->createHandle(handle, WebKit::SharedMemory::Protection::ReadOnly))
+                return false;
 
-        attachments.append(handle.releaseAttachment());
+            messageInfo.setMessageBodyIsOutOfLine();
+
+            memcpy(oolMessageBody->data(), encoder->buffer(), encoder->bufferSize());
+
+            attachments.append(handle.releaseAttachment());
+        }
     }
 
     struct msghdr message;
@@ -576,8 +826,13 @@ bool Connection::sendOutgoingMessage(std::unique_ptr<MessageEncoder> encoder)
 
         if (m_isConnected)
             WTFLogAlways("Error sending IPC message: %s", strerror(errno));
+        if (bodySegment)
+            messageBodySegmentHeader(*bodySegment->memory).state.store(MessageBodySegmentUnused, std::memory_order_relaxed);
         return false;
     }
+
+    if (bodySegment)
+        bodySegment->isMappedByReceiver = true;
     return true;
 }
 
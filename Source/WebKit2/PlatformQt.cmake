@@ -241,6 +241,9 @@ elseif (WIN32)
     )
 else ()
     list(APPEND WebKit2_SOURCES
+        NetworkProcess/cache/NetworkCacheDataUnix.cpp
+        NetworkProcess/cache/NetworkCacheIOChannelUnix.cpp
+
         Platform/IPC/unix/AttachmentUnix.cpp
         Platform/IPC/unix/ConnectionUnix.cpp
 
@@ -190,6 +190,16 @@ void WebCoordinatedSurface::paintToSurface(const IntRect& rect, CoordinatedSurfa
     client->paintToSurfaceContext(*context);
 }
 
+bool WebCoordinatedSurface::supportsConcurrentPainting() const
+{
+#if USE(GRAPHICS_SURFACE)
+    if (isBackedByGraphicsSurface())
+        return false;
+#endif
+    // Each call to paintToSurface() creates its own GraphicsContext on the shared bitmap.
+    return true;
+}
+
 #if USE(TEXTURE_MAPPER)
 void WebCoordinatedSurface::copyToTexture(PassRefPtr<WebCore::BitmapTexture> passTexture, const IntRect& target, const IntPoint& sourceOffset)
 {
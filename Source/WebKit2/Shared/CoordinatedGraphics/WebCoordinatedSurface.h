@@ -72,6 +72,7 @@ public:
     virtual ~WebCoordinatedSurface();
 
     virtual void paintToSurface(const WebCore::IntRect&, WebCore::CoordinatedSurface::Client*) override;
+    virtual bool supportsConcurrentPainting() const override;
 
 #if USE(TEXTURE_MAPPER)
     virtual void copyToTexture(PassRefPtr<WebCore::BitmapTexture>, const WebCore::IntRect& target, const WebCore::IntPoint& sourceOffset) override;
@@ -1456,3 +1456,23 @@ bool WKPreferencesGetMockCaptureDevicesEnabled(WKPreferencesRef preferencesRef)
 {
     return toImpl(preferencesRef)->mockCaptureDevicesEnabled();
 }
+
+void WKPreferencesSetDeferredCSSParserEnabled(WKPreferencesRef preferencesRef, bool enabled)
+{
+    toImpl(preferencesRef)->setDeferredCSSParserEnabled(enabled);
+}
+
+bool WKPreferencesGetDeferredCSSParserEnabled(WKPreferencesRef preferencesRef)
+{
+    return toImpl(preferencesRef)->deferredCSSParserEnabled();
+}
+
+void WKPreferencesSetThreadedHTMLParserEnabled(WKPreferencesRef preferencesRef, bool enabled)
+{
+    toImpl(preferencesRef)->setThreadedHTMLParserEnabled(enabled);
+}
+
+bool WKPreferencesGetThreadedHTMLParserEnabled(WKPreferencesRef preferencesRef)
+{
+    return toImpl(preferencesRef)->threadedHTMLParserEnabled();
+}
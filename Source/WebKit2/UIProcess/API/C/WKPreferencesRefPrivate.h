@@ -402,6 +402,14 @@ WK_EXPORT bool WKPreferencesGetResourceUsageOverlayVisible(WKPreferencesRef);
 WK_EXPORT void WKPreferencesSetMockCaptureDevicesEnabled(WKPreferencesRef, bool);
 WK_EXPORT bool WKPreferencesGetMockCaptureDevicesEnabled(WKPreferencesRef);
 
+// Defaults to false.
+WK_EXPORT void WKPreferencesSetDeferredCSSParserEnabled(WKPreferencesRef, bool);
+WK_EXPORT bool WKPreferencesGetDeferredCSSParserEnabled(WKPreferencesRef);
+
+// Defaults to false. Has no effect while the XSS auditor is enabled.
+WK_EXPORT void WKPreferencesSetThreadedHTMLParserEnabled(WKPreferencesRef, bool);
+WK_EXPORT bool WKPreferencesGetThreadedHTMLParserEnabled(WKPreferencesRef);
+
 #ifdef __cplusplus
 }
 #endif
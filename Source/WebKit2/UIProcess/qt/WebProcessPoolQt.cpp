@@ -72,6 +72,13 @@ void WebProcessPool::platformInitializeNetworkProcess(NetworkProcessCreationPara
     // QTFIXME
     parameters.cookiePersistentStoragePath = QtWebContext::preparedStoragePath(QtWebContext::CookieStorage);
     parameters.languages = WebCore::userPreferredLanguages();
+#if ENABLE(NETWORK_CACHE)
+    parameters.shouldEnableNetworkCache = true;
+    parameters.shouldEnableNetworkCacheEfficacyLogging = false;
+#if ENABLE(NETWORK_CACHE_SPECULATIVE_REVALIDATION)
+    parameters.shouldEnableNetworkCacheSpeculativeRevalidation = true;
+#endif
+#endif
 }
 
 String WebProcessPool::platformDefaultIconDatabasePath() const
@@ -3105,6 +3105,9 @@ void WebPage::updatePreferences(const WebPreferencesStore& store)
 
     settings.setEnableInheritURIQueryComponent(store.getBoolValueForKey(WebPreferencesKey::enableInheritURIQueryComponentKey()));
 
+    settings.setDeferredCSSParserEnabled(store.getBoolValueForKey(WebPreferencesKey::deferredCSSParserEnabledKey()));
+    settings.setThreadedHTMLParserEnabled(store.getBoolValueForKey(WebPreferencesKey::threadedHTMLParserEnabledKey()));
+
     settings.setShouldDispatchJavaScriptWindowOnErrorEvents(true);
 
 #if PLATFORM(IOS)
@@ -255,7 +255,14 @@ void WebProcess::initializeWebProcess(WebProcessCreationParameters&& parameters)
 
     WTF::setCurrentThreadIsUserInitiated();
 
-    MemoryPressureHandler::singleton().install();
+    auto& memoryPressureHandler = MemoryPressureHandler::singleton();
+    memoryPressureHandler.setLowMemoryHandler([this] (Critical critical, Synchronous synchronous) {
+        MemoryPressureHandler::singleton().releaseMemory(critical, synchronous);
+#if USE(UNIX_DOMAIN_SOCKETS)
+        parentProcessConnection()->releaseMessageBodySegments();
+#endif
+    });
+    memoryPressureHandler.install();
 
     if (!parameters.injectedBundlePath.isEmpty())
         m_injectedBundle = InjectedBundle::create(parameters, transformHandlesToObjects(parameters.initializationUserData.object()).get());
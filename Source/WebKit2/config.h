@@ -117,7 +117,7 @@
 #endif
 
 #ifndef ENABLE_NETWORK_CACHE
-#if PLATFORM(COCOA) || PLATFORM(GTK)
+#if PLATFORM(COCOA) || PLATFORM(GTK) || (PLATFORM(QT) && OS(UNIX))
 #define ENABLE_NETWORK_CACHE 1
 #else
 #define ENABLE_NETWORK_CACHE 0
@@ -125,7 +125,7 @@
 #endif
 
 #ifndef ENABLE_NETWORK_CACHE_SPECULATIVE_REVALIDATION
-#if ENABLE(NETWORK_CACHE) && PLATFORM(COCOA)
+#if ENABLE(NETWORK_CACHE) && (PLATFORM(COCOA) || PLATFORM(QT))
 #define ENABLE_NETWORK_CACHE_SPECULATIVE_REVALIDATION 1
 #else
 #define ENABLE_NETWORK_CACHE_SPECULATIVE_REVALIDATION 0
@@ -28,6 +28,7 @@
 #include "Chunk.h"
 #include "Deallocator.h"
 #include "Heap.h"
+#include "HeapShards.h"
 #include "PerProcess.h"
 #include "Sizes.h"
 #include <algorithm>
@@ -38,7 +39,8 @@ using namespace std;
 namespace bmalloc {
 
 Allocator::Allocator(Heap* heap, Deallocator& deallocator)
-    : m_isBmallocEnabled(heap->environment().isBmallocEnabled())
+    : m_heap(heap)
+    , m_isBmallocEnabled(heap->environment().isBmallocEnabled())
     , m_deallocator(deallocator)
 {
     for (size_t sizeClass = 0; sizeClass < sizeClassCount; ++sizeClass)
@@ -58,8 +60,8 @@ void* Allocator::tryAllocate(size_t size)
     if (size <= smallMax)
         return allocate(size);
 
-    std::lock_guard<StaticMutex> lock(PerProcess<Heap>::mutex());
-    return PerProcess<Heap>::getFastCase()->tryAllocateLarge(lock, alignment, size);
+    std::lock_guard<StaticMutex> lock(PerProcess<HeapShards>::getFastCase()->mutex(m_heap->index()));
+    return m_heap->tryAllocateLarge(lock, alignment, size);
 }
 
 void* Allocator::allocate(size_t alignment, size_t size)
@@ -79,8 +81,8 @@ void* Allocator::allocate(size_t alignment, size_t size)
     if (size <= smallMax && alignment <= smallMax)
         return allocate(roundUpToMultipleOf(alignment, size));
 
-    std::lock_guard<StaticMutex> lock(PerProcess<Heap>::mutex());
-    return PerProcess<Heap>::getFastCase()->allocateLarge(lock, alignment, size);
+    std::lock_guard<StaticMutex> lock(PerProcess<HeapShards>::getFastCase()->mutex(m_heap->index()));
+    return m_heap->allocateLarge(lock, alignment, size);
 }
 
 void* Allocator::reallocate(void* object, size_t newSize)
@@ -100,11 +102,14 @@ void* Allocator::reallocate(void* object, size_t newSize)
         break;
     }
     case ObjectType::Large: {
-        std::lock_guard<StaticMutex> lock(PerProcess<Heap>::mutex());
-        oldSize = PerProcess<Heap>::getFastCase()->largeSize(lock, object);
+        HeapShards* shards = PerProcess<HeapShards>::getFastCase();
+        size_t heapIndex = shards->heapIndex(object);
+        Heap* heap = shards->heap(heapIndex);
+        std::lock_guard<StaticMutex> lock(shards->mutex(heapIndex));
+        oldSize = heap->largeSize(lock, object);
 
         if (newSize < oldSize && newSize > smallMax) {
-            PerProcess<Heap>::getFastCase()->shrinkLarge(lock, Range(object, oldSize), newSize);
+            heap->shrinkLarge(lock, Range(object, oldSize), newSize);
             return object;
         }
         break;
@@ -141,9 +146,9 @@ NO_INLINE void Allocator::refillAllocatorSlowCase(BumpAllocator& allocator, size
 {
     BumpRangeCache& bumpRangeCache = m_bumpRangeCaches[sizeClass];
 
-    std::lock_guard<StaticMutex> lock(PerProcess<Heap>::mutex());
+    std::lock_guard<StaticMutex> lock(PerProcess<HeapShards>::getFastCase()->mutex(m_heap->index()));
     m_deallocator.processObjectLog(lock);
-    PerProcess<Heap>::getFastCase()->allocateSmallBumpRanges(lock, sizeClass, allocator, bumpRangeCache);
+    m_heap->allocateSmallBumpRanges(lock, sizeClass, allocator, bumpRangeCache);
 }
 
 INLINE void Allocator::refillAllocator(BumpAllocator& allocator, size_t sizeClass)
@@ -156,8 +161,8 @@ INLINE void Allocator::refillAllocator(BumpAllocator& allocator, size_t sizeClas
 
 NO_INLINE void* Allocator::allocateLarge(size_t size)
 {
-    std::lock_guard<StaticMutex> lock(PerProcess<Heap>::mutex());
-    return PerProcess<Heap>::getFastCase()->allocateLarge(lock, alignment, size);
+    std::lock_guard<StaticMutex> lock(PerProcess<HeapShards>::getFastCase()->mutex(m_heap->index()));
+    return m_heap->allocateLarge(lock, alignment, size);
 }
 
 NO_INLINE void* Allocator::allocateLogSizeClass(size_t size)
@@ -61,6 +61,7 @@ private:
     std::array<BumpAllocator, sizeClassCount> m_bumpAllocators;
     std::array<BumpRangeCache, sizeClassCount> m_bumpRangeCaches;
 
+    Heap* m_heap;
     bool m_isBmallocEnabled;
     Deallocator& m_deallocator;
 };
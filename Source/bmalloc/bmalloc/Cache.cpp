@@ -25,6 +25,7 @@
 
 #include "Cache.h"
 #include "Heap.h"
+#include "HeapShards.h"
 #include "Inline.h"
 #include "PerProcess.h"
 
@@ -51,8 +52,13 @@ void Cache::scavenge()
 }
 
 Cache::Cache()
-    : m_deallocator(PerProcess<Heap>::get())
-    , m_allocator(PerProcess<Heap>::get(), m_deallocator)
+    : Cache(PerProcess<HeapShards>::get()->heapForNewCache())
+{
+}
+
+Cache::Cache(Heap* heap)
+    : m_deallocator(heap)
+    , m_allocator(heap, m_deallocator)
 {
 }
 
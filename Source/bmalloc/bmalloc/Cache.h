@@ -32,7 +32,7 @@
 
 namespace bmalloc {
 
-// Per-thread allocation / deallocation cache, backed by a per-process Heap.
+// Per-thread allocation / deallocation cache, backed by one of the per-process heap shards.
 
 class Cache {
 public:
@@ -53,6 +53,8 @@ public:
     Deallocator& deallocator() { return m_deallocator; }
 
 private:
+    Cache(Heap*);
+
     static void* tryAllocateSlowCaseNullCache(size_t);
     static void* allocateSlowCaseNullCache(size_t);
     static void* allocateSlowCaseNullCache(size_t alignment, size_t);
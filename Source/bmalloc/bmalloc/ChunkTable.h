@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#ifndef ChunkTable_h
+#define ChunkTable_h
+
+#include "BAssert.h"
+#include "Mutex.h"
+#include "ObjectType.h"
+#include "Sizes.h"
+#include "VMAllocate.h"
+#include <array>
+#include <atomic>
+#include <mutex>
+
+namespace bmalloc {
+
+class Chunk;
+
+// Records the object type and owning heap shard of every chunk we allocate.
+// Chunks are never returned to the OS, so entries are only ever added, and
+// lookups don't need a lock. The table covers the low 2^addressBits bytes of
+// the address space; chunks above that can't be recorded, and lookups report
+// addresses above it as not owned.
+
+class ChunkTable {
+public:
+    static const size_t addressBits = 48;
+
+    ChunkTable();
+
+    // Returns false, recording nothing, if the range lies beyond the table.
+    bool add(void* begin, size_t, ObjectType, size_t heapIndex);
+
+    bool isLarge(void*);
+    size_t heapIndex(void*);
+
+private:
+    static const size_t leafBits = 15;
+    static const size_t leafSize = static_cast<size_t>(1) << leafBits;
+    static const size_t chunkShift = log2(chunkSize);
+    static const size_t rootSize = static_cast<size_t>(1) << (addressBits - chunkShift - leafBits);
+
+    static const unsigned char validFlag = 0x80;
+    static const unsigned char largeFlag = 0x40;
+    static const unsigned char heapIndexMask = 0x3f;
+    static_assert(heapShardCount <= heapIndexMask + 1, "heap index must fit in a table entry");
+
+    unsigned char entry(void*);
+    unsigned char* leaf(uint64_t chunkNumber);
+
+    Mutex m_mutex;
+    std::array<std::atomic<unsigned char*>, rootSize> m_root;
+};
+
+inline ChunkTable::ChunkTable()
+{
+    for (auto& leaf : m_root)
+        leaf.store(nullptr, std::memory_order_relaxed);
+}
+
+inline unsigned char ChunkTable::entry(void* object)
+{
+    uint64_t chunkNumber = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(object)) >> chunkShift;
+    if (chunkNumber >> leafBits >= rootSize)
+        return 0;
+
+    unsigned char* leaf = m_root[chunkNumber >> leafBits].load(std::memory_order_consume);
+    if (!leaf)
+        return 0;
+    return leaf[chunkNumber & (leafSize - 1)];
+}
+
+inline bool ChunkTable::isLarge(void* object)
+{
+    return entry(object) & largeFlag;
+}
+
+inline size_t ChunkTable::heapIndex(void* object)
+{
+    unsigned char entry = this->entry(object);
+    BASSERT(entry & validFlag);
+    return entry & heapIndexMask;
+}
+
+inline unsigned char* ChunkTable::leaf(uint64_t chunkNumber)
+{
+    BASSERT(chunkNumber >> leafBits < rootSize);
+    std::atomic<unsigned char*>& slot = m_root[chunkNumber >> leafBits];
+
+    unsigned char* leaf = slot.load(std::memory_order_consume);
+    if (leaf)
+        return leaf;
+
+    std::lock_guard<StaticMutex> lock(m_mutex);
+    leaf = slot.load(std::memory_order_consume);
+    if (!leaf) {
+        leaf = static_cast<unsigned char*>(vmAllocate(vmSize(leafSize)));
+        slot.store(leaf, std::memory_order_release);
+    }
+    return leaf;
+}
+
+inline bool ChunkTable::add(void* begin, size_t size, ObjectType type, size_t heapIndex)
+{
+    BASSERT(!test(begin, ~chunkMask));
+    BASSERT(heapIndex <= heapIndexMask);
+
+    unsigned char entry = validFlag | static_cast<unsigned char>(heapIndex);
+    if (type == ObjectType::Large)
+        entry |= largeFlag;
+
+    uint64_t firstChunk = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(begin)) >> chunkShift;
+    uint64_t endChunk = firstChunk + divideRoundingUp(size, chunkSize);
+    if (endChunk < firstChunk || (endChunk - 1) >> leafBits >= rootSize)
+        return false;
+
+    for (uint64_t chunkNumber = firstChunk; chunkNumber < endChunk; ++chunkNumber)
+        leaf(chunkNumber)[chunkNumber & (leafSize - 1)] = entry;
+    return true;
+}
+
+} // namespace bmalloc
+
+#endif // ChunkTable_h
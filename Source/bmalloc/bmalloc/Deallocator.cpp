@@ -27,6 +27,7 @@
 #include "Chunk.h"
 #include "Deallocator.h"
 #include "Heap.h"
+#include "HeapShards.h"
 #include "Inline.h"
 #include "Object.h"
 #include "PerProcess.h"
@@ -39,7 +40,8 @@ using namespace std;
 namespace bmalloc {
 
 Deallocator::Deallocator(Heap* heap)
-    : m_isBmallocEnabled(heap->environment().isBmallocEnabled())
+    : m_heap(heap)
+    , m_isBmallocEnabled(heap->environment().isBmallocEnabled())
 {
     if (!m_isBmallocEnabled) {
         // Fill the object log in order to disable the fast path.
@@ -59,20 +61,39 @@ void Deallocator::scavenge()
         processObjectLog();
 }
 
-void Deallocator::processObjectLog(std::lock_guard<StaticMutex>& lock)
+// Frees the logged objects owned by heap, whose lock the caller holds.
+// Objects owned by other heaps stay in the log.
+void Deallocator::processObjectLog(std::lock_guard<StaticMutex>& lock, Heap* heap)
 {
-    Heap* heap = PerProcess<Heap>::getFastCase();
-    
-    for (Object object : m_objectLog)
+    HeapShards* shards = PerProcess<HeapShards>::getFastCase();
+
+    size_t size = 0;
+    for (void* object : m_objectLog) {
+        if (shards->heapIndex(object) != heap->index()) {
+            m_objectLog[size++] = object;
+            continue;
+        }
         heap->derefSmallLine(lock, object);
+    }
 
-    m_objectLog.clear();
+    m_objectLog.shrink(size);
+}
+
+void Deallocator::processObjectLog(std::lock_guard<StaticMutex>& lock)
+{
+    processObjectLog(lock, m_heap);
 }
 
 void Deallocator::processObjectLog()
 {
-    std::lock_guard<StaticMutex> lock(PerProcess<Heap>::mutex());
-    processObjectLog(lock);
+    HeapShards* shards = PerProcess<HeapShards>::getFastCase();
+
+    while (!m_objectLog.isEmpty()) {
+        size_t heapIndex = shards->heapIndex(m_objectLog[0]);
+        Heap* heap = shards->heap(heapIndex);
+        std::lock_guard<StaticMutex> lock(shards->mutex(heapIndex));
+        processObjectLog(lock, heap);
+    }
 }
 
 void Deallocator::deallocateSlowCase(void* object)
@@ -85,14 +106,17 @@ void Deallocator::deallocateSlowCase(void* object)
     if (!object)
         return;
 
-    std::lock_guard<StaticMutex> lock(PerProcess<Heap>::mutex());
-    if (PerProcess<Heap>::getFastCase()->isLarge(lock, object)) {
-        PerProcess<Heap>::getFastCase()->deallocateLarge(lock, object);
+    HeapShards* shards = PerProcess<HeapShards>::getFastCase();
+    if (shards->chunkTable().isLarge(object)) {
+        size_t heapIndex = shards->heapIndex(object);
+        Heap* heap = shards->heap(heapIndex);
+        std::lock_guard<StaticMutex> lock(shards->mutex(heapIndex));
+        heap->deallocateLarge(lock, object);
         return;
     }
 
     if (m_objectLog.size() == m_objectLog.capacity())
-        processObjectLog(lock);
+        processObjectLog();
 
     m_objectLog.push(object);
 }
@@ -50,8 +50,10 @@ public:
 private:
     bool deallocateFastCase(void*);
     void deallocateSlowCase(void*);
+    void processObjectLog(std::lock_guard<StaticMutex>&, Heap*);
 
     FixedVector<void*, deallocatorLogCapacity> m_objectLog;
+    Heap* m_heap;
     bool m_isBmallocEnabled;
 };
 
@@ -26,18 +26,26 @@
 #include "Heap.h"
 #include "BumpAllocator.h"
 #include "Chunk.h"
-#include "PerProcess.h"
+#include "HeapShards.h"
 #include "SmallLine.h"
 #include "SmallPage.h"
 #include <thread>
 
 namespace bmalloc {
 
-Heap::Heap(std::lock_guard<StaticMutex>&)
+Heap::Heap(std::lock_guard<StaticMutex>&, HeapShards& shards, size_t index)
     : m_vmPageSizePhysical(vmPageSizePhysical())
+    , m_shards(shards)
+    , m_index(index)
+    , m_freeSmallPageCount(0)
+    , m_freeSmallPageBytes(0)
+    , m_largeAllocatedBytes(0)
+    , m_scavengedBytes(0)
     , m_isAllocatingPages(false)
-    , m_scavenger(*this, &Heap::concurrentScavenge)
 {
+    m_smallObjectCounts.fill(0);
+    m_smallPageCounts.fill(0);
+
     RELEASE_BASSERT(vmPageSizePhysical() >= smallPageSize);
     RELEASE_BASSERT(vmPageSize() >= vmPageSizePhysical());
 
@@ -101,20 +109,12 @@ void Heap::initializePageMetadata()
         m_pageClasses[i] = (computePageSize(i) - 1) / smallPageSize;
 }
 
-void Heap::concurrentScavenge()
-{
-    std::unique_lock<StaticMutex> lock(PerProcess<Heap>::mutex());
-    scavenge(lock, scavengeSleepDuration);
-}
-
 void Heap::scavenge(std::unique_lock<StaticMutex>& lock, std::chrono::milliseconds sleepDuration)
 {
     waitUntilFalse(lock, sleepDuration, m_isAllocatingPages);
 
     scavengeSmallPages(lock, sleepDuration);
     scavengeLargeObjects(lock, sleepDuration);
-
-    sleep(lock, sleepDuration);
 }
 
 void Heap::scavengeSmallPages(std::unique_lock<StaticMutex>& lock, std::chrono::milliseconds sleepDuration)
@@ -123,6 +123,9 @@ void Heap::scavengeSmallPages(std::unique_lock<StaticMutex>& lock, std::chrono::
         while (!smallPages.isEmpty()) {
             SmallPage* page = smallPages.pop();
             size_t pageClass = m_pageClasses[page->sizeClass()];
+            --m_freeSmallPageCount;
+            m_freeSmallPageBytes -= pageSize(pageClass);
+            m_scavengedBytes += pageSize(pageClass);
             m_vmHeap.deallocateSmallPage(lock, pageClass, page);
             waitUntilFalse(lock, sleepDuration, m_isAllocatingPages);
         }
@@ -134,6 +137,7 @@ void Heap::scavengeLargeObjects(std::unique_lock<StaticMutex>& lock, std::chrono
     auto& ranges = m_largeFree.ranges();
     for (size_t i = ranges.size(); i-- > 0; i = std::min(i, ranges.size())) {
         auto range = ranges.pop(i);
+        m_scavengedBytes += range.physicalSize();
 
         lock.unlock();
         vmDeallocatePhysicalPagesSloppy(range.begin(), range.size());
@@ -153,16 +157,24 @@ SmallPage* Heap::allocateSmallPage(std::lock_guard<StaticMutex>& lock, size_t si
 
     SmallPage* page = [&]() {
         size_t pageClass = m_pageClasses[sizeClass];
-        if (!m_smallPages[pageClass].isEmpty())
+        if (!m_smallPages[pageClass].isEmpty()) {
+            --m_freeSmallPageCount;
+            m_freeSmallPageBytes -= pageSize(pageClass);
             return m_smallPages[pageClass].pop();
+        }
 
         m_isAllocatingPages = true;
 
         SmallPage* page = m_vmHeap.allocateSmallPage(lock, pageClass);
-        m_objectTypes.set(Chunk::get(page), ObjectType::Small);
+
+        // Small page allocation can't fail, so memory the chunk table can't
+        // describe is treated like running out of memory.
+        bool isRecorded = m_shards.chunkTable().add(Chunk::get(page), chunkSize, ObjectType::Small, m_index);
+        RELEASE_BASSERT(isRecorded);
         return page;
     }();
 
+    ++m_smallPageCounts[sizeClass];
     page->setSizeClass(sizeClass);
     return page;
 }
@@ -187,7 +199,11 @@ void Heap::deallocateSmallLine(std::lock_guard<StaticMutex>& lock, Object object
     m_smallPagesWithFreeLines[sizeClass].remove(page);
     m_smallPages[pageClass].push(page);
 
-    m_scavenger.run();
+    --m_smallPageCounts[sizeClass];
+    ++m_freeSmallPageCount;
+    m_freeSmallPageBytes += pageSize(pageClass);
+
+    m_shards.runScavenger();
 }
 
 void Heap::allocateSmallBumpRangesByMetadata(
@@ -244,6 +260,7 @@ void Heap::allocateSmallBumpRangesByMetadata(
         }
 
         BumpRange bumpRange = allocateSmallBumpRange(lineNumber);
+        m_smallObjectCounts[sizeClass] += bumpRange.objectCount;
         if (allocator.canAllocate())
             rangeCache.push(bumpRange);
         else
@@ -298,6 +315,7 @@ void Heap::allocateSmallBumpRangesByObject(
         }
 
         BumpRange bumpRange = allocateSmallBumpRange(it, end);
+        m_smallObjectCounts[sizeClass] += bumpRange.objectCount;
         if (allocator.canAllocate())
             rangeCache.push(bumpRange);
         else
@@ -337,9 +355,8 @@ XLargeRange Heap::splitAndAllocate(XLargeRange& range, size_t alignment, size_t
     if (next)
         m_largeFree.add(next);
 
-    m_objectTypes.set(Chunk::get(range.begin()), ObjectType::Large);
-
     m_largeAllocated.set(range.begin(), range.size());
+    m_largeAllocatedBytes += range.size();
     return range;
 }
 
@@ -363,6 +380,11 @@ void* Heap::tryAllocateLarge(std::lock_guard<StaticMutex>& lock, size_t alignmen
         if (!range)
             return nullptr;
 
+        // Objects the chunk table doesn't know about can't be freed. We keep such
+        // a range reserved, since returning it would likely get it handed back.
+        if (!m_shards.chunkTable().add(range.begin(), range.size(), ObjectType::Large, m_index))
+            return nullptr;
+
         m_largeFree.add(range);
         range = m_largeFree.remove(alignment, size);
     }
@@ -377,11 +399,6 @@ void* Heap::allocateLarge(std::lock_guard<StaticMutex>& lock, size_t alignment,
     return result;
 }
 
-bool Heap::isLarge(std::lock_guard<StaticMutex>&, void* object)
-{
-    return m_objectTypes.get(Object(object).chunk()) == ObjectType::Large;
-}
-
 size_t Heap::largeSize(std::lock_guard<StaticMutex>&, void* object)
 {
     return m_largeAllocated.get(object);
@@ -392,18 +409,55 @@ void Heap::shrinkLarge(std::lock_guard<StaticMutex>&, const Range& object, size_
     BASSERT(object.size() > newSize);
 
     size_t size = m_largeAllocated.remove(object.begin());
+    m_largeAllocatedBytes -= size;
     XLargeRange range = XLargeRange(object, size);
     splitAndAllocate(range, alignment, newSize);
 
-    m_scavenger.run();
+    m_shards.runScavenger();
 }
 
 void Heap::deallocateLarge(std::lock_guard<StaticMutex>&, void* object)
 {
     size_t size = m_largeAllocated.remove(object);
+    m_largeAllocatedBytes -= size;
     m_largeFree.add(XLargeRange(object, size, size));
     
-    m_scavenger.run();
+    m_shards.runScavenger();
+}
+
+void Heap::collectStatistics(std::lock_guard<StaticMutex>&, Statistics& statistics)
+{
+    for (size_t sizeClass = 0; sizeClass < sizeClassCount; ++sizeClass) {
+        size_t pageCount = m_smallPageCounts[sizeClass];
+        size_t pageBytes = pageCount * pageSize(m_pageClasses[sizeClass]);
+        size_t liveBytes = m_smallObjectCounts[sizeClass] * objectSize(sizeClass);
+
+        SizeClassStatistics& sizeClassStatistics = statistics.sizeClasses[sizeClass];
+        sizeClassStatistics.pageCount += pageCount;
+        sizeClassStatistics.liveBytes += liveBytes;
+        sizeClassStatistics.freeBytes += pageBytes - liveBytes;
+
+        statistics.smallPageCount += pageCount;
+        statistics.committedBytes += pageBytes;
+    }
+
+    statistics.freeSmallPageCount += m_freeSmallPageCount;
+    statistics.freeSmallPageBytes += m_freeSmallPageBytes;
+    statistics.committedBytes += m_freeSmallPageBytes;
+
+    statistics.largeObjectCount += m_largeAllocated.size();
+    statistics.largeObjectBytes += m_largeAllocatedBytes;
+    statistics.committedBytes += m_largeAllocatedBytes;
+
+    for (auto& range : m_largeFree.ranges()) {
+        ++statistics.freeLargeRangeCount;
+        statistics.freeLargeBytes += range.size();
+        statistics.freeLargeCommittedBytes += range.physicalSize();
+        statistics.committedBytes += range.physicalSize();
+    }
+
+    statistics.reservedBytes += m_vmHeap.reservedBytes();
+    statistics.scavengedBytes += m_scavengedBytes;
 }
 
 } // namespace bmalloc
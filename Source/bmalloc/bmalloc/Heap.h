@@ -26,7 +26,6 @@
 #ifndef Heap_h
 #define Heap_h
 
-#include "AsyncTask.h"
 #include "BumpRange.h"
 #include "Environment.h"
 #include "LineMetadata.h"
@@ -36,6 +35,7 @@
 #include "Object.h"
 #include "SmallLine.h"
 #include "SmallPage.h"
+#include "Statistics.h"
 #include "VMHeap.h"
 #include "Vector.h"
 #include "XLargeMap.h"
@@ -47,11 +47,15 @@ namespace bmalloc {
 class BeginTag;
 class BumpAllocator;
 class EndTag;
+class HeapShards;
+
+// One shard of the process-wide heap. Callers must hold HeapShards::mutex(index()).
 
 class Heap {
 public:
-    Heap(std::lock_guard<StaticMutex>&);
+    Heap(std::lock_guard<StaticMutex>&, HeapShards&, size_t index);
     
+    size_t index() { return m_index; }
     Environment& environment() { return m_environment; }
 
     void allocateSmallBumpRanges(std::lock_guard<StaticMutex>&, size_t sizeClass, BumpAllocator&, BumpRangeCache&);
@@ -61,12 +65,13 @@ public:
     void* tryAllocateLarge(std::lock_guard<StaticMutex>&, size_t alignment, size_t);
     void deallocateLarge(std::lock_guard<StaticMutex>&, void*);
 
-    bool isLarge(std::lock_guard<StaticMutex>&, void*);
     size_t largeSize(std::lock_guard<StaticMutex>&, void*);
     void shrinkLarge(std::lock_guard<StaticMutex>&, const Range&, size_t);
 
     void scavenge(std::unique_lock<StaticMutex>&, std::chrono::milliseconds sleepDuration);
 
+    void collectStatistics(std::lock_guard<StaticMutex>&, Statistics&);
+
 private:
     struct LargeObjectHash {
         static unsigned hash(void* key)
@@ -96,7 +101,6 @@ private:
 
     XLargeRange splitAndAllocate(XLargeRange&, size_t alignment, size_t);
 
-    void concurrentScavenge();
     void scavengeSmallPages(std::unique_lock<StaticMutex>&, std::chrono::milliseconds);
     void scavengeLargeObjects(std::unique_lock<StaticMutex>&, std::chrono::milliseconds);
 
@@ -110,10 +114,17 @@ private:
     Map<void*, size_t, LargeObjectHash> m_largeAllocated;
     XLargeMap m_largeFree;
 
-    Map<Chunk*, ObjectType, ChunkHash> m_objectTypes;
+    HeapShards& m_shards;
+    size_t m_index;
+
+    std::array<size_t, sizeClassCount> m_smallObjectCounts;
+    std::array<size_t, sizeClassCount> m_smallPageCounts;
+    size_t m_freeSmallPageCount;
+    size_t m_freeSmallPageBytes;
+    size_t m_largeAllocatedBytes;
+    size_t m_scavengedBytes;
 
     bool m_isAllocatingPages;
-    AsyncTask<Heap, decltype(&Heap::concurrentScavenge)> m_scavenger;
 
     Environment m_environment;
 
@@ -131,6 +142,8 @@ inline void Heap::allocateSmallBumpRanges(
 
 inline void Heap::derefSmallLine(std::lock_guard<StaticMutex>& lock, Object object)
 {
+    --m_smallObjectCounts[object.page()->sizeClass()];
+
     if (!object.line()->deref(lock))
         return;
     deallocateSmallLine(lock, object);
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "HeapShards.h"
+#include <algorithm>
+#include <thread>
+
+namespace bmalloc {
+
+HeapShards::HeapShards(std::lock_guard<StaticMutex>&)
+    : m_heapCount(std::max<size_t>(1, std::min<size_t>(heapShardCount, std::thread::hardware_concurrency())))
+    , m_nextHeapIndex(0)
+    , m_scavengeCount(0)
+    , m_scavenger(*this, &HeapShards::concurrentScavenge)
+{
+    for (auto& heap : m_heaps)
+        heap.store(nullptr, std::memory_order_relaxed);
+}
+
+NO_INLINE Heap* HeapShards::heapSlowCase(size_t index)
+{
+    std::lock_guard<StaticMutex> lock(m_mutexes[index]);
+    if (!m_heaps[index].load(std::memory_order_consume)) {
+        Heap* heap = new (&m_memory[index]) Heap(lock, *this, index);
+        m_heaps[index].store(heap, std::memory_order_release);
+    }
+    return m_heaps[index].load(std::memory_order_consume);
+}
+
+Heap* HeapShards::heapForNewCache()
+{
+    // Threads are spread over the shards in creation order, which balances
+    // them better than hashing thread IDs or sampling the current CPU.
+    return heap(m_nextHeapIndex++ % m_heapCount);
+}
+
+void HeapShards::concurrentScavenge()
+{
+    scavenge(scavengeSleepDuration);
+}
+
+void HeapShards::scavenge(std::chrono::milliseconds sleepDuration)
+{
+    ++m_scavengeCount;
+
+    for (size_t index = 0; index < m_heapCount; ++index) {
+        Heap* heap = m_heaps[index].load(std::memory_order_consume);
+        if (!heap)
+            continue;
+
+        std::unique_lock<StaticMutex> lock(m_mutexes[index]);
+        heap->scavenge(lock, sleepDuration);
+    }
+
+    if (sleepDuration != std::chrono::milliseconds(0))
+        std::this_thread::sleep_for(sleepDuration);
+}
+
+Statistics HeapShards::statistics()
+{
+    Statistics statistics = Statistics();
+    for (size_t sizeClass = 0; sizeClass < sizeClassCount; ++sizeClass)
+        statistics.sizeClasses[sizeClass].objectSize = objectSize(sizeClass);
+
+    for (size_t index = 0; index < m_heapCount; ++index) {
+        Heap* heap = m_heaps[index].load(std::memory_order_consume);
+        if (!heap)
+            continue;
+
+        std::lock_guard<StaticMutex> lock(m_mutexes[index]);
+        heap->collectStatistics(lock, statistics);
+    }
+
+    statistics.scavengeCount = m_scavengeCount;
+    return statistics;
+}
+
+} // namespace bmalloc
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#ifndef HeapShards_h
+#define HeapShards_h
+
+#include "AsyncTask.h"
+#include "ChunkTable.h"
+#include "Heap.h"
+#include "Mutex.h"
+#include "Sizes.h"
+#include "Statistics.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+namespace bmalloc {
+
+// A set of independently locked Heaps. Each thread's cache allocates from one
+// shard, and objects are always freed back to the shard that owns their chunk.
+//
+// Shards never share free pages or free large ranges, since ownership is
+// recorded per chunk. A shard can hold free memory while another one asks the
+// OS for more, so in the worst case committed memory grows by up to
+// heapShardCount times the peak of a single heap until the scavenger returns
+// the free pages to the OS.
+
+class HeapShards {
+public:
+    HeapShards(std::lock_guard<StaticMutex>&);
+
+    size_t heapCount() { return m_heapCount; }
+    Heap* heap(size_t index);
+    StaticMutex& mutex(size_t index) { return m_mutexes[index]; }
+
+    Heap* heapForNewCache();
+    size_t heapIndex(void* object) { return m_chunkTable.heapIndex(object); }
+
+    ChunkTable& chunkTable() { return m_chunkTable; }
+
+    void runScavenger() { m_scavenger.run(); }
+    void scavenge(std::chrono::milliseconds sleepDuration);
+
+    Statistics statistics();
+
+private:
+    ~HeapShards() = delete;
+
+    Heap* heapSlowCase(size_t index);
+    void concurrentScavenge();
+
+    size_t m_heapCount;
+    std::atomic<size_t> m_nextHeapIndex;
+    std::atomic<size_t> m_scavengeCount;
+
+    std::array<Mutex, heapShardCount> m_mutexes;
+    std::array<std::atomic<Heap*>, heapShardCount> m_heaps;
+
+    typedef std::aligned_storage<sizeof(Heap), std::alignment_of<Heap>::value>::type Memory;
+    std::array<Memory, heapShardCount> m_memory;
+
+    ChunkTable m_chunkTable;
+
+    AsyncTask<HeapShards, decltype(&HeapShards::concurrentScavenge)> m_scavenger;
+};
+
+inline Heap* HeapShards::heap(size_t index)
+{
+    BASSERT(index < m_heapCount);
+    Heap* heap = m_heaps[index].load(std::memory_order_consume);
+    if (!heap)
+        return heapSlowCase(index);
+    return heap;
+}
+
+} // namespace bmalloc
+
+#endif // HeapShards_h
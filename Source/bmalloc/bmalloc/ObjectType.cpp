@@ -26,7 +26,7 @@
 #include "ObjectType.h"
 
 #include "Chunk.h"
-#include "Heap.h"
+#include "HeapShards.h"
 #include "Object.h"
 #include "PerProcess.h"
 
@@ -38,8 +38,7 @@ ObjectType objectType(void* object)
         if (!object)
             return ObjectType::Small;
 
-        std::lock_guard<StaticMutex> lock(PerProcess<Heap>::mutex());
-        if (PerProcess<Heap>::getFastCase()->isLarge(lock, object))
+        if (PerProcess<HeapShards>::getFastCase()->chunkTable().isLarge(object))
             return ObjectType::Large;
     }
     
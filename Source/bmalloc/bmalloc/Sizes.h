@@ -65,6 +65,8 @@ namespace Sizes {
     static const size_t largeAlignment = smallMax / pageSizeWasteFactor;
     static const size_t largeAlignmentMask = largeAlignment - 1;
 
+    static const size_t heapShardCount = 8;
+
     static const size_t deallocatorLogCapacity = 256;
     static const size_t bumpRangeCacheCapacity = 3;
     
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#ifndef Statistics_h
+#define Statistics_h
+
+#include "Sizes.h"
+#include <array>
+
+namespace bmalloc {
+
+// A snapshot of heap usage, summed over all heap shards. Objects that sit in
+// per-thread caches count as live, since the heap can't tell them apart.
+
+struct SizeClassStatistics {
+    size_t objectSize;
+    size_t pageCount;
+    size_t liveBytes;
+    size_t freeBytes;
+};
+
+struct Statistics {
+    std::array<SizeClassStatistics, sizeClassCount> sizeClasses;
+
+    size_t smallPageCount;
+    size_t freeSmallPageCount;
+    size_t freeSmallPageBytes;
+
+    size_t largeObjectCount;
+    size_t largeObjectBytes;
+    size_t freeLargeRangeCount;
+    size_t freeLargeBytes;
+    size_t freeLargeCommittedBytes;
+
+    size_t reservedBytes;
+    size_t committedBytes;
+
+    size_t scavengeCount;
+    size_t scavengedBytes;
+};
+
+} // namespace bmalloc
+
+#endif // Statistics_h
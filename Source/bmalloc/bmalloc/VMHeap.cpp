@@ -48,6 +48,7 @@ XLargeRange VMHeap::tryAllocateLargeChunk(std::lock_guard<StaticMutex>& lock, si
         return XLargeRange();
 
     Chunk* chunk = new (memory) Chunk(lock);
+    m_reservedBytes += size;
     
 #if BOS(DARWIN)
     m_zone.addChunk(chunk);
@@ -60,6 +61,7 @@ void VMHeap::allocateSmallChunk(std::lock_guard<StaticMutex>& lock, size_t pageC
 {
     Chunk* chunk =
         new (vmAllocate(chunkSize, chunkSize)) Chunk(lock);
+    m_reservedBytes += chunkSize;
 
 #if BOS(DARWIN)
     m_zone.addChunk(chunk);
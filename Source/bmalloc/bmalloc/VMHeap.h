@@ -43,6 +43,10 @@ class Heap;
 
 class VMHeap {
 public:
+    VMHeap();
+
+    size_t reservedBytes() { return m_reservedBytes; }
+
     SmallPage* allocateSmallPage(std::lock_guard<StaticMutex>&, size_t);
     void deallocateSmallPage(std::unique_lock<StaticMutex>&, size_t, SmallPage*);
 
@@ -52,12 +56,18 @@ private:
     void allocateSmallChunk(std::lock_guard<StaticMutex>&, size_t);
 
     std::array<List<SmallPage>, pageClassCount> m_smallPages;
+    size_t m_reservedBytes;
     
 #if BOS(DARWIN)
     Zone m_zone;
 #endif
 };
 
+inline VMHeap::VMHeap()
+    : m_reservedBytes(0)
+{
+}
+
 inline SmallPage* VMHeap::allocateSmallPage(std::lock_guard<StaticMutex>& lock, size_t pageClass)
 {
     if (m_smallPages[pageClass].isEmpty())
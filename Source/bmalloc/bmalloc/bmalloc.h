@@ -24,7 +24,7 @@
  */
 
 #include "Cache.h"
-#include "Heap.h"
+#include "HeapShards.h"
 #include "PerProcess.h"
 #include "StaticMutex.h"
 
@@ -69,8 +69,13 @@ inline void scavenge()
 {
     scavengeThisThread();
 
-    std::unique_lock<StaticMutex> lock(PerProcess<Heap>::mutex());
-    PerProcess<Heap>::get()->scavenge(lock, std::chrono::milliseconds(0));
+    PerProcess<HeapShards>::get()->scavenge(std::chrono::milliseconds(0));
+}
+
+// Takes each heap shard's lock briefly, so it's cheap enough to sample periodically.
+inline Statistics statistics()
+{
+    return PerProcess<HeapShards>::get()->statistics();
 }
 
 } // namespace api
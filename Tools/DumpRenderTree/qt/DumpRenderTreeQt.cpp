@@ -195,6 +195,7 @@ void WebPage::resetSettings()
     settings()->resetAttribute(QWebSettings::CSSGridLayoutEnabled);
     settings()->resetAttribute(QWebSettings::AcceleratedCompositingEnabled);
     settings()->resetAttribute(QWebSettings::FullScreenSupportEnabled);
+    settings()->resetAttribute(QWebSettings::DeferredCSSParserEnabled);
 
     m_drt->testRunner()->setCaretBrowsingEnabled(false);
     m_drt->testRunner()->setAuthorAndUserStylesEnabled(true);
@@ -572,6 +572,8 @@ void TestRunnerQt::overridePreference(const QString& name, const QVariant& value
         settings->setAttribute(QWebSettings::AutoLoadImages, value.toBool());
     else if (name == "WebKitWebAudioEnabled")
         settings->setAttribute(QWebSettings::WebAudioEnabled, value.toBool());
+    else if (name == "WebKitDeferredCSSParserEnabled")
+        settings->setAttribute(QWebSettings::DeferredCSSParserEnabled, value.toBool());
     else
         printf("ERROR: TestRunner::overridePreference() does not support the '%s' preference\n",
             name.toLatin1().data());
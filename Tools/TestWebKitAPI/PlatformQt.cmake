@@ -41,15 +41,56 @@ set(test_webcore_LIBRARIES
 add_executable(TestWebCore
     ${test_main_SOURCES}
     ${TESTWEBKITAPI_DIR}/TestsController.cpp
+    ${TESTWEBKITAPI_DIR}/Tests/WebCore/CSSParser.cpp
     ${TESTWEBKITAPI_DIR}/Tests/WebCore/LayoutUnit.cpp
     ${TESTWEBKITAPI_DIR}/Tests/WebCore/URL.cpp
     ${TESTWEBKITAPI_DIR}/Tests/WebCore/SharedBuffer.cpp
+    ${TESTWEBKITAPI_DIR}/Tests/WebCore/DisplayList.cpp
     ${TESTWEBKITAPI_DIR}/Tests/WebCore/FileSystem.cpp
+    ${TESTWEBKITAPI_DIR}/Tests/WebCore/IDBSerialization.cpp
+    ${TESTWEBKITAPI_DIR}/Tests/WebCore/InputStreamPreprocessor.cpp
+    ${TESTWEBKITAPI_DIR}/Tests/WebCore/OrderedKeyMap.cpp
+    ${TESTWEBKITAPI_DIR}/Tests/WebCore/OverlapMapContainer.cpp
     ${TESTWEBKITAPI_DIR}/Tests/WebCore/PublicSuffix.cpp
     ${TESTWEBKITAPI_DIR}/Tests/WebCore/TextCodec.cpp
+    ${TESTWEBKITAPI_DIR}/Tests/WebCore/CachedImage.cpp
 )
 
 target_link_libraries(TestWebCore ${test_webcore_LIBRARIES})
 add_test(TestWebCore ${TESTWEBKITAPI_RUNTIME_OUTPUT_DIRECTORY}/WebCore/TestWebCore)
 set_tests_properties(TestWebCore PROPERTIES TIMEOUT 60)
 set_target_properties(TestWebCore PROPERTIES RUNTIME_OUTPUT_DIRECTORY ${TESTWEBKITAPI_RUNTIME_OUTPUT_DIRECTORY}/WebCore)
+
+if (ENABLE_WEBKIT2)
+    # The connection is tested directly, so its private headers are needed as well.
+    include_directories(
+        ${THIRDPARTY_DIR}/gtest/include
+        ${WEBKIT2_DIR}/Platform
+        ${WEBKIT2_DIR}/Platform/IPC
+        ${WEBKIT2_DIR}/Platform/IPC/unix
+        ${WEBKIT2_DIR}/Platform/unix
+        ${WEBKIT2_DIR}/Shared
+        ${WTF_DIR}
+    )
+
+    set(test_webkit2_LIBRARIES
+        WebKit2
+        gtest
+        ${Qt5Gui_LIBRARIES}
+        ${DEPEND_STATIC_LIBS}
+    )
+
+    add_executable(TestWebKit2
+        ${test_main_SOURCES}
+        ${TESTWEBKITAPI_DIR}/PlatformUtilities.cpp
+        ${TESTWEBKITAPI_DIR}/TestsController.cpp
+        ${TESTWEBKITAPI_DIR}/qt/PlatformUtilitiesQt.cpp
+        ${TESTWEBKITAPI_DIR}/Tests/WebKit2/MessageBodySegments.cpp
+    )
+
+    target_link_libraries(TestWebKit2 ${test_webkit2_LIBRARIES})
+    add_dependencies(TestWebKit2 ${ForwardingHeadersForTestWebKitAPI_NAME})
+    add_test(TestWebKit2 ${TESTWEBKITAPI_RUNTIME_OUTPUT_DIRECTORY}/WebKit2/TestWebKit2)
+    set_tests_properties(TestWebKit2 PROPERTIES TIMEOUT 60)
+    set_target_properties(TestWebKit2 PROPERTIES RUNTIME_OUTPUT_DIRECTORY ${TESTWEBKITAPI_RUNTIME_OUTPUT_DIRECTORY}/WebKit2)
+endif ()
@@ -25,6 +25,7 @@
 
 #include "config.h"
 
+#include <wtf/Threading.h>
 #include <wtf/text/AtomicString.h>
 
 namespace TestWebKitAPI {
@@ -53,6 +54,26 @@ TEST(WTF, AtomicStringCreationFromLiteralUniqueness)
     ASSERT_EQ(string1.impl(), string3.impl());
 }
 
+#if ENABLE(SHARED_ATOMIC_STRING_TABLE)
+TEST(WTF, AtomicStringCreationFromLiteralSharedAcrossThreads)
+{
+    AtomicStringImpl* otherThreadImpl = nullptr;
+    ThreadIdentifier thread = createThread("AtomicString test thread", [&otherThreadImpl] {
+        AtomicString string("Shared Literal", AtomicString::ConstructFromLiteral);
+        otherThreadImpl = string.impl();
+    });
+    waitForThreadCompletion(thread);
+
+    AtomicString string("Shared Literal");
+    ASSERT_EQ(otherThreadImpl, string.impl());
+
+    // A string this thread atomized first is not replaced by the literal.
+    AtomicString ownString(String("Unshared Literal"));
+    AtomicString literal("Unshared Literal", AtomicString::ConstructFromLiteral);
+    ASSERT_EQ(ownString.impl(), literal.impl());
+}
+#endif
+
 TEST(WTF, AtomicStringExistingHash)
 {
     AtomicString string1("Template Literal", AtomicString::ConstructFromLiteral);
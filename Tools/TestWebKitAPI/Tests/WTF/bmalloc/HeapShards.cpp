@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <bmalloc/Environment.h>
+#include <bmalloc/HeapShards.h>
+#include <bmalloc/bmalloc.h>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <vector>
+
+using namespace bmalloc;
+
+namespace TestWebKitAPI {
+
+static const size_t smallSize = 64;
+static const size_t largeSize = 1024 * 1024;
+
+// The first allocation on a new thread creates its cache, which binds it to the next shard.
+static void runOnNewThread(const std::function<void()>& function)
+{
+    std::thread thread(function);
+    thread.join();
+}
+
+static bool hasSeveralShards()
+{
+    return Environment().isBmallocEnabled() && PerProcess<HeapShards>::get()->heapCount() > 1;
+}
+
+static size_t owningShard(void* object)
+{
+    return PerProcess<HeapShards>::get()->heapIndex(object);
+}
+
+static size_t shardOfThisThread()
+{
+    void* probe = api::malloc(smallSize);
+    size_t shard = owningShard(probe);
+    api::free(probe);
+    return shard;
+}
+
+static size_t liveBytes(size_t size)
+{
+    return api::statistics().sizeClasses[sizeClass(size)].liveBytes;
+}
+
+static void fill(void* object, size_t size, unsigned char seed)
+{
+    unsigned char* bytes = static_cast<unsigned char*>(object);
+    for (size_t i = 0; i < size; ++i)
+        bytes[i] = static_cast<unsigned char>(seed + i);
+}
+
+static bool hasContents(void* object, size_t size, unsigned char seed)
+{
+    unsigned char* bytes = static_cast<unsigned char*>(object);
+    for (size_t i = 0; i < size; ++i) {
+        if (bytes[i] != static_cast<unsigned char>(seed + i))
+            return false;
+    }
+    return true;
+}
+
+TEST(bmalloc, HeapShardsRemoteFree)
+{
+    if (!hasSeveralShards())
+        return;
+
+    // More objects than the deallocator logs, so that the log fills up with remote objects.
+    std::vector<void*> objects(10000);
+    size_t allocatingShard = 0;
+    runOnNewThread([&] {
+        allocatingShard = shardOfThisThread();
+        for (void*& object : objects) {
+            object = api::malloc(smallSize);
+            fill(object, smallSize, 0);
+        }
+        api::scavengeThisThread();
+    });
+
+    for (void* object : objects)
+        EXPECT_EQ(allocatingShard, owningShard(object));
+
+    size_t liveBytesBeforeFree = liveBytes(smallSize);
+    size_t freeingShard = allocatingShard;
+    runOnNewThread([&] {
+        freeingShard = shardOfThisThread();
+        for (void* object : objects)
+            api::free(object);
+        api::scavengeThisThread();
+    });
+
+    EXPECT_NE(allocatingShard, freeingShard);
+    EXPECT_EQ(liveBytesBeforeFree - objects.size() * objectSize(sizeClass(smallSize)), liveBytes(smallSize));
+}
+
+TEST(bmalloc, HeapShardsRemoteRealloc)
+{
+    if (!hasSeveralShards())
+        return;
+
+    void* smallObject = nullptr;
+    void* largeObject = nullptr;
+    size_t allocatingShard = 0;
+    runOnNewThread([&] {
+        allocatingShard = shardOfThisThread();
+        smallObject = api::malloc(smallSize);
+        fill(smallObject, smallSize, 1);
+        largeObject = api::malloc(largeSize);
+        fill(largeObject, largeSize, 2);
+        api::scavengeThisThread();
+    });
+
+    size_t largeObjectCountBeforeRealloc = api::statistics().largeObjectCount;
+    runOnNewThread([&] {
+        size_t reallocatingShard = shardOfThisThread();
+        EXPECT_NE(allocatingShard, reallocatingShard);
+
+        // Growing a small object moves it into this thread's shard.
+        void* grownSmallObject = api::realloc(smallObject, smallSize * 4);
+        EXPECT_EQ(reallocatingShard, owningShard(grownSmallObject));
+        EXPECT_TRUE(hasContents(grownSmallObject, smallSize, 1));
+        api::free(grownSmallObject);
+
+        // Shrinking a large object happens in place, in the shard that owns it.
+        void* shrunkLargeObject = api::realloc(largeObject, largeSize / 2);
+        EXPECT_EQ(largeObject, shrunkLargeObject);
+        EXPECT_EQ(allocatingShard, owningShard(shrunkLargeObject));
+        EXPECT_TRUE(hasContents(shrunkLargeObject, largeSize / 2, 2));
+
+        // Growing it moves it into this thread's shard.
+        void* grownLargeObject = api::realloc(shrunkLargeObject, largeSize * 2);
+        EXPECT_EQ(ObjectType::Large, objectType(grownLargeObject));
+        EXPECT_EQ(reallocatingShard, owningShard(grownLargeObject));
+        EXPECT_TRUE(hasContents(grownLargeObject, largeSize / 2, 2));
+        api::free(grownLargeObject);
+
+        api::scavengeThisThread();
+    });
+
+    EXPECT_EQ(largeObjectCountBeforeRealloc - 1, api::statistics().largeObjectCount);
+}
+
+} // namespace TestWebKitAPI
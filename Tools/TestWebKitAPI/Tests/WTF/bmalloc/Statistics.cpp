@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <bmalloc/Environment.h>
+#include <bmalloc/bmalloc.h>
+#include <thread>
+#include <vector>
+
+using namespace bmalloc;
+
+namespace TestWebKitAPI {
+
+static const size_t smallSize = 256;
+static const size_t largeSize = 1024 * 1024;
+
+static size_t pageBytes(const Statistics& statistics)
+{
+    size_t bytes = 0;
+    for (const SizeClassStatistics& sizeClass : statistics.sizeClasses)
+        bytes += sizeClass.liveBytes + sizeClass.freeBytes;
+    return bytes;
+}
+
+TEST(bmalloc, Statistics)
+{
+    if (!Environment().isBmallocEnabled())
+        return;
+
+    // A new thread starts with an empty cache, and scavenging it hands back what it holds, so that
+    // the only objects the heap counts as live are the ones this test allocates.
+    std::thread thread([] {
+        size_t sizeClass = bmalloc::sizeClass(smallSize);
+        Statistics before = api::statistics();
+
+        std::vector<void*> objects(1000);
+        for (void*& object : objects)
+            object = api::malloc(smallSize);
+        void* largeObject = api::malloc(largeSize);
+        api::scavengeThisThread();
+
+        Statistics allocated = api::statistics();
+        EXPECT_EQ(before.sizeClasses[sizeClass].liveBytes + objects.size() * objectSize(sizeClass), allocated.sizeClasses[sizeClass].liveBytes);
+        EXPECT_EQ(before.largeObjectCount + 1, allocated.largeObjectCount);
+        EXPECT_LE(before.largeObjectBytes + largeSize, allocated.largeObjectBytes);
+        EXPECT_LE(pageBytes(allocated) + allocated.freeSmallPageBytes + allocated.largeObjectBytes, allocated.committedBytes);
+        EXPECT_LE(allocated.committedBytes, allocated.reservedBytes);
+
+        for (void* object : objects)
+            api::free(object);
+        api::free(largeObject);
+        api::scavengeThisThread();
+
+        Statistics freed = api::statistics();
+        EXPECT_EQ(before.sizeClasses[sizeClass].liveBytes, freed.sizeClasses[sizeClass].liveBytes);
+        EXPECT_EQ(before.largeObjectCount, freed.largeObjectCount);
+        EXPECT_LE(before.freeLargeCommittedBytes + largeSize, freed.freeLargeCommittedBytes);
+        EXPECT_EQ(allocated.committedBytes, freed.committedBytes);
+
+        // Scavenging returns the free pages and the free large ranges to the OS.
+        api::scavenge();
+        Statistics scavenged = api::statistics();
+        EXPECT_LT(freed.scavengeCount, scavenged.scavengeCount);
+        EXPECT_LE(freed.scavengedBytes + freed.freeSmallPageBytes + freed.freeLargeCommittedBytes, scavenged.scavengedBytes);
+        EXPECT_EQ(0u, scavenged.freeSmallPageBytes);
+        EXPECT_EQ(0u, scavenged.freeLargeCommittedBytes);
+        EXPECT_EQ(freed.committedBytes - freed.freeSmallPageBytes - freed.freeLargeCommittedBytes, scavenged.committedBytes);
+    });
+    thread.join();
+}
+
+} // namespace TestWebKitAPI
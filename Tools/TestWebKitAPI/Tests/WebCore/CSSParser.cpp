@@ -25,9 +25,13 @@
 
 #include "config.h"
 
+#include "WTFStringUtilities.h"
 #include <WebCore/CSSParser.h>
 #include <WebCore/CSSValueList.h>
 #include <WebCore/StyleProperties.h>
+#include <WebCore/StyleRule.h>
+#include <WebCore/StyleSheetContents.h>
+#include <wtf/text/StringBuilder.h>
 
 namespace TestWebKitAPI {
 
@@ -85,4 +89,99 @@ TEST(CSSPropertyParserTest, GridTrackLimits)
 #endif // ENABLE(CSS_GRID_LAYOUT)
 }
 
+static const char deferredParsingTestSheet[] =
+    "div { color: red; margin: 1px 2px }\n"
+    "p.a > span { content: \"}\"; font-family: 'a}b', serif }\n"
+    "em { /* } */ color: blue /* { */ }\n"
+    "a { background-image: url(images/a{b}.png); width: 10px }\n"
+    "b { color: green !important; width: 2rem ! important }\n"
+    "i { color: red; { nested: block } width: 5px }\n"
+    "u { width: calc((1px + 2px) * 3) }\n"
+    "@media screen { s { color: olive } }\n";
+
+static Ref<StyleSheetContents> parseSheet(const char* text, bool deferred)
+{
+    CSSParserContext context(CSSStrictMode, URL(ParsedURLString, "http://example.com/"));
+    context.isDeferredCSSParserEnabled = deferred;
+    Ref<StyleSheetContents> sheet = StyleSheetContents::create(context);
+    sheet->parseString(String(text));
+    return sheet;
+}
+
+static StyleRule& styleRuleAt(StyleSheetContents& sheet, size_t index)
+{
+    return downcast<StyleRule>(*sheet.childRules()[index]);
+}
+
+static void serializeRules(const Vector<RefPtr<StyleRuleBase>>& rules, StringBuilder& result)
+{
+    for (auto& rule : rules) {
+        if (is<StyleRule>(*rule)) {
+            auto& styleRule = downcast<StyleRule>(*rule);
+            result.append(styleRule.selectorList().selectorsText());
+            result.appendLiteral(" { ");
+            result.append(styleRule.properties().asText());
+            result.appendLiteral(" }\n");
+        } else if (is<StyleRuleMedia>(*rule))
+            serializeRules(downcast<StyleRuleMedia>(*rule).childRules(), result);
+    }
+}
+
+static String serializeSheet(StyleSheetContents& sheet)
+{
+    StringBuilder result;
+    serializeRules(sheet.childRules(), result);
+    return result.toString();
+}
+
+TEST(CSSParserTest, DeferredParsingMatchesEagerParsing)
+{
+    Ref<StyleSheetContents> eagerSheet = parseSheet(deferredParsingTestSheet, false);
+    Ref<StyleSheetContents> deferredSheet = parseSheet(deferredParsingTestSheet, true);
+
+    ASSERT_EQ(eagerSheet->childRules().size(), deferredSheet->childRules().size());
+    EXPECT_EQ(eagerSheet->usesRemUnits(), deferredSheet->usesRemUnits());
+    EXPECT_TRUE(deferredSheet->usesRemUnits());
+
+    // Braces and comments inside strings, comments and url() don't keep a block from being deferred.
+    for (size_t i = 0; i < 5; ++i)
+        EXPECT_FALSE(styleRuleAt(deferredSheet, i).propertiesWithoutDeferredParsing());
+    // A nested block is parsed right away.
+    EXPECT_TRUE(styleRuleAt(deferredSheet, 5).propertiesWithoutDeferredParsing());
+
+    String eagerText = serializeSheet(eagerSheet);
+    EXPECT_EQ(eagerText, serializeSheet(deferredSheet));
+    EXPECT_NE(notFound, eagerText.find("'}'"));
+    EXPECT_NE(notFound, eagerText.find("a}b"));
+    EXPECT_NE(notFound, eagerText.find("color: blue"));
+    EXPECT_NE(notFound, eagerText.find("example.com/images/a"));
+    EXPECT_NE(notFound, eagerText.find("color: green !important"));
+    EXPECT_NE(notFound, eagerText.find("width: 2rem !important"));
+}
+
+TEST(CSSParserTest, DeferredParsingMutationBeforeFirstAccess)
+{
+    Ref<StyleSheetContents> originalSheet = parseSheet(deferredParsingTestSheet, false);
+    Ref<StyleSheetContents> eagerSheet = parseSheet(deferredParsingTestSheet, false);
+    Ref<StyleSheetContents> deferredSheet = parseSheet(deferredParsingTestSheet, true);
+
+    // A copy made before the block is parsed, like the one CSSOM makes before mutating a shared sheet.
+    Ref<StyleSheetContents> deferredCopy = deferredSheet->copy();
+    EXPECT_FALSE(styleRuleAt(deferredCopy, 0).propertiesWithoutDeferredParsing());
+
+    styleRuleAt(eagerSheet, 0).mutableProperties().setProperty(CSSPropertyColor, "blue");
+    styleRuleAt(deferredCopy, 0).mutableProperties().setProperty(CSSPropertyColor, "blue");
+    styleRuleAt(eagerSheet, 1).mutableProperties().removeProperty(CSSPropertyContent);
+    styleRuleAt(deferredSheet, 1).mutableProperties().removeProperty(CSSPropertyContent);
+
+    EXPECT_EQ(styleRuleAt(eagerSheet, 0).properties().asText(), styleRuleAt(deferredCopy, 0).properties().asText());
+    EXPECT_NE(notFound, styleRuleAt(deferredCopy, 0).properties().asText().find("color: blue"));
+    EXPECT_EQ(styleRuleAt(eagerSheet, 1).properties().asText(), styleRuleAt(deferredSheet, 1).properties().asText());
+    EXPECT_EQ(notFound, styleRuleAt(deferredSheet, 1).properties().asText().find("content"));
+
+    // The original is parsed from the sheet text, unaffected by the mutation of its copy.
+    EXPECT_FALSE(styleRuleAt(deferredSheet, 0).propertiesWithoutDeferredParsing());
+    EXPECT_EQ(styleRuleAt(originalSheet, 0).properties().asText(), styleRuleAt(deferredSheet, 0).properties().asText());
+}
+
 } // namespace TestWebKitAPI
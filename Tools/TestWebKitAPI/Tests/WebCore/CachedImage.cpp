@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+
+#include "Test.h"
+#include <WebCore/BitmapImage.h>
+#include <WebCore/CachedImage.h>
+#include <WebCore/CachedImageClient.h>
+#include <WebCore/CachedResourceHandle.h>
+#include <WebCore/SessionID.h>
+#include <WebCore/SharedBuffer.h>
+#include <wtf/MainThread.h>
+
+using namespace WebCore;
+
+namespace TestWebKitAPI {
+
+static const int imageDimension = 64;
+
+static void appendLittleEndian(Vector<char>& data, uint32_t value, size_t byteCount)
+{
+    for (size_t i = 0; i < byteCount; ++i)
+        data.append(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+// An uncompressed 24-bit BMP, which every port can decode.
+static RefPtr<SharedBuffer> createBitmapData()
+{
+    const uint32_t headerSize = 14 + 40;
+    const uint32_t pixelDataSize = imageDimension * imageDimension * 3;
+
+    Vector<char> data;
+    data.append('B');
+    data.append('M');
+    appendLittleEndian(data, headerSize + pixelDataSize, 4);
+    appendLittleEndian(data, 0, 4);
+    appendLittleEndian(data, headerSize, 4);
+    appendLittleEndian(data, 40, 4);
+    appendLittleEndian(data, imageDimension, 4);
+    appendLittleEndian(data, imageDimension, 4);
+    appendLittleEndian(data, 1, 2);
+    appendLittleEndian(data, 24, 2);
+    appendLittleEndian(data, 0, 4);
+    appendLittleEndian(data, pixelDataSize, 4);
+    appendLittleEndian(data, 2835, 4);
+    appendLittleEndian(data, 2835, 4);
+    appendLittleEndian(data, 0, 4);
+    appendLittleEndian(data, 0, 4);
+    data.grow(headerSize + pixelDataSize);
+
+    return SharedBuffer::adoptVector(data);
+}
+
+class TestImageClient : public CachedImageClient {
+public:
+    explicit TestImageClient(bool drawsImage = true)
+        : m_drawsImage(drawsImage)
+    {
+    }
+
+    virtual bool drawsCachedImage() const override { return m_drawsImage; }
+
+private:
+    bool m_drawsImage;
+};
+
+class CachedImageDownsamplingTest : public testing::Test {
+public:
+    virtual void SetUp() override
+    {
+        WTF::initializeMainThread();
+
+        m_image = BitmapImage::create();
+        m_image->setData(createBitmapData(), true);
+        ASSERT_EQ(IntSize(imageDimension, imageDimension), m_image->size());
+
+        m_cachedImage = new CachedImage(m_image.get(), SessionID::defaultSessionID());
+    }
+
+    virtual void TearDown() override
+    {
+        m_cachedImage = nullptr;
+        m_image = nullptr;
+    }
+
+    IntSize maximumDecodedSize() const { return m_image->maximumDecodedSize(); }
+
+protected:
+    RefPtr<BitmapImage> m_image;
+    CachedResourceHandle<CachedImage> m_cachedImage;
+};
+
+TEST_F(CachedImageDownsamplingTest, LargestSizeAcrossClients)
+{
+    TestImageClient first;
+    TestImageClient second;
+    m_cachedImage->addClient(&first);
+    m_cachedImage->addClient(&second);
+
+    m_cachedImage->updateDisplayedSize(first, IntSize(16, 16));
+    EXPECT_TRUE(maximumDecodedSize().isEmpty());
+
+    m_cachedImage->updateDisplayedSize(second, IntSize(20, 20));
+    EXPECT_EQ(IntSize(32, 32), maximumDecodedSize());
+
+    m_cachedImage->removeClient(&second);
+    m_cachedImage->removeClient(&first);
+}
+
+TEST_F(CachedImageDownsamplingTest, ClientWithoutSizeGetsFullSize)
+{
+    TestImageClient renderImage;
+    m_cachedImage->addClient(&renderImage);
+    m_cachedImage->updateDisplayedSize(renderImage, IntSize(16, 16));
+    EXPECT_EQ(IntSize(16, 16), maximumDecodedSize());
+
+    // E.g. a renderer painting the image as a CSS background.
+    TestImageClient background;
+    m_cachedImage->addClient(&background);
+    EXPECT_TRUE(maximumDecodedSize().isEmpty());
+
+    m_cachedImage->removeClient(&background);
+    EXPECT_EQ(IntSize(16, 16), maximumDecodedSize());
+
+    m_cachedImage->removeClient(&renderImage);
+}
+
+TEST_F(CachedImageDownsamplingTest, ClientsThatDoNotDrawAreIgnored)
+{
+    TestImageClient imageLoader(false);
+    TestImageClient renderImage;
+    m_cachedImage->addClient(&imageLoader);
+    m_cachedImage->addClient(&renderImage);
+
+    m_cachedImage->updateDisplayedSize(renderImage, IntSize(16, 16));
+    EXPECT_EQ(IntSize(16, 16), maximumDecodedSize());
+
+    m_cachedImage->removeClient(&renderImage);
+    m_cachedImage->removeClient(&imageLoader);
+}
+
+TEST_F(CachedImageDownsamplingTest, FullSizeAfterCanvasAccess)
+{
+    TestImageClient renderImage;
+    m_cachedImage->addClient(&renderImage);
+    m_cachedImage->updateDisplayedSize(renderImage, IntSize(16, 16));
+    EXPECT_EQ(IntSize(16, 16), maximumDecodedSize());
+
+    m_cachedImage->requireFullSizeDecode();
+    EXPECT_TRUE(maximumDecodedSize().isEmpty());
+
+    m_cachedImage->updateDisplayedSize(renderImage, IntSize(8, 8));
+    EXPECT_TRUE(maximumDecodedSize().isEmpty());
+
+    m_cachedImage->removeClient(&renderImage);
+}
+
+} // namespace TestWebKitAPI
+
+#endif // ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
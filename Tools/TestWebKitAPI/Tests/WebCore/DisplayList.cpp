@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include "Test.h"
+#include <WebCore/CanvasRenderingContext2D.h>
+#include <WebCore/DisplayList.h>
+#include <WebCore/DisplayListRecorder.h>
+#include <WebCore/DisplayListReplayer.h>
+#include <WebCore/Document.h>
+#include <WebCore/GraphicsContext.h>
+#include <WebCore/HTMLCanvasElement.h>
+#include <WebCore/HTMLNames.h>
+#include <WebCore/ScriptController.h>
+
+using namespace WebCore;
+
+namespace TestWebKitAPI {
+
+static void recordDrawing(GraphicsContext& context)
+{
+    context.fillRect(FloatRect(0, 0, 10, 10), Color(255, 0, 0));
+    context.save();
+    context.translate(20, 20);
+    context.setFillColor(Color(0, 255, 0));
+    context.fillRect(FloatRect(0, 0, 10, 10));
+    context.restore();
+    context.fillRect(FloatRect(50, 50, 10, 10), Color(0, 0, 255));
+}
+
+TEST(DisplayList, ArenaStorage)
+{
+    FloatRect clip(0, 0, 100, 100);
+
+    GraphicsContext refCountedContext;
+    DisplayList::DisplayList refCountedList;
+    {
+        DisplayList::Recorder recorder(refCountedContext, refCountedList, clip, AffineTransform());
+        recordDrawing(refCountedContext);
+    }
+
+    GraphicsContext arenaContext;
+    DisplayList::DisplayList arenaList(DisplayList::DisplayList::StorageMode::Arena);
+    {
+        DisplayList::Recorder recorder(arenaContext, arenaList, clip, AffineTransform());
+        recordDrawing(arenaContext);
+    }
+
+    EXPECT_EQ(DisplayList::DisplayList::StorageMode::Arena, arenaList.storageMode());
+    EXPECT_EQ(refCountedList.itemCount(), arenaList.itemCount());
+    EXPECT_EQ(refCountedList.asText(DisplayList::AsTextFlag::None), arenaList.asText(DisplayList::AsTextFlag::None));
+
+    arenaList.clear();
+    EXPECT_EQ(0U, arenaList.itemCount());
+}
+
+static Ref<HTMLCanvasElement> createCanvas(Document& document, bool tracksDisplayListReplay)
+{
+    Ref<HTMLCanvasElement> canvas = HTMLCanvasElement::create(document);
+    canvas->setSize(IntSize(100, 100));
+    canvas->setUsesDisplayListDrawing(true);
+    canvas->setTracksDisplayListReplay(tracksDisplayListReplay);
+    return canvas;
+}
+
+static CanvasRenderingContext2D& context2D(HTMLCanvasElement& canvas)
+{
+    return downcast<CanvasRenderingContext2D>(*canvas.getContext("2d"));
+}
+
+// Leaves a fill color in an open save that the recorder hasn't written to the list yet.
+static void drawBeforeTracking(CanvasRenderingContext2D& context)
+{
+    context.setFillColor("red");
+    context.fillRect(0, 0, 10, 10);
+    context.save();
+    context.translate(20, 20);
+    context.setFillColor("lime");
+    context.fillRect(0, 0, 10, 10);
+    context.restore();
+    context.save();
+    context.setFillColor("blue");
+}
+
+static void drawAfterTracking(CanvasRenderingContext2D& context)
+{
+    context.fillRect(50, 50, 10, 10);
+    context.restore();
+    context.fillRect(70, 70, 10, 10);
+}
+
+TEST(DisplayList, CanvasTracksReplayOfReRecordedArenaItems)
+{
+    ScriptController::initializeThreading();
+    AtomicString::init();
+    HTMLNames::init();
+    QualifiedName::init();
+
+    Ref<Document> document = Document::create(nullptr, URL());
+
+    // Tracks replay from the start, so it records into ref-counted storage right away.
+    Ref<HTMLCanvasElement> expectedCanvas = createCanvas(document, true);
+    CanvasRenderingContext2D& expectedContext = context2D(expectedCanvas);
+    drawBeforeTracking(expectedContext);
+    drawAfterTracking(expectedContext);
+
+    // Records into an arena until tracking is turned on in the middle of drawing.
+    Ref<HTMLCanvasElement> canvas = createCanvas(document, false);
+    CanvasRenderingContext2D& context = context2D(canvas);
+    drawBeforeTracking(context);
+    canvas->setTracksDisplayListReplay(true);
+    drawAfterTracking(context);
+
+    String expectedText = expectedCanvas->displayListAsText(DisplayList::AsTextFlag::None);
+    EXPECT_FALSE(expectedText.isEmpty());
+    EXPECT_EQ(expectedText, canvas->displayListAsText(DisplayList::AsTextFlag::None));
+
+    expectedCanvas->makeRenderingResultsAvailable();
+    canvas->makeRenderingResultsAvailable();
+    String expectedReplayText = expectedCanvas->replayDisplayListAsText(DisplayList::AsTextFlag::None);
+    EXPECT_FALSE(expectedReplayText.isEmpty());
+    EXPECT_EQ(expectedReplayText, canvas->replayDisplayListAsText(DisplayList::AsTextFlag::None));
+
+    canvas->setTracksDisplayListReplay(false);
+    expectedCanvas->setTracksDisplayListReplay(false);
+}
+
+} // namespace TestWebKitAPI
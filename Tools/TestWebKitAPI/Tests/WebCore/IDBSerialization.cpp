@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#if ENABLE(INDEXED_DATABASE)
+
+#include "Test.h"
+#include <WebCore/IDBKeyData.h>
+#include <WebCore/IDBSerialization.h>
+#include <limits>
+
+using namespace WebCore;
+
+namespace TestWebKitAPI {
+
+static IDBKeyData numberKey(double value)
+{
+    IDBKeyData key;
+    key.setNumberValue(value);
+    return key;
+}
+
+static IDBKeyData dateKey(double value)
+{
+    IDBKeyData key;
+    key.setDateValue(value);
+    return key;
+}
+
+static IDBKeyData stringKey(const String& value)
+{
+    IDBKeyData key;
+    key.setStringValue(value);
+    return key;
+}
+
+static IDBKeyData arrayKey(const Vector<IDBKeyData>& value)
+{
+    IDBKeyData key;
+    key.setArrayValue(value);
+    return key;
+}
+
+static int compareSerializedKeys(const IDBKeyData& a, const IDBKeyData& b)
+{
+    RefPtr<SharedBuffer> aBuffer = serializeSortableIDBKeyData(a);
+    RefPtr<SharedBuffer> bBuffer = serializeSortableIDBKeyData(b);
+    int result = memcmp(aBuffer->data(), bBuffer->data(), std::min(aBuffer->size(), bBuffer->size()));
+    if (result)
+        return result;
+    if (aBuffer->size() == bBuffer->size())
+        return 0;
+    return aBuffer->size() < bBuffer->size() ? -1 : 1;
+}
+
+static int sign(int value)
+{
+    return (value > 0) - (value < 0);
+}
+
+static Vector<IDBKeyData> testKeys()
+{
+    const UChar surrogatePair[] = { 0xD83D, 0xDE00 };
+    const UChar highCharacters[] = { 0x3FFF, 0x4000, 0xFFFF };
+
+    return {
+        IDBKeyData::minimum(),
+        numberKey(-std::numeric_limits<double>::infinity()),
+        numberKey(-1e300),
+        numberKey(-1),
+        numberKey(-0.0),
+        numberKey(0),
+        numberKey(1e-300),
+        numberKey(1),
+        numberKey(2),
+        numberKey(std::numeric_limits<double>::infinity()),
+        dateKey(-1),
+        dateKey(0),
+        dateKey(1458000000000),
+        stringKey(emptyString()),
+        stringKey(String("\0", 1)),
+        stringKey("a"),
+        stringKey("ab"),
+        stringKey("b"),
+        stringKey(String(surrogatePair, 2)),
+        stringKey(String(highCharacters, 3)),
+        arrayKey({ }),
+        arrayKey({ numberKey(1) }),
+        arrayKey({ numberKey(1), numberKey(1) }),
+        arrayKey({ numberKey(1), stringKey("a") }),
+        arrayKey({ numberKey(2) }),
+        arrayKey({ stringKey("a") }),
+        arrayKey({ arrayKey({ }) }),
+        arrayKey({ arrayKey({ numberKey(1) }) }),
+        IDBKeyData::maximum(),
+    };
+}
+
+TEST(IDBSerialization, SortableKeyOrder)
+{
+    Vector<IDBKeyData> keys = testKeys();
+    for (auto& a : keys) {
+        for (auto& b : keys)
+            EXPECT_EQ(sign(a.compare(b)), sign(compareSerializedKeys(a, b)));
+    }
+}
+
+TEST(IDBSerialization, SortableKeyRoundTrip)
+{
+    for (auto& key : testKeys()) {
+        RefPtr<SharedBuffer> buffer = serializeSortableIDBKeyData(key);
+        IDBKeyData decodedKey;
+        EXPECT_TRUE(deserializeSortableIDBKeyData(reinterpret_cast<const uint8_t*>(buffer->data()), buffer->size(), decodedKey));
+        EXPECT_EQ(0, key.compare(decodedKey));
+        EXPECT_EQ(key.type(), decodedKey.type());
+    }
+}
+
+TEST(IDBSerialization, SortableKeyRejectsTruncatedData)
+{
+    RefPtr<SharedBuffer> buffer = serializeSortableIDBKeyData(arrayKey({ stringKey("abc"), numberKey(1) }));
+    for (size_t size = 1; size < buffer->size(); ++size) {
+        IDBKeyData decodedKey;
+        EXPECT_FALSE(deserializeSortableIDBKeyData(reinterpret_cast<const uint8_t*>(buffer->data()), size, decodedKey));
+    }
+}
+
+} // namespace TestWebKitAPI
+
+#endif // ENABLE(INDEXED_DATABASE)
@@ -0,0 +1,334 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include "Test.h"
+#include "WTFStringUtilities.h"
+#include <WebCore/InputStreamPreprocessor.h>
+#include <WebCore/SegmentedString.h>
+#include <wtf/text/TextPosition.h>
+
+using namespace WebCore;
+
+namespace TestWebKitAPI {
+
+// Longer than two SSE2/NEON chunks of either width, so that runs end in every position of a chunk and of the scalar tail.
+static const unsigned maximumRunLength = 40;
+
+static const UChar stopCharacters[] = { '<', '&', '\n', '\r', 0 };
+
+// 16-bit characters whose low or high byte is one of the stop characters, and which must not end a run.
+static const UChar lookalikeCharacters[] = { 0x013C, 0x0126, 0x010A, 0x010D, 0x0100, 0x3C00, 0x2600, 0x0A0A };
+
+static unsigned lengthOfPlainCharacterRun(const LChar* characters, unsigned length, LChar delimiter1, LChar delimiter2)
+{
+    return WebCore::lengthOfPlainCharacterRun(characters, length, delimiter1, delimiter2);
+}
+
+// Also checks that the scan ORs exactly the characters of the run together.
+static unsigned lengthOfPlainCharacterRun(const UChar* characters, unsigned length, LChar delimiter1, LChar delimiter2)
+{
+    UChar characterBits = 0;
+    unsigned runLength = WebCore::lengthOfPlainCharacterRun(characters, length, delimiter1, delimiter2, characterBits);
+    UChar expectedCharacterBits = 0;
+    for (unsigned i = 0; i < runLength; ++i)
+        expectedCharacterBits |= characters[i];
+    EXPECT_EQ(expectedCharacterBits, characterBits) << "run length " << runLength;
+    return runLength;
+}
+
+template<typename CharacterType>
+static void testStopCharacterPositions(CharacterType filler)
+{
+    for (unsigned length = 0; length <= maximumRunLength; ++length) {
+        Vector<CharacterType> characters(length);
+        characters.fill(filler);
+        EXPECT_EQ(length, lengthOfPlainCharacterRun(characters.data(), length, '<', '&'));
+
+        for (unsigned position = 0; position < length; ++position) {
+            for (UChar stopCharacter : stopCharacters) {
+                characters[position] = stopCharacter;
+                EXPECT_EQ(position, lengthOfPlainCharacterRun(characters.data(), length, '<', '&'))
+                    << "length " << length << ", stop character " << stopCharacter << " at " << position;
+                characters[position] = filler;
+            }
+        }
+    }
+}
+
+TEST(InputStreamPreprocessor, LengthOfPlainCharacterRun8Bit)
+{
+    testStopCharacterPositions<LChar>('a');
+    // Latin-1 characters don't stop a run either.
+    testStopCharacterPositions<LChar>(0xE9);
+}
+
+TEST(InputStreamPreprocessor, LengthOfPlainCharacterRun16Bit)
+{
+    testStopCharacterPositions<UChar>('a');
+    testStopCharacterPositions<UChar>(0x3042);
+}
+
+TEST(InputStreamPreprocessor, LengthOfPlainCharacterRunChunkBoundaries)
+{
+    // Runs that end exactly at the end of a chunk, with the stop character first in the next one or in the scalar tail.
+    for (unsigned runLength : { 7u, 8u, 15u, 16u, 31u, 32u }) {
+        Vector<LChar> characters8(maximumRunLength);
+        characters8.fill('a');
+        characters8[runLength] = '<';
+        EXPECT_EQ(runLength, lengthOfPlainCharacterRun(characters8.data(), characters8.size(), '<', '&'));
+
+        Vector<UChar> characters16(maximumRunLength);
+        characters16.fill('a');
+        characters16[runLength] = '&';
+        EXPECT_EQ(runLength, lengthOfPlainCharacterRun(characters16.data(), characters16.size(), '<', '&'));
+    }
+
+    // A whole number of chunks without a stop character, then one in the scalar tail.
+    Vector<LChar> characters8(35);
+    characters8.fill('a');
+    characters8[33] = '\r';
+    EXPECT_EQ(33u, lengthOfPlainCharacterRun(characters8.data(), characters8.size(), '<', '&'));
+
+    Vector<UChar> characters16(19);
+    characters16.fill('a');
+    characters16[17] = 0;
+    EXPECT_EQ(17u, lengthOfPlainCharacterRun(characters16.data(), characters16.size(), '<', '&'));
+}
+
+TEST(InputStreamPreprocessor, LengthOfPlainCharacterRunLookalikeCharacters)
+{
+    for (UChar lookalike : lookalikeCharacters) {
+        for (unsigned length = 1; length <= maximumRunLength; ++length) {
+            Vector<UChar> characters(length);
+            characters.fill('a');
+            for (unsigned position = 0; position < length; ++position) {
+                characters[position] = lookalike;
+                EXPECT_EQ(length, lengthOfPlainCharacterRun(characters.data(), length, '<', '&'))
+                    << "length " << length << ", character " << lookalike << " at " << position;
+                characters[position] = 'a';
+            }
+        }
+    }
+}
+
+TEST(InputStreamPreprocessor, LengthOfPlainCharacterRunDelimiters)
+{
+    const LChar characters[] = "abc\"def'ghi";
+    unsigned length = sizeof(characters) - 1;
+    EXPECT_EQ(3u, lengthOfPlainCharacterRun(characters, length, '"', '&'));
+    EXPECT_EQ(7u, lengthOfPlainCharacterRun(characters, length, '\'', '&'));
+    EXPECT_EQ(length, lengthOfPlainCharacterRun(characters, length, '<', '<'));
+}
+
+class TestTokenizer {
+public:
+    bool neverSkipNullCharacters() const { return false; }
+};
+
+class InputStreamPreprocessorTest : public testing::Test {
+public:
+    InputStreamPreprocessorTest()
+        : m_preprocessor(m_tokenizer)
+    {
+    }
+
+    // Consumes the input the way a tokenizer state that buffers text does, and returns what it buffered.
+    String consumeText(SegmentedString& source, LChar delimiter1, LChar delimiter2)
+    {
+        StringBuilder text;
+        while (m_preprocessor.peek(source)) {
+            UChar character = m_preprocessor.nextInputCharacter();
+            if (character == delimiter1 || character == delimiter2)
+                break;
+            text.append(character);
+            StringView run = m_preprocessor.advancePastCharacterRun(source, delimiter1, delimiter2, m_characterBits);
+            text.append(run);
+            if (!run.is8Bit()) {
+                for (unsigned i = 0; i < run.length(); ++i)
+                    m_expectedCharacterBits |= run[i];
+            }
+        }
+        EXPECT_EQ(m_expectedCharacterBits, m_characterBits);
+        return text.toString();
+    }
+
+    StringView advancePastCharacterRun(SegmentedString& source, LChar delimiter1, LChar delimiter2)
+    {
+        UChar characterBits = 0;
+        return m_preprocessor.advancePastCharacterRun(source, delimiter1, delimiter2, characterBits);
+    }
+
+protected:
+    TestTokenizer m_tokenizer;
+    InputStreamPreprocessor<TestTokenizer> m_preprocessor;
+    UChar m_characterBits { 0 };
+    UChar m_expectedCharacterBits { 0 };
+};
+
+TEST_F(InputStreamPreprocessorTest, AdvancePastCharacterRun)
+{
+    SegmentedString source(String("abcdefghijklmnopqrstuvwxyz<p>"));
+    ASSERT_TRUE(m_preprocessor.peek(source));
+    EXPECT_EQ('a', m_preprocessor.nextInputCharacter());
+
+    EXPECT_EQ("bcdefghijklmnopqrstuvwxyz", advancePastCharacterRun(source, '<', '&').toString());
+    ASSERT_TRUE(m_preprocessor.peek(source));
+    EXPECT_EQ('<', m_preprocessor.nextInputCharacter());
+
+    // The current character is consumed on its own when it ends the run.
+    EXPECT_TRUE(advancePastCharacterRun(source, '<', '&').isEmpty());
+    ASSERT_TRUE(m_preprocessor.peek(source));
+    EXPECT_EQ('p', m_preprocessor.nextInputCharacter());
+}
+
+TEST_F(InputStreamPreprocessorTest, AdvancePastCharacterRunAcrossSubstrings)
+{
+    SegmentedString source(String("abc"));
+    source.append(SegmentedString(String("d")));
+    source.append(SegmentedString(String("efghijklmnopqrstuvwxyz0123456789")));
+    source.append(SegmentedString(String("ABCDEFGH&amp;")));
+    EXPECT_EQ("abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGH", consumeText(source, '<', '&'));
+    EXPECT_EQ('&', source.currentChar());
+}
+
+TEST_F(InputStreamPreprocessorTest, AdvancePastCharacterRun16Bit)
+{
+    const UChar characters[] = { 'a', 0x013C, 0x0126, 'b', 0x010D, 0x010A, 0x0100, 'c', 'd', 'e', 'f', 0x3042, '<', 'x' };
+    String input(characters, WTF_ARRAY_LENGTH(characters));
+    SegmentedString source(input);
+    EXPECT_EQ(input.left(12), consumeText(source, '<', '&'));
+    EXPECT_EQ('<', source.currentChar());
+}
+
+TEST_F(InputStreamPreprocessorTest, AdvancePastCharacterRunWithPushedBackCharacters)
+{
+    SegmentedString source(String("cdefgh<"));
+    source.push('a');
+    source.push('b');
+    EXPECT_EQ("abcdefgh", consumeText(source, '<', '&'));
+    EXPECT_EQ('<', source.currentChar());
+}
+
+TEST_F(InputStreamPreprocessorTest, AdvancePastCharacterRunNormalizesNewlines)
+{
+    SegmentedString source(String("first line\r\nsecond\rthird\nfourth line that is longer than a chunk<"));
+    EXPECT_EQ("first line\nsecond\nthird\nfourth line that is longer than a chunk", consumeText(source, '<', '&'));
+    EXPECT_EQ('<', source.currentChar());
+}
+
+TEST_F(InputStreamPreprocessorTest, LineAndColumnAcrossRuns)
+{
+    SegmentedString source(String("0123456789abcdefghij\nklmnopqrstuvwxyz0123456789<\n"));
+    source.append(SegmentedString(String("zyxwvutsrqponmlkjihgfedcba&")));
+    EXPECT_EQ("0123456789abcdefghij\nklmnopqrstuvwxyz0123456789", consumeText(source, '<', '&'));
+    EXPECT_EQ('<', source.currentChar());
+    EXPECT_EQ(1, source.currentLine().zeroBasedInt());
+    EXPECT_EQ(26, source.currentColumn().zeroBasedInt());
+
+    source.advanceAndUpdateLineNumber();
+    EXPECT_EQ("\nzyxwvutsrqponmlkjihgfedcba", consumeText(source, '<', '&'));
+    EXPECT_EQ('&', source.currentChar());
+    EXPECT_EQ(2, source.currentLine().zeroBasedInt());
+    EXPECT_EQ(26, source.currentColumn().zeroBasedInt());
+}
+
+TEST(SegmentedString, AdvancePastNonNewlinesInCurrentSubstring)
+{
+    SegmentedString source(String("ab\ncdefghijklmnop"));
+    source.append(SegmentedString(String("qrstuvwxyz")));
+    source.advanceAndUpdateLineNumber();
+    source.advanceAndUpdateLineNumber();
+    source.advanceAndUpdateLineNumber();
+    EXPECT_EQ('c', source.currentChar());
+    EXPECT_EQ(1, source.currentLine().zeroBasedInt());
+    EXPECT_EQ(0, source.currentColumn().zeroBasedInt());
+    EXPECT_EQ(14u, source.lengthOfCurrentSubstring());
+
+    source.advancePastNonNewlinesInCurrentSubstring(0);
+    EXPECT_EQ('c', source.currentChar());
+
+    source.advancePastNonNewlinesInCurrentSubstring(5);
+    EXPECT_EQ('h', source.currentChar());
+    EXPECT_EQ(1, source.currentLine().zeroBasedInt());
+    EXPECT_EQ(5, source.currentColumn().zeroBasedInt());
+    EXPECT_EQ(9u, source.lengthOfCurrentSubstring());
+
+    // Leaves the last character of the substring, then advance() moves on to the next one.
+    source.advancePastNonNewlinesInCurrentSubstring(8);
+    EXPECT_EQ('p', source.currentChar());
+    EXPECT_EQ(1u, source.lengthOfCurrentSubstring());
+    source.advanceAndUpdateLineNumber();
+    EXPECT_EQ('q', source.currentChar());
+    EXPECT_EQ(1, source.currentLine().zeroBasedInt());
+    EXPECT_EQ(14, source.currentColumn().zeroBasedInt());
+    EXPECT_EQ(10u, source.lengthOfCurrentSubstring());
+
+    source.push('!');
+    EXPECT_EQ(0u, source.lengthOfCurrentSubstring());
+}
+
+TEST(SegmentedString, AdvanceByCount)
+{
+    SegmentedString source(String("abc"));
+    source.append(SegmentedString(String("de\nfg")));
+    source.append(SegmentedString(String::fromUTF8("hij\xE3\x81\x82")));
+
+    source.advance(0u);
+    EXPECT_EQ('a', source.currentChar());
+
+    source.advance(2u);
+    EXPECT_EQ('c', source.currentChar());
+    EXPECT_EQ(1u, source.lengthOfCurrentSubstring());
+
+    // Ends right at the start of a substring.
+    source.advance(1u);
+    EXPECT_EQ('d', source.currentChar());
+    EXPECT_EQ(5u, source.lengthOfCurrentSubstring());
+
+    // Crosses a substring, and a newline without counting it.
+    source.advance(6u);
+    EXPECT_EQ('i', source.currentChar());
+    EXPECT_EQ(0, source.currentLine().zeroBasedInt());
+    EXPECT_EQ(9, source.numberOfCharactersConsumed());
+    EXPECT_FALSE(source.currentSubstringIs8Bit());
+
+    // Advancing one at a time still works from where it stopped.
+    source.advance();
+    EXPECT_EQ('j', source.currentChar());
+
+    source.push('!');
+    source.push('?');
+    source.advance(3u);
+    EXPECT_EQ(0x3042, source.currentChar());
+    EXPECT_EQ(1u, source.length());
+
+    source.advance(1u);
+    EXPECT_TRUE(source.isEmpty());
+    EXPECT_EQ(0, source.currentChar());
+}
+
+} // namespace TestWebKitAPI
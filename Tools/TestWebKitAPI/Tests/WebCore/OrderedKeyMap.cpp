@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#if ENABLE(INDEXED_DATABASE)
+
+#include "Test.h"
+#include <WebCore/IDBKeyData.h>
+#include <WebCore/OrderedKeyMap.h>
+
+using namespace WebCore;
+using namespace WebCore::IDBServer;
+
+namespace TestWebKitAPI {
+
+static IDBKeyData numberKey(double value)
+{
+    IDBKeyData key;
+    key.setNumberValue(value);
+    return key;
+}
+
+static Vector<int> keysInOrder(const OrderedKeyMap<int>& map)
+{
+    Vector<int> result;
+    for (auto& key : map)
+        result.append(static_cast<int>(key.number()));
+    return result;
+}
+
+TEST(OrderedKeyMap, AddFindAndRemove)
+{
+    OrderedKeyMap<int> map;
+    EXPECT_TRUE(map.isEmpty());
+    EXPECT_TRUE(map.begin() == map.end());
+
+    // Interleave insertions so that chunks get split in the middle as well as appended to.
+    for (int i = 0; i < 1000; i += 2)
+        EXPECT_TRUE(map.add(numberKey(i), i * 10).isNewEntry);
+    for (int i = 999; i > 0; i -= 2)
+        EXPECT_TRUE(map.add(numberKey(i), i * 10).isNewEntry);
+
+    EXPECT_FALSE(map.add(numberKey(42), 0).isNewEntry);
+    EXPECT_EQ(1000u, map.size());
+
+    Vector<int> keys = keysInOrder(map);
+    ASSERT_EQ(1000u, keys.size());
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(i, keys[i]);
+
+    for (int i = 0; i < 1000; ++i) {
+        auto* value = map.valueForKey(numberKey(i));
+        ASSERT_TRUE(value);
+        EXPECT_EQ(i * 10, *value);
+    }
+    EXPECT_FALSE(map.valueForKey(numberKey(1000)));
+    EXPECT_TRUE(map.find(numberKey(-1)) == map.end());
+
+    for (int i = 0; i < 1000; ++i) {
+        if (i % 3)
+            EXPECT_TRUE(map.remove(numberKey(i)));
+    }
+    EXPECT_FALSE(map.remove(numberKey(1)));
+    EXPECT_EQ(334u, map.size());
+
+    keys = keysInOrder(map);
+    ASSERT_EQ(334u, keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+        EXPECT_EQ(static_cast<int>(i * 3), keys[i]);
+}
+
+TEST(OrderedKeyMap, Bounds)
+{
+    OrderedKeyMap<int> map;
+    for (int i = 0; i < 300; ++i)
+        map.add(numberKey(i * 2), i);
+
+    EXPECT_EQ(5, map.lowerBound(numberKey(10)).value());
+    EXPECT_EQ(6, map.lowerBound(numberKey(11)).value());
+    EXPECT_EQ(6, map.upperBound(numberKey(10)).value());
+    EXPECT_TRUE(map.lowerBound(numberKey(600)) == map.end());
+    EXPECT_TRUE(map.upperBound(numberKey(598)) == map.end());
+    EXPECT_TRUE(map.upperBound(IDBKeyData::minimum()) == map.begin());
+
+    auto iterator = map.upperBound(numberKey(201));
+    --iterator;
+    EXPECT_EQ(200, iterator->number());
+
+    iterator = map.end();
+    --iterator;
+    EXPECT_EQ(598, iterator->number());
+}
+
+TEST(OrderedKeyMap, MutationMakesIteratorsStale)
+{
+    OrderedKeyMap<int> map;
+    map.add(numberKey(1), 1);
+    map.add(numberKey(3), 3);
+
+    auto iterator = map.find(numberKey(3));
+    EXPECT_FALSE(iterator.isStale());
+
+    map.add(numberKey(2), 2);
+    EXPECT_TRUE(iterator.isStale());
+
+    iterator = map.find(numberKey(3));
+    EXPECT_FALSE(iterator.isStale());
+    EXPECT_EQ(3, iterator.value());
+
+    // Adding an existing key doesn't change the map.
+    map.add(numberKey(2), 20);
+    EXPECT_FALSE(iterator.isStale());
+    EXPECT_EQ(2, *map.valueForKey(numberKey(2)));
+
+    map.remove(numberKey(1));
+    EXPECT_TRUE(iterator.isStale());
+}
+
+} // namespace TestWebKitAPI
+
+#endif // ENABLE(INDEXED_DATABASE)
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2016 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include "Test.h"
+#include <WebCore/OverlapMapContainer.h>
+#include <wtf/CurrentTime.h>
+
+using namespace WebCore;
+
+namespace TestWebKitAPI {
+
+TEST(OverlapMapContainer, Overlap)
+{
+    OverlapMapContainer container;
+    EXPECT_TRUE(container.isEmpty());
+    EXPECT_FALSE(container.overlapsLayers(LayoutRect(0, 0, 100, 100)));
+
+    container.add(LayoutRect(0, 0, 100, 100));
+    container.add(LayoutRect(-300, -300, 10, 10));
+    container.add(LayoutRect(LayoutUnit(500.5), 0, 100, 100));
+    EXPECT_FALSE(container.isEmpty());
+
+    EXPECT_TRUE(container.overlapsLayers(LayoutRect(50, 50, 100, 100)));
+    EXPECT_TRUE(container.overlapsLayers(LayoutRect(-295, -295, 1, 1)));
+    EXPECT_TRUE(container.overlapsLayers(LayoutRect(LayoutUnit(600.25), 0, 10, 10)));
+
+    // Rects that only touch don't overlap.
+    EXPECT_FALSE(container.overlapsLayers(LayoutRect(100, 0, 100, 100)));
+    EXPECT_FALSE(container.overlapsLayers(LayoutRect(-290, -300, 10, 10)));
+    EXPECT_FALSE(container.overlapsLayers(LayoutRect(LayoutUnit(600.5), 0, 10, 10)));
+    EXPECT_FALSE(container.overlapsLayers(LayoutRect(200, 200, 100, 100)));
+
+    // Empty rects never overlap.
+    EXPECT_FALSE(container.overlapsLayers(LayoutRect(50, 50, 0, 10)));
+    container.add(LayoutRect(1000, 1000, 0, 0));
+    EXPECT_FALSE(container.overlapsLayers(LayoutRect(990, 990, 20, 20)));
+
+    // A rect spanning many cells, and a query spanning many cells.
+    container.add(LayoutRect(-10000, 5000, 20000, 10));
+    EXPECT_TRUE(container.overlapsLayers(LayoutRect(9000, 5005, 1, 1)));
+    EXPECT_TRUE(container.overlapsLayers(LayoutRect(-100000, -100000, 200000, 200000)));
+    EXPECT_FALSE(container.overlapsLayers(LayoutRect(-10000, 5010, 20000, 10)));
+}
+
+static unsigned nextRandom(unsigned& seed)
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) & 0x7fff;
+}
+
+static LayoutRect randomRect(unsigned& seed)
+{
+    int size = nextRandom(seed) % 8 ? 200 : 3000;
+    return LayoutRect(static_cast<int>(nextRandom(seed) % 8000) - 2000, static_cast<int>(nextRandom(seed) % 8000) - 2000,
+        nextRandom(seed) % size, nextRandom(seed) % size);
+}
+
+static bool overlapsAny(const Vector<LayoutRect>& rects, const LayoutRect& bounds)
+{
+    for (auto& rect : rects) {
+        if (rect.intersects(bounds))
+            return true;
+    }
+    return false;
+}
+
+TEST(OverlapMapContainer, UniteMatchesLinearSearch)
+{
+    unsigned seed = 1;
+    for (unsigned iteration = 0; iteration < 20; ++iteration) {
+        OverlapMapContainer first;
+        OverlapMapContainer second;
+        Vector<LayoutRect> rects;
+        unsigned firstCount = nextRandom(seed) % 300;
+        unsigned secondCount = nextRandom(seed) % 300;
+        for (unsigned i = 0; i < firstCount + secondCount; ++i) {
+            LayoutRect rect = randomRect(seed);
+            (i < firstCount ? first : second).add(rect);
+            rects.append(rect);
+        }
+
+        // Unite into whichever is smaller at times, which swaps the containers internally.
+        first.unite(WTFMove(second));
+        EXPECT_TRUE(second.isEmpty());
+
+        for (unsigned i = 0; i < 200; ++i) {
+            LayoutRect bounds = randomRect(seed);
+            EXPECT_EQ(overlapsAny(rects, bounds), first.overlapsLayers(bounds));
+        }
+    }
+}
+
+// A micro-benchmark rather than a test. Run it with --gtest_also_run_disabled_tests.
+TEST(OverlapMapContainer, DISABLED_SpeedTest)
+{
+    // Like RenderLayerCompositor for a page with a grid of cards that each get a layer: every card is
+    // tested against the cards before it, which all go in the same container.
+    const unsigned columnCount = 4;
+    for (unsigned cardCount : { 1000, 3000, 10000 }) {
+        Vector<LayoutRect> cards;
+        for (unsigned i = 0; i < cardCount; ++i)
+            cards.append(LayoutRect((i % columnCount) * 310, (i / columnCount) * 210, 300, 200));
+
+        double before = monotonicallyIncreasingTime();
+        Vector<LayoutRect> flatList;
+        unsigned flatOverlapCount = 0;
+        for (auto& card : cards) {
+            flatOverlapCount += overlapsAny(flatList, card);
+            flatList.append(card);
+        }
+        double flatTime = monotonicallyIncreasingTime() - before;
+
+        before = monotonicallyIncreasingTime();
+        OverlapMapContainer container;
+        unsigned gridOverlapCount = 0;
+        for (auto& card : cards) {
+            gridOverlapCount += container.overlapsLayers(card);
+            container.add(card);
+        }
+        double gridTime = monotonicallyIncreasingTime() - before;
+
+        EXPECT_EQ(flatOverlapCount, gridOverlapCount);
+        printf("%u layers: linear search %.3f ms, grid %.3f ms\n", cardCount, flatTime * 1000, gridTime * 1000);
+    }
+}
+
+} // namespace TestWebKitAPI
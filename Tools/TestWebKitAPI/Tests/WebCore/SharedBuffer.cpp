@@ -116,4 +116,42 @@ TEST_F(SharedBufferTest, appendBufferCreatedWithContentsOfExistingFile)
     EXPECT_EQ('a', buffer->data()[strlen(SharedBufferTestData)]);
 }
 
+#if PLATFORM(QT)
+TEST_F(SharedBufferTest, appendWrappedQByteArrays)
+{
+    QByteArray first("This is ");
+    QByteArray second("a test");
+    RefPtr<SharedBuffer> buffer = SharedBuffer::wrapQByteArray(first);
+    buffer->append(SharedBuffer::wrapQByteArray(second).get());
+    EXPECT_EQ(strlen(SharedBufferTestData), buffer->size());
+
+    // The byte arrays are shared, not copied.
+    const char* segment;
+    EXPECT_EQ(static_cast<unsigned>(first.size()), buffer->getSomeData(segment, 0));
+    EXPECT_EQ(first.constData(), segment);
+    EXPECT_EQ(static_cast<unsigned>(second.size()), buffer->getSomeData(segment, first.size()));
+    EXPECT_EQ(second.constData(), segment);
+
+    Ref<SharedBuffer> copy = buffer->copy();
+    EXPECT_EQ(strlen(SharedBufferTestData), copy->size());
+    EXPECT_TRUE(!memcmp(copy->data(), SharedBufferTestData, strlen(SharedBufferTestData)));
+    EXPECT_TRUE(!memcmp(buffer->data(), SharedBufferTestData, strlen(SharedBufferTestData)));
+}
+
+TEST_F(SharedBufferTest, appendDataAfterWrappedQByteArray)
+{
+    Vector<char> segmentedData(5000, 'x');
+    RefPtr<SharedBuffer> buffer = SharedBuffer::create(segmentedData.data(), segmentedData.size());
+    buffer->append(SharedBuffer::wrapQByteArray(QByteArray("ab")).get());
+    buffer->append("c", 1);
+    EXPECT_EQ(5003u, buffer->size());
+
+    const char* data = buffer->data();
+    EXPECT_EQ('x', data[4999]);
+    EXPECT_EQ('a', data[5000]);
+    EXPECT_EQ('b', data[5001]);
+    EXPECT_EQ('c', data[5002]);
+}
+#endif
+
 }
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#if USE(UNIX_DOMAIN_SOCKETS)
+
+#include "PlatformUtilities.h"
+#include <Connection.h>
+#include <DataReference.h>
+#include <MessageDecoder.h>
+#include <MessageEncoder.h>
+#include <thread>
+#include <wtf/RunLoop.h>
+
+namespace TestWebKitAPI {
+
+// Large enough to be sent out of line, small enough to fit in a single pooled segment.
+static const size_t messageBodySize = 32 * 1024;
+
+class MessageBodySegmentsClient : public IPC::Connection::Client {
+public:
+    unsigned receivedMessageCount { 0 };
+    bool receivedMessage { false };
+    bool receivedExpectedBody { true };
+
+private:
+    void didReceiveMessage(IPC::Connection&, IPC::MessageDecoder& decoder) override
+    {
+        IPC::DataReference body;
+        receivedExpectedBody &= decoder.decode(body) && body.size() == messageBodySize && body.data()[messageBodySize - 1] == receivedMessageCount % 256;
+        ++receivedMessageCount;
+        receivedMessage = true;
+    }
+
+    void didClose(IPC::Connection&) override { }
+    void didReceiveInvalidMessage(IPC::Connection&, IPC::StringReference, IPC::StringReference) override { receivedExpectedBody = false; }
+    IPC::ProcessType localProcessType() override { return IPC::ProcessType::Web; }
+    IPC::ProcessType remoteProcessType() override { return IPC::ProcessType::UI; }
+};
+
+static void sendMessageAndWait(IPC::Connection& sender, MessageBodySegmentsClient& receiverClient)
+{
+    unsigned messageIndex = receiverClient.receivedMessageCount;
+    Vector<uint8_t> body(messageBodySize, static_cast<uint8_t>(messageIndex % 256));
+
+    auto encoder = std::make_unique<IPC::MessageEncoder>("MessageBodySegmentsTest", "Message", 0);
+    encoder->encode(IPC::DataReference(body));
+    receiverClient.receivedMessage = false;
+    EXPECT_TRUE(sender.sendMessage(WTFMove(encoder)));
+    Util::run(&receiverClient.receivedMessage);
+}
+
+// Segments are released on the connection queue.
+static void waitUntilSegmentsAreReleased(IPC::Connection& connection)
+{
+    while (connection.outgoingMessageBodySegmentsSize() || connection.incomingMessageBodySegmentsSize())
+        std::this_thread::yield();
+}
+
+TEST(WebKit2, MessageBodySegmentsAreReusedAndReleased)
+{
+    RunLoop::initializeMainRunLoop();
+
+    IPC::Connection::SocketPair socketPair = IPC::Connection::createPlatformConnection(0);
+    MessageBodySegmentsClient serverClient;
+    MessageBodySegmentsClient clientClient;
+    Ref<IPC::Connection> server = IPC::Connection::createServerConnection(socketPair.server, serverClient);
+    Ref<IPC::Connection> client = IPC::Connection::createClientConnection(socketPair.client, clientClient);
+    ASSERT_TRUE(server->open());
+    ASSERT_TRUE(client->open());
+
+    // Every message after the first one reuses the segment the first one allocated.
+    for (unsigned i = 0; i < 4; ++i)
+        sendMessageAndWait(server.get(), clientClient);
+    EXPECT_EQ(4u, clientClient.receivedMessageCount);
+    EXPECT_TRUE(clientClient.receivedExpectedBody);
+    EXPECT_EQ(3u, server->messageBodySegmentPoolHits());
+    size_t segmentsSize = server->outgoingMessageBodySegmentsSize();
+    EXPECT_GT(segmentsSize, messageBodySize);
+    EXPECT_EQ(segmentsSize, client->incomingMessageBodySegmentsSize());
+
+    // Once the receiver has released the segment, the sender sends it again on its next use.
+    client->releaseMessageBodySegments();
+    waitUntilSegmentsAreReleased(client.get());
+    EXPECT_EQ(segmentsSize, server->outgoingMessageBodySegmentsSize());
+    sendMessageAndWait(server.get(), clientClient);
+    EXPECT_EQ(5u, clientClient.receivedMessageCount);
+    EXPECT_TRUE(clientClient.receivedExpectedBody);
+    EXPECT_EQ(4u, server->messageBodySegmentPoolHits());
+    EXPECT_EQ(segmentsSize, client->incomingMessageBodySegmentsSize());
+
+    server->releaseMessageBodySegments();
+    client->releaseMessageBodySegments();
+    waitUntilSegmentsAreReleased(server.get());
+    waitUntilSegmentsAreReleased(client.get());
+
+    // A released pool starts over with a new segment.
+    sendMessageAndWait(server.get(), clientClient);
+    EXPECT_EQ(6u, clientClient.receivedMessageCount);
+    EXPECT_TRUE(clientClient.receivedExpectedBody);
+    EXPECT_EQ(4u, server->messageBodySegmentPoolHits());
+    EXPECT_EQ(segmentsSize, server->outgoingMessageBodySegmentsSize());
+
+    client->invalidate();
+    server->invalidate();
+}
+
+} // namespace TestWebKitAPI
+
+#endif // USE(UNIX_DOMAIN_SOCKETS)